@@ -169,6 +169,9 @@ extern DECLSPEC void SDLCALL SDL_MemoryBarrierAcquire(void);
 #define SDL_MemoryBarrierRelease()   __asm__ __volatile__ ("" : : : "memory")
 #define SDL_MemoryBarrierAcquire()   __asm__ __volatile__ ("" : : : "memory")
 #endif /* __GNUC__ && __arm__ */
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define SDL_MemoryBarrierRelease()   __asm__ __volatile__ ("dmb ish" : : : "memory")
+#define SDL_MemoryBarrierAcquire()   __asm__ __volatile__ ("dmb ish" : : : "memory")
 #else
 #if (defined(__SUNPRO_C) && (__SUNPRO_C >= 0x5120))
 /* This is correct for all CPUs on Solaris when using Solaris Studio 12.1+. */
@@ -182,6 +185,23 @@ extern DECLSPEC void SDLCALL SDL_MemoryBarrierAcquire(void);
 #endif
 #endif
 
+/**
+ * The pause instruction tells the CPU that it is in a spin-wait loop, which
+ * saves power and frees up resources for a hyperthreaded sibling core.
+ */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SDL_CPUPauseInstruction()   __asm__ __volatile__ ("pause\n" : : : "memory")
+#elif defined(__GNUC__) && (defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH) && (__ARM_ARCH >= 7)))
+#define SDL_CPUPauseInstruction()   __asm__ __volatile__ ("yield" : : : "memory")
+#elif defined(__GNUC__) && (defined(__powerpc__) || defined(__ppc__))
+#define SDL_CPUPauseInstruction()   __asm__ __volatile__ ("or 27,27,27" : : : "memory")
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define SDL_CPUPauseInstruction()   _mm_pause()
+#else
+#define SDL_CPUPauseInstruction()   SDL_CompilerBarrier()
+#endif
+
 /**
  * \brief A type representing an atomic integer value.  It is a struct
  *        so people don't accidentally use numeric operations on it.
@@ -256,6 +276,103 @@ extern DECLSPEC void* SDLCALL SDL_AtomicSetPtr(void **a, void* v);
  */
 extern DECLSPEC void* SDLCALL SDL_AtomicGetPtr(void **a);
 
+
+/**
+ *  \name Lock-free queues
+ *
+ *  Bounded queues that can be shared between threads without a mutex.
+ *  Neither kind ever blocks: writing to a full queue or reading from an
+ *  empty one returns immediately, so callers decide how to wait.
+ */
+/* @{ */
+
+/**
+ *  \brief A single producer, single consumer ring of bytes.
+ *
+ *  One thread may write to the ring while another reads from it.  Using
+ *  more than one writer or more than one reader at a time needs a lock.
+ */
+typedef struct SDL_RingBuffer SDL_RingBuffer;
+
+/**
+ *  \brief Create a ring buffer holding at least \c capacity bytes.
+ *
+ *  The capacity is rounded up to a power of two.
+ *
+ *  \return The new ring buffer, or NULL on error.
+ */
+extern DECLSPEC SDL_RingBuffer * SDLCALL SDL_CreateRingBuffer(size_t capacity);
+
+/**
+ *  \brief Copy up to \c len bytes into the ring buffer.  Producer only.
+ *
+ *  \return The number of bytes written, less than \c len if the ring filled up.
+ */
+extern DECLSPEC size_t SDLCALL SDL_WriteRingBuffer(SDL_RingBuffer *ring, const void *data, size_t len);
+
+/**
+ *  \brief Copy up to \c len bytes out of the ring buffer.  Consumer only.
+ *
+ *  \return The number of bytes read, less than \c len if the ring ran dry.
+ */
+extern DECLSPEC size_t SDLCALL SDL_ReadRingBuffer(SDL_RingBuffer *ring, void *data, size_t len);
+
+/**
+ *  \brief Get the number of bytes waiting to be read.
+ *
+ *  If called from the producer this may be an overestimate, and from the
+ *  consumer an underestimate, since the other side may be running.
+ */
+extern DECLSPEC size_t SDLCALL SDL_GetRingBufferAvailable(SDL_RingBuffer *ring);
+
+/**
+ *  \brief Get the total number of bytes the ring buffer can hold.
+ */
+extern DECLSPEC size_t SDLCALL SDL_GetRingBufferCapacity(SDL_RingBuffer *ring);
+
+/**
+ *  \brief Destroy a ring buffer.  No other thread may be using it.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRingBuffer(SDL_RingBuffer *ring);
+
+/**
+ *  \brief A multiple producer, multiple consumer queue of fixed size elements.
+ *
+ *  Any number of threads may push and pop elements at the same time.
+ */
+typedef struct SDL_AtomicQueue SDL_AtomicQueue;
+
+/**
+ *  \brief Create a queue holding at least \c capacity elements of
+ *         \c element_size bytes each.
+ *
+ *  The capacity is rounded up to a power of two.
+ *
+ *  \return The new queue, or NULL on error.
+ */
+extern DECLSPEC SDL_AtomicQueue * SDLCALL SDL_CreateAtomicQueue(size_t element_size, size_t capacity);
+
+/**
+ *  \brief Copy an element onto the end of the queue.
+ *
+ *  \return SDL_TRUE if the element was added, SDL_FALSE if the queue is full.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicQueuePush(SDL_AtomicQueue *queue, const void *element);
+
+/**
+ *  \brief Copy the element at the front of the queue out and remove it.
+ *
+ *  \return SDL_TRUE if an element was removed, SDL_FALSE if the queue is empty.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicQueuePop(SDL_AtomicQueue *queue, void *element);
+
+/**
+ *  \brief Destroy a queue.  No other thread may be using it.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyAtomicQueue(SDL_AtomicQueue *queue);
+
+/* @} *//* Lock-free queues */
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -92,6 +92,41 @@ extern DECLSPEC int SDLCALL SDL_GetCPUCount(void);
  */
 extern DECLSPEC int SDLCALL SDL_GetCPUCacheLineSize(void);
 
+/**
+ *  \brief The layout of the processors and caches in the system.
+ *
+ *  Counts that can't be determined on a platform are filled in as if each
+ *  logical CPU were a separate core in a single package and NUMA node, and
+ *  cache sizes that can't be determined are 0.
+ *
+ *  \sa SDL_GetCPUTopology
+ */
+typedef struct SDL_CPUTopology
+{
+    int logical_cores;      /**< Logical CPUs available, as SDL_GetCPUCount() */
+    int physical_cores;     /**< Physical cores, without SMT siblings */
+    int packages;           /**< CPU packages (sockets) */
+    int numa_nodes;         /**< NUMA memory nodes */
+    int performance_cores;  /**< Logical CPUs on the fastest core type */
+    int efficiency_cores;   /**< Logical CPUs on slower core types, 0 if all cores are alike */
+    int cache_line_size;    /**< L1 cache line size in bytes */
+    int l1d_cache_size;     /**< Size of one L1 data cache in bytes */
+    int l1i_cache_size;     /**< Size of one L1 instruction cache in bytes */
+    int l2_cache_size;      /**< Size of one L2 cache in bytes */
+    int l3_cache_size;      /**< Size of one L3 cache in bytes */
+} SDL_CPUTopology;
+
+/**
+ *  \brief Get the core counts and cache sizes of the system.
+ *
+ *  On hybrid CPUs the cache sizes are the ones seen by the first CPU.
+ *  The information is gathered on the first call and cached.
+ *
+ *  \param topology A structure to fill in.
+ *  \return 0 on success, or -1 if topology is NULL.
+ */
+extern DECLSPEC int SDLCALL SDL_GetCPUTopology(SDL_CPUTopology *topology);
+
 /**
  *  This function returns true if the CPU has the RDTSC instruction.
  */
@@ -141,6 +141,37 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_VSYNC               "SDL_RENDER_VSYNC"
 
+/**
+ *  \brief  A variable controlling whether lines drawn by the software renderer are anti-aliased.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Lines are drawn with hard edges
+ *    "1"       - Line edges are blended by how much of each pixel they cover
+ *
+ *  By default lines are not anti-aliased.
+ */
+#define SDL_HINT_RENDER_LINE_ANTIALIAS      "SDL_RENDER_LINE_ANTIALIAS"
+
+/**
+ *  \brief  A variable setting the width in pixels of lines drawn by the software renderer.
+ *
+ *  This variable is a floating point number, lines wider than one pixel get round caps.
+ *
+ *  By default lines are one pixel wide.
+ */
+#define SDL_HINT_RENDER_LINE_WIDTH          "SDL_RENDER_LINE_WIDTH"
+
+/**
+ *  \brief  A variable setting how many kilobytes of rotated texture copies the software renderer keeps.
+ *
+ *  SDL_RenderCopyEx() keeps the rotated and scaled copies it makes, so drawing a texture
+ *  the same way in later frames can reuse them.  The least recently used copies are dropped
+ *  when they don't fit, and "0" disables the cache.
+ *
+ *  By default up to 4096 kilobytes are kept.
+ */
+#define SDL_HINT_RENDER_TRANSFORM_CACHE     "SDL_RENDER_TRANSFORM_CACHE"
+
 /**
  *  \brief  A variable controlling whether the screensaver is enabled. 
  *
@@ -449,6 +480,38 @@ extern "C" {
 */
 #define SDL_HINT_THREAD_STACK_SIZE              "SDL_THREAD_STACK_SIZE"
 
+/**
+ *  \brief  A variable controlling whether the threads SDL creates for audio and timers use real-time scheduling
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - The threads use their usual priority (default)
+ *    "1"       - The threads are set to SDL_THREAD_PRIORITY_TIME_CRITICAL
+ *
+ *  This is checked when each thread starts.
+ */
+#define SDL_HINT_THREAD_REALTIME                "SDL_THREAD_REALTIME"
+
+/**
+ *  \brief  A variable listing the CPUs that the threads SDL creates for audio and timers may run on
+ *
+ *  The value is a comma separated list of logical CPU numbers and ranges, e.g. "2,3" or "0,4-7".
+ *  By default the threads may run on any CPU. This is checked when each thread starts.
+ *
+ *  \sa SDL_SetThreadAffinityMask
+ */
+#define SDL_HINT_THREAD_AFFINITY                "SDL_THREAD_AFFINITY"
+
+/**
+ *  \brief  A variable setting how many times SDL_LockMutex() polls a busy mutex before sleeping
+ *
+ *  By default a busy mutex is polled 100 times on systems with more than one CPU and not at
+ *  all otherwise. "0" turns polling off.
+ *
+ *  Hints are built on mutexes, so this can only be set in the environment. It is read when
+ *  the first mutex is created.
+ */
+#define SDL_HINT_MUTEX_SPIN_COUNT               "SDL_MUTEX_SPIN_COUNT"
+
 /**
  *  \brief If set to 1, then do not allow high-DPI windows. ("Retina" on Mac and iOS)
  */
@@ -725,6 +788,22 @@ extern "C" {
  */
 #define SDL_HINT_BMP_SAVE_LEGACY_FORMAT "SDL_BMP_SAVE_LEGACY_FORMAT"
 
+/**
+ *  \brief  A variable controlling whether SDL_LoadBMP_RW() may return surfaces
+ *          that use the pixels of a memory stream without copying them.
+ *
+ * This applies to uncompressed top-down 32-bit BMP files read from SDL_RWFromMem(),
+ * SDL_RWFromConstMem() or SDL_RWFromMappedFile() streams, which are then wrapped
+ * with SDL_CreateRGBSurfaceFrom(). The memory has to stay valid as long as the
+ * surface exists, so a mapped file has to stay open, and the surface must not
+ * be written to if the memory is read-only.
+ *
+ * This variable can be set to the following values:
+ *   "0"       - Pixels are always copied into a new surface (default)
+ *   "1"       - Pixels are used in place when possible
+ */
+#define SDL_HINT_BMP_LOAD_IN_PLACE "SDL_BMP_LOAD_IN_PLACE"
+
 /**
  * \brief Tell SDL not to name threads on Windows.
  *
@@ -775,6 +854,20 @@ extern "C" {
  */
 #define SDL_HINT_OPENGL_ES_DRIVER   "SDL_OPENGL_ES_DRIVER"
 
+/**
+ *  \brief  A variable controlling whether RLE encoding runs on a background thread.
+ *
+ *  Surfaces with RLE acceleration enabled are encoded the first time they
+ *  are blitted and again after their pixels change.  With this variable set,
+ *  the encoding is done on a background thread and blits use the regular
+ *  blitter until it is ready, instead of stalling the blit that needs it.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Encode on the thread that blits the surface (default)
+ *    "1"       - Encode on a background thread
+ */
+#define SDL_HINT_VIDEO_RLE_BACKGROUND   "SDL_VIDEO_RLE_BACKGROUND"
+
 /**
  *  \brief  An enumeration of hint priorities
  */
@@ -792,6 +885,8 @@ typedef enum
  *  The priority controls the behavior when setting a hint that already
  *  has a value.  Hints will replace existing hints of their priority and
  *  lower.  Environment variables are considered to have override priority.
+ *  The environment is read the first time a hint is set or watched, and
+ *  again after SDL_ClearHints(), so later changes to it are not seen.
  *
  *  \return SDL_TRUE if the hint was set, SDL_FALSE otherwise
  */
@@ -810,6 +905,8 @@ extern DECLSPEC SDL_bool SDLCALL SDL_SetHint(const char *name,
 /**
  *  \brief Get a hint
  *
+ *  The string stays valid until the hint has changed twice more.
+ *
  *  \return The string value of a hint variable.
  */
 extern DECLSPEC const char * SDLCALL SDL_GetHint(const char *name);
@@ -821,6 +918,33 @@ extern DECLSPEC const char * SDLCALL SDL_GetHint(const char *name);
  */
 extern DECLSPEC SDL_bool SDLCALL SDL_GetHintBoolean(const char *name, SDL_bool default_value);
 
+/**
+ *  \brief An opaque handle to a hint, see SDL_GetHintHandle()
+ */
+typedef struct SDL_HintHandle SDL_HintHandle;
+
+/**
+ *  \brief Get a handle for fast, repeated lookups of a hint
+ *
+ *  The handle remains valid for the life of the program, even across
+ *  SDL_ClearHints(), and reading it doesn't take any locks or compare any
+ *  strings, so it is suitable for code that checks a hint very often.
+ *
+ *  \param name The name of the hint
+ *
+ *  \return A handle for the hint, or NULL if there was an error.
+ */
+extern DECLSPEC SDL_HintHandle * SDLCALL SDL_GetHintHandle(const char *name);
+
+/**
+ *  \brief Get the current value of a hint from a handle
+ *
+ *  This returns the same value as SDL_GetHint() for the hint's name.
+ *
+ *  \return The string value of the hint, or NULL if it isn't set.
+ */
+extern DECLSPEC const char * SDLCALL SDL_GetHintFromHandle(SDL_HintHandle *handle);
+
 /**
  * \brief type definition of the hint callback function.
  */
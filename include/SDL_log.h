@@ -199,6 +199,37 @@ extern DECLSPEC void SDLCALL SDL_LogGetOutputFunction(SDL_LogOutputFunction *cal
  */
 extern DECLSPEC void SDLCALL SDL_LogSetOutputFunction(SDL_LogOutputFunction callback, void *userdata);
 
+/**
+ *  \brief Turn asynchronous logging on or off.
+ *
+ *  In async mode each thread formats its messages into its own lock-free
+ *  queue instead of calling the output function, so logging from time
+ *  critical threads like the audio callback never waits on the output.
+ *  A background thread passes the queued messages to the output function
+ *  every few milliseconds, and SDL_LogFlush() does it immediately.
+ *
+ *  Messages from a single thread are output in order, but messages from
+ *  different threads may be interleaved differently than they were logged.
+ *  If a thread logs faster than its queue is drained, messages are dropped
+ *  and a warning with the number of dropped messages is output.
+ *
+ *  Turning async mode off outputs any queued messages. This is called
+ *  with SDL_FALSE in SDL_Quit().
+ *
+ *  \param async SDL_TRUE to queue messages, SDL_FALSE to output them directly.
+ *  \return 0 on success, or -1 if async mode couldn't be set up.
+ *
+ *  \sa SDL_LogFlush
+ */
+extern DECLSPEC int SDLCALL SDL_LogSetAsync(SDL_bool async);
+
+/**
+ *  \brief Pass all messages queued in async mode to the output function.
+ *
+ *  \sa SDL_LogSetAsync
+ */
+extern DECLSPEC void SDLCALL SDL_LogFlush(void);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
@@ -63,6 +63,15 @@ typedef struct SDL_mutex SDL_mutex;
  */
 extern DECLSPEC SDL_mutex *SDLCALL SDL_CreateMutex(void);
 
+/**
+ *  Create a mutex that can't be locked recursively, initialized unlocked.
+ *
+ *  This can be cheaper than SDL_CreateMutex(), but locking it again from
+ *  the thread that holds it will deadlock.  Platforms without a separate
+ *  non-recursive mutex return a regular mutex.
+ */
+extern DECLSPEC SDL_mutex *SDLCALL SDL_CreateFastMutex(void);
+
 /**
  *  Lock the mutex.
  *
@@ -97,6 +106,99 @@ extern DECLSPEC void SDLCALL SDL_DestroyMutex(SDL_mutex * mutex);
 /* @} *//* Mutex functions */
 
 
+/**
+ *  \brief Lock contention counters, for profiling.
+ *
+ *  These count how often SDL_AtomicLock() and SDL_LockMutex() found the
+ *  lock already held by another thread, and how often the waiting thread
+ *  stopped spinning and went to sleep.  Mutex implementations that can't
+ *  count contention leave their counters at zero.
+ */
+typedef struct SDL_LockStats
+{
+    Uint32 spinlock_contended;  /**< SDL_AtomicLock() calls that had to wait */
+    Uint32 spinlock_sleeps;     /**< SDL_AtomicLock() calls that had to sleep */
+    Uint32 mutex_contended;     /**< SDL_LockMutex() calls that had to wait */
+    Uint32 mutex_sleeps;        /**< SDL_LockMutex() calls that had to sleep */
+} SDL_LockStats;
+
+/**
+ *  Get the lock contention counters since startup or the last call to
+ *  SDL_ResetLockStats().
+ */
+extern DECLSPEC void SDLCALL SDL_GetLockStats(SDL_LockStats *stats);
+
+/**
+ *  Reset the lock contention counters to zero.
+ */
+extern DECLSPEC void SDLCALL SDL_ResetLockStats(void);
+
+
+/**
+ *  \name Reader-writer lock functions
+ *
+ *  A reader-writer lock lets any number of threads hold it for reading at
+ *  the same time, or one thread hold it for writing.  It suits data that
+ *  is read much more often than it is changed.
+ *
+ *  Reader-writer locks are not recursive.  A thread holding the lock for
+ *  writing must not lock it again, and a thread holding it for reading
+ *  must not try to lock it for writing.
+ */
+/* @{ */
+
+/* The SDL reader-writer lock structure, defined in SDL_sysrwlock.c */
+struct SDL_RWLock;
+typedef struct SDL_RWLock SDL_RWLock;
+
+/**
+ *  Create a reader-writer lock, initialized unlocked.
+ */
+extern DECLSPEC SDL_RWLock *SDLCALL SDL_CreateRWLock(void);
+
+/**
+ *  Lock the reader-writer lock for reading, waiting for any writer.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForReading(SDL_RWLock * rwlock);
+
+/**
+ *  Lock the reader-writer lock for writing, waiting for all other users.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForWriting(SDL_RWLock * rwlock);
+
+/**
+ *  Try to lock the reader-writer lock for reading
+ *
+ *  \return 0, SDL_MUTEX_TIMEDOUT, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForReading(SDL_RWLock * rwlock);
+
+/**
+ *  Try to lock the reader-writer lock for writing
+ *
+ *  \return 0, SDL_MUTEX_TIMEDOUT, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForWriting(SDL_RWLock * rwlock);
+
+/**
+ *  Unlock the reader-writer lock, whichever way it was locked.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_UnlockRWLock(SDL_RWLock * rwlock);
+
+/**
+ *  Destroy a reader-writer lock.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_RWLock * rwlock);
+
+/* @} *//* Reader-writer lock functions */
+
+
 /**
  *  \name Semaphore functions
  */
@@ -127,6 +127,27 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief A set of large textures that many small images are packed into
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
+/**
+ *  \brief A handle to an image stored in a texture atlas, 0 is never valid
+ */
+typedef Uint32 SDL_AtlasEntryID;
+
+/**
+ *  \brief Flags used when creating a texture atlas
+ */
+typedef enum
+{
+    SDL_ATLAS_DEFAULT = 0x00000000,     /**< Fail when the atlas is full */
+    SDL_ATLAS_EVICT_LRU = 0x00000001    /**< Evict the least recently used
+                                             entries when the atlas is full */
+} SDL_AtlasFlags;
+
 
 /* Function prototypes */
 
@@ -893,6 +914,116 @@ extern DECLSPEC int SDLCALL SDL_GL_BindTexture(SDL_Texture *texture, float *texw
  */
 extern DECLSPEC int SDLCALL SDL_GL_UnbindTexture(SDL_Texture *texture);
 
+/**
+ *  \brief Create a texture atlas for a rendering context.
+ *
+ *  A texture atlas packs many small images into a few large static textures
+ *  (pages), so they don't fragment texture memory and can be drawn from the
+ *  same texture.  A copy of each page is kept in system memory so the atlas
+ *  can be repacked.
+ *
+ *  \param renderer  The renderer.
+ *  \param format    The format of the pages, one of the non-indexed,
+ *                   non-FOURCC formats enumerated by ::SDL_PixelFormatEnum.
+ *  \param page_w    The width of each page in pixels.
+ *  \param page_h    The height of each page in pixels.
+ *  \param max_pages The maximum number of pages, or 0 for no limit.
+ *  \param flags     ::SDL_AtlasFlags OR'd together.
+ *
+ *  \return The created atlas is returned, or NULL on error.
+ *
+ *  \note The atlas must be destroyed before its renderer.
+ *
+ *  \sa SDL_AtlasAddSurface()
+ *  \sa SDL_DestroyTextureAtlas()
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(SDL_Renderer * renderer,
+                                                                 Uint32 format,
+                                                                 int page_w, int page_h,
+                                                                 int max_pages,
+                                                                 Uint32 flags);
+
+/**
+ *  \brief Copy a surface into free space in a texture atlas.
+ *
+ *  If the atlas is full it is repacked, and if it was created with
+ *  ::SDL_ATLAS_EVICT_LRU the least recently used entries are removed until
+ *  the surface fits.
+ *
+ *  \param atlas    The texture atlas.
+ *  \param surface  The surface to copy, converted to the format of the atlas.
+ *
+ *  \return A handle to the new entry, or 0 on error.
+ */
+extern DECLSPEC SDL_AtlasEntryID SDLCALL SDL_AtlasAddSurface(SDL_TextureAtlas * atlas,
+                                                             SDL_Surface * surface);
+
+/**
+ *  \brief Remove an entry from a texture atlas.
+ *
+ *  The space used by the entry is reclaimed the next time the atlas is
+ *  repacked.
+ *
+ *  \return 0 on success, or -1 if the entry is not valid.
+ */
+extern DECLSPEC int SDLCALL SDL_AtlasRemoveEntry(SDL_TextureAtlas * atlas,
+                                                 SDL_AtlasEntryID id);
+
+/**
+ *  \brief Get the texture and the area within it holding an atlas entry.
+ *
+ *  \param atlas    The texture atlas.
+ *  \param id       The entry to look up.
+ *  \param texture  A pointer filled in with the page texture, or NULL.
+ *  \param rect     A pointer filled in with the entry's area in the texture,
+ *                  or NULL.
+ *
+ *  \return 0 on success, or -1 if the entry is not valid, e.g. because it
+ *          was evicted.
+ *
+ *  \note The texture and area of an entry may change when the atlas is
+ *        repacked, which can happen in SDL_AtlasAddSurface().
+ */
+extern DECLSPEC int SDLCALL SDL_AtlasQueryEntry(SDL_TextureAtlas * atlas,
+                                                SDL_AtlasEntryID id,
+                                                SDL_Texture ** texture,
+                                                SDL_Rect * rect);
+
+/**
+ *  \brief Copy a portion of an atlas entry to the current rendering target.
+ *
+ *  \param atlas    The texture atlas.
+ *  \param id       The entry to draw.
+ *  \param srcrect  A pointer to the source rectangle relative to the entry,
+ *                  or NULL for the entire entry.
+ *  \param dstrect  A pointer to the destination rectangle, or NULL for the
+ *                  entire rendering target.
+ *
+ *  \return 0 on success, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyAtlasEntry(SDL_TextureAtlas * atlas,
+                                                     SDL_AtlasEntryID id,
+                                                     const SDL_Rect * srcrect,
+                                                     const SDL_Rect * dstrect);
+
+/**
+ *  \brief Repack all entries of a texture atlas, reclaiming space left by
+ *         removed entries and releasing pages that are no longer needed.
+ *
+ *  The pages are rebuilt in new textures, so while this runs the atlas needs
+ *  up to twice its usual texture memory.
+ *
+ *  \return 0 on success, or -1 on error, in which case the atlas is unchanged.
+ */
+extern DECLSPEC int SDLCALL SDL_AtlasRepack(SDL_TextureAtlas * atlas);
+
+/**
+ *  \brief Destroy a texture atlas and all of its pages.
+ *
+ *  \sa SDL_CreateTextureAtlas()
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
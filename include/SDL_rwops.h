@@ -45,6 +45,8 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3U  /* Android asset */
 #define SDL_RWOPS_MEMORY    4U  /* Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5U  /* Read-Only memory stream */
+#define SDL_RWOPS_MAPPED    6U  /* Read-Only memory mapped file */
+#define SDL_RWOPS_BUFFERED  7U  /* Buffer around another stream */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -165,6 +167,34 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
                                                       int size);
 
+/**
+ *  \brief Open a file for reading by mapping it into memory.
+ *
+ *  The returned stream is read-only and its contents can be accessed
+ *  directly with SDL_RWGetPointer().  On platforms without memory mapped
+ *  files, or when the file can't be mapped, this falls back to
+ *  SDL_RWFromFile(file, "rb").
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMappedFile(const char *file);
+
+/**
+ *  \brief Add a read-ahead and write-behind buffer to another stream.
+ *
+ *  Reads and writes of a few bytes at a time, like SDL_ReadLE32(), are
+ *  served from the buffer instead of going to \c src every time.
+ *
+ *  \param src The stream to buffer.
+ *  \param size The size of the buffer in bytes, or 0 for a default size.
+ *  \param autoclose If SDL_TRUE, \c src is closed when the buffered stream
+ *                   is, otherwise it's left positioned where the buffered
+ *                   stream was.
+ *
+ *  \return The buffered stream, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromBufferedRW(SDL_RWops * src,
+                                                        size_t size,
+                                                        SDL_bool autoclose);
+
 /* @} *//* RWFrom functions */
 
 
@@ -189,6 +219,20 @@ extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops * area);
 #define SDL_RWclose(ctx)        (ctx)->close(ctx)
 /* @} *//* Read/write macros */
 
+/**
+ *  \brief Get direct access to the unread data of a stream.
+ *
+ *  For memory streams and memory mapped files this returns a pointer to the
+ *  current read position and sets \c size to the number of bytes remaining,
+ *  so the data can be used without copying it.  The pointer remains valid
+ *  until the stream is closed.  The data must not be modified unless the
+ *  stream was created with SDL_RWFromMem().
+ *
+ *  \return A pointer to the data, or NULL if the stream isn't in memory.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetPointer(SDL_RWops * context,
+                                                     size_t * size);
+
 
 /**
  *  \name Read endian functions
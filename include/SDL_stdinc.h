@@ -337,6 +337,94 @@ extern DECLSPEC void *SDLCALL SDL_calloc(size_t nmemb, size_t size);
 extern DECLSPEC void *SDLCALL SDL_realloc(void *mem, size_t size);
 extern DECLSPEC void SDLCALL SDL_free(void *mem);
 
+typedef void *(SDLCALL *SDL_malloc_func)(size_t size);
+typedef void *(SDLCALL *SDL_calloc_func)(size_t nmemb, size_t size);
+typedef void *(SDLCALL *SDL_realloc_func)(void *mem, size_t size);
+typedef void (SDLCALL *SDL_free_func)(void *mem);
+
+/**
+ *  \brief Get the current set of SDL memory functions
+ */
+extern DECLSPEC void SDLCALL SDL_GetMemoryFunctions(SDL_malloc_func *malloc_func,
+                                                    SDL_calloc_func *calloc_func,
+                                                    SDL_realloc_func *realloc_func,
+                                                    SDL_free_func *free_func);
+
+/**
+ *  \brief Replace SDL's memory allocation functions with a custom set
+ *
+ *  \note If you are replacing SDL's memory functions, you should call
+ *        SDL_GetNumAllocations() and be very careful if it returns non-zero.
+ *        That means that your free function will be called with memory
+ *        allocated by the previous memory allocation functions.
+ *
+ *  \return 0 on success, or -1 if any of the functions is NULL.
+ */
+extern DECLSPEC int SDLCALL SDL_SetMemoryFunctions(SDL_malloc_func malloc_func,
+                                                   SDL_calloc_func calloc_func,
+                                                   SDL_realloc_func realloc_func,
+                                                   SDL_free_func free_func);
+
+/**
+ *  \brief Get the number of outstanding (unfreed) allocations made by SDL
+ */
+extern DECLSPEC int SDLCALL SDL_GetNumAllocations(void);
+
+/**
+ *  \brief The subsystems whose internal allocations can be routed to their
+ *         own memory functions.
+ */
+typedef enum
+{
+    SDL_MEMORY_TAG_GENERAL,     /**< Everything not covered by another tag */
+    SDL_MEMORY_TAG_AUDIO,       /**< Audio device and stream buffers */
+    SDL_MEMORY_TAG_VIDEO,       /**< Surface pixels and window framebuffers */
+    SDL_MEMORY_TAG_RENDER,      /**< Texture pixels and staging buffers */
+    SDL_MEMORY_TAG_EVENTS,      /**< Event queue entries */
+    SDL_MEMORY_TAG_JOYSTICK,    /**< Joystick state */
+    SDL_NUM_MEMORY_TAGS
+} SDL_MemoryTag;
+
+/**
+ *  \brief Get the memory functions used for a subsystem's allocations
+ *
+ *  Tags that haven't been given their own functions report the ones set
+ *  with SDL_SetMemoryFunctions().
+ */
+extern DECLSPEC void SDLCALL SDL_GetMemoryFunctionsForTag(SDL_MemoryTag tag,
+                                                          SDL_malloc_func *malloc_func,
+                                                          SDL_calloc_func *calloc_func,
+                                                          SDL_realloc_func *realloc_func,
+                                                          SDL_free_func *free_func);
+
+/**
+ *  \brief Route a subsystem's internal allocations to a custom set of
+ *         memory functions, such as a pool or arena allocator
+ *
+ *  Passing NULL for all of the functions makes the tag use the functions set
+ *  with SDL_SetMemoryFunctions() again.  SDL_MEMORY_TAG_GENERAL is the same
+ *  as SDL_SetMemoryFunctions() and can't be reset.
+ *
+ *  \note The functions should be set while SDL_GetNumAllocationsForTag()
+ *        returns 0 for the tag, otherwise they will be called with memory
+ *        allocated by the previous functions.
+ *
+ *  \return 0 on success, or -1 if the tag is invalid or only some of the
+ *          functions are NULL.
+ */
+extern DECLSPEC int SDLCALL SDL_SetMemoryFunctionsForTag(SDL_MemoryTag tag,
+                                                         SDL_malloc_func malloc_func,
+                                                         SDL_calloc_func calloc_func,
+                                                         SDL_realloc_func realloc_func,
+                                                         SDL_free_func free_func);
+
+/**
+ *  \brief Get the number of outstanding allocations made for a subsystem
+ *
+ *  SDL_GetNumAllocations() returns the total over all of the tags.
+ */
+extern DECLSPEC int SDLCALL SDL_GetNumAllocationsForTag(SDL_MemoryTag tag);
+
 extern DECLSPEC char *SDLCALL SDL_getenv(const char *name);
 extern DECLSPEC int SDLCALL SDL_setenv(const char *name, const char *value, int overwrite);
 
@@ -54,12 +54,18 @@ typedef unsigned int SDL_TLSID;
 /**
  *  The SDL thread priority.
  *
+ *  SDL_THREAD_PRIORITY_TIME_CRITICAL asks for real-time scheduling, for
+ *  threads like audio mixers that must not be preempted. On Linux, when
+ *  the process isn't allowed to do that itself, it is requested through
+ *  RealtimeKit if that is available.
+ *
  *  \note On many systems you require special privileges to set high priority.
  */
 typedef enum {
     SDL_THREAD_PRIORITY_LOW,
     SDL_THREAD_PRIORITY_NORMAL,
-    SDL_THREAD_PRIORITY_HIGH
+    SDL_THREAD_PRIORITY_HIGH,
+    SDL_THREAD_PRIORITY_TIME_CRITICAL
 } SDL_ThreadPriority;
 
 /**
@@ -169,6 +175,29 @@ extern DECLSPEC SDL_threadID SDLCALL SDL_GetThreadID(SDL_Thread * thread);
  */
 extern DECLSPEC int SDLCALL SDL_SetThreadPriority(SDL_ThreadPriority priority);
 
+/**
+ *  Restrict the current thread to run only on the given logical CPUs.
+ *
+ *  \param mask A bit mask of logical CPUs, bit 0 being the first CPU.
+ *              CPUs that don't exist are ignored.
+ *
+ *  \return 0 on success, or -1 if the mask contains no usable CPU or
+ *          CPU affinity isn't supported on this platform.
+ *
+ *  \sa SDL_GetThreadAffinityMask
+ */
+extern DECLSPEC int SDLCALL SDL_SetThreadAffinityMask(Uint64 mask);
+
+/**
+ *  Get the logical CPUs that the current thread may run on.
+ *
+ *  \return A bit mask of logical CPUs, bit 0 being the first CPU, or 0 if
+ *          CPU affinity isn't supported on this platform.
+ *
+ *  \sa SDL_SetThreadAffinityMask
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetThreadAffinityMask(void);
+
 /**
  *  Wait for a thread to finish. Threads that haven't been detached will
  *  remain (as a "zombie") until this function cleans them up. Not doing so
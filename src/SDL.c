@@ -38,6 +38,9 @@
 #if !SDL_TIMERS_DISABLED
 # include "timer/SDL_timer_c.h"
 #endif
+#ifdef __LINUX__
+# include "core/linux/SDL_dbus.h"
+#endif
 #if SDL_VIDEO_DRIVER_WINDOWS
 extern int SDL_HelperWindowCreate(void);
 extern int SDL_HelperWindowDestroy(void);
@@ -359,8 +362,14 @@ SDL_Quit(void)
 
     SDL_ClearHints();
     SDL_AssertionsQuit();
+    SDL_LogSetAsync(SDL_FALSE);
     SDL_LogResetPriorities();
 
+#if SDL_USE_LIBDBUS
+    /* Thread priorities may have opened the system bus without any video */
+    SDL_DBus_Quit();
+#endif
+
     /* Now that every subsystem has been quit, we reset the subsystem refcount
      * and the list of initialized subsystems.
      */
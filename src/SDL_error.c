@@ -36,8 +36,6 @@ static SDL_error SDL_global_error;
 extern SDL_error *SDL_GetErrBuf(void);
 #endif /* SDL_THREADS_DISABLED */
 
-#define SDL_ERRBUFIZE   1024
-
 /* Private functions */
 
 static const char *
@@ -61,6 +59,7 @@ SDL_SetError(SDL_PRINTF_FORMAT_STRING const char *fmt, ...)
     /* Copy in the key, mark error as valid */
     error = SDL_GetErrBuf();
     error->error = 1;
+    error->formatted = 0;
     SDL_strlcpy((char *) error->key, fmt, sizeof(error->key));
 
     va_start(ap, fmt);
@@ -110,21 +109,33 @@ SDL_SetError(SDL_PRINTF_FORMAT_STRING const char *fmt, ...)
     }
     va_end(ap);
 
-    /* If we are in debug mode, print out an error message */
-    SDL_LogDebug(SDL_LOG_CATEGORY_ERROR, "%s", SDL_GetError());
+    /* If we are in debug mode, print out an error message.
+       Otherwise the message isn't formatted until someone asks for it.
+     */
+    if (SDL_LogGetPriority(SDL_LOG_CATEGORY_ERROR) <= SDL_LOG_PRIORITY_DEBUG) {
+        SDL_LogDebug(SDL_LOG_CATEGORY_ERROR, "%s", SDL_GetError());
+    }
 
     return -1;
 }
 
-static char *SDL_GetErrorMsg(char *errstr, int maxlen);
+static char *SDL_GetErrorMsg(SDL_error *error, char *errstr, int maxlen);
 
 /* Available for backwards compatibility */
 const char *
 SDL_GetError(void)
 {
-    static char errmsg[SDL_ERRBUFIZE];
+    SDL_error *error;
 
-    return SDL_GetErrorMsg(errmsg, SDL_ERRBUFIZE);
+    error = SDL_GetErrBuf();
+    if (!error->error) {
+        return "";
+    }
+    if (!error->formatted) {
+        SDL_GetErrorMsg(error, error->str, sizeof(error->str));
+        error->formatted = 1;
+    }
+    return error->str;
 }
 
 void
@@ -186,16 +197,13 @@ main(int argc, char *argv[])
    so that it supports internationalization and thread-safe errors.
 */
 static char *
-SDL_GetErrorMsg(char *errstr, int maxlen)
+SDL_GetErrorMsg(SDL_error *error, char *errstr, int maxlen)
 {
-    SDL_error *error;
-
     /* Clear the error string */
     *errstr = '\0';
     --maxlen;
 
-    /* Get the thread-safe error, and print it out */
-    error = SDL_GetErrBuf();
+    /* Print out the thread-safe error */
     if (error->error) {
         const char *fmt;
         char *msg = errstr;
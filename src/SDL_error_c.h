@@ -29,6 +29,7 @@
 
 #define ERR_MAX_STRLEN  128
 #define ERR_MAX_ARGS    5
+#define SDL_ERRBUFIZE   1024
 
 typedef struct SDL_error
 {
@@ -54,6 +55,12 @@ typedef struct SDL_error
         double value_f;
         char buf[ERR_MAX_STRLEN];
     } args[ERR_MAX_ARGS];
+
+    /* The message is only formatted from the key and arguments when
+       SDL_GetError() asks for it, and is kept here until the next error.
+     */
+    int formatted;
+    char str[SDL_ERRBUFIZE];
 } SDL_error;
 
 /* Defined in SDL_thread.c */
@@ -22,11 +22,24 @@
 
 #include "SDL_hints.h"
 #include "SDL_error.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
 
 
-/* Assuming there aren't many hints set and they aren't being queried in
-   critical performance paths, we'll just use linked lists here.
+/* Hints live in a small hash table.  The environment is checked once, the
+   first time a hint is set or watched.  Hint handles and SDL_GetHint() read
+   the current value without locking, so when a hint changes its old value
+   is kept until the next change, for readers that picked it up just before.
+   Older values are freed.
+
+   Changes and callbacks are serialized by a recursive mutex, so callbacks
+   can set hints themselves.  Lookups only take a reader-writer lock, which
+   is held for writing just while hints are added to or removed from the
+   table.  The locks are created on first use and kept for the life of the
+   program, as other threads may still be waiting on them.
  */
+#define SDL_HINT_BUCKETS    64
+
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
     void *userdata;
@@ -35,62 +48,219 @@ typedef struct SDL_HintWatch {
 
 typedef struct SDL_Hint {
     char *name;
-    char *value;
+    Uint32 hash;
+    const char *value;
     SDL_HintPriority priority;
+    char *env;
+    void *current;          /* What SDL_GetHint() returns, updated atomically */
+    SDL_bool handled;       /* A handle was given out, never free this hint */
+    char *previous;         /* The value before the last change */
     SDL_HintWatch *callbacks;
     struct SDL_Hint *next;
 } SDL_Hint;
 
-static SDL_Hint *SDL_hints;
+static SDL_Hint *SDL_hints[SDL_HINT_BUCKETS];
+static SDL_mutex *SDL_hints_lock;
+static SDL_RWLock *SDL_hints_table_lock;
+static SDL_SpinLock SDL_hints_spinlock;
+
+static void
+SDL_CreateHintLocks(void)
+{
+    if (!SDL_AtomicGetPtr((void **)&SDL_hints_table_lock)) {
+        SDL_AtomicLock(&SDL_hints_spinlock);
+        if (!SDL_hints_lock) {
+            SDL_hints_lock = SDL_CreateMutex();
+        }
+        if (!SDL_hints_table_lock) {
+            SDL_AtomicSetPtr((void **)&SDL_hints_table_lock, SDL_CreateRWLock());
+        }
+        SDL_AtomicUnlock(&SDL_hints_spinlock);
+    }
+}
+
+static void
+SDL_LockHintTable(SDL_bool write)
+{
+    SDL_CreateHintLocks();
+    if (SDL_hints_table_lock) {
+        if (write) {
+            SDL_LockRWLockForWriting(SDL_hints_table_lock);
+        } else {
+            SDL_LockRWLockForReading(SDL_hints_table_lock);
+        }
+    }
+}
+
+static void
+SDL_UnlockHintTable(void)
+{
+    if (SDL_hints_table_lock) {
+        SDL_UnlockRWLock(SDL_hints_table_lock);
+    }
+}
+
+static void
+SDL_LockHints(void)
+{
+    SDL_CreateHintLocks();
+    if (SDL_hints_lock) {
+        SDL_LockMutex(SDL_hints_lock);
+    }
+}
+
+static void
+SDL_UnlockHints(void)
+{
+    if (SDL_hints_lock) {
+        SDL_UnlockMutex(SDL_hints_lock);
+    }
+}
+
+static Uint32
+SDL_HashHintName(const char *name)
+{
+    Uint32 hash = 5381;
+
+    while (*name) {
+        hash = (hash * 33) ^ (Uint8)*name++;
+    }
+    return hash;
+}
+
+static void
+SDL_SnapshotHintEnv(SDL_Hint *hint)
+{
+    const char *env = SDL_getenv(hint->name);
+
+    hint->env = env ? SDL_strdup(env) : NULL;
+}
+
+static void
+SDL_UpdateHintCurrent(SDL_Hint *hint)
+{
+    const char *current;
+
+    if (!hint->env || hint->priority == SDL_HINT_OVERRIDE) {
+        current = hint->value;
+    } else {
+        current = hint->env;
+    }
+    SDL_AtomicSetPtr(&hint->current, (void *)current);
+}
+
+/* Must be called with the table locked */
+static SDL_Hint *
+SDL_LookupHint(const char *name, Uint32 hash)
+{
+    SDL_Hint *hint;
+
+    for (hint = SDL_hints[hash % SDL_HINT_BUCKETS]; hint; hint = hint->next) {
+        if (hint->hash == hash && SDL_strcmp(name, hint->name) == 0) {
+            return hint;
+        }
+    }
+    return NULL;
+}
+
+static SDL_Hint *
+SDL_FindHint(const char *name, SDL_bool create)
+{
+    const Uint32 hash = SDL_HashHintName(name);
+    SDL_Hint *hint, *existing;
+
+    SDL_LockHintTable(SDL_FALSE);
+    hint = SDL_LookupHint(name, hash);
+    SDL_UnlockHintTable();
+    if (hint || !create) {
+        return hint;
+    }
+
+    hint = (SDL_Hint *)SDL_calloc(1, sizeof(*hint));
+    if (!hint) {
+        return NULL;
+    }
+    hint->name = SDL_strdup(name);
+    if (!hint->name) {
+        SDL_free(hint);
+        return NULL;
+    }
+    hint->hash = hash;
+    hint->priority = SDL_HINT_DEFAULT;
+    SDL_SnapshotHintEnv(hint);
+    SDL_UpdateHintCurrent(hint);
+
+    SDL_LockHintTable(SDL_TRUE);
+    existing = SDL_LookupHint(name, hash);
+    if (!existing) {
+        hint->next = SDL_hints[hash % SDL_HINT_BUCKETS];
+        SDL_hints[hash % SDL_HINT_BUCKETS] = hint;
+    }
+    SDL_UnlockHintTable();
+
+    if (existing) {
+        /* Another thread added it first */
+        SDL_free(hint->env);
+        SDL_free(hint->name);
+        SDL_free(hint);
+        hint = existing;
+    }
+    return hint;
+}
+
+/* Keeps the value a hint had before a change alive until the next one */
+static void
+SDL_RetireHintValue(SDL_Hint *hint, char *value)
+{
+    SDL_free(hint->previous);
+    hint->previous = value;
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
                         SDL_HintPriority priority)
 {
-    const char *env;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    char *copy;
 
     if (!name || !value) {
         return SDL_FALSE;
     }
 
-    env = SDL_getenv(name);
-    if (env && priority < SDL_HINT_OVERRIDE) {
+    SDL_LockHints();
+    hint = SDL_FindHint(name, SDL_TRUE);
+    if (!hint ||
+        (hint->env && priority < SDL_HINT_OVERRIDE) ||
+        priority < hint->priority) {
+        SDL_UnlockHints();
         return SDL_FALSE;
     }
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (priority < hint->priority) {
-                return SDL_FALSE;
-            }
-            if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
-                hint->value = value ? SDL_strdup(value) : NULL;
-            }
-            hint->priority = priority;
-            return SDL_TRUE;
+    if (!hint->value || SDL_strcmp(hint->value, value) != 0) {
+        /* A hint going back and forth between two values reuses them */
+        if (hint->previous && SDL_strcmp(hint->previous, value) == 0) {
+            copy = hint->previous;
+            hint->previous = NULL;
+        } else {
+            copy = SDL_strdup(value);
         }
+        if (!copy) {
+            SDL_UnlockHints();
+            return SDL_FALSE;
+        }
+        for (entry = hint->callbacks; entry; ) {
+            /* Save the next entry in case this one is deleted */
+            SDL_HintWatch *next = entry->next;
+            entry->callback(entry->userdata, name, hint->value, copy);
+            entry = next;
+        }
+        SDL_RetireHintValue(hint, (char *)hint->value);
+        hint->value = copy;
     }
-
-    /* Couldn't find the hint, add a new one */
-    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-    if (!hint) {
-        return SDL_FALSE;
-    }
-    hint->name = SDL_strdup(name);
-    hint->value = value ? SDL_strdup(value) : NULL;
     hint->priority = priority;
-    hint->callbacks = NULL;
-    hint->next = SDL_hints;
-    SDL_hints = hint;
+    SDL_UpdateHintCurrent(hint);
+    SDL_UnlockHints();
     return SDL_TRUE;
 }
 
@@ -103,19 +273,21 @@ SDL_SetHint(const char *name, const char *value)
 const char *
 SDL_GetHint(const char *name)
 {
-    const char *env;
     SDL_Hint *hint;
+    const char *value;
 
-    env = SDL_getenv(name);
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
-            }
-            break;
-        }
+    if (!name) {
+        return NULL;
     }
-    return env;
+
+    /* Hints that were never set or watched are only in the environment */
+    hint = SDL_FindHint(name, SDL_FALSE);
+    if (hint) {
+        value = (const char *)SDL_AtomicGetPtr(&hint->current);
+    } else {
+        value = SDL_getenv(name);
+    }
+    return value;
 }
 
 SDL_bool
@@ -131,6 +303,36 @@ SDL_GetHintBoolean(const char *name, SDL_bool default_value)
     return SDL_TRUE;
 }
 
+SDL_HintHandle *
+SDL_GetHintHandle(const char *name)
+{
+    SDL_Hint *hint;
+
+    if (!name || !*name) {
+        SDL_InvalidParamError("name");
+        return NULL;
+    }
+
+    SDL_LockHints();
+    hint = SDL_FindHint(name, SDL_TRUE);
+    if (hint) {
+        hint->handled = SDL_TRUE;
+    } else {
+        SDL_OutOfMemory();
+    }
+    SDL_UnlockHints();
+    return (SDL_HintHandle *)hint;
+}
+
+const char *
+SDL_GetHintFromHandle(SDL_HintHandle *handle)
+{
+    if (!handle) {
+        return NULL;
+    }
+    return (const char *)SDL_AtomicGetPtr(&((SDL_Hint *)handle)->current);
+}
+
 void
 SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
 {
@@ -147,35 +349,24 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
         return;
     }
 
+    SDL_LockHints();
     SDL_DelHintCallback(name, callback, userdata);
 
     entry = (SDL_HintWatch *)SDL_malloc(sizeof(*entry));
     if (!entry) {
+        SDL_UnlockHints();
         SDL_OutOfMemory();
         return;
     }
     entry->callback = callback;
     entry->userdata = userdata;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            break;
-        }
-    }
+    hint = SDL_FindHint(name, SDL_TRUE);
     if (!hint) {
-        /* Need to add a hint entry for this watcher */
-        hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-        if (!hint) {
-            SDL_OutOfMemory();
-            SDL_free(entry);
-            return;
-        }
-        hint->name = SDL_strdup(name);
-        hint->value = NULL;
-        hint->priority = SDL_HINT_DEFAULT;
-        hint->callbacks = NULL;
-        hint->next = SDL_hints;
-        SDL_hints = hint;
+        SDL_UnlockHints();
+        SDL_OutOfMemory();
+        SDL_free(entry);
+        return;
     }
 
     /* Add it to the callbacks for this hint */
@@ -183,8 +374,9 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     hint->callbacks = entry;
 
     /* Now call it with the current value */
-    value = SDL_GetHint(name);
+    value = (const char *)hint->current;
     callback(userdata, name, value, value);
+    SDL_UnlockHints();
 }
 
 void
@@ -193,44 +385,80 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     SDL_Hint *hint;
     SDL_HintWatch *entry, *prev;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            prev = NULL;
-            for (entry = hint->callbacks; entry; entry = entry->next) {
-                if (callback == entry->callback && userdata == entry->userdata) {
-                    if (prev) {
-                        prev->next = entry->next;
-                    } else {
-                        hint->callbacks = entry->next;
-                    }
-                    SDL_free(entry);
-                    break;
+    if (!name) {
+        return;
+    }
+
+    SDL_LockHints();
+    hint = SDL_FindHint(name, SDL_FALSE);
+    if (hint) {
+        prev = NULL;
+        for (entry = hint->callbacks; entry; entry = entry->next) {
+            if (callback == entry->callback && userdata == entry->userdata) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    hint->callbacks = entry->next;
                 }
-                prev = entry;
+                SDL_free(entry);
+                break;
             }
-            return;
+            prev = entry;
         }
     }
+    SDL_UnlockHints();
 }
 
 void SDL_ClearHints(void)
 {
-    SDL_Hint *hint;
+    SDL_Hint *hint, **link;
     SDL_HintWatch *entry;
+    int i;
 
-    while (SDL_hints) {
-        hint = SDL_hints;
-        SDL_hints = hint->next;
+    SDL_LockHints();
+    SDL_LockHintTable(SDL_TRUE);
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        link = &SDL_hints[i];
+        while (*link) {
+            hint = *link;
 
-        SDL_free(hint->name);
-        SDL_free(hint->value);
-        for (entry = hint->callbacks; entry; ) {
-            SDL_HintWatch *freeable = entry;
-            entry = entry->next;
-            SDL_free(freeable);
+            for (entry = hint->callbacks; entry; ) {
+                SDL_HintWatch *freeable = entry;
+                entry = entry->next;
+                SDL_free(freeable);
+            }
+            hint->callbacks = NULL;
+
+            if (hint->handled) {
+                /* Handles stay valid, so just reset the hint.  The current
+                   value is kept in case someone is still looking at it.
+                 */
+                if (hint->current == hint->env) {
+                    SDL_free((char *)hint->value);
+                    SDL_RetireHintValue(hint, hint->env);
+                } else {
+                    SDL_free(hint->env);
+                    SDL_RetireHintValue(hint, (char *)hint->value);
+                }
+                hint->value = NULL;
+                hint->priority = SDL_HINT_DEFAULT;
+                SDL_SnapshotHintEnv(hint);
+                SDL_UpdateHintCurrent(hint);
+                link = &hint->next;
+                continue;
+            }
+
+            *link = hint->next;
+            SDL_free((char *)hint->value);
+            SDL_free(hint->previous);
+            SDL_free(hint->env);
+            SDL_free(hint->name);
+            SDL_free(hint);
         }
-        SDL_free(hint);
     }
+
+    SDL_UnlockHintTable();
+    SDL_UnlockHints();
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
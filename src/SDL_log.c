@@ -28,6 +28,11 @@
 
 #include "SDL_error.h"
 #include "SDL_log.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+#include "thread/SDL_systhread.h"
 
 #if HAVE_STDIO_H
 #include <stdio.h>
@@ -42,6 +47,16 @@
 #define DEFAULT_APPLICATION_PRIORITY    SDL_LOG_PRIORITY_INFO
 #define DEFAULT_TEST_PRIORITY           SDL_LOG_PRIORITY_VERBOSE
 
+/* Categories below this have their priority looked up in an array,
+   the rest fall back to the SDL_loglevels list. */
+#define SDL_LOG_FAST_CATEGORIES         64
+
+/* Size of the per-thread message ring used in async mode */
+#define SDL_LOG_QUEUE_SIZE              (64 * 1024)
+
+/* How often the async log thread drains the message rings, in ms */
+#define SDL_LOG_ASYNC_INTERVAL          10
+
 typedef struct SDL_LogLevel
 {
     int category;
@@ -49,12 +64,37 @@ typedef struct SDL_LogLevel
     struct SDL_LogLevel *next;
 } SDL_LogLevel;
 
+/* The header written ahead of each message in an async log queue */
+typedef struct SDL_LogRecord
+{
+    int category;
+    SDL_LogPriority priority;
+    size_t length;
+} SDL_LogRecord;
+
+/* The messages logged by one thread while in async mode */
+typedef struct SDL_LogQueue
+{
+    SDL_RingBuffer *ring;
+    SDL_atomic_t orphaned;  /* set when the owning thread exits */
+    struct SDL_LogQueue *next;
+} SDL_LogQueue;
+
+/* What a thread's TLS slot points to.  It outlives the queue, which is freed
+   when async mode is turned off, so the thread can tell its queue is gone. */
+typedef struct SDL_LogQueueRef
+{
+    SDL_LogQueue *queue;
+    int generation;
+} SDL_LogQueueRef;
+
 /* The default log output function */
 static void SDL_LogOutput(void *userdata,
                           int category, SDL_LogPriority priority,
                           const char *message);
 
 static SDL_LogLevel *SDL_loglevels;
+static SDL_LogPriority SDL_fast_loglevels[SDL_LOG_FAST_CATEGORIES];  /* 0 if not set */
 static SDL_LogPriority SDL_default_priority = DEFAULT_PRIORITY;
 static SDL_LogPriority SDL_assert_priority = DEFAULT_ASSERT_PRIORITY;
 static SDL_LogPriority SDL_application_priority = DEFAULT_APPLICATION_PRIORITY;
@@ -62,6 +102,17 @@ static SDL_LogPriority SDL_test_priority = DEFAULT_TEST_PRIORITY;
 static SDL_LogOutputFunction SDL_log_function = SDL_LogOutput;
 static void *SDL_log_userdata = NULL;
 
+static SDL_atomic_t SDL_log_async;
+static SDL_atomic_t SDL_log_dropped;
+static SDL_atomic_t SDL_log_writers;        /* threads inside SDL_LogEnqueue() */
+static SDL_atomic_t SDL_log_generation;     /* bumped when the queues are freed */
+static SDL_mutex *SDL_log_queue_lock;
+static SDL_sem *SDL_log_async_wakeup;
+static SDL_Thread *SDL_log_async_thread;
+static SDL_TLSID SDL_log_queue_tls;
+static SDL_LogQueue *SDL_log_queues;
+static char SDL_log_drain_buffer[SDL_MAX_LOG_MESSAGE];
+
 static const char *SDL_priority_prefixes[SDL_NUM_LOG_PRIORITIES] = {
     NULL,
     "VERBOSE",
@@ -100,9 +151,16 @@ SDL_LogSetAllPriority(SDL_LogPriority priority)
 {
     SDL_LogLevel *entry;
 
+    int i;
+
     for (entry = SDL_loglevels; entry; entry = entry->next) {
         entry->priority = priority;
     }
+    for (i = 0; i < SDL_LOG_FAST_CATEGORIES; ++i) {
+        if (SDL_fast_loglevels[i]) {
+            SDL_fast_loglevels[i] = priority;
+        }
+    }
     SDL_default_priority = priority;
     SDL_assert_priority = priority;
     SDL_application_priority = priority;
@@ -113,6 +171,11 @@ SDL_LogSetPriority(int category, SDL_LogPriority priority)
 {
     SDL_LogLevel *entry;
 
+    if (category >= 0 && category < SDL_LOG_FAST_CATEGORIES) {
+        SDL_fast_loglevels[category] = priority;
+        return;
+    }
+
     for (entry = SDL_loglevels; entry; entry = entry->next) {
         if (entry->category == category) {
             entry->priority = priority;
@@ -135,9 +198,15 @@ SDL_LogGetPriority(int category)
 {
     SDL_LogLevel *entry;
 
-    for (entry = SDL_loglevels; entry; entry = entry->next) {
-        if (entry->category == category) {
-            return entry->priority;
+    if (category >= 0 && category < SDL_LOG_FAST_CATEGORIES) {
+        if (SDL_fast_loglevels[category]) {
+            return SDL_fast_loglevels[category];
+        }
+    } else {
+        for (entry = SDL_loglevels; entry; entry = entry->next) {
+            if (entry->category == category) {
+                return entry->priority;
+            }
         }
     }
 
@@ -162,6 +231,7 @@ SDL_LogResetPriorities(void)
         SDL_loglevels = entry->next;
         SDL_free(entry);
     }
+    SDL_zero(SDL_fast_loglevels);
 
     SDL_default_priority = DEFAULT_PRIORITY;
     SDL_assert_priority = DEFAULT_ASSERT_PRIORITY;
@@ -263,9 +333,185 @@ GetCategoryPrefix(int category)
 }
 #endif /* __ANDROID__ */
 
+/* Called from SDL_TLSCleanup() when a thread that logged asynchronously exits */
+static void
+SDL_LogReleaseQueue(void *data)
+{
+    SDL_LogQueueRef *ref = (SDL_LogQueueRef *)data;
+
+    /* The queue may still hold messages, the drain frees it afterwards */
+    SDL_LockMutex(SDL_log_queue_lock);
+    if (ref->queue && ref->generation == SDL_AtomicGet(&SDL_log_generation)) {
+        SDL_AtomicSet(&ref->queue->orphaned, 1);
+    }
+    SDL_UnlockMutex(SDL_log_queue_lock);
+    SDL_free(ref);
+}
+
+static SDL_LogQueue *
+SDL_LogGetQueue(void)
+{
+    SDL_LogQueueRef *ref;
+    SDL_LogQueue *queue;
+
+    ref = (SDL_LogQueueRef *)SDL_TLSGet(SDL_log_queue_tls);
+    if (ref && ref->queue && ref->generation == SDL_AtomicGet(&SDL_log_generation)) {
+        return ref->queue;
+    }
+    if (!ref) {
+        ref = (SDL_LogQueueRef *)SDL_calloc(1, sizeof(*ref));
+        if (!ref) {
+            return NULL;
+        }
+        if (SDL_TLSSet(SDL_log_queue_tls, ref, SDL_LogReleaseQueue) < 0) {
+            SDL_free(ref);
+            return NULL;
+        }
+    }
+
+    queue = (SDL_LogQueue *)SDL_calloc(1, sizeof(*queue));
+    if (!queue) {
+        return NULL;
+    }
+    queue->ring = SDL_CreateRingBuffer(SDL_LOG_QUEUE_SIZE);
+    if (!queue->ring) {
+        SDL_free(queue);
+        return NULL;
+    }
+
+    SDL_LockMutex(SDL_log_queue_lock);
+    queue->next = SDL_log_queues;
+    SDL_log_queues = queue;
+    ref->queue = queue;
+    ref->generation = SDL_AtomicGet(&SDL_log_generation);
+    SDL_UnlockMutex(SDL_log_queue_lock);
+
+    return queue;
+}
+
+/* Add a formatted message to this thread's queue, the record header is
+   filled in at the start of buffer and the message text follows it.
+   Returns SDL_FALSE if the message should be output synchronously. */
+static SDL_bool
+SDL_LogEnqueue(char *buffer, int category, SDL_LogPriority priority, size_t len)
+{
+    SDL_LogQueue *queue;
+    SDL_LogRecord record;
+    size_t size = sizeof(record) + len;
+
+    /* SDL_LogFreeQueues() waits for the writers to leave before freeing */
+    SDL_AtomicIncRef(&SDL_log_writers);
+    if (!SDL_AtomicGet(&SDL_log_async)) {
+        SDL_AtomicAdd(&SDL_log_writers, -1);
+        return SDL_FALSE;
+    }
+
+    queue = SDL_LogGetQueue();
+    if (!queue) {
+        SDL_AtomicAdd(&SDL_log_writers, -1);
+        return SDL_FALSE;
+    }
+
+    /* Only this thread writes to the ring, so the free space can't shrink
+       between the check and the write, and the whole record goes in at once.
+       Drop the message rather than block if the log thread is behind. */
+    if (SDL_GetRingBufferCapacity(queue->ring) - SDL_GetRingBufferAvailable(queue->ring) < size) {
+        SDL_AtomicIncRef(&SDL_log_dropped);
+    } else {
+        record.category = category;
+        record.priority = priority;
+        record.length = len;
+        SDL_memcpy(buffer, &record, sizeof(record));
+        SDL_WriteRingBuffer(queue->ring, buffer, size);
+    }
+    SDL_AtomicAdd(&SDL_log_writers, -1);
+    return SDL_TRUE;
+}
+
+/* Output everything in the async log queues, called with SDL_log_queue_lock held */
+static void
+SDL_LogDrainQueues(void)
+{
+    SDL_LogQueue *queue, **prev;
+    SDL_LogRecord record;
+    int dropped;
+
+    for (queue = SDL_log_queues; queue; queue = queue->next) {
+        /* Check first, so anything logged before the thread exited is output */
+        const SDL_bool orphaned = SDL_AtomicGet(&queue->orphaned) ? SDL_TRUE : SDL_FALSE;
+
+        while (SDL_ReadRingBuffer(queue->ring, &record, sizeof(record)) == sizeof(record)) {
+            SDL_ReadRingBuffer(queue->ring, SDL_log_drain_buffer, record.length);
+            SDL_log_drain_buffer[record.length] = '\0';
+            if (SDL_log_function) {
+                SDL_log_function(SDL_log_userdata, record.category, record.priority, SDL_log_drain_buffer);
+            }
+        }
+        if (orphaned) {
+            SDL_AtomicSet(&queue->orphaned, 2);
+        }
+    }
+
+    /* Free queues separately, the output function may have added new ones */
+    prev = &SDL_log_queues;
+    while ((queue = *prev) != NULL) {
+        if (SDL_AtomicGet(&queue->orphaned) == 2) {
+            *prev = queue->next;
+            SDL_DestroyRingBuffer(queue->ring);
+            SDL_free(queue);
+        } else {
+            prev = &queue->next;
+        }
+    }
+
+    dropped = SDL_AtomicSet(&SDL_log_dropped, 0);
+    if (dropped > 0 && SDL_log_function) {
+        SDL_snprintf(SDL_log_drain_buffer, sizeof(SDL_log_drain_buffer),
+                     "%d log messages were dropped", dropped);
+        SDL_log_function(SDL_log_userdata, SDL_LOG_CATEGORY_SYSTEM, SDL_LOG_PRIORITY_WARN, SDL_log_drain_buffer);
+    }
+}
+
+/* Output and free every queue, including those of threads that are still
+   running.  Async mode must already be off, so no new messages come in. */
+static void
+SDL_LogFreeQueues(void)
+{
+    SDL_LogQueue *queue;
+
+    /* Wait for threads that saw async mode still on to finish writing */
+    while (SDL_AtomicGet(&SDL_log_writers) > 0) {
+        SDL_Delay(0);
+    }
+
+    SDL_LockMutex(SDL_log_queue_lock);
+    SDL_LogDrainQueues();
+    while ((queue = SDL_log_queues) != NULL) {
+        SDL_log_queues = queue->next;
+        SDL_DestroyRingBuffer(queue->ring);
+        SDL_free(queue);
+    }
+    /* Threads holding one of the freed queues will allocate a new one */
+    SDL_AtomicIncRef(&SDL_log_generation);
+    SDL_UnlockMutex(SDL_log_queue_lock);
+}
+
+static int SDLCALL
+SDL_LogAsyncThread(void *data)
+{
+    while (SDL_AtomicGet(&SDL_log_async)) {
+        SDL_SemWaitTimeout(SDL_log_async_wakeup, SDL_LOG_ASYNC_INTERVAL);
+        SDL_LockMutex(SDL_log_queue_lock);
+        SDL_LogDrainQueues();
+        SDL_UnlockMutex(SDL_log_queue_lock);
+    }
+    return 0;
+}
+
 void
 SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list ap)
 {
+    char *buffer;
     char *message;
     size_t len;
 
@@ -284,10 +530,12 @@ SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list
         return;
     }
 
-    message = SDL_stack_alloc(char, SDL_MAX_LOG_MESSAGE);
-    if (!message) {
+    /* Leave room in front of the message for an async log record header */
+    buffer = SDL_stack_alloc(char, sizeof(SDL_LogRecord) + SDL_MAX_LOG_MESSAGE);
+    if (!buffer) {
         return;
     }
+    message = buffer + sizeof(SDL_LogRecord);
 
     SDL_vsnprintf(message, SDL_MAX_LOG_MESSAGE, fmt, ap);
 
@@ -300,8 +548,11 @@ SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list
         }
     }
 
-    SDL_log_function(SDL_log_userdata, category, priority, message);
-    SDL_stack_free(message);
+    if (!SDL_AtomicGet(&SDL_log_async) ||
+        !SDL_LogEnqueue(buffer, category, priority, len)) {
+        SDL_log_function(SDL_log_userdata, category, priority, message);
+    }
+    SDL_stack_free(buffer);
 }
 
 #if defined(__WIN32__) && !defined(HAVE_STDIO_H) && !defined(__WINRT__)
@@ -438,4 +689,69 @@ SDL_LogSetOutputFunction(SDL_LogOutputFunction callback, void *userdata)
     SDL_log_userdata = userdata;
 }
 
+int
+SDL_LogSetAsync(SDL_bool async)
+{
+    if (!async) {
+        if (SDL_AtomicCAS(&SDL_log_async, 1, 0)) {
+            if (SDL_log_async_thread) {
+                SDL_SemPost(SDL_log_async_wakeup);
+                SDL_WaitThread(SDL_log_async_thread, NULL);
+                SDL_log_async_thread = NULL;
+            }
+        }
+        if (SDL_log_queue_lock) {
+            SDL_LogFreeQueues();
+        }
+        return 0;
+    }
+
+    if (SDL_AtomicGet(&SDL_log_async)) {
+        return 0;
+    }
+
+    /* These stay around, threads that logged asynchronously use the lock
+       when they exit, even after async mode is turned off. */
+    if (!SDL_log_queue_lock) {
+        SDL_log_queue_lock = SDL_CreateMutex();
+        if (!SDL_log_queue_lock) {
+            return -1;
+        }
+    }
+    if (!SDL_log_async_wakeup) {
+        SDL_log_async_wakeup = SDL_CreateSemaphore(0);
+        if (!SDL_log_async_wakeup) {
+            return -1;
+        }
+    }
+    if (!SDL_log_queue_tls) {
+        SDL_log_queue_tls = SDL_TLSCreate();
+        if (!SDL_log_queue_tls) {
+            return -1;
+        }
+    }
+
+    SDL_AtomicSet(&SDL_log_async, 1);
+
+    SDL_log_async_thread = SDL_CreateThreadInternal(SDL_LogAsyncThread, "SDLLog", 64 * 1024, NULL);
+    if (!SDL_log_async_thread) {
+        /* Output anything queued in the meantime and log directly again */
+        SDL_AtomicSet(&SDL_log_async, 0);
+        SDL_LogFreeQueues();
+        return -1;
+    }
+    return 0;
+}
+
+void
+SDL_LogFlush(void)
+{
+    if (!SDL_log_queue_lock) {
+        return;
+    }
+    SDL_LockMutex(SDL_log_queue_lock);
+    SDL_LogDrainQueues();
+    SDL_UnlockMutex(SDL_log_queue_lock);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
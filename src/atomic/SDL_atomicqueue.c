@@ -0,0 +1,369 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_atomic.h"
+#include "SDL_error.h"
+
+/* Lock-free bounded queues.
+
+   SDL_RingBuffer is a byte ring with one producer and one consumer.  Each
+   side owns one position, and publishes it with a release store after
+   touching the data, so the other side's acquire load sees the data too.
+
+   SDL_AtomicQueue is Dmitry Vyukov's bounded MPMC queue: every cell has a
+   sequence number that says whose turn it is, and producers and consumers
+   claim positions with a compare-and-swap.
+ */
+
+/* Keep positions written by different threads on separate cache lines */
+#define SDL_QUEUE_CACHELINE     64
+#define SDL_QUEUE_PAD(name)     char name[SDL_QUEUE_CACHELINE - sizeof(SDL_atomic_t)]
+
+/* Positions wrap around, so capacities are kept well below 2^32 */
+#define SDL_QUEUE_MAX_CAPACITY  0x40000000u
+
+/* Room for the sequence number at the start of each SDL_AtomicQueue cell */
+#define SDL_QUEUE_CELL_HEADER   8
+
+#if HAVE_GCC_ATOMICS && defined(__ATOMIC_ACQUIRE)
+#define LoadRelaxed(a)      ((Uint32)__atomic_load_n(&(a)->value, __ATOMIC_RELAXED))
+#define LoadAcquire(a)      ((Uint32)__atomic_load_n(&(a)->value, __ATOMIC_ACQUIRE))
+#define StoreRelease(a, v)  __atomic_store_n(&(a)->value, (int)(v), __ATOMIC_RELEASE)
+#else
+static SDL_INLINE Uint32
+LoadRelaxed(SDL_atomic_t *a)
+{
+    return (Uint32)*(volatile int *)&a->value;
+}
+
+static SDL_INLINE Uint32
+LoadAcquire(SDL_atomic_t *a)
+{
+    const Uint32 value = (Uint32)*(volatile int *)&a->value;
+    SDL_MemoryBarrierAcquire();
+    return value;
+}
+
+static SDL_INLINE void
+StoreRelease(SDL_atomic_t *a, Uint32 value)
+{
+    SDL_MemoryBarrierRelease();
+    *(volatile int *)&a->value = (int)value;
+}
+#endif
+
+static Uint32
+RoundUpCapacity(size_t capacity)
+{
+    Uint32 rounded = 2;
+
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+struct SDL_RingBuffer
+{
+    Uint8 *data;
+    Uint32 capacity;
+    Uint32 mask;
+
+    SDL_QUEUE_PAD(pad0);
+    SDL_atomic_t head;      /* Written by the producer */
+    Uint32 cached_tail;     /* The producer's last look at the tail */
+    SDL_QUEUE_PAD(pad1);
+    SDL_atomic_t tail;      /* Written by the consumer */
+    Uint32 cached_head;     /* The consumer's last look at the head */
+    SDL_QUEUE_PAD(pad2);
+};
+
+SDL_RingBuffer *
+SDL_CreateRingBuffer(size_t capacity)
+{
+    SDL_RingBuffer *ring;
+
+    if (capacity == 0 || capacity > SDL_QUEUE_MAX_CAPACITY) {
+        SDL_InvalidParamError("capacity");
+        return NULL;
+    }
+
+    ring = (SDL_RingBuffer *) SDL_calloc(1, sizeof(*ring));
+    if (!ring) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    ring->capacity = RoundUpCapacity(capacity);
+    ring->mask = ring->capacity - 1;
+    ring->data = (Uint8 *) SDL_malloc(ring->capacity);
+    if (!ring->data) {
+        SDL_free(ring);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    return ring;
+}
+
+size_t
+SDL_WriteRingBuffer(SDL_RingBuffer *ring, const void *data, size_t len)
+{
+    const Uint8 *src = (const Uint8 *) data;
+    Uint32 head, space, offset, chunk, count;
+
+    if (!ring) {
+        SDL_InvalidParamError("ring");
+        return 0;
+    }
+    if (!data && len) {
+        SDL_InvalidParamError("data");
+        return 0;
+    }
+
+    head = LoadRelaxed(&ring->head);
+    space = ring->capacity - (head - ring->cached_tail);
+    if (space < len) {
+        /* Only look at the consumer's cache line when we have to */
+        ring->cached_tail = LoadAcquire(&ring->tail);
+        space = ring->capacity - (head - ring->cached_tail);
+    }
+    count = (len < space) ? (Uint32) len : space;
+    if (count == 0) {
+        return 0;
+    }
+
+    offset = head & ring->mask;
+    chunk = SDL_min(count, ring->capacity - offset);
+    SDL_memcpy(ring->data + offset, src, chunk);
+    SDL_memcpy(ring->data, src + chunk, count - chunk);
+
+    StoreRelease(&ring->head, head + count);
+    return count;
+}
+
+size_t
+SDL_ReadRingBuffer(SDL_RingBuffer *ring, void *data, size_t len)
+{
+    Uint8 *dst = (Uint8 *) data;
+    Uint32 tail, available, offset, chunk, count;
+
+    if (!ring) {
+        SDL_InvalidParamError("ring");
+        return 0;
+    }
+    if (!data && len) {
+        SDL_InvalidParamError("data");
+        return 0;
+    }
+
+    tail = LoadRelaxed(&ring->tail);
+    available = ring->cached_head - tail;
+    if (available < len) {
+        ring->cached_head = LoadAcquire(&ring->head);
+        available = ring->cached_head - tail;
+    }
+    count = (len < available) ? (Uint32) len : available;
+    if (count == 0) {
+        return 0;
+    }
+
+    offset = tail & ring->mask;
+    chunk = SDL_min(count, ring->capacity - offset);
+    SDL_memcpy(dst, ring->data + offset, chunk);
+    SDL_memcpy(dst + chunk, ring->data, count - chunk);
+
+    StoreRelease(&ring->tail, tail + count);
+    return count;
+}
+
+size_t
+SDL_GetRingBufferAvailable(SDL_RingBuffer *ring)
+{
+    Uint32 tail;
+
+    if (!ring) {
+        return 0;
+    }
+    /* Read the tail first so the difference can't go negative */
+    tail = LoadAcquire(&ring->tail);
+    return (size_t) (LoadAcquire(&ring->head) - tail);
+}
+
+size_t
+SDL_GetRingBufferCapacity(SDL_RingBuffer *ring)
+{
+    return ring ? ring->capacity : 0;
+}
+
+void
+SDL_DestroyRingBuffer(SDL_RingBuffer *ring)
+{
+    if (ring) {
+        SDL_free(ring->data);
+        SDL_free(ring);
+    }
+}
+
+struct SDL_AtomicQueue
+{
+    Uint8 *cells;
+    size_t element_size;
+    size_t stride;
+    Uint32 mask;
+
+    SDL_QUEUE_PAD(pad0);
+    SDL_atomic_t enqueue_pos;
+    SDL_QUEUE_PAD(pad1);
+    SDL_atomic_t dequeue_pos;
+    SDL_QUEUE_PAD(pad2);
+};
+
+#define CELL_SEQUENCE(queue, pos) \
+    ((SDL_atomic_t *) ((queue)->cells + ((pos) & (queue)->mask) * (queue)->stride))
+#define CELL_DATA(queue, pos) \
+    ((queue)->cells + ((pos) & (queue)->mask) * (queue)->stride + SDL_QUEUE_CELL_HEADER)
+
+SDL_AtomicQueue *
+SDL_CreateAtomicQueue(size_t element_size, size_t capacity)
+{
+    SDL_AtomicQueue *queue;
+    Uint32 count, i;
+
+    if (element_size == 0 || element_size > SDL_QUEUE_MAX_CAPACITY) {
+        SDL_InvalidParamError("element_size");
+        return NULL;
+    }
+    if (capacity == 0 || capacity > SDL_QUEUE_MAX_CAPACITY) {
+        SDL_InvalidParamError("capacity");
+        return NULL;
+    }
+
+    queue = (SDL_AtomicQueue *) SDL_calloc(1, sizeof(*queue));
+    if (!queue) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    count = RoundUpCapacity(capacity);
+    queue->element_size = element_size;
+    queue->stride = SDL_QUEUE_CELL_HEADER + ((element_size + 7) & ~(size_t)7);
+    queue->mask = count - 1;
+    if (queue->stride > (~(size_t)0) / count) {
+        SDL_free(queue);
+        SDL_SetError("Queue is too large");
+        return NULL;
+    }
+    queue->cells = (Uint8 *) SDL_malloc(count * queue->stride);
+    if (!queue->cells) {
+        SDL_free(queue);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Cell i is ready for the producer that claims position i */
+    for (i = 0; i < count; ++i) {
+        StoreRelease(CELL_SEQUENCE(queue, i), i);
+    }
+    return queue;
+}
+
+SDL_bool
+SDL_AtomicQueuePush(SDL_AtomicQueue *queue, const void *element)
+{
+    Uint32 pos, sequence;
+    Sint32 diff;
+
+    if (!queue) {
+        SDL_InvalidParamError("queue");
+        return SDL_FALSE;
+    }
+    if (!element) {
+        SDL_InvalidParamError("element");
+        return SDL_FALSE;
+    }
+
+    pos = LoadRelaxed(&queue->enqueue_pos);
+    for (;;) {
+        sequence = LoadAcquire(CELL_SEQUENCE(queue, pos));
+        diff = (Sint32) (sequence - pos);
+        if (diff == 0) {
+            /* The cell is free, try to claim it */
+            if (SDL_AtomicCAS(&queue->enqueue_pos, (int) pos, (int) (pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* The consumer a lap behind us hasn't emptied this cell yet */
+            return SDL_FALSE;
+        }
+        pos = LoadRelaxed(&queue->enqueue_pos);
+    }
+
+    SDL_memcpy(CELL_DATA(queue, pos), element, queue->element_size);
+    StoreRelease(CELL_SEQUENCE(queue, pos), pos + 1);
+    return SDL_TRUE;
+}
+
+SDL_bool
+SDL_AtomicQueuePop(SDL_AtomicQueue *queue, void *element)
+{
+    Uint32 pos, sequence;
+    Sint32 diff;
+
+    if (!queue) {
+        SDL_InvalidParamError("queue");
+        return SDL_FALSE;
+    }
+    if (!element) {
+        SDL_InvalidParamError("element");
+        return SDL_FALSE;
+    }
+
+    pos = LoadRelaxed(&queue->dequeue_pos);
+    for (;;) {
+        sequence = LoadAcquire(CELL_SEQUENCE(queue, pos));
+        diff = (Sint32) (sequence - (pos + 1));
+        if (diff == 0) {
+            /* The cell is full, try to claim it */
+            if (SDL_AtomicCAS(&queue->dequeue_pos, (int) pos, (int) (pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Nothing has been pushed here yet */
+            return SDL_FALSE;
+        }
+        pos = LoadRelaxed(&queue->dequeue_pos);
+    }
+
+    SDL_memcpy(element, CELL_DATA(queue, pos), queue->element_size);
+    /* Hand the cell to the producer one lap ahead */
+    StoreRelease(CELL_SEQUENCE(queue, pos), pos + queue->mask + 1);
+    return SDL_TRUE;
+}
+
+void
+SDL_DestroyAtomicQueue(SDL_AtomicQueue *queue)
+{
+    if (queue) {
+        SDL_free(queue->cells);
+        SDL_free(queue);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
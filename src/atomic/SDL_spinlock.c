@@ -27,11 +27,63 @@
 #include "SDL_atomic.h"
 #include "SDL_mutex.h"
 #include "SDL_timer.h"
+#include "SDL_cpuinfo.h"
 
 #if !defined(HAVE_GCC_ATOMICS) && defined(__SOLARIS__)
 #include <atomic.h>
 #endif
 
+#include "SDL_spinlock_c.h"
+
+/* On Linux a contended lock is marked with 2 and waiters sleep on a futex
+   instead of polling with SDL_Delay().  This needs a compare-and-swap in
+   SDL_AtomicTryLock() so it doesn't clobber the contended state.
+ */
+#if defined(__LINUX__) && HAVE_GCC_ATOMICS && !SDL_ATOMIC_DISABLED
+#define SDL_SPINLOCK_FUTEX 1
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+/* The number of times the backoff doubles before a waiter goes to sleep */
+#define SDL_SPINLOCK_BACKOFF_LIMIT  8
+
+static int SDL_lock_stats[SDL_NUM_LOCKSTATS];
+
+void
+SDL_CountLockStat(SDL_LockStat stat)
+{
+    /* These can't use SDL_AtomicAdd(), which may be built on spinlocks */
+#if defined(_MSC_VER)
+    InterlockedIncrement((long*)&SDL_lock_stats[stat]);
+#elif HAVE_GCC_ATOMICS
+    __sync_fetch_and_add(&SDL_lock_stats[stat], 1);
+#else
+    /* Close enough for profiling */
+    ++SDL_lock_stats[stat];
+#endif
+}
+
+void
+SDL_GetLockStats(SDL_LockStats *stats)
+{
+    if (!stats) {
+        SDL_InvalidParamError("stats");
+        return;
+    }
+    stats->spinlock_contended = (Uint32)SDL_lock_stats[SDL_LOCKSTAT_SPINLOCK_CONTENDED];
+    stats->spinlock_sleeps = (Uint32)SDL_lock_stats[SDL_LOCKSTAT_SPINLOCK_SLEEPS];
+    stats->mutex_contended = (Uint32)SDL_lock_stats[SDL_LOCKSTAT_MUTEX_CONTENDED];
+    stats->mutex_sleeps = (Uint32)SDL_lock_stats[SDL_LOCKSTAT_MUTEX_SLEEPS];
+}
+
+void
+SDL_ResetLockStats(void)
+{
+    SDL_zero(SDL_lock_stats);
+}
+
 /* This function is where all the magic happens... */
 SDL_bool
 SDL_AtomicTryLock(SDL_SpinLock *lock)
@@ -58,6 +110,9 @@ SDL_AtomicTryLock(SDL_SpinLock *lock)
     SDL_COMPILE_TIME_ASSERT(locksize, sizeof(*lock) == sizeof(long));
     return (InterlockedExchange((long*)lock, 1) == 0);
 
+#elif SDL_SPINLOCK_FUTEX
+    return __sync_bool_compare_and_swap(lock, 0, 1);
+
 #elif HAVE_GCC_ATOMICS || HAVE_GCC_SYNC_LOCK_TEST_AND_SET
     return (__sync_lock_test_and_set(lock, 1) == 0);
 
@@ -106,16 +161,63 @@ SDL_AtomicTryLock(SDL_SpinLock *lock)
 void
 SDL_AtomicLock(SDL_SpinLock *lock)
 {
+    int backoff = 0;
+    int i;
+
+    if (SDL_AtomicTryLock(lock)) {
+        return;
+    }
+    SDL_CountLockStat(SDL_LOCKSTAT_SPINLOCK_CONTENDED);
+
+    /* Spin with exponential backoff, only retrying when the lock looks free
+       so waiters don't keep stealing the cache line from the owner.  This
+       is pointless if the owner can't be running at the same time.
+     */
+    if (SDL_GetCPUCount() == 1) {
+        backoff = SDL_SPINLOCK_BACKOFF_LIMIT;
+    }
+    while (backoff < SDL_SPINLOCK_BACKOFF_LIMIT) {
+        for (i = (1 << backoff); i > 0; --i) {
+            SDL_CPUPauseInstruction();
+        }
+        ++backoff;
+
+        if (*(volatile SDL_SpinLock *)lock == 0 && SDL_AtomicTryLock(lock)) {
+            return;
+        }
+    }
+
+    SDL_CountLockStat(SDL_LOCKSTAT_SPINLOCK_SLEEPS);
+#if SDL_SPINLOCK_FUTEX
+    /* Mark the lock contended and sleep until the owner wakes us up.
+       If we get the lock this way it stays marked, which at worst costs
+       the next unlock a spurious wake.
+     */
+    while (__sync_lock_test_and_set(lock, 2) != 0) {
+        syscall(SYS_futex, lock, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+    }
+#else
     /* FIXME: Should we have an eventual timeout? */
     while (!SDL_AtomicTryLock(lock)) {
         SDL_Delay(0);
     }
+#endif
 }
 
 void
 SDL_AtomicUnlock(SDL_SpinLock *lock)
 {
-#if defined(_MSC_VER)
+#if SDL_SPINLOCK_FUTEX
+#ifdef __ATOMIC_RELEASE
+    if (__atomic_exchange_n(lock, 0, __ATOMIC_RELEASE) == 2) {
+#else
+    __sync_synchronize();
+    if (__sync_lock_test_and_set(lock, 0) == 2) {
+#endif
+        syscall(SYS_futex, lock, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+
+#elif defined(_MSC_VER)
     _ReadWriteBarrier();
     *lock = 0;
 
@@ -27,6 +27,7 @@
 #include "SDL_audio_c.h"
 #include "SDL_sysaudio.h"
 #include "../thread/SDL_systhread.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 #define _THIS SDL_AudioDevice *_this
 
@@ -625,7 +626,7 @@ SDL_RunAudio(void *devicep)
     SDL_assert(!device->iscapture);
 
     /* The audio mixing is always a high priority thread */
-    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+    SDL_ApplyThreadHints(SDL_THREAD_PRIORITY_HIGH);
 
     /* Perform any thread setup */
     device->threadid = SDL_ThreadID();
@@ -718,7 +719,7 @@ SDL_CaptureAudio(void *devicep)
     SDL_assert(device->iscapture);
 
     /* The audio mixing is always a high priority thread */
-    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+    SDL_ApplyThreadHints(SDL_THREAD_PRIORITY_HIGH);
 
     /* Perform any thread setup */
     device->threadid = SDL_ThreadID();
@@ -1037,7 +1038,7 @@ close_audio_device(SDL_AudioDevice * device)
         SDL_DestroyMutex(device->mixer_lock);
     }
 
-    SDL_free(device->work_buffer);
+    SDL_TaggedFree(SDL_MEMORY_TAG_AUDIO, device->work_buffer);
     SDL_FreeAudioStream(device->stream);
 
     if (device->hidden != NULL) {
@@ -1046,7 +1047,7 @@ close_audio_device(SDL_AudioDevice * device)
 
     SDL_FreeDataQueue(device->buffer_queue);
 
-    SDL_free(device);
+    SDL_TaggedFree(SDL_MEMORY_TAG_AUDIO, device);
 }
 
 
@@ -1222,7 +1223,7 @@ open_audio_device(const char *devname, int iscapture,
         }
     }
 
-    device = (SDL_AudioDevice *) SDL_calloc(1, sizeof (SDL_AudioDevice));
+    device = (SDL_AudioDevice *) SDL_TaggedCalloc(SDL_MEMORY_TAG_AUDIO, 1, sizeof (SDL_AudioDevice));
     if (device == NULL) {
         SDL_OutOfMemory();
         return 0;
@@ -1329,7 +1330,7 @@ open_audio_device(const char *devname, int iscapture,
     }
     SDL_assert(device->work_buffer_len > 0);
 
-    device->work_buffer = (Uint8 *) SDL_malloc(device->work_buffer_len);
+    device->work_buffer = (Uint8 *) SDL_TaggedMalloc(SDL_MEMORY_TAG_AUDIO, device->work_buffer_len);
     if (device->work_buffer == NULL) {
         close_audio_device(device);
         SDL_OutOfMemory();
@@ -28,6 +28,7 @@
 #include "SDL_loadso.h"
 #include "SDL_assert.h"
 #include "../SDL_dataqueue.h"
+#include "../stdlib/SDL_malloc_c.h"
 #include "SDL_cpuinfo.h"
 
 #ifdef __SSE3__
@@ -1025,7 +1026,7 @@ SDL_ResetAudioStreamResampler(SDL_AudioStream *stream)
 static void
 SDL_CleanupAudioStreamResampler(SDL_AudioStream *stream)
 {
-    SDL_free(stream->resampler_state);
+    SDL_TaggedFree(SDL_MEMORY_TAG_AUDIO, stream->resampler_state);
 }
 
 SDL_AudioStream *
@@ -1043,7 +1044,7 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     const SDL_bool SRC_available = SDL_FALSE;
 #endif
 
-    retval = (SDL_AudioStream *) SDL_calloc(1, sizeof (SDL_AudioStream));
+    retval = (SDL_AudioStream *) SDL_TaggedCalloc(SDL_MEMORY_TAG_AUDIO, 1, sizeof (SDL_AudioStream));
     if (!retval) {
         return NULL;
     }
@@ -1076,7 +1077,7 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     /* fast path special case for stereo Sint16 data that just needs resampling. */
     } else if ((!SRC_available) && (src_channels == 2) && (dst_channels == 2) && (src_format == AUDIO_S16SYS) && (dst_format == AUDIO_S16SYS)) {
         SDL_assert(src_rate != dst_rate);
-        retval->resampler_state = SDL_calloc(1, sizeof(SDL_AudioStreamResamplerState));
+        retval->resampler_state = SDL_TaggedCalloc(SDL_MEMORY_TAG_AUDIO, 1, sizeof(SDL_AudioStreamResamplerState));
         if (!retval->resampler_state) {
             SDL_FreeAudioStream(retval);
             SDL_OutOfMemory();
@@ -1098,7 +1099,7 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
 #endif
 
         if (!retval->resampler_func) {
-            retval->resampler_state = SDL_calloc(1, sizeof(SDL_AudioStreamResamplerState));
+            retval->resampler_state = SDL_TaggedCalloc(SDL_MEMORY_TAG_AUDIO, 1, sizeof(SDL_AudioStreamResamplerState));
             if (!retval->resampler_state) {
                 SDL_FreeAudioStream(retval);
                 SDL_OutOfMemory();
@@ -1129,7 +1130,7 @@ static Uint8 *
 EnsureStreamBufferSize(SDL_AudioStream *stream, const int newlen)
 {
     if (stream->work_buffer_len < newlen) {
-        Uint8 *ptr = (Uint8 *) SDL_realloc(stream->work_buffer_base, newlen + 32);
+        Uint8 *ptr = (Uint8 *) SDL_TaggedRealloc(SDL_MEMORY_TAG_AUDIO, stream->work_buffer_base, newlen + 32);
         const size_t offset = ((size_t) ptr) & 15;
         if (!ptr) {
             SDL_OutOfMemory();
@@ -1265,8 +1266,8 @@ SDL_FreeAudioStream(SDL_AudioStream *stream)
             stream->cleanup_resampler_func(stream);
         }
         SDL_FreeDataQueue(stream->queue);
-        SDL_free(stream->work_buffer_base);
-        SDL_free(stream);
+        SDL_TaggedFree(SDL_MEMORY_TAG_AUDIO, stream->work_buffer_base);
+        SDL_TaggedFree(SDL_MEMORY_TAG_AUDIO, stream);
     }
 }
 
@@ -26,7 +26,8 @@
 #include "SDL_wave.h"
 
 
-static int ReadChunk(SDL_RWops * src, Chunk * chunk);
+static int ReadChunk(SDL_RWops * src, Chunk * chunk, Uint32 keep_magic);
+static void FreeChunk(Chunk * chunk);
 
 struct MS_ADPCM_decodestate
 {
@@ -119,7 +120,7 @@ static int
 MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
 {
     struct MS_ADPCM_decodestate *state[2];
-    Uint8 *freeable, *encoded, *decoded;
+    Uint8 *encoded, *decoded;
     Sint32 encoded_len, samplesleft;
     Sint8 nybble;
     Uint8 stereo;
@@ -129,7 +130,6 @@ MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
     /* Allocate the proper sized output buffer */
     encoded_len = *audio_len;
     encoded = *audio_buf;
-    freeable = *audio_buf;
     *audio_len = (encoded_len / MS_ADPCM_state.wavefmt.blockalign) *
         MS_ADPCM_state.wSamplesPerBlock *
         MS_ADPCM_state.wavefmt.channels * sizeof(Sint16);
@@ -211,7 +211,6 @@ MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
         }
         encoded_len -= MS_ADPCM_state.wavefmt.blockalign;
     }
-    SDL_free(freeable);
     return (0);
 }
 
@@ -338,7 +337,7 @@ static int
 IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
 {
     struct IMA_ADPCM_decodestate *state;
-    Uint8 *freeable, *encoded, *decoded;
+    Uint8 *encoded, *decoded;
     Sint32 encoded_len, samplesleft;
     unsigned int c, channels;
 
@@ -354,7 +353,6 @@ IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
     /* Allocate the proper sized output buffer */
     encoded_len = *audio_len;
     encoded = *audio_buf;
-    freeable = *audio_buf;
     *audio_len = (encoded_len / IMA_ADPCM_state.wavefmt.blockalign) *
         IMA_ADPCM_state.wSamplesPerBlock *
         IMA_ADPCM_state.wavefmt.channels * sizeof(Sint16);
@@ -399,7 +397,6 @@ IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
         }
         encoded_len -= IMA_ADPCM_state.wavefmt.blockalign;
     }
-    SDL_free(freeable);
     return (0);
 }
 
@@ -431,6 +428,15 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         goto done;
     }
 
+    /* The headers are read a field at a time, so buffer custom streams */
+    if (src->type == SDL_RWOPS_UNKNOWN) {
+        SDL_RWops *buffered = SDL_RWFromBufferedRW(src, 0, freesrc ? SDL_TRUE : SDL_FALSE);
+        if (buffered) {
+            src = buffered;
+            freesrc = 1;
+        }
+    }
+
     /* Check the magic header */
     RIFFchunk = SDL_ReadLE32(src);
     wavelen = SDL_ReadLE32(src);
@@ -449,11 +455,9 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     headerDiff += sizeof(Uint32);       /* for WAVE */
 
     /* Read the audio data format chunk */
-    chunk.data = NULL;
     do {
-        SDL_free(chunk.data);
-        chunk.data = NULL;
-        lenread = ReadChunk(src, &chunk);
+        FreeChunk(&chunk);
+        lenread = ReadChunk(src, &chunk, FMT);
         if (lenread < 0) {
             was_error = 1;
             goto done;
@@ -463,12 +467,13 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     } while ((chunk.magic == FACT) || (chunk.magic == LIST) || (chunk.magic == BEXT) || (chunk.magic == JUNK));
 
     /* Decode the audio data format */
-    format = (WaveFMT *) chunk.data;
     if (chunk.magic != FMT) {
         SDL_SetError("Complex WAVE files not supported");
         was_error = 1;
         goto done;
     }
+    format = (WaveFMT *) chunk.data;
+    chunk.data = NULL;
     IEEE_float_encoded = MS_ADPCM_encoded = IMA_ADPCM_encoded = 0;
     switch (SDL_SwapLE16(format->encoding)) {
     case PCM_CODE:
@@ -545,34 +550,37 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     spec->channels = (Uint8) SDL_SwapLE16(format->channels);
     spec->samples = 4096;       /* Good default buffer size */
 
-    /* Read the audio data chunk */
+    /* Read the audio data chunk, which is returned unless it's decoded */
     *audio_buf = NULL;
     do {
-        SDL_free(*audio_buf);
-        *audio_buf = NULL;
-        lenread = ReadChunk(src, &chunk);
+        FreeChunk(&chunk);
+        lenread = ReadChunk(src, &chunk,
+                            (MS_ADPCM_encoded || IMA_ADPCM_encoded) ? 0 : DATA);
         if (lenread < 0) {
             was_error = 1;
             goto done;
         }
         *audio_len = lenread;
-        *audio_buf = chunk.data;
         if (chunk.magic != DATA)
             headerDiff += lenread + 2 * sizeof(Uint32);
     } while (chunk.magic != DATA);
     headerDiff += 2 * sizeof(Uint32);   /* for the data chunk and len */
 
+    *audio_buf = chunk.data;
     if (MS_ADPCM_encoded) {
         if (MS_ADPCM_decode(audio_buf, audio_len) < 0) {
+            *audio_buf = NULL;
             was_error = 1;
             goto done;
         }
-    }
-    if (IMA_ADPCM_encoded) {
+    } else if (IMA_ADPCM_encoded) {
         if (IMA_ADPCM_decode(audio_buf, audio_len) < 0) {
+            *audio_buf = NULL;
             was_error = 1;
             goto done;
         }
+    } else {
+        chunk.data = NULL;      /* The caller frees the PCM data */
     }
 
     /* Don't return a buffer that isn't a multiple of samplesize */
@@ -581,6 +589,7 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
 
   done:
     SDL_free(format);
+    FreeChunk(&chunk);
     if (src) {
         if (freesrc) {
             SDL_RWclose(src);
@@ -604,11 +613,26 @@ SDL_FreeWAV(Uint8 * audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Reads a chunk into memory.  Chunks other than keep_magic are only needed
+   while loading, so if the stream is already in memory they point into it. */
 static int
-ReadChunk(SDL_RWops * src, Chunk * chunk)
+ReadChunk(SDL_RWops * src, Chunk * chunk, Uint32 keep_magic)
 {
+    const void *mem;
+    size_t available;
+
     chunk->magic = SDL_ReadLE32(src);
     chunk->length = SDL_ReadLE32(src);
+    chunk->in_place = SDL_FALSE;
+    if (chunk->magic != keep_magic) {
+        mem = SDL_RWGetPointer(src, &available);
+        if (mem != NULL && available >= chunk->length) {
+            chunk->data = (Uint8 *) mem;
+            chunk->in_place = SDL_TRUE;
+            SDL_RWseek(src, chunk->length, RW_SEEK_CUR);
+            return (chunk->length);
+        }
+    }
     chunk->data = (Uint8 *) SDL_malloc(chunk->length);
     if (chunk->data == NULL) {
         return SDL_OutOfMemory();
@@ -621,4 +645,14 @@ ReadChunk(SDL_RWops * src, Chunk * chunk)
     return (chunk->length);
 }
 
+static void
+FreeChunk(Chunk * chunk)
+{
+    if (!chunk->in_place) {
+        SDL_free(chunk->data);
+    }
+    chunk->data = NULL;
+    chunk->in_place = SDL_FALSE;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
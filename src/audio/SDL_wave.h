@@ -62,6 +62,7 @@ typedef struct Chunk
     Uint32 magic;
     Uint32 length;
     Uint8 *data;
+    SDL_bool in_place;          /* data points into a stream in memory */
 } Chunk;
 
 /* vi: set ts=4 sw=4 expandtab: */
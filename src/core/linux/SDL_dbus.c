@@ -23,10 +23,18 @@
 
 #if SDL_USE_LIBDBUS
 /* we never link directly to libdbus. */
+#include "SDL_atomic.h"
 #include "SDL_loadso.h"
+#include <sys/resource.h>
+
+#define RTKIT_DBUS_NODE "org.freedesktop.RealtimeKit1"
+#define RTKIT_DBUS_PATH "/org/freedesktop/RealtimeKit1"
+#define RTKIT_DBUS_INTERFACE "org.freedesktop.RealtimeKit1"
+
 static const char *dbus_library = "libdbus-1.so.3";
 static void *dbus_handle = NULL;
 static unsigned int screensaver_cookie = 0;
+static SDL_SpinLock rtkit_lock = 0;
 static SDL_DBusContext dbus;
 
 static int
@@ -127,13 +135,21 @@ SDL_DBus_Init(void)
 void
 SDL_DBus_Quit(void)
 {
+    SDL_AtomicLock(&rtkit_lock);
+    if (dbus.system_conn) {
+        dbus.connection_close(dbus.system_conn);
+        dbus.connection_unref(dbus.system_conn);
+    }
     if (dbus.session_conn) {
         dbus.connection_close(dbus.session_conn);
         dbus.connection_unref(dbus.session_conn);
+    }
+    if (dbus.system_conn || dbus.session_conn) {
         dbus.shutdown();
         SDL_memset(&dbus, 0, sizeof(dbus));
     }
     UnloadDBUSLibrary();
+    SDL_AtomicUnlock(&rtkit_lock);
 }
 
 SDL_DBusContext *
@@ -236,6 +252,166 @@ SDL_DBus_ScreensaverInhibit(SDL_bool inhibit)
         return SDL_TRUE;
     }
 }
+
+/* RealtimeKit lives on the system bus, which is opened on first use so
+   that programs which never ask for real-time threads don't connect to it. */
+static DBusConnection *
+SDL_DBus_GetSystemConnection(void)
+{
+    if (!dbus.system_conn && LoadDBUSLibrary() != -1) {
+        DBusError err;
+        dbus.error_init(&err);
+        dbus.system_conn = dbus.bus_get_private(DBUS_BUS_SYSTEM, &err);
+        if (dbus.error_is_set(&err)) {
+            dbus.error_free(&err);
+            if (dbus.system_conn) {
+                dbus.connection_unref(dbus.system_conn);
+                dbus.system_conn = NULL;
+            }
+            return NULL;
+        }
+        dbus.connection_set_exit_on_disconnect(dbus.system_conn, 0);
+    }
+    return dbus.system_conn;
+}
+
+static SDL_bool
+RTKit_GetIntProperty(DBusConnection *conn, const char *property, Sint64 *value)
+{
+    const char *iface = RTKIT_DBUS_INTERFACE;
+    SDL_bool retval = SDL_FALSE;
+    DBusMessage *msg = dbus.message_new_method_call(RTKIT_DBUS_NODE,
+                                                    RTKIT_DBUS_PATH,
+                                                    "org.freedesktop.DBus.Properties",
+                                                    "Get");
+    if (msg == NULL) {
+        return SDL_FALSE;
+    }
+
+    if (dbus.message_append_args(msg,
+                                 DBUS_TYPE_STRING, &iface,
+                                 DBUS_TYPE_STRING, &property,
+                                 DBUS_TYPE_INVALID)) {
+        DBusMessage *reply = dbus.connection_send_with_reply_and_block(conn, msg, 300, NULL);
+        if (reply) {
+            DBusMessageIter iter, variant;
+            if (dbus.message_iter_init(reply, &iter) &&
+                dbus.message_iter_get_arg_type(&iter) == DBUS_TYPE_VARIANT) {
+                dbus.message_iter_recurse(&iter, &variant);
+                switch (dbus.message_iter_get_arg_type(&variant)) {
+                case DBUS_TYPE_INT32: {
+                    dbus_int32_t i32;
+                    dbus.message_iter_get_basic(&variant, &i32);
+                    *value = i32;
+                    retval = SDL_TRUE;
+                    break;
+                }
+                case DBUS_TYPE_INT64: {
+                    dbus_int64_t i64;
+                    dbus.message_iter_get_basic(&variant, &i64);
+                    *value = i64;
+                    retval = SDL_TRUE;
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+            dbus.message_unref(reply);
+        }
+    }
+    dbus.message_unref(msg);
+
+    return retval;
+}
+
+static SDL_bool
+RTKit_CallMethod(DBusConnection *conn, const char *method, Sint64 thread, int type, const void *arg)
+{
+    dbus_uint64_t tid = (dbus_uint64_t)thread;
+    SDL_bool retval = SDL_FALSE;
+    DBusMessage *msg = dbus.message_new_method_call(RTKIT_DBUS_NODE,
+                                                    RTKIT_DBUS_PATH,
+                                                    RTKIT_DBUS_INTERFACE,
+                                                    method);
+    if (msg == NULL) {
+        return SDL_FALSE;
+    }
+
+    if (dbus.message_append_args(msg,
+                                 DBUS_TYPE_UINT64, &tid,
+                                 type, arg,
+                                 DBUS_TYPE_INVALID)) {
+        DBusError err;
+        DBusMessage *reply;
+
+        dbus.error_init(&err);
+        reply = dbus.connection_send_with_reply_and_block(conn, msg, 300, &err);
+        if (dbus.error_is_set(&err)) {
+            dbus.error_free(&err);
+        } else if (reply) {
+            retval = SDL_TRUE;
+        }
+        if (reply) {
+            dbus.message_unref(reply);
+        }
+    }
+    dbus.message_unref(msg);
+
+    return retval;
+}
+
+SDL_bool
+SDL_DBus_MakeThreadRealtime(Sint64 thread, int priority)
+{
+    SDL_bool retval = SDL_FALSE;
+    DBusConnection *conn;
+
+    SDL_AtomicLock(&rtkit_lock);
+    conn = SDL_DBus_GetSystemConnection();
+    if (conn) {
+        Sint64 max_priority, max_rttime;
+        if (RTKit_GetIntProperty(conn, "MaxRealtimePriority", &max_priority) &&
+            RTKit_GetIntProperty(conn, "RTTimeUSecMax", &max_rttime)) {
+            dbus_uint32_t value;
+            struct rlimit limit;
+
+            /* RealtimeKit refuses processes that could hog the CPU forever,
+               so cap the real-time CPU time to what it allows. */
+            if (getrlimit(RLIMIT_RTTIME, &limit) == 0 &&
+                (limit.rlim_max == RLIM_INFINITY || limit.rlim_max > (rlim_t)max_rttime)) {
+                limit.rlim_cur = limit.rlim_max = (rlim_t)max_rttime;
+                setrlimit(RLIMIT_RTTIME, &limit);
+            }
+
+            value = (dbus_uint32_t)SDL_min(SDL_max(priority, 1), max_priority);
+            retval = RTKit_CallMethod(conn, "MakeThreadRealtime", thread, DBUS_TYPE_UINT32, &value);
+        }
+    }
+    SDL_AtomicUnlock(&rtkit_lock);
+
+    return retval;
+}
+
+SDL_bool
+SDL_DBus_MakeThreadHighPriority(Sint64 thread, int nice)
+{
+    SDL_bool retval = SDL_FALSE;
+    DBusConnection *conn;
+
+    SDL_AtomicLock(&rtkit_lock);
+    conn = SDL_DBus_GetSystemConnection();
+    if (conn) {
+        Sint64 min_nice;
+        if (RTKit_GetIntProperty(conn, "MinNiceLevel", &min_nice)) {
+            dbus_int32_t value = (dbus_int32_t)SDL_max(nice, min_nice);
+            retval = RTKit_CallMethod(conn, "MakeThreadHighPriority", thread, DBUS_TYPE_INT32, &value);
+        }
+    }
+    SDL_AtomicUnlock(&rtkit_lock);
+
+    return retval;
+}
 #endif
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -32,6 +32,7 @@
 
 typedef struct SDL_DBusContext {
     DBusConnection *session_conn;
+    DBusConnection *system_conn;
 
     DBusConnection *(*bus_get_private)(DBusBusType, DBusError *);
     dbus_bool_t (*bus_register)(DBusConnection *, DBusError *);
@@ -75,6 +76,11 @@ extern SDL_DBusContext * SDL_DBus_GetContext(void);
 extern void SDL_DBus_ScreensaverTickle(void);
 extern SDL_bool SDL_DBus_ScreensaverInhibit(SDL_bool inhibit);
 
+/* Ask RealtimeKit on the system bus to raise a thread's scheduling.
+   The priority and nice level are clamped to what RealtimeKit allows. */
+extern SDL_bool SDL_DBus_MakeThreadRealtime(Sint64 thread, int priority);
+extern SDL_bool SDL_DBus_MakeThreadHighPriority(Sint64 thread, int nice);
+
 #endif /* HAVE_DBUS_DBUS_H */
 
 #endif /* SDL_dbus_h_ */
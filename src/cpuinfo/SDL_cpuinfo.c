@@ -31,6 +31,7 @@
 /* CPU feature detection for SDL */
 
 #include "SDL_cpuinfo.h"
+#include "SDL_error.h"
 
 #ifdef HAVE_SYSCONF
 #include <unistd.h>
@@ -50,6 +51,11 @@
 #include <setjmp.h>
 #endif
 
+#if defined(__LINUX__) && !defined(SDL_CPUINFO_DISABLED)
+#include <fcntl.h>  /* For reading the topology from sysfs */
+#include <unistd.h>
+#endif
+
 #if (defined(__LINUX__) || defined(__ANDROID__)) && defined(__ARM_ARCH)
 /*#include <asm/hwcap.h>*/
 #ifndef AT_HWCAP
@@ -232,6 +238,49 @@ done:
     a = b = c = d = 0
 #endif
 
+/* The same, for leaves that take a subleaf in ecx */
+#if defined(__GNUC__) && defined(i386)
+#define cpuid_count(func, sub, a, b, c, d) \
+    __asm__ __volatile__ ( \
+"        pushl %%ebx        \n" \
+"        cpuid              \n" \
+"        movl %%ebx, %%esi  \n" \
+"        popl %%ebx         \n" : \
+            "=a" (a), "=S" (b), "=c" (c), "=d" (d) : "a" (func), "c" (sub))
+#elif defined(__GNUC__) && defined(__x86_64__)
+#define cpuid_count(func, sub, a, b, c, d) \
+    __asm__ __volatile__ ( \
+"        pushq %%rbx        \n" \
+"        cpuid              \n" \
+"        movq %%rbx, %%rsi  \n" \
+"        popq %%rbx         \n" : \
+            "=a" (a), "=S" (b), "=c" (c), "=d" (d) : "a" (func), "c" (sub))
+#elif (defined(_MSC_VER) && defined(_M_IX86)) || defined(__WATCOMC__)
+#define cpuid_count(func, sub, a, b, c, d) \
+    __asm { \
+        __asm mov eax, func \
+        __asm mov ecx, sub \
+        __asm cpuid \
+        __asm mov a, eax \
+        __asm mov b, ebx \
+        __asm mov c, ecx \
+        __asm mov d, edx \
+}
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define cpuid_count(func, sub, a, b, c, d) \
+{ \
+    int CPUInfo[4]; \
+    __cpuidex(CPUInfo, func, sub); \
+    a = CPUInfo[0]; \
+    b = CPUInfo[1]; \
+    c = CPUInfo[2]; \
+    d = CPUInfo[3]; \
+}
+#else
+#define cpuid_count(func, sub, a, b, c, d) \
+    a = b = c = d = 0
+#endif
+
 static int CPU_CPUIDFeatures[4];
 static int CPU_CPUIDMaxFunction = 0;
 static SDL_bool CPU_OSSavesYMM = SDL_FALSE;
@@ -551,6 +600,356 @@ SDL_GetCPUCacheLineSize(void)
     }
 }
 
+/* Cache types, as numbered by cpuid leaf 4 */
+#define CPU_CACHE_DATA          1
+#define CPU_CACHE_INSTRUCTION   2
+#define CPU_CACHE_UNIFIED       3
+
+static void
+CPU_setCacheSize(SDL_CPUTopology *topology, int level, int type, int size)
+{
+    switch (level) {
+    case 1:
+        if (type == CPU_CACHE_INSTRUCTION) {
+            topology->l1i_cache_size = size;
+        } else {
+            topology->l1d_cache_size = size;
+        }
+        break;
+    case 2:
+        topology->l2_cache_size = size;
+        break;
+    case 3:
+        topology->l3_cache_size = size;
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+CPU_calcCPUIDTopology(SDL_CPUTopology *topology)
+{
+    const char *cpuType = SDL_GetCPUType();
+    int a, b, c, d;
+    (void) a; (void) b; (void) c; (void) d;
+
+    if (CPU_CPUIDMaxFunction <= 0) {
+        return;
+    }
+
+    if (SDL_strcmp(cpuType, "GenuineIntel") == 0) {
+        if (CPU_CPUIDMaxFunction >= 4) {
+            int i;
+            for (i = 0; i < 16; ++i) {
+                int type, level;
+                cpuid_count(4, i, a, b, c, d);
+                type = (a & 0x1f);
+                if (type == 0) {
+                    break;
+                }
+                level = ((a >> 5) & 0x7);
+                /* ways * partitions * line size * sets */
+                CPU_setCacheSize(topology, level, type,
+                                 (((b >> 22) & 0x3ff) + 1) * (((b >> 12) & 0x3ff) + 1) *
+                                 ((b & 0xfff) + 1) * (c + 1));
+            }
+        }
+        if (CPU_CPUIDMaxFunction >= 0xB) {
+            /* Subleaf 0 is the SMT level, giving the threads per core */
+            cpuid_count(0xB, 0, a, b, c, d);
+            if (((c >> 8) & 0xff) == 1 && (b & 0xffff) > 1) {
+                topology->physical_cores = topology->logical_cores / (b & 0xffff);
+            }
+        }
+    } else if (SDL_strcmp(cpuType, "AuthenticAMD") == 0) {
+        int maxExtended;
+        cpuid(0x80000000, a, b, c, d);
+        maxExtended = a;
+        if (maxExtended >= (int)0x80000005) {
+            cpuid(0x80000005, a, b, c, d);
+            topology->l1d_cache_size = ((c >> 24) & 0xff) * 1024;
+            topology->l1i_cache_size = ((d >> 24) & 0xff) * 1024;
+        }
+        if (maxExtended >= (int)0x80000006) {
+            cpuid(0x80000006, a, b, c, d);
+            topology->l2_cache_size = ((c >> 16) & 0xffff) * 1024;
+            topology->l3_cache_size = ((d >> 18) & 0x3fff) * 512 * 1024;
+        }
+        if (maxExtended >= (int)0x8000001E) {
+            cpuid(0x8000001E, a, b, c, d);
+            if (((b >> 8) & 0xff) > 0) {
+                topology->physical_cores = topology->logical_cores / (((b >> 8) & 0xff) + 1);
+            }
+        }
+    }
+}
+
+#if defined(__LINUX__) && !defined(SDL_CPUINFO_DISABLED)
+/* Beyond this the sysfs topology is ignored and the defaults are used */
+#define CPU_MAX_SYSFS_CPUS  1024
+
+static SDL_bool
+CPU_readSysFile(const char *path, char *buf, size_t buflen)
+{
+    ssize_t len;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return SDL_FALSE;
+    }
+    len = read(fd, buf, buflen - 1);
+    close(fd);
+    if (len <= 0) {
+        return SDL_FALSE;
+    }
+    buf[len] = '\0';
+    return SDL_TRUE;
+}
+
+/* Parses a CPU list like "0-3,8,10-11", marking the CPUs in set if it
+   isn't NULL, and returns how many CPUs are in the list */
+static int
+CPU_parseCPUList(const char *list, Uint8 *set)
+{
+    int count = 0;
+
+    while (*list >= '0' && *list <= '9') {
+        char *end;
+        long first = SDL_strtol(list, &end, 10), last = first;
+        if (*end == '-') {
+            last = SDL_strtol(end + 1, &end, 10);
+        }
+        for (; first <= last && first < CPU_MAX_SYSFS_CPUS; ++first) {
+            if (set) {
+                set[first] = 1;
+            }
+            ++count;
+        }
+        list = end;
+        if (*list == ',') {
+            ++list;
+        }
+    }
+    return count;
+}
+
+/* Returns whether cpu is the lowest numbered CPU in the list in the
+   given topology file, used to count each core or package only once */
+static SDL_bool
+CPU_isFirstInList(int cpu, const char *file)
+{
+    char path[128], buf[256];
+
+    SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, file);
+    if (!CPU_readSysFile(path, buf, sizeof(buf))) {
+        return SDL_TRUE;
+    }
+    return (SDL_atoi(buf) == cpu) ? SDL_TRUE : SDL_FALSE;
+}
+
+static void
+CPU_calcSysfsTopology(SDL_CPUTopology *topology)
+{
+    Uint8 online[CPU_MAX_SYSFS_CPUS];
+    char path[128], buf[256];
+    int cpu, first = -1, cores = 0, packages = 0, count;
+    int max_capacity = 0, max_capacity_count = 0, capacity_count = 0;
+    int i;
+
+    SDL_zero(online);
+    if (!CPU_readSysFile("/sys/devices/system/cpu/online", buf, sizeof(buf)) ||
+        CPU_parseCPUList(buf, online) == 0) {
+        return;
+    }
+
+    for (cpu = 0; cpu < CPU_MAX_SYSFS_CPUS; ++cpu) {
+        if (!online[cpu]) {
+            continue;
+        }
+        if (first < 0) {
+            first = cpu;
+        }
+        if (CPU_isFirstInList(cpu, "thread_siblings_list")) {
+            ++cores;
+        }
+        if (CPU_isFirstInList(cpu, "core_siblings_list")) {
+            ++packages;
+        }
+
+        /* Big.LITTLE systems report a relative capacity for each core */
+        SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpu_capacity", cpu);
+        if (CPU_readSysFile(path, buf, sizeof(buf))) {
+            const int capacity = SDL_atoi(buf);
+            if (capacity > max_capacity) {
+                max_capacity = capacity;
+                max_capacity_count = 0;
+            }
+            if (capacity == max_capacity) {
+                ++max_capacity_count;
+            }
+            ++capacity_count;
+        }
+    }
+    if (cores > 0) {
+        topology->physical_cores = cores;
+    }
+    if (packages > 0) {
+        topology->packages = packages;
+    }
+
+    /* Intel hybrid CPUs have a separate PMU for each core type */
+    if (CPU_readSysFile("/sys/devices/cpu_core/cpus", buf, sizeof(buf)) &&
+        (count = CPU_parseCPUList(buf, NULL)) > 0) {
+        topology->performance_cores = count;
+        if (CPU_readSysFile("/sys/devices/cpu_atom/cpus", buf, sizeof(buf))) {
+            topology->efficiency_cores = CPU_parseCPUList(buf, NULL);
+        }
+    } else if (capacity_count > 0 && max_capacity_count < capacity_count) {
+        topology->performance_cores = max_capacity_count;
+        topology->efficiency_cores = capacity_count - max_capacity_count;
+    }
+
+    if (CPU_readSysFile("/sys/devices/system/node/online", buf, sizeof(buf)) &&
+        (count = CPU_parseCPUList(buf, NULL)) > 0) {
+        topology->numa_nodes = count;
+    }
+
+    for (i = 0; i < 16; ++i) {
+        int level, type, size;
+        char *end;
+
+        SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", first, i);
+        if (!CPU_readSysFile(path, buf, sizeof(buf))) {
+            break;
+        }
+        level = SDL_atoi(buf);
+
+        SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/type", first, i);
+        if (!CPU_readSysFile(path, buf, sizeof(buf))) {
+            continue;
+        }
+        if (SDL_strncmp(buf, "Data", 4) == 0) {
+            type = CPU_CACHE_DATA;
+        } else if (SDL_strncmp(buf, "Instruction", 11) == 0) {
+            type = CPU_CACHE_INSTRUCTION;
+        } else {
+            type = CPU_CACHE_UNIFIED;
+        }
+
+        SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/size", first, i);
+        if (!CPU_readSysFile(path, buf, sizeof(buf))) {
+            continue;
+        }
+        size = (int)SDL_strtol(buf, &end, 10);
+        if (*end == 'K') {
+            size *= 1024;
+        } else if (*end == 'M') {
+            size *= 1024 * 1024;
+        }
+        CPU_setCacheSize(topology, level, type, size);
+
+        if (level == 1 && type != CPU_CACHE_INSTRUCTION) {
+            SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/coherency_line_size", first, i);
+            if (CPU_readSysFile(path, buf, sizeof(buf)) && SDL_atoi(buf) > 0) {
+                topology->cache_line_size = SDL_atoi(buf);
+            }
+        }
+    }
+}
+#endif /* __LINUX__ */
+
+#if defined(__MACOSX__) && defined(HAVE_SYSCTLBYNAME) && !defined(SDL_CPUINFO_DISABLED)
+/* Reads a sysctl that may be either an int or a 64-bit value, 0 if missing */
+static Sint64
+CPU_sysctlValue(const char *name)
+{
+    union {
+        int i;
+        Sint64 l;
+    } value;
+    size_t size = sizeof(value);
+
+    value.l = 0;
+    if (sysctlbyname(name, &value, &size, NULL, 0) != 0) {
+        return 0;
+    }
+    return (size == sizeof(value.i)) ? value.i : value.l;
+}
+
+static void
+CPU_calcSysctlTopology(SDL_CPUTopology *topology)
+{
+    Sint64 value;
+
+    if ((value = CPU_sysctlValue("hw.physicalcpu")) > 0) {
+        topology->physical_cores = (int)value;
+    }
+    if ((value = CPU_sysctlValue("hw.packages")) > 0) {
+        topology->packages = (int)value;
+    }
+    if ((value = CPU_sysctlValue("hw.cachelinesize")) > 0) {
+        topology->cache_line_size = (int)value;
+    }
+    if ((value = CPU_sysctlValue("hw.l1dcachesize")) > 0) {
+        topology->l1d_cache_size = (int)value;
+    }
+    if ((value = CPU_sysctlValue("hw.l1icachesize")) > 0) {
+        topology->l1i_cache_size = (int)value;
+    }
+    if ((value = CPU_sysctlValue("hw.l2cachesize")) > 0) {
+        topology->l2_cache_size = (int)value;
+    }
+    if ((value = CPU_sysctlValue("hw.l3cachesize")) > 0) {
+        topology->l3_cache_size = (int)value;
+    }
+    /* Performance level 0 is the fastest on Apple silicon */
+    if (CPU_sysctlValue("hw.nperflevels") > 1) {
+        topology->performance_cores = (int)CPU_sysctlValue("hw.perflevel0.logicalcpu");
+        topology->efficiency_cores = topology->logical_cores - topology->performance_cores;
+    }
+}
+#endif /* __MACOSX__ */
+
+static SDL_CPUTopology SDL_CPUTopologyInfo;
+
+int
+SDL_GetCPUTopology(SDL_CPUTopology *topology)
+{
+    if (!topology) {
+        return SDL_InvalidParamError("topology");
+    }
+
+    if (!SDL_CPUTopologyInfo.logical_cores) {
+        SDL_CPUTopology info;
+
+        SDL_zero(info);
+        info.logical_cores = SDL_GetCPUCount();
+        info.physical_cores = info.logical_cores;
+        info.packages = 1;
+        info.numa_nodes = 1;
+        info.cache_line_size = SDL_GetCPUCacheLineSize();
+
+#ifndef SDL_CPUINFO_DISABLED
+        CPU_calcCPUIDTopology(&info);
+#if defined(__LINUX__)
+        CPU_calcSysfsTopology(&info);
+#elif defined(__MACOSX__) && defined(HAVE_SYSCTLBYNAME)
+        CPU_calcSysctlTopology(&info);
+#endif
+#endif
+        if (info.physical_cores <= 0 || info.physical_cores > info.logical_cores) {
+            info.physical_cores = info.logical_cores;
+        }
+        if (info.performance_cores <= 0) {
+            info.performance_cores = info.logical_cores;
+            info.efficiency_cores = 0;
+        }
+        SDL_CPUTopologyInfo = info;
+    }
+    *topology = SDL_CPUTopologyInfo;
+    return 0;
+}
+
 static Uint32 SDL_CPUFeatures = 0xFFFFFFFF;
 
 static Uint32
@@ -730,6 +1129,17 @@ main()
     printf("CPU type: %s\n", SDL_GetCPUType());
     printf("CPU name: %s\n", SDL_GetCPUName());
     printf("CacheLine size: %d\n", SDL_GetCPUCacheLineSize());
+    {
+        SDL_CPUTopology topology;
+        SDL_GetCPUTopology(&topology);
+        printf("Cores: %d logical, %d physical, %d performance, %d efficiency\n",
+               topology.logical_cores, topology.physical_cores,
+               topology.performance_cores, topology.efficiency_cores);
+        printf("Packages: %d, NUMA nodes: %d\n", topology.packages, topology.numa_nodes);
+        printf("Caches: L1d %d, L1i %d, L2 %d, L3 %d\n",
+               topology.l1d_cache_size, topology.l1i_cache_size,
+               topology.l2_cache_size, topology.l3_cache_size);
+    }
     printf("RDTSC: %d\n", SDL_HasRDTSC());
     printf("Altivec: %d\n", SDL_HasAltiVec());
     printf("MMX: %d\n", SDL_HasMMX());
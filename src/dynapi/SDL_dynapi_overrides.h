@@ -625,3 +625,50 @@
 #define SDL_GameControllerNumMappings SDL_GameControllerNumMappings_REAL
 #define SDL_GameControllerMappingForIndex SDL_GameControllerMappingForIndex_REAL
 #define SDL_JoystickGetAxisInitialState SDL_JoystickGetAxisInitialState_REAL
+#define SDL_CreateTextureAtlas SDL_CreateTextureAtlas_REAL
+#define SDL_AtlasAddSurface SDL_AtlasAddSurface_REAL
+#define SDL_AtlasRemoveEntry SDL_AtlasRemoveEntry_REAL
+#define SDL_AtlasQueryEntry SDL_AtlasQueryEntry_REAL
+#define SDL_RenderCopyAtlasEntry SDL_RenderCopyAtlasEntry_REAL
+#define SDL_AtlasRepack SDL_AtlasRepack_REAL
+#define SDL_DestroyTextureAtlas SDL_DestroyTextureAtlas_REAL
+#define SDL_SetYUVConversionMode SDL_SetYUVConversionMode_REAL
+#define SDL_GetYUVConversionMode SDL_GetYUVConversionMode_REAL
+#define SDL_GetYUVConversionModeForResolution SDL_GetYUVConversionModeForResolution_REAL
+#define SDL_PremultiplyAlpha SDL_PremultiplyAlpha_REAL
+#define SDL_RWFromMappedFile SDL_RWFromMappedFile_REAL
+#define SDL_RWGetPointer SDL_RWGetPointer_REAL
+#define SDL_RWFromBufferedRW SDL_RWFromBufferedRW_REAL
+#define SDL_GetMemoryFunctions SDL_GetMemoryFunctions_REAL
+#define SDL_SetMemoryFunctions SDL_SetMemoryFunctions_REAL
+#define SDL_GetNumAllocations SDL_GetNumAllocations_REAL
+#define SDL_GetMemoryFunctionsForTag SDL_GetMemoryFunctionsForTag_REAL
+#define SDL_SetMemoryFunctionsForTag SDL_SetMemoryFunctionsForTag_REAL
+#define SDL_GetNumAllocationsForTag SDL_GetNumAllocationsForTag_REAL
+#define SDL_GetHintHandle SDL_GetHintHandle_REAL
+#define SDL_GetHintFromHandle SDL_GetHintFromHandle_REAL
+#define SDL_GetLockStats SDL_GetLockStats_REAL
+#define SDL_ResetLockStats SDL_ResetLockStats_REAL
+#define SDL_CreateFastMutex SDL_CreateFastMutex_REAL
+#define SDL_CreateRWLock SDL_CreateRWLock_REAL
+#define SDL_LockRWLockForReading SDL_LockRWLockForReading_REAL
+#define SDL_LockRWLockForWriting SDL_LockRWLockForWriting_REAL
+#define SDL_TryLockRWLockForReading SDL_TryLockRWLockForReading_REAL
+#define SDL_TryLockRWLockForWriting SDL_TryLockRWLockForWriting_REAL
+#define SDL_UnlockRWLock SDL_UnlockRWLock_REAL
+#define SDL_DestroyRWLock SDL_DestroyRWLock_REAL
+#define SDL_CreateRingBuffer SDL_CreateRingBuffer_REAL
+#define SDL_WriteRingBuffer SDL_WriteRingBuffer_REAL
+#define SDL_ReadRingBuffer SDL_ReadRingBuffer_REAL
+#define SDL_GetRingBufferAvailable SDL_GetRingBufferAvailable_REAL
+#define SDL_GetRingBufferCapacity SDL_GetRingBufferCapacity_REAL
+#define SDL_DestroyRingBuffer SDL_DestroyRingBuffer_REAL
+#define SDL_CreateAtomicQueue SDL_CreateAtomicQueue_REAL
+#define SDL_AtomicQueuePush SDL_AtomicQueuePush_REAL
+#define SDL_AtomicQueuePop SDL_AtomicQueuePop_REAL
+#define SDL_DestroyAtomicQueue SDL_DestroyAtomicQueue_REAL
+#define SDL_LogSetAsync SDL_LogSetAsync_REAL
+#define SDL_LogFlush SDL_LogFlush_REAL
+#define SDL_GetCPUTopology SDL_GetCPUTopology_REAL
+#define SDL_SetThreadAffinityMask SDL_SetThreadAffinityMask_REAL
+#define SDL_GetThreadAffinityMask SDL_GetThreadAffinityMask_REAL
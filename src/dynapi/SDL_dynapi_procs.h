@@ -657,3 +657,50 @@ SDL_DYNAPI_PROC(SDL_bool,SDL_HasNEON,(void),(),return)
 SDL_DYNAPI_PROC(int,SDL_GameControllerNumMappings,(void),(),return)
 SDL_DYNAPI_PROC(char*,SDL_GameControllerMappingForIndex,(int a),(a),return)
 SDL_DYNAPI_PROC(SDL_bool,SDL_JoystickGetAxisInitialState,(SDL_Joystick *a, int b, Sint16 *c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_TextureAtlas*,SDL_CreateTextureAtlas,(SDL_Renderer *a, Uint32 b, int c, int d, int e, Uint32 f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(SDL_AtlasEntryID,SDL_AtlasAddSurface,(SDL_TextureAtlas *a, SDL_Surface *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_AtlasRemoveEntry,(SDL_TextureAtlas *a, SDL_AtlasEntryID b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_AtlasQueryEntry,(SDL_TextureAtlas *a, SDL_AtlasEntryID b, SDL_Texture **c, SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_RenderCopyAtlasEntry,(SDL_TextureAtlas *a, SDL_AtlasEntryID b, const SDL_Rect *c, const SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_AtlasRepack,(SDL_TextureAtlas *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyTextureAtlas,(SDL_TextureAtlas *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_SetYUVConversionMode,(SDL_YUV_CONVERSION_MODE a),(a),)
+SDL_DYNAPI_PROC(SDL_YUV_CONVERSION_MODE,SDL_GetYUVConversionMode,(void),(),return)
+SDL_DYNAPI_PROC(SDL_YUV_CONVERSION_MODE,SDL_GetYUVConversionModeForResolution,(int a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromMappedFile,(const char *a),(a),return)
+SDL_DYNAPI_PROC(const void*,SDL_RWGetPointer,(SDL_RWops *a, size_t *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromBufferedRW,(SDL_RWops *a, size_t b, SDL_bool c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_GetMemoryFunctions,(SDL_malloc_func *a, SDL_calloc_func *b, SDL_realloc_func *c, SDL_free_func *d),(a,b,c,d),)
+SDL_DYNAPI_PROC(int,SDL_SetMemoryFunctions,(SDL_malloc_func a, SDL_calloc_func b, SDL_realloc_func c, SDL_free_func d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_GetNumAllocations,(void),(),return)
+SDL_DYNAPI_PROC(void,SDL_GetMemoryFunctionsForTag,(SDL_MemoryTag a, SDL_malloc_func *b, SDL_calloc_func *c, SDL_realloc_func *d, SDL_free_func *e),(a,b,c,d,e),)
+SDL_DYNAPI_PROC(int,SDL_SetMemoryFunctionsForTag,(SDL_MemoryTag a, SDL_malloc_func b, SDL_calloc_func c, SDL_realloc_func d, SDL_free_func e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(int,SDL_GetNumAllocationsForTag,(SDL_MemoryTag a),(a),return)
+SDL_DYNAPI_PROC(SDL_HintHandle*,SDL_GetHintHandle,(const char *a),(a),return)
+SDL_DYNAPI_PROC(const char*,SDL_GetHintFromHandle,(SDL_HintHandle *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_GetLockStats,(SDL_LockStats *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_ResetLockStats,(void),(),)
+SDL_DYNAPI_PROC(SDL_mutex*,SDL_CreateFastMutex,(void),(),return)
+SDL_DYNAPI_PROC(SDL_RWLock*,SDL_CreateRWLock,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForReading,(SDL_RWLock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForWriting,(SDL_RWLock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForReading,(SDL_RWLock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForWriting,(SDL_RWLock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_UnlockRWLock,(SDL_RWLock *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRWLock,(SDL_RWLock *a),(a),)
+SDL_DYNAPI_PROC(SDL_RingBuffer*,SDL_CreateRingBuffer,(size_t a),(a),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteRingBuffer,(SDL_RingBuffer *a, const void *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadRingBuffer,(SDL_RingBuffer *a, void *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_GetRingBufferAvailable,(SDL_RingBuffer *a),(a),return)
+SDL_DYNAPI_PROC(size_t,SDL_GetRingBufferCapacity,(SDL_RingBuffer *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRingBuffer,(SDL_RingBuffer *a),(a),)
+SDL_DYNAPI_PROC(SDL_AtomicQueue*,SDL_CreateAtomicQueue,(size_t a, size_t b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_AtomicQueuePush,(SDL_AtomicQueue *a, const void *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_AtomicQueuePop,(SDL_AtomicQueue *a, void *b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyAtomicQueue,(SDL_AtomicQueue *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_LogSetAsync,(SDL_bool a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_LogFlush,(void),(),)
+SDL_DYNAPI_PROC(int,SDL_GetCPUTopology,(SDL_CPUTopology *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_SetThreadAffinityMask,(Uint64 a),(a),return)
+SDL_DYNAPI_PROC(Uint64,SDL_GetThreadAffinityMask,(void),(),return)
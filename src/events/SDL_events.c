@@ -28,6 +28,7 @@
 #include "SDL_thread.h"
 #include "SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 #if !SDL_JOYSTICK_DISABLED
 #include "../joystick/SDL_joystick_c.h"
 #endif
@@ -334,22 +335,22 @@ SDL_StopEventLoop(void)
     /* Clean out EventQ */
     for (entry = SDL_EventQ.head; entry; ) {
         SDL_EventEntry *next = entry->next;
-        SDL_free(entry);
+        SDL_TaggedFree(SDL_MEMORY_TAG_EVENTS, entry);
         entry = next;
     }
     for (entry = SDL_EventQ.free; entry; ) {
         SDL_EventEntry *next = entry->next;
-        SDL_free(entry);
+        SDL_TaggedFree(SDL_MEMORY_TAG_EVENTS, entry);
         entry = next;
     }
     for (wmmsg = SDL_EventQ.wmmsg_used; wmmsg; ) {
         SDL_SysWMEntry *next = wmmsg->next;
-        SDL_free(wmmsg);
+        SDL_TaggedFree(SDL_MEMORY_TAG_EVENTS, wmmsg);
         wmmsg = next;
     }
     for (wmmsg = SDL_EventQ.wmmsg_free; wmmsg; ) {
         SDL_SysWMEntry *next = wmmsg->next;
-        SDL_free(wmmsg);
+        SDL_TaggedFree(SDL_MEMORY_TAG_EVENTS, wmmsg);
         wmmsg = next;
     }
 
@@ -426,7 +427,7 @@ SDL_AddEvent(SDL_Event * event)
     }
 
     if (SDL_EventQ.free == NULL) {
-        entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
+        entry = (SDL_EventEntry *)SDL_TaggedMalloc(SDL_MEMORY_TAG_EVENTS, sizeof(*entry));
         if (!entry) {
             return 0;
         }
@@ -546,7 +547,7 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                                 wmmsg = SDL_EventQ.wmmsg_free;
                                 SDL_EventQ.wmmsg_free = wmmsg->next;
                             } else {
-                                wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
+                                wmmsg = (SDL_SysWMEntry *)SDL_TaggedMalloc(SDL_MEMORY_TAG_EVENTS, sizeof(*wmmsg));
                             }
                             wmmsg->msg = *entry->event.syswm.msg;
                             wmmsg->next = SDL_EventQ.wmmsg_used;
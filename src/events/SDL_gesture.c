@@ -222,6 +222,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 {
     int i,loaded = 0;
     SDL_GestureTouch *touch = NULL;
+    SDL_RWops *buffered = NULL;
     if (src == NULL) return 0;
     if (touchId >= 0) {
         for (i = 0; i < SDL_numGestureTouches; i++) {
@@ -234,12 +235,20 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
         }
     }
 
+    /* Templates are read one at a time, so buffer custom streams */
+    if (src->type == SDL_RWOPS_UNKNOWN) {
+        buffered = SDL_RWFromBufferedRW(src, 0, SDL_FALSE);
+        if (buffered) {
+            src = buffered;
+        }
+    }
+
     while (1) {
         SDL_DollarTemplate templ;
 
         if (SDL_RWread(src,templ.path,sizeof(templ.path[0]),DOLLARNPOINTS) < DOLLARNPOINTS) {
             if (loaded == 0) {
-                return SDL_SetError("could not read any dollar gesture from rwops");
+                loaded = SDL_SetError("could not read any dollar gesture from rwops");
             }
             break;
         }
@@ -269,6 +278,9 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
         }
     }
 
+    if (buffered) {
+        SDL_RWclose(buffered);
+    }
     return loaded;
 }
 
@@ -47,6 +47,14 @@
 #include "nacl_io/nacl_io.h"
 #endif
 
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #ifdef __WIN32__
 
 /* Functions to read/write Win32 API file pointers */
@@ -459,6 +467,281 @@ mem_close(SDL_RWops * context)
     return 0;
 }
 
+#ifdef HAVE_MMAP
+/* Memory mapped files use the memory stream functions for everything but
+   closing, which has to unmap the file.
+ */
+
+static int SDLCALL
+mmap_close(SDL_RWops * context)
+{
+    int status = 0;
+    if (context) {
+        if (munmap(context->hidden.mem.base, (size_t)(context->hidden.mem.stop - context->hidden.mem.base)) < 0) {
+            status = SDL_SetError("Couldn't unmap file");
+        }
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
+static SDL_RWops *
+SDL_RWFromMapping(const char *file)
+{
+    SDL_RWops *rwops;
+    struct stat st;
+    void *base;
+    int flags = O_RDONLY;
+    int fd;
+
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+    fd = open(file, flags);
+    if (fd < 0) {
+        return NULL;
+    }
+    /* Empty files can't be mapped, and other files may not have a size */
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (Uint64)st.st_size > (Uint64)(~(size_t)0)) {
+        close(fd);
+        return NULL;
+    }
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+#ifdef MADV_SEQUENTIAL
+    /* Most files are read from start to end, so prefetch aggressively */
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+    madvise(base, (size_t)st.st_size, MADV_WILLNEED);
+#endif
+
+    rwops = SDL_AllocRW();
+    if (rwops == NULL) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    rwops->size = mem_size;
+    rwops->seek = mem_seek;
+    rwops->read = mem_read;
+    rwops->write = mem_writeconst;
+    rwops->close = mmap_close;
+    rwops->hidden.mem.base = (Uint8 *) base;
+    rwops->hidden.mem.here = rwops->hidden.mem.base;
+    rwops->hidden.mem.stop = rwops->hidden.mem.base + st.st_size;
+    rwops->type = SDL_RWOPS_MAPPED;
+    return rwops;
+}
+#endif /* HAVE_MMAP */
+
+/* Functions to buffer another SDL_RWops
+
+   The buffer either holds data read ahead from the source, in which case
+   the source is positioned after it, or data waiting to be written, in
+   which case the source is positioned where that data goes.
+ */
+
+#define SDL_RWBUFFER_DEFAULT_SIZE   4096
+
+typedef struct SDL_RWBuffer
+{
+    SDL_RWops *src;
+    SDL_bool autoclose;
+    SDL_bool dirty;     /* the buffer holds data to be written */
+    Uint8 *data;
+    size_t size;        /* size of the buffer */
+    size_t pos;         /* read or write position in the buffer */
+    size_t len;         /* amount of data read ahead */
+    Sint64 offset;      /* stream position of the start of the buffer */
+} SDL_RWBuffer;
+
+static int
+buffer_flush(SDL_RWBuffer * buffer)
+{
+    size_t written;
+
+    if (buffer->dirty) {
+        written = SDL_RWwrite(buffer->src, buffer->data, 1, buffer->pos);
+        buffer->offset += written;
+        buffer->dirty = SDL_FALSE;
+        if (written != buffer->pos) {
+            buffer->pos = buffer->len = 0;
+            return SDL_Error(SDL_EFWRITE);
+        }
+    } else if (buffer->pos < buffer->len) {
+        /* Put the source back where the reader is */
+        buffer->offset += buffer->pos;
+        if (SDL_RWseek(buffer->src, buffer->offset, RW_SEEK_SET) < 0) {
+            buffer->pos = buffer->len = 0;
+            return -1;
+        }
+    } else {
+        buffer->offset += buffer->len;
+    }
+    buffer->pos = buffer->len = 0;
+    return 0;
+}
+
+static Sint64 SDLCALL
+buffer_size(SDL_RWops * context)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+
+    if (buffer->dirty && buffer_flush(buffer) < 0) {
+        return -1;
+    }
+    return SDL_RWsize(buffer->src);
+}
+
+static Sint64 SDLCALL
+buffer_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    Sint64 pos;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        break;
+    case RW_SEEK_CUR:
+        offset += buffer->offset + buffer->pos;
+        break;
+    case RW_SEEK_END:
+        if (buffer_flush(buffer) < 0) {
+            return -1;
+        }
+        pos = SDL_RWseek(buffer->src, offset, RW_SEEK_END);
+        if (pos >= 0) {
+            buffer->offset = pos;
+        }
+        return pos;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    /* Seeking within the data read ahead doesn't touch the source */
+    if (!buffer->dirty &&
+        offset >= buffer->offset && offset <= buffer->offset + (Sint64) buffer->len) {
+        buffer->pos = (size_t) (offset - buffer->offset);
+        return offset;
+    }
+    if (offset == buffer->offset + (Sint64) buffer->pos) {
+        return offset;
+    }
+    if (buffer_flush(buffer) < 0) {
+        return -1;
+    }
+    pos = SDL_RWseek(buffer->src, offset, RW_SEEK_SET);
+    if (pos >= 0) {
+        buffer->offset = pos;
+    }
+    return pos;
+}
+
+static size_t SDLCALL
+buffer_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    Uint8 *dst = (Uint8 *) ptr;
+    size_t total_bytes, total_read, amount;
+
+    total_bytes = (maxnum * size);
+    if ((maxnum <= 0) || (size <= 0)
+        || ((total_bytes / maxnum) != (size_t) size)) {
+        return 0;
+    }
+    if (buffer->dirty && buffer_flush(buffer) < 0) {
+        return 0;
+    }
+
+    total_read = 0;
+    while (total_read < total_bytes) {
+        if (buffer->pos < buffer->len) {
+            amount = SDL_min(total_bytes - total_read, buffer->len - buffer->pos);
+            SDL_memcpy(dst + total_read, buffer->data + buffer->pos, amount);
+            buffer->pos += amount;
+            total_read += amount;
+            continue;
+        }
+
+        buffer->offset += buffer->len;
+        buffer->pos = buffer->len = 0;
+        if ((total_bytes - total_read) >= buffer->size) {
+            /* Large reads go straight to the destination */
+            amount = SDL_RWread(buffer->src, dst + total_read, 1, total_bytes - total_read);
+            buffer->offset += amount;
+        } else {
+            amount = SDL_RWread(buffer->src, buffer->data, 1, buffer->size);
+            buffer->len = amount;
+            amount = SDL_min(amount, total_bytes - total_read);
+            SDL_memcpy(dst + total_read, buffer->data, amount);
+            buffer->pos = amount;
+        }
+        if (amount == 0) {
+            break;
+        }
+        total_read += amount;
+    }
+    return (total_read / size);
+}
+
+static size_t SDLCALL
+buffer_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    size_t total_bytes;
+
+    total_bytes = (num * size);
+    if ((num <= 0) || (size <= 0) || ((total_bytes / num) != (size_t) size)) {
+        return 0;
+    }
+    if (!buffer->dirty && buffer_flush(buffer) < 0) {
+        return 0;
+    }
+
+    if (buffer->pos + total_bytes > buffer->size) {
+        if (buffer_flush(buffer) < 0) {
+            return 0;
+        }
+        if (total_bytes >= buffer->size) {
+            /* Large writes go straight to the source */
+            total_bytes = SDL_RWwrite(buffer->src, ptr, 1, total_bytes);
+            buffer->offset += total_bytes;
+            return (total_bytes / size);
+        }
+    }
+    SDL_memcpy(buffer->data + buffer->pos, ptr, total_bytes);
+    buffer->pos += total_bytes;
+    buffer->dirty = SDL_TRUE;
+    return num;
+}
+
+static int SDLCALL
+buffer_close(SDL_RWops * context)
+{
+    SDL_RWBuffer *buffer;
+    int status = 0;
+
+    if (context) {
+        buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+        if (buffer->dirty || !buffer->autoclose) {
+            status = buffer_flush(buffer);
+        }
+        if (buffer->autoclose) {
+            if (SDL_RWclose(buffer->src) < 0) {
+                status = -1;
+            }
+        }
+        SDL_free(buffer->data);
+        SDL_free(buffer);
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -633,6 +916,102 @@ SDL_RWFromConstMem(const void *mem, int size)
     return rwops;
 }
 
+SDL_RWops *
+SDL_RWFromMappedFile(const char *file)
+{
+    SDL_RWops *rwops = NULL;
+    if (!file || !*file) {
+        SDL_SetError("SDL_RWFromMappedFile(): No file specified");
+        return NULL;
+    }
+#ifdef HAVE_MMAP
+#if defined(__ANDROID__) || defined(__APPLE__)
+    /* Relative paths may name Android assets or bundle resources, which
+       only SDL_RWFromFile() knows how to find. */
+    if (*file == '/') {
+        rwops = SDL_RWFromMapping(file);
+    }
+#else
+    rwops = SDL_RWFromMapping(file);
+#endif
+#endif /* HAVE_MMAP */
+    if (rwops == NULL) {
+        rwops = SDL_RWFromFile(file, "rb");
+    }
+    return rwops;
+}
+
+SDL_RWops *
+SDL_RWFromBufferedRW(SDL_RWops * src, size_t size, SDL_bool autoclose)
+{
+    SDL_RWops *rwops;
+    SDL_RWBuffer *buffer;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+    if (!size) {
+        size = SDL_RWBUFFER_DEFAULT_SIZE;
+    }
+
+    buffer = (SDL_RWBuffer *) SDL_calloc(1, sizeof(*buffer));
+    if (buffer == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    buffer->data = (Uint8 *) SDL_malloc(size);
+    if (buffer->data == NULL) {
+        SDL_free(buffer);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rwops = SDL_AllocRW();
+    if (rwops == NULL) {
+        SDL_free(buffer->data);
+        SDL_free(buffer);
+        return NULL;
+    }
+    buffer->src = src;
+    buffer->autoclose = autoclose;
+    buffer->size = size;
+    /* Streams that can't tell their position are treated as starting at 0 */
+    buffer->offset = SDL_max(SDL_RWtell(src), 0);
+
+    rwops->size = buffer_size;
+    rwops->seek = buffer_seek;
+    rwops->read = buffer_read;
+    rwops->write = buffer_write;
+    rwops->close = buffer_close;
+    rwops->hidden.unknown.data1 = buffer;
+    rwops->type = SDL_RWOPS_BUFFERED;
+    return rwops;
+}
+
+const void *
+SDL_RWGetPointer(SDL_RWops * context, size_t * size)
+{
+    if (!context) {
+        SDL_InvalidParamError("context");
+        return NULL;
+    }
+    switch (context->type) {
+    case SDL_RWOPS_MEMORY:
+    case SDL_RWOPS_MEMORY_RO:
+    case SDL_RWOPS_MAPPED:
+        if (size) {
+            *size = (size_t)(context->hidden.mem.stop - context->hidden.mem.here);
+        }
+        return context->hidden.mem.here;
+    default:
+        break;
+    }
+    if (size) {
+        *size = 0;
+    }
+    return NULL;
+}
+
 SDL_RWops *
 SDL_AllocRW(void)
 {
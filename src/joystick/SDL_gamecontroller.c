@@ -841,20 +841,98 @@ static ControllerMapping_t *SDL_PrivateGetControllerMapping(int device_index)
     return mapping;
 }
 
+/*
+ * Checks the platform field of a mapping line, which isn't NUL terminated
+ */
+static SDL_bool
+SDL_PrivateMappingLineMatchesPlatform(const char *line, size_t length, const char *platform)
+{
+    const size_t field_len = SDL_strlen(SDL_CONTROLLER_PLATFORM_FIELD);
+    size_t i, end;
+
+    for (i = 0; i + field_len <= length; ++i) {
+        if (SDL_memcmp(&line[i], SDL_CONTROLLER_PLATFORM_FIELD, field_len) == 0) {
+            i += field_len;
+            for (end = i; end < length && line[end] != ','; ++end) {
+                continue;
+            }
+            if (end == length || SDL_strlen(platform) != (end - i)) {
+                return SDL_FALSE;
+            }
+            return (SDL_strncasecmp(&line[i], platform, end - i) == 0);
+        }
+    }
+    return SDL_FALSE;
+}
+
+/*
+ * Add the mappings for this platform from a database in memory, copying
+ * only the lines that are actually used
+ */
+static int
+SDL_PrivateGameControllerAddMappingsFromMemory(const char *db, size_t db_size)
+{
+    const char *platform = SDL_GetPlatform();
+    const char *line, *line_end, *db_end = db + db_size;
+    char *mapping = NULL, *new_mapping;
+    size_t mapping_size = 0, line_len;
+    int controllers = 0;
+
+    for (line = db; line < db_end; line = line_end + 1) {
+        for (line_end = line; line_end < db_end && *line_end != '\n'; ++line_end) {
+            continue;
+        }
+        line_len = (line_end - line);
+
+        /* Extract and verify the platform */
+        if (!SDL_PrivateMappingLineMatchesPlatform(line, line_len, platform)) {
+            continue;
+        }
+        if (line_len + 1 > mapping_size) {
+            new_mapping = (char *)SDL_realloc(mapping, line_len + 1);
+            if (new_mapping == NULL) {
+                SDL_free(mapping);
+                return SDL_OutOfMemory();
+            }
+            mapping = new_mapping;
+            mapping_size = line_len + 1;
+        }
+        SDL_memcpy(mapping, line, line_len);
+        mapping[line_len] = '\0';
+        if (SDL_GameControllerAddMapping(mapping) > 0) {
+            controllers++;
+        }
+    }
+
+    SDL_free(mapping);
+    return controllers;
+}
+
 /*
  * Add or update an entry into the Mappings Database
  */
 int
 SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
 {
-    const char *platform = SDL_GetPlatform();
-    int controllers = 0;
-    char *buf, *line, *line_end, *tmp, *comma, line_platform[64];
-    size_t db_size, platform_len;
+    int controllers;
+    const char *db;
+    char *buf;
+    size_t db_size;
     
     if (rw == NULL) {
         return SDL_SetError("Invalid RWops");
     }
+
+    /* Memory streams and mapped files can be parsed where they are */
+    db = (const char *)SDL_RWGetPointer(rw, &db_size);
+    if (db != NULL) {
+        controllers = SDL_PrivateGameControllerAddMappingsFromMemory(db, db_size);
+        if (freerw) {
+            SDL_RWclose(rw);
+        }
+        return controllers;
+    }
+
     db_size = (size_t)SDL_RWsize(rw);
     
     buf = (char *)SDL_malloc(db_size + 1);
@@ -876,38 +954,8 @@ SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
     if (freerw) {
         SDL_RWclose(rw);
     }
-    
-    buf[db_size] = '\0';
-    line = buf;
-    
-    while (line < buf + db_size) {
-        line_end = SDL_strchr(line, '\n');
-        if (line_end != NULL) {
-            *line_end = '\0';
-        } else {
-            line_end = buf + db_size;
-        }
-        
-        /* Extract and verify the platform */
-        tmp = SDL_strstr(line, SDL_CONTROLLER_PLATFORM_FIELD);
-        if (tmp != NULL) {
-            tmp += SDL_strlen(SDL_CONTROLLER_PLATFORM_FIELD);
-            comma = SDL_strchr(tmp, ',');
-            if (comma != NULL) {
-                platform_len = comma - tmp + 1;
-                if (platform_len + 1 < SDL_arraysize(line_platform)) {
-                    SDL_strlcpy(line_platform, tmp, platform_len);
-                    if (SDL_strncasecmp(line_platform, platform, platform_len) == 0 &&
-                        SDL_GameControllerAddMapping(line) > 0) {
-                        controllers++;
-                    }
-                }
-            }
-        }
-        
-        line = line_end + 1;
-    }
 
+    controllers = SDL_PrivateGameControllerAddMappingsFromMemory(buf, db_size);
     SDL_free(buf);
     return controllers;
 }
@@ -1232,8 +1280,10 @@ SDL_GameControllerOpen(int device_index)
     /* Add the controller to list */
     ++gamecontroller->ref_count;
     /* Link the controller in the list */
+    SDL_LockJoystickLinks(SDL_TRUE);
     gamecontroller->next = SDL_gamecontrollers;
     SDL_gamecontrollers = gamecontroller;
+    SDL_UnlockJoystickLinks();
 
     SDL_UnlockJoystickList();
 
@@ -1408,16 +1458,16 @@ SDL_GameControllerFromInstanceID(SDL_JoystickID joyid)
 {
     SDL_GameController *gamecontroller;
 
-    SDL_LockJoystickList();
+    SDL_LockJoystickLinks(SDL_FALSE);
     gamecontroller = SDL_gamecontrollers;
     while (gamecontroller) {
         if (gamecontroller->joystick->instance_id == joyid) {
-            SDL_UnlockJoystickList();
+            SDL_UnlockJoystickLinks();
             return gamecontroller;
         }
         gamecontroller = gamecontroller->next;
     }
-    SDL_UnlockJoystickList();
+    SDL_UnlockJoystickLinks();
     return NULL;
 }
 
@@ -1503,6 +1553,7 @@ SDL_GameControllerClose(SDL_GameController * gamecontroller)
 
     SDL_JoystickClose(gamecontroller->joystick);
 
+    SDL_LockJoystickLinks(SDL_TRUE);
     gamecontrollerlist = SDL_gamecontrollers;
     gamecontrollerlistprev = NULL;
     while (gamecontrollerlist) {
@@ -1518,6 +1569,7 @@ SDL_GameControllerClose(SDL_GameController * gamecontroller)
         gamecontrollerlistprev = gamecontrollerlist;
         gamecontrollerlist = gamecontrollerlist->next;
     }
+    SDL_UnlockJoystickLinks();
 
     SDL_free(gamecontroller->bindings);
     SDL_free(gamecontroller->last_match_axis);
@@ -30,12 +30,14 @@
 
 #if !SDL_EVENTS_DISABLED
 #include "../events/SDL_events_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 #endif
 
 static SDL_bool SDL_joystick_allows_background_events = SDL_FALSE;
 static SDL_Joystick *SDL_joysticks = NULL;
 static SDL_bool SDL_updating_joystick = SDL_FALSE;
 static SDL_mutex *SDL_joystick_lock = NULL; /* This needs to support recursive locks */
+static SDL_RWLock *SDL_joystick_links_lock = NULL;
 
 void
 SDL_LockJoystickList(void)
@@ -53,6 +55,26 @@ SDL_UnlockJoystickList(void)
     }
 }
 
+void
+SDL_LockJoystickLinks(SDL_bool write)
+{
+    if (SDL_joystick_links_lock) {
+        if (write) {
+            SDL_LockRWLockForWriting(SDL_joystick_links_lock);
+        } else {
+            SDL_LockRWLockForReading(SDL_joystick_links_lock);
+        }
+    }
+}
+
+void
+SDL_UnlockJoystickLinks(void)
+{
+    if (SDL_joystick_links_lock) {
+        SDL_UnlockRWLock(SDL_joystick_links_lock);
+    }
+}
+
 
 static void
 SDL_JoystickAllowBackgroundEventsChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
@@ -73,6 +95,9 @@ SDL_JoystickInit(void)
     if (!SDL_joystick_lock) {
         SDL_joystick_lock = SDL_CreateMutex();
     }
+    if (!SDL_joystick_links_lock) {
+        SDL_joystick_links_lock = SDL_CreateRWLock();
+    }
 
     /* See if we should allow joystick events while in the background */
     SDL_AddHintCallback(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS,
@@ -185,7 +210,7 @@ SDL_JoystickOpen(int device_index)
     }
 
     /* Create and initialize the joystick */
-    joystick = (SDL_Joystick *) SDL_malloc((sizeof *joystick));
+    joystick = (SDL_Joystick *) SDL_TaggedMalloc(SDL_MEMORY_TAG_JOYSTICK, (sizeof *joystick));
     if (joystick == NULL) {
         SDL_OutOfMemory();
         SDL_UnlockJoystickList();
@@ -194,7 +219,7 @@ SDL_JoystickOpen(int device_index)
 
     SDL_memset(joystick, 0, (sizeof *joystick));
     if (SDL_SYS_JoystickOpen(joystick, device_index) < 0) {
-        SDL_free(joystick);
+        SDL_TaggedFree(SDL_MEMORY_TAG_JOYSTICK, joystick);
         SDL_UnlockJoystickList();
         return NULL;
     }
@@ -206,16 +231,16 @@ SDL_JoystickOpen(int device_index)
         joystick->name = NULL;
 
     if (joystick->naxes > 0) {
-        joystick->axes = (SDL_JoystickAxisInfo *) SDL_calloc(joystick->naxes, sizeof(SDL_JoystickAxisInfo));
+        joystick->axes = (SDL_JoystickAxisInfo *) SDL_TaggedCalloc(SDL_MEMORY_TAG_JOYSTICK, joystick->naxes, sizeof(SDL_JoystickAxisInfo));
     }
     if (joystick->nhats > 0) {
-        joystick->hats = (Uint8 *) SDL_calloc(joystick->nhats, sizeof(Uint8));
+        joystick->hats = (Uint8 *) SDL_TaggedCalloc(SDL_MEMORY_TAG_JOYSTICK, joystick->nhats, sizeof(Uint8));
     }
     if (joystick->nballs > 0) {
-        joystick->balls = (struct balldelta *) SDL_calloc(joystick->nballs, sizeof(*joystick->balls));
+        joystick->balls = (struct balldelta *) SDL_TaggedCalloc(SDL_MEMORY_TAG_JOYSTICK, joystick->nballs, sizeof(*joystick->balls));
     }
     if (joystick->nbuttons > 0) {
-        joystick->buttons = (Uint8 *) SDL_calloc(joystick->nbuttons, sizeof(Uint8));
+        joystick->buttons = (Uint8 *) SDL_TaggedCalloc(SDL_MEMORY_TAG_JOYSTICK, joystick->nbuttons, sizeof(Uint8));
     }
     if (((joystick->naxes > 0) && !joystick->axes)
         || ((joystick->nhats > 0) && !joystick->hats)
@@ -240,8 +265,10 @@ SDL_JoystickOpen(int device_index)
     /* Add joystick to list */
     ++joystick->ref_count;
     /* Link the joystick in the list */
+    SDL_LockJoystickLinks(SDL_TRUE);
     joystick->next = SDL_joysticks;
     SDL_joysticks = joystick;
+    SDL_UnlockJoystickLinks();
 
     SDL_UnlockJoystickList();
 
@@ -459,14 +486,14 @@ SDL_JoystickFromInstanceID(SDL_JoystickID joyid)
 {
     SDL_Joystick *joystick;
 
-    SDL_LockJoystickList();
+    SDL_LockJoystickLinks(SDL_FALSE);
     for (joystick = SDL_joysticks; joystick; joystick = joystick->next) {
         if (joystick->instance_id == joyid) {
-            SDL_UnlockJoystickList();
+            SDL_UnlockJoystickLinks();
             return joystick;
         }
     }
-    SDL_UnlockJoystickList();
+    SDL_UnlockJoystickLinks();
     return NULL;
 }
 
@@ -512,6 +539,7 @@ SDL_JoystickClose(SDL_Joystick * joystick)
     SDL_SYS_JoystickClose(joystick);
     joystick->hwdata = NULL;
 
+    SDL_LockJoystickLinks(SDL_TRUE);
     joysticklist = SDL_joysticks;
     joysticklistprev = NULL;
     while (joysticklist) {
@@ -527,15 +555,16 @@ SDL_JoystickClose(SDL_Joystick * joystick)
         joysticklistprev = joysticklist;
         joysticklist = joysticklist->next;
     }
+    SDL_UnlockJoystickLinks();
 
     SDL_free(joystick->name);
 
     /* Free the data associated with this joystick */
-    SDL_free(joystick->axes);
-    SDL_free(joystick->hats);
-    SDL_free(joystick->balls);
-    SDL_free(joystick->buttons);
-    SDL_free(joystick);
+    SDL_TaggedFree(SDL_MEMORY_TAG_JOYSTICK, joystick->axes);
+    SDL_TaggedFree(SDL_MEMORY_TAG_JOYSTICK, joystick->hats);
+    SDL_TaggedFree(SDL_MEMORY_TAG_JOYSTICK, joystick->balls);
+    SDL_TaggedFree(SDL_MEMORY_TAG_JOYSTICK, joystick->buttons);
+    SDL_TaggedFree(SDL_MEMORY_TAG_JOYSTICK, joystick);
 
     SDL_UnlockJoystickList();
 }
@@ -567,6 +596,10 @@ SDL_JoystickQuit(void)
         SDL_DestroyMutex(SDL_joystick_lock);
         SDL_joystick_lock = NULL;
     }
+    if (SDL_joystick_links_lock) {
+        SDL_DestroyRWLock(SDL_joystick_links_lock);
+        SDL_joystick_links_lock = NULL;
+    }
 }
 
 
@@ -35,6 +35,13 @@ extern void SDL_GameControllerQuit(void);
 extern void SDL_LockJoystickList(void);
 extern void SDL_UnlockJoystickList(void);
 
+/* Code that adds or removes joysticks or game controllers holds the list
+   lock, and also locks the links for writing while it changes them, so
+   lookups by instance id only need to lock the links for reading.
+ */
+extern void SDL_LockJoystickLinks(SDL_bool write);
+extern void SDL_UnlockJoystickLinks(void);
+
 /* Internal event queueing functions */
 extern void SDL_PrivateJoystickAdded(int device_index);
 extern void SDL_PrivateJoystickRemoved(SDL_JoystickID device_instance);
@@ -0,0 +1,682 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Dynamic texture atlas built on top of the 2D rendering API.
+
+   Entries are packed into pages with a skyline bottom-left packer.  Each
+   page keeps a copy of its pixels in a surface, so the atlas can be
+   repacked without reading back from the renderer.
+ */
+
+#include "SDL_render.h"
+
+/* Empty pixels kept to the right and below each entry, so that linear
+   filtering doesn't pick up the neighbouring entries */
+#define ATLAS_PADDING   1
+
+/* Entry handles are the slot index + 1 in the low bits, and a generation
+   count in the high bits so stale handles are detected. */
+#define ATLAS_INDEX_BITS    20
+#define ATLAS_INDEX_MASK    ((1 << ATLAS_INDEX_BITS) - 1)
+#define ATLAS_MAKE_ID(index, generation) \
+    ((SDL_AtlasEntryID)(((Uint32)((generation) & 0xFFF) << ATLAS_INDEX_BITS) | (Uint32)((index) + 1)))
+
+typedef struct
+{
+    int x;
+    int y;
+    int w;
+} SDL_AtlasSkyline;
+
+typedef struct
+{
+    SDL_Texture *texture;
+    SDL_Surface *surface;       /* System memory copy of the page */
+    SDL_AtlasSkyline *skyline;
+    int num_skyline;
+} SDL_AtlasPage;
+
+typedef struct
+{
+    int page;                   /* -1 if this slot is unused */
+    SDL_Rect rect;
+    Uint32 generation;
+    Uint32 last_used;
+    int next_free;
+} SDL_AtlasEntry;
+
+struct SDL_TextureAtlas
+{
+    const void *magic;
+    SDL_Renderer *renderer;
+    Uint32 format;
+    int page_w;
+    int page_h;
+    int max_pages;
+    Uint32 flags;
+
+    SDL_AtlasPage *pages;
+    int num_pages;
+
+    SDL_AtlasEntry *entries;
+    int num_entries;
+    int max_entries;
+    int first_free;
+    int num_used;
+
+    /* Set when entries were removed since the last time the atlas was packed */
+    SDL_bool fragmented;
+
+    Uint32 clock;
+};
+
+static char atlas_magic;
+
+#define CHECK_ATLAS_MAGIC(atlas, retval) \
+    if (!atlas || atlas->magic != &atlas_magic) { \
+        SDL_SetError("Invalid texture atlas"); \
+        return retval; \
+    }
+
+
+static void
+SDL_ResetAtlasPage(SDL_TextureAtlas * atlas, SDL_AtlasPage * page)
+{
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->page_w;
+    page->num_skyline = 1;
+}
+
+static int
+SDL_InitAtlasPage(SDL_TextureAtlas * atlas, SDL_AtlasPage * page)
+{
+    SDL_zerop(page);
+
+    /* There can never be more skyline segments than pixel columns, plus one
+       while a new segment is being inserted */
+    page->skyline = (SDL_AtlasSkyline *) SDL_malloc((atlas->page_w + 1) * sizeof(*page->skyline));
+    if (!page->skyline) {
+        return SDL_OutOfMemory();
+    }
+    page->surface = SDL_CreateRGBSurfaceWithFormat(0, atlas->page_w, atlas->page_h,
+                                                   SDL_BITSPERPIXEL(atlas->format),
+                                                   atlas->format);
+    if (!page->surface) {
+        SDL_free(page->skyline);
+        return -1;
+    }
+    SDL_ResetAtlasPage(atlas, page);
+    return 0;
+}
+
+static void
+SDL_FreeAtlasPage(SDL_AtlasPage * page)
+{
+    if (page->texture) {
+        SDL_DestroyTexture(page->texture);
+    }
+    SDL_FreeSurface(page->surface);
+    SDL_free(page->skyline);
+    SDL_zerop(page);
+}
+
+/* Returns the lowest y at which a w pixel wide rectangle fits starting at
+   skyline segment i, or -1 if it doesn't fit at all */
+static int
+SDL_AtlasSkylineFit(SDL_TextureAtlas * atlas, SDL_AtlasPage * page, int i, int w, int h)
+{
+    int x = page->skyline[i].x;
+    int y = 0;
+    int remaining = w;
+
+    if (x + w > atlas->page_w) {
+        return -1;
+    }
+    while (remaining > 0) {
+        if (page->skyline[i].y > y) {
+            y = page->skyline[i].y;
+        }
+        if (y + h > atlas->page_h) {
+            return -1;
+        }
+        remaining -= page->skyline[i].w;
+        ++i;
+    }
+    return y;
+}
+
+static void
+SDL_AtlasSkylineAdd(SDL_AtlasPage * page, int i, const SDL_Rect * rect)
+{
+    SDL_AtlasSkyline *skyline = page->skyline;
+    int right = rect->x + rect->w;
+
+    SDL_memmove(&skyline[i + 1], &skyline[i], (page->num_skyline - i) * sizeof(*skyline));
+    skyline[i].x = rect->x;
+    skyline[i].y = rect->y + rect->h;
+    skyline[i].w = rect->w;
+    ++page->num_skyline;
+
+    /* Trim or remove the segments now hidden under the new one */
+    ++i;
+    while (i < page->num_skyline && skyline[i].x < right) {
+        int shrink = right - skyline[i].x;
+        if (shrink < skyline[i].w) {
+            skyline[i].x += shrink;
+            skyline[i].w -= shrink;
+            break;
+        }
+        SDL_memmove(&skyline[i], &skyline[i + 1], (page->num_skyline - i - 1) * sizeof(*skyline));
+        --page->num_skyline;
+    }
+
+    /* Merge neighbouring segments at the same height */
+    for (i = 0; i < page->num_skyline - 1; ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            SDL_memmove(&skyline[i + 1], &skyline[i + 2], (page->num_skyline - i - 2) * sizeof(*skyline));
+            --page->num_skyline;
+        } else {
+            ++i;
+        }
+    }
+}
+
+/* Find a spot for a w x h rectangle in the page, without padding.  Returns
+   the skyline segment it would rest on, or -1 if it doesn't fit. */
+static int
+SDL_AtlasFindInPage(SDL_TextureAtlas * atlas, SDL_AtlasPage * page, int w, int h, SDL_Rect * rect)
+{
+    int padded_w = SDL_min(w + ATLAS_PADDING, atlas->page_w);
+    int padded_h = SDL_min(h + ATLAS_PADDING, atlas->page_h);
+    int best = -1, best_bottom = 0, best_width = 0;
+    int i, y;
+
+    for (i = 0; i < page->num_skyline; ++i) {
+        y = SDL_AtlasSkylineFit(atlas, page, i, padded_w, padded_h);
+        if (y >= 0) {
+            int bottom = y + padded_h;
+            if (best < 0 || bottom < best_bottom ||
+                (bottom == best_bottom && page->skyline[i].w < best_width)) {
+                best = i;
+                best_bottom = bottom;
+                best_width = page->skyline[i].w;
+                rect->x = page->skyline[i].x;
+                rect->y = y;
+            }
+        }
+    }
+    rect->w = w;
+    rect->h = h;
+    return best;
+}
+
+/* Mark a spot returned by SDL_AtlasPack() as used */
+static void
+SDL_AtlasReserve(SDL_TextureAtlas * atlas, SDL_AtlasPage * page, int segment, const SDL_Rect * rect)
+{
+    SDL_Rect padded;
+
+    padded.x = rect->x;
+    padded.y = rect->y;
+    padded.w = SDL_min(rect->w + ATLAS_PADDING, atlas->page_w);
+    padded.h = SDL_min(rect->h + ATLAS_PADDING, atlas->page_h);
+    SDL_AtlasSkylineAdd(page, segment, &padded);
+}
+
+/* Find a spot for a rectangle in a set of pages, adding a page if needed and
+   allowed.  The spot stays free until it is passed to SDL_AtlasReserve(). */
+static int
+SDL_AtlasPack(SDL_TextureAtlas * atlas, SDL_AtlasPage ** pages, int *num_pages,
+              int w, int h, SDL_Rect * rect, int *segment)
+{
+    SDL_AtlasPage *new_pages;
+    int i;
+
+    for (i = 0; i < *num_pages; ++i) {
+        *segment = SDL_AtlasFindInPage(atlas, &(*pages)[i], w, h, rect);
+        if (*segment >= 0) {
+            return i;
+        }
+    }
+    if (atlas->max_pages > 0 && *num_pages >= atlas->max_pages) {
+        return -1;
+    }
+
+    new_pages = (SDL_AtlasPage *) SDL_realloc(*pages, (*num_pages + 1) * sizeof(*new_pages));
+    if (!new_pages) {
+        SDL_OutOfMemory();
+        return -2;
+    }
+    *pages = new_pages;
+    if (SDL_InitAtlasPage(atlas, &new_pages[*num_pages]) < 0) {
+        return -2;
+    }
+    i = (*num_pages)++;
+    *segment = SDL_AtlasFindInPage(atlas, &new_pages[i], w, h, rect);
+    return i;
+}
+
+static void
+SDL_AtlasCopyRect(SDL_Surface * src, const SDL_Rect * srcrect,
+                  SDL_Surface * dst, const SDL_Rect * dstrect)
+{
+    const int bpp = dst->format->BytesPerPixel;
+    const int length = srcrect->w * bpp;
+    const Uint8 *srcp = (const Uint8 *) src->pixels + srcrect->y * src->pitch + srcrect->x * bpp;
+    Uint8 *dstp = (Uint8 *) dst->pixels + dstrect->y * dst->pitch + dstrect->x * bpp;
+    int row;
+
+    for (row = srcrect->h; row--; ) {
+        SDL_memcpy(dstp, srcp, length);
+        srcp += src->pitch;
+        dstp += dst->pitch;
+    }
+}
+
+static int
+SDL_AtlasUploadPage(SDL_TextureAtlas * atlas, SDL_AtlasPage * page, const SDL_Rect * rect)
+{
+    const Uint8 *pixels = (const Uint8 *) page->surface->pixels;
+
+    if (!page->texture) {
+        page->texture = SDL_CreateTexture(atlas->renderer, atlas->format,
+                                          SDL_TEXTUREACCESS_STATIC,
+                                          atlas->page_w, atlas->page_h);
+        if (!page->texture) {
+            return -1;
+        }
+        if (SDL_ISPIXELFORMAT_ALPHA(atlas->format)) {
+            SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+        }
+        rect = NULL;
+    }
+    if (rect) {
+        pixels += rect->y * page->surface->pitch + rect->x * page->surface->format->BytesPerPixel;
+    }
+    return SDL_UpdateTexture(page->texture, rect, pixels, page->surface->pitch);
+}
+
+static int
+SDL_CompareAtlasEntries(const void *a, const void *b)
+{
+    const SDL_AtlasEntry *A = *(const SDL_AtlasEntry **) a;
+    const SDL_AtlasEntry *B = *(const SDL_AtlasEntry **) b;
+
+    if (A->rect.h != B->rect.h) {
+        return B->rect.h - A->rect.h;
+    }
+    return B->rect.w - A->rect.w;
+}
+
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format,
+                       int page_w, int page_h, int max_pages, Uint32 flags)
+{
+    SDL_TextureAtlas *atlas;
+
+    if (!renderer) {
+        SDL_InvalidParamError("renderer");
+        return NULL;
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format) ||
+        SDL_BYTESPERPIXEL(format) == 0) {
+        SDL_SetError("Texture atlas pages must use a packed RGB format");
+        return NULL;
+    }
+    if (page_w <= 0 || page_h <= 0) {
+        SDL_SetError("Texture atlas page dimensions must be positive");
+        return NULL;
+    }
+    if (max_pages < 0) {
+        SDL_InvalidParamError("max_pages");
+        return NULL;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof(*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->magic = &atlas_magic;
+    atlas->renderer = renderer;
+    atlas->format = format;
+    atlas->page_w = page_w;
+    atlas->page_h = page_h;
+    atlas->max_pages = max_pages;
+    atlas->flags = flags;
+    atlas->first_free = -1;
+    return atlas;
+}
+
+static SDL_AtlasEntry *
+SDL_GetAtlasEntry(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id)
+{
+    int index = (int)(id & ATLAS_INDEX_MASK) - 1;
+    SDL_AtlasEntry *entry;
+
+    if (index < 0 || index >= atlas->num_entries) {
+        return NULL;
+    }
+    entry = &atlas->entries[index];
+    if (entry->page < 0 || ATLAS_MAKE_ID(index, entry->generation) != id) {
+        return NULL;
+    }
+    return entry;
+}
+
+static void
+SDL_ReleaseAtlasEntry(SDL_TextureAtlas * atlas, SDL_AtlasEntry * entry)
+{
+    entry->page = -1;
+    ++entry->generation;
+    entry->next_free = atlas->first_free;
+    atlas->first_free = (int)(entry - atlas->entries);
+    --atlas->num_used;
+    atlas->fragmented = SDL_TRUE;
+}
+
+/* Evict the least recently used entries until at least 'area' pixels are
+   freed.  Returns the number of entries evicted. */
+static int
+SDL_AtlasEvict(SDL_TextureAtlas * atlas, int area)
+{
+    int evicted = 0;
+
+    while (area > 0 && atlas->num_used > 0) {
+        SDL_AtlasEntry *oldest = NULL;
+        int i;
+
+        for (i = 0; i < atlas->num_entries; ++i) {
+            SDL_AtlasEntry *entry = &atlas->entries[i];
+            if (entry->page >= 0 &&
+                (!oldest || (Sint32)(entry->last_used - oldest->last_used) < 0)) {
+                oldest = entry;
+            }
+        }
+        area -= (oldest->rect.w + ATLAS_PADDING) * (oldest->rect.h + ATLAS_PADDING);
+        SDL_ReleaseAtlasEntry(atlas, oldest);
+        ++evicted;
+    }
+    return evicted;
+}
+
+SDL_AtlasEntryID
+SDL_AtlasAddSurface(SDL_TextureAtlas * atlas, SDL_Surface * surface)
+{
+    SDL_Surface *converted;
+    SDL_AtlasEntry *entry;
+    SDL_Rect rect, srcrect;
+    int index, segment, num_pages, page = -1;
+
+    CHECK_ATLAS_MAGIC(atlas, 0);
+
+    if (!surface) {
+        SDL_InvalidParamError("surface");
+        return 0;
+    }
+    if (surface->w <= 0 || surface->h <= 0 ||
+        surface->w > atlas->page_w || surface->h > atlas->page_h) {
+        SDL_SetError("Surface doesn't fit in a texture atlas page");
+        return 0;
+    }
+
+    if (atlas->first_free < 0 && atlas->num_entries == ATLAS_INDEX_MASK) {
+        SDL_SetError("Texture atlas has too many entries");
+        return 0;
+    }
+
+    /* Make room for the entry first, nothing may fail once the spot in
+       the page is taken */
+    if (atlas->first_free < 0 && atlas->num_entries == atlas->max_entries) {
+        int max_entries = atlas->max_entries ? atlas->max_entries * 2 : 64;
+        SDL_AtlasEntry *entries = (SDL_AtlasEntry *) SDL_realloc(atlas->entries, max_entries * sizeof(*entries));
+        if (!entries) {
+            SDL_OutOfMemory();
+            return 0;
+        }
+        atlas->entries = entries;
+        atlas->max_entries = max_entries;
+    }
+
+    converted = SDL_ConvertSurfaceFormat(surface, atlas->format, 0);
+    if (!converted) {
+        return 0;
+    }
+
+    for ( ; ; ) {
+        num_pages = atlas->num_pages;
+        page = SDL_AtlasPack(atlas, &atlas->pages, &atlas->num_pages,
+                             converted->w, converted->h, &rect, &segment);
+        if (page != -1) {
+            break;
+        }
+        if (atlas->fragmented) {
+            if (SDL_AtlasRepack(atlas) < 0) {
+                page = -2;
+                break;
+            }
+            continue;
+        }
+        if ((atlas->flags & SDL_ATLAS_EVICT_LRU) &&
+            SDL_AtlasEvict(atlas, (converted->w + ATLAS_PADDING) * (converted->h + ATLAS_PADDING)) > 0) {
+            continue;
+        }
+        SDL_SetError("Texture atlas is full");
+        break;
+    }
+    if (page < 0) {
+        SDL_FreeSurface(converted);
+        return 0;
+    }
+
+    srcrect.x = 0;
+    srcrect.y = 0;
+    srcrect.w = converted->w;
+    srcrect.h = converted->h;
+    SDL_AtlasCopyRect(converted, &srcrect, atlas->pages[page].surface, &rect);
+    SDL_FreeSurface(converted);
+
+    if (SDL_AtlasUploadPage(atlas, &atlas->pages[page], &rect) < 0) {
+        /* The spot is still free, only a page added for it needs undoing */
+        if (page >= num_pages) {
+            SDL_FreeAtlasPage(&atlas->pages[page]);
+            --atlas->num_pages;
+        }
+        return 0;
+    }
+    SDL_AtlasReserve(atlas, &atlas->pages[page], segment, &rect);
+
+    if (atlas->first_free >= 0) {
+        index = atlas->first_free;
+        atlas->first_free = atlas->entries[index].next_free;
+    } else {
+        index = atlas->num_entries++;
+        atlas->entries[index].generation = 0;
+    }
+    entry = &atlas->entries[index];
+    entry->page = page;
+    entry->rect = rect;
+    entry->last_used = ++atlas->clock;
+    entry->next_free = -1;
+    ++atlas->num_used;
+
+    return ATLAS_MAKE_ID(index, entry->generation);
+}
+
+int
+SDL_AtlasRemoveEntry(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id)
+{
+    SDL_AtlasEntry *entry;
+
+    CHECK_ATLAS_MAGIC(atlas, -1);
+
+    entry = SDL_GetAtlasEntry(atlas, id);
+    if (!entry) {
+        return SDL_SetError("Invalid texture atlas entry");
+    }
+    SDL_ReleaseAtlasEntry(atlas, entry);
+    return 0;
+}
+
+int
+SDL_AtlasQueryEntry(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id,
+                    SDL_Texture ** texture, SDL_Rect * rect)
+{
+    SDL_AtlasEntry *entry;
+
+    CHECK_ATLAS_MAGIC(atlas, -1);
+
+    entry = SDL_GetAtlasEntry(atlas, id);
+    if (!entry) {
+        return SDL_SetError("Invalid texture atlas entry");
+    }
+    entry->last_used = ++atlas->clock;
+    if (texture) {
+        *texture = atlas->pages[entry->page].texture;
+    }
+    if (rect) {
+        *rect = entry->rect;
+    }
+    return 0;
+}
+
+int
+SDL_RenderCopyAtlasEntry(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id,
+                         const SDL_Rect * srcrect, const SDL_Rect * dstrect)
+{
+    SDL_Texture *texture = NULL;
+    SDL_Rect rect, subrect;
+
+    if (SDL_AtlasQueryEntry(atlas, id, &texture, &rect) < 0) {
+        return -1;
+    }
+    if (srcrect) {
+        subrect = *srcrect;
+        subrect.x += rect.x;
+        subrect.y += rect.y;
+        if (!SDL_IntersectRect(&subrect, &rect, &rect)) {
+            return 0;
+        }
+    }
+    return SDL_RenderCopy(atlas->renderer, texture, &rect, dstrect);
+}
+
+int
+SDL_AtlasRepack(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPage *pages = NULL;
+    SDL_AtlasEntry **sorted = NULL;
+    SDL_Rect *rects = NULL;
+    int *placement = NULL;
+    int num_pages = 0;
+    int i, n, segment, retval = 0;
+
+    CHECK_ATLAS_MAGIC(atlas, -1);
+
+    /* Pack all live entries into a fresh set of pages, tallest first */
+    if (atlas->num_used > 0) {
+        sorted = (SDL_AtlasEntry **) SDL_malloc(atlas->num_used * sizeof(*sorted));
+        rects = (SDL_Rect *) SDL_malloc(atlas->num_used * sizeof(*rects));
+        placement = (int *) SDL_malloc(atlas->num_used * sizeof(*placement));
+        if (!sorted || !rects || !placement) {
+            retval = SDL_OutOfMemory();
+            goto done;
+        }
+    }
+    for (i = 0, n = 0; i < atlas->num_entries; ++i) {
+        if (atlas->entries[i].page >= 0) {
+            sorted[n++] = &atlas->entries[i];
+        }
+    }
+    SDL_qsort(sorted, n, sizeof(*sorted), SDL_CompareAtlasEntries);
+
+    for (i = 0; i < n; ++i) {
+        SDL_AtlasEntry *entry = sorted[i];
+        placement[i] = SDL_AtlasPack(atlas, &pages, &num_pages, entry->rect.w, entry->rect.h, &rects[i], &segment);
+        if (placement[i] < 0) {
+            if (placement[i] == -1) {
+                SDL_SetError("Texture atlas entries don't fit after repacking");
+            }
+            retval = -1;
+            goto done;
+        }
+        SDL_AtlasReserve(atlas, &pages[placement[i]], segment, &rects[i]);
+        SDL_AtlasCopyRect(atlas->pages[entry->page].surface, &entry->rect,
+                          pages[placement[i]].surface, &rects[i]);
+    }
+
+    /* Upload into new textures, the old ones keep the current layout in
+       case one of the uploads fails */
+    for (i = 0; i < num_pages; ++i) {
+        if (SDL_AtlasUploadPage(atlas, &pages[i], NULL) < 0) {
+            retval = -1;
+            goto done;
+        }
+    }
+
+    for (i = 0; i < n; ++i) {
+        sorted[i]->page = placement[i];
+        sorted[i]->rect = rects[i];
+    }
+    SDL_free(sorted);
+    SDL_free(rects);
+    SDL_free(placement);
+
+    for (i = 0; i < atlas->num_pages; ++i) {
+        SDL_FreeAtlasPage(&atlas->pages[i]);
+    }
+    SDL_free(atlas->pages);
+    atlas->pages = pages;
+    atlas->num_pages = num_pages;
+    atlas->fragmented = SDL_FALSE;
+    return 0;
+
+done:
+    for (i = 0; i < num_pages; ++i) {
+        SDL_FreeAtlasPage(&pages[i]);
+    }
+    SDL_free(pages);
+    SDL_free(sorted);
+    SDL_free(rects);
+    SDL_free(placement);
+    return retval;
+}
+
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    int i;
+
+    CHECK_ATLAS_MAGIC(atlas, );
+
+    for (i = 0; i < atlas->num_pages; ++i) {
+        SDL_FreeAtlasPage(&atlas->pages[i]);
+    }
+    SDL_free(atlas->pages);
+    SDL_free(atlas->entries);
+    atlas->magic = NULL;
+    SDL_free(atlas);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
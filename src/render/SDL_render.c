@@ -28,6 +28,7 @@
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 
 #define SDL_WINDOWRENDERDATA    "_SDL_WindowRenderData"
@@ -490,7 +491,7 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         } else if (access == SDL_TEXTUREACCESS_STREAMING) {
             /* The pitch is 4 byte aligned */
             texture->pitch = (((w * SDL_BYTESPERPIXEL(format)) + 3) & ~3);
-            texture->pixels = SDL_calloc(1, texture->pitch * h);
+            texture->pixels = SDL_TaggedCalloc(SDL_MEMORY_TAG_RENDER, 1, texture->pitch * h);
             if (!texture->pixels) {
                 SDL_DestroyTexture(texture);
                 return NULL;
@@ -715,22 +716,59 @@ SDL_GetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode *blendMode)
     return 0;
 }
 
+/* Chroma samples are shared by pixel pairs in the subsampled formats, so
+   updating one pixel of a pair changes the color of its neighbor too.
+   Widen the area converted back to RGB to whole chroma blocks.
+ */
+static void
+SDL_GetYUVTextureConversionRect(SDL_Texture * texture, const SDL_Rect * rect,
+                                SDL_Rect * result)
+{
+    int x1 = rect->x, y1 = rect->y;
+    int x2 = rect->x + rect->w, y2 = rect->y + rect->h;
+
+    switch (texture->format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        y1 &= ~1;
+        y2 = SDL_min((y2 + 1) & ~1, texture->h);
+        /* fall through */
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        x1 &= ~1;
+        x2 = SDL_min((x2 + 1) & ~1, texture->w);
+        break;
+    default:
+        break;
+    }
+    result->x = x1;
+    result->y = y1;
+    result->w = x2 - x1;
+    result->h = y2 - y1;
+}
+
 static int
 SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
                      const void *pixels, int pitch)
 {
     SDL_Texture *native = texture->native;
-    SDL_Rect full_rect;
+    SDL_Rect conv_rect;
 
     if (SDL_SW_UpdateYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
         return -1;
     }
 
-    full_rect.x = 0;
-    full_rect.y = 0;
-    full_rect.w = texture->w;
-    full_rect.h = texture->h;
-    rect = &full_rect;
+    if (!rect->w || !rect->h) {
+        return 0;  /* nothing to do. */
+    }
+
+    /* Only the updated area needs converting, the YUV converter reads
+       chroma samples from outside the rectangle as needed */
+    SDL_GetYUVTextureConversionRect(texture, rect, &conv_rect);
+    rect = &conv_rect;
 
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         /* We can lock the texture and copy to it */
@@ -748,14 +786,14 @@ SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_TaggedMalloc(SDL_MEMORY_TAG_RENDER, alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
             SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
                                 rect->w, rect->h, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_TaggedFree(SDL_MEMORY_TAG_RENDER, temp_pixels);
         }
     }
     return 0;
@@ -788,7 +826,7 @@ SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_TaggedMalloc(SDL_MEMORY_TAG_RENDER, alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
@@ -796,7 +834,7 @@ SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
                               texture->format, pixels, pitch,
                               native->format, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_TaggedFree(SDL_MEMORY_TAG_RENDER, temp_pixels);
         }
     }
     return 0;
@@ -845,22 +883,19 @@ SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
                            const Uint8 *Vplane, int Vpitch)
 {
     SDL_Texture *native = texture->native;
-    SDL_Rect full_rect;
+    SDL_Rect conv_rect;
 
     if (SDL_SW_UpdateYUVTexturePlanar(texture->yuv, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch) < 0) {
         return -1;
     }
 
-    full_rect.x = 0;
-    full_rect.y = 0;
-    full_rect.w = texture->w;
-    full_rect.h = texture->h;
-    rect = &full_rect;
-
     if (!rect->w || !rect->h) {
         return 0;  /* nothing to do. */
     }
 
+    SDL_GetYUVTextureConversionRect(texture, rect, &conv_rect);
+    rect = &conv_rect;
+
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         /* We can lock the texture and copy to it */
         void *native_pixels = NULL;
@@ -877,14 +912,14 @@ SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_TaggedMalloc(SDL_MEMORY_TAG_RENDER, alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
             SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
                                 rect->w, rect->h, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_TaggedFree(SDL_MEMORY_TAG_RENDER, temp_pixels);
         }
     }
     return 0;
@@ -954,7 +989,11 @@ static int
 SDL_LockTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
                    void **pixels, int *pitch)
 {
-    return SDL_SW_LockYUVTexture(texture->yuv, rect, pixels, pitch);
+    if (SDL_SW_LockYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
+        return -1;
+    }
+    texture->locked_rect = *rect;
+    return 0;
 }
 
 static int
@@ -1008,10 +1047,7 @@ SDL_UnlockTextureYUV(SDL_Texture * texture)
     int native_pitch = 0;
     SDL_Rect rect;
 
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = texture->w;
-    rect.h = texture->h;
+    SDL_GetYUVTextureConversionRect(texture, &texture->locked_rect, &rect);
 
     if (SDL_LockTexture(native, &rect, &native_pixels, &native_pitch) < 0) {
         return;
@@ -1923,7 +1959,7 @@ SDL_DestroyTexture(SDL_Texture * texture)
     if (texture->yuv) {
         SDL_SW_DestroyYUVTexture(texture->yuv);
     }
-    SDL_free(texture->pixels);
+    SDL_TaggedFree(SDL_MEMORY_TAG_RENDER, texture->pixels);
 
     renderer->DestroyTexture(renderer, texture);
     SDL_free(texture);
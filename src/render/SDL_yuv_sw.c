@@ -86,6 +86,8 @@
 #include "SDL_video.h"
 #include "SDL_cpuinfo.h"
 #include "SDL_yuv_sw_c.h"
+#include "../video/SDL_yuv_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 
 /* The colorspace conversion functions */
@@ -1048,6 +1050,8 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     case SDL_PIXELFORMAT_YUY2:
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
         break;
     default:
         SDL_SetError("Unsupported YUV format");
@@ -1064,7 +1068,9 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     swdata->target_format = SDL_PIXELFORMAT_UNKNOWN;
     swdata->w = w;
     swdata->h = h;
-    swdata->pixels = (Uint8 *) SDL_malloc(w * h * 2);
+    /* The packed 4:2:2 formats are the largest, except the 4:2:0 planes
+       round up for odd sizes */
+    swdata->pixels = (Uint8 *) SDL_TaggedMalloc(SDL_MEMORY_TAG_RENDER, SDL_max(w * h * 2, w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2)));
     swdata->colortab = (int *) SDL_malloc(4 * 256 * sizeof(int));
     swdata->rgb_2_pix = (Uint32 *) SDL_malloc(3 * 768 * sizeof(Uint32));
     if (!swdata->pixels || !swdata->colortab || !swdata->rgb_2_pix) {
@@ -1094,11 +1100,18 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     case SDL_PIXELFORMAT_YV12:
     case SDL_PIXELFORMAT_IYUV:
         swdata->pitches[0] = w;
-        swdata->pitches[1] = swdata->pitches[0] / 2;
-        swdata->pitches[2] = swdata->pitches[0] / 2;
+        swdata->pitches[1] = (swdata->pitches[0] + 1) / 2;
+        swdata->pitches[2] = (swdata->pitches[0] + 1) / 2;
+        swdata->planes[0] = swdata->pixels;
+        swdata->planes[1] = swdata->planes[0] + swdata->pitches[0] * h;
+        swdata->planes[2] = swdata->planes[1] + swdata->pitches[1] * ((h + 1) / 2);
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        swdata->pitches[0] = w;
+        swdata->pitches[1] = 2 * ((swdata->pitches[0] + 1) / 2);
         swdata->planes[0] = swdata->pixels;
         swdata->planes[1] = swdata->planes[0] + swdata->pitches[0] * h;
-        swdata->planes[2] = swdata->planes[1] + swdata->pitches[1] * h / 2;
         break;
     case SDL_PIXELFORMAT_YUY2:
     case SDL_PIXELFORMAT_UYVY:
@@ -1124,75 +1137,81 @@ SDL_SW_QueryYUVTexturePixels(SDL_SW_YUVTexture * swdata, void **pixels,
     return 0;
 }
 
+static void
+SDL_SW_CopyPlane(Uint8 *dst, int dst_pitch, const Uint8 *src, int src_pitch,
+                 size_t length, int rows)
+{
+    int row;
+
+    for (row = 0; row < rows; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+
 int
 SDL_SW_UpdateYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                         const void *pixels, int pitch)
 {
+    const Uint8 *src = (const Uint8 *) pixels;
+    /* The source has (w+1)/2 by (h+1)/2 chroma samples, which an odd
+       rect position doesn't change */
+    const int uv_x = rect->x / 2;
+    const int uv_y = rect->y / 2;
+    const int uv_w = (rect->w + 1) / 2;
+    const int uv_h = (rect->h + 1) / 2;
+
     switch (swdata->format) {
     case SDL_PIXELFORMAT_YV12:
     case SDL_PIXELFORMAT_IYUV:
-        if (rect->x == 0 && rect->y == 0 &&
-            rect->w == swdata->w && rect->h == swdata->h) {
+        {
+            const int src_uv_pitch = (pitch + 1) / 2;
+
+            if (rect->x == 0 && rect->y == 0 &&
+                rect->w == swdata->w && rect->h == swdata->h &&
+                pitch == swdata->pitches[0]) {
                 SDL_memcpy(swdata->pixels, pixels,
-                           (swdata->h * swdata->w) + (swdata->h * swdata->w) / 2);
-        } else {
-            Uint8 *src, *dst;
-            int row;
-            size_t length;
+                           swdata->h * swdata->pitches[0] +
+                           2 * ((swdata->h + 1) / 2) * swdata->pitches[1]);
+                break;
+            }
 
             /* Copy the Y plane */
-            src = (Uint8 *) pixels;
-            dst = swdata->pixels + rect->y * swdata->w + rect->x;
-            length = rect->w;
-            for (row = 0; row < rect->h; ++row) {
-                SDL_memcpy(dst, src, length);
-                src += pitch;
-                dst += swdata->w;
-            }
+            SDL_SW_CopyPlane(swdata->planes[0] + rect->y * swdata->pitches[0] + rect->x,
+                             swdata->pitches[0], src, pitch, rect->w, rect->h);
+            src += rect->h * pitch;
 
             /* Copy the next plane */
-            src = (Uint8 *) pixels + rect->h * pitch;
-            dst = swdata->pixels + swdata->h * swdata->w;
-            dst += rect->y/2 * swdata->w/2 + rect->x/2;
-            length = rect->w / 2;
-            for (row = 0; row < rect->h/2; ++row) {
-                SDL_memcpy(dst, src, length);
-                src += pitch/2;
-                dst += swdata->w/2;
-            }
+            SDL_SW_CopyPlane(swdata->planes[1] + uv_y * swdata->pitches[1] + uv_x,
+                             swdata->pitches[1], src, src_uv_pitch, uv_w, uv_h);
+            src += ((rect->h + 1) / 2) * src_uv_pitch;
 
             /* Copy the next plane */
-            src = (Uint8 *) pixels + rect->h * pitch + (rect->h * pitch) / 4;
-            dst = swdata->pixels + swdata->h * swdata->w +
-                  (swdata->h * swdata->w) / 4;
-            dst += rect->y/2 * swdata->w/2 + rect->x/2;
-            length = rect->w / 2;
-            for (row = 0; row < rect->h/2; ++row) {
-                SDL_memcpy(dst, src, length);
-                src += pitch/2;
-                dst += swdata->w/2;
-            }
+            SDL_SW_CopyPlane(swdata->planes[2] + uv_y * swdata->pitches[2] + uv_x,
+                             swdata->pitches[2], src, src_uv_pitch, uv_w, uv_h);
+        }
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        {
+            const int src_uv_pitch = 2 * ((pitch + 1) / 2);
+
+            /* Copy the Y plane */
+            SDL_SW_CopyPlane(swdata->planes[0] + rect->y * swdata->pitches[0] + rect->x,
+                             swdata->pitches[0], src, pitch, rect->w, rect->h);
+            src += rect->h * pitch;
+
+            /* Copy the interleaved U/V plane */
+            SDL_SW_CopyPlane(swdata->planes[1] + uv_y * swdata->pitches[1] + uv_x * 2,
+                             swdata->pitches[1], src, src_uv_pitch, uv_w * 2, uv_h);
         }
         break;
     case SDL_PIXELFORMAT_YUY2:
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
-        {
-            Uint8 *src, *dst;
-            int row;
-            size_t length;
-
-            src = (Uint8 *) pixels;
-            dst =
-                swdata->planes[0] + rect->y * swdata->pitches[0] +
-                rect->x * 2;
-            length = rect->w * 2;
-            for (row = 0; row < rect->h; ++row) {
-                SDL_memcpy(dst, src, length);
-                src += pitch;
-                dst += swdata->pitches[0];
-            }
-        }
+        SDL_SW_CopyPlane(swdata->planes[0] + rect->y * swdata->pitches[0] + rect->x * 2,
+                         swdata->pitches[0], src, pitch, rect->w * 2, rect->h);
         break;
     }
     return 0;
@@ -1204,52 +1223,33 @@ SDL_SW_UpdateYUVTexturePlanar(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                               const Uint8 *Uplane, int Upitch,
                               const Uint8 *Vplane, int Vpitch)
 {
-    const Uint8 *src;
-    Uint8 *dst;
-    int row;
-    size_t length;
+    /* The source has (w+1)/2 by (h+1)/2 chroma samples, which an odd
+       rect position doesn't change */
+    const int uv_x = rect->x / 2;
+    const int uv_y = rect->y / 2;
+    const int uv_w = (rect->w + 1) / 2;
+    const int uv_h = (rect->h + 1) / 2;
+    Uint8 *Udst, *Vdst;
 
-    /* Copy the Y plane */
-    src = Yplane;
-    dst = swdata->pixels + rect->y * swdata->w + rect->x;
-    length = rect->w;
-    for (row = 0; row < rect->h; ++row) {
-        SDL_memcpy(dst, src, length);
-        src += Ypitch;
-        dst += swdata->w;
-    }
-
-    /* Copy the U plane */
-    src = Uplane;
     if (swdata->format == SDL_PIXELFORMAT_IYUV) {
-        dst = swdata->pixels + swdata->h * swdata->w;
+        Udst = swdata->planes[1];
+        Vdst = swdata->planes[2];
     } else {
-        dst = swdata->pixels + swdata->h * swdata->w +
-              (swdata->h * swdata->w) / 4;
-    }
-    dst += rect->y/2 * swdata->w/2 + rect->x/2;
-    length = rect->w / 2;
-    for (row = 0; row < rect->h/2; ++row) {
-        SDL_memcpy(dst, src, length);
-        src += Upitch;
-        dst += swdata->w/2;
+        Udst = swdata->planes[2];
+        Vdst = swdata->planes[1];
     }
 
+    /* Copy the Y plane */
+    SDL_SW_CopyPlane(swdata->planes[0] + rect->y * swdata->pitches[0] + rect->x,
+                     swdata->pitches[0], Yplane, Ypitch, rect->w, rect->h);
+
+    /* Copy the U plane */
+    SDL_SW_CopyPlane(Udst + uv_y * swdata->pitches[1] + uv_x,
+                     swdata->pitches[1], Uplane, Upitch, uv_w, uv_h);
+
     /* Copy the V plane */
-    src = Vplane;
-    if (swdata->format == SDL_PIXELFORMAT_YV12) {
-        dst = swdata->pixels + swdata->h * swdata->w;
-    } else {
-        dst = swdata->pixels + swdata->h * swdata->w +
-              (swdata->h * swdata->w) / 4;
-    }
-    dst += rect->y/2 * swdata->w/2 + rect->x/2;
-    length = rect->w / 2;
-    for (row = 0; row < rect->h/2; ++row) {
-        SDL_memcpy(dst, src, length);
-        src += Vpitch;
-        dst += swdata->w/2;
-    }
+    SDL_SW_CopyPlane(Vdst + uv_y * swdata->pitches[2] + uv_x,
+                     swdata->pitches[2], Vplane, Vpitch, uv_w, uv_h);
     return 0;
 }
 
@@ -1260,11 +1260,13 @@ SDL_SW_LockYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
     switch (swdata->format) {
     case SDL_PIXELFORMAT_YV12:
     case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
         if (rect
             && (rect->x != 0 || rect->y != 0 || rect->w != swdata->w
                 || rect->h != swdata->h)) {
             return SDL_SetError
-                ("YV12 and IYUV textures only support full surface locks");
+                ("YV12, IYUV, NV12 and NV21 textures only support full surface locks");
         }
         break;
     }
@@ -1298,6 +1300,19 @@ SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
         return SDL_SetError("Invalid target pixel format");
     }
 
+    if (targetbpp == 4 || (swdata->w & 1) ||
+        swdata->format == SDL_PIXELFORMAT_NV12 ||
+        swdata->format == SDL_PIXELFORMAT_NV21) {
+        /* The YUV converter reads the clipped source in place and scales
+           while it converts, so this is a single pass with no scratch
+           surfaces.  It also has SIMD paths and honors the conversion mode.
+         */
+        return SDL_ConvertPixelsRect_YUV_to_RGB(swdata->w, swdata->h, swdata->format,
+                                                swdata->planes[0], swdata->pitches[0],
+                                                srcrect, w, h,
+                                                target_format, pixels, pitch);
+    }
+
     /* Make sure we're set up to display in the desired format */
     if (target_format != swdata->target_format) {
         if (SDL_SW_SetupYUVDisplay(swdata, target_format) < 0) {
@@ -1407,7 +1422,7 @@ void
 SDL_SW_DestroyYUVTexture(SDL_SW_YUVTexture * swdata)
 {
     if (swdata) {
-        SDL_free(swdata->pixels);
+        SDL_TaggedFree(SDL_MEMORY_TAG_RENDER, swdata->pixels);
         SDL_free(swdata->colortab);
         SDL_free(swdata->rgb_2_pix);
         SDL_FreeSurface(swdata->stretch);
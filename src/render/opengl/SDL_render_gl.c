@@ -1109,6 +1109,10 @@ GL_SetBlendMode(GL_RenderData * data, int blendMode)
             data->glEnable(GL_BLEND);
             data->glBlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
             break;
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+            data->glEnable(GL_BLEND);
+            data->glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
         }
         data->current.blendMode = blendMode;
     }
@@ -768,6 +768,10 @@ GLES_SetBlendMode(GLES_RenderData * data, int blendMode)
                 data->glBlendFunc(GL_ZERO, GL_SRC_COLOR);
             }
             break;
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+            data->glEnable(GL_BLEND);
+            data->glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
         }
         data->current.blendMode = blendMode;
     }
@@ -818,6 +818,7 @@ const GLES2_Shader *GLES2_GetShader(GLES2_ShaderType type, SDL_BlendMode blendMo
     case SDL_BLENDMODE_NONE:
         return &GLES2_FragmentShader_None_SolidSrc;
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
         return &GLES2_FragmentShader_Alpha_SolidSrc;
     case SDL_BLENDMODE_ADD:
         return &GLES2_FragmentShader_Additive_SolidSrc;
@@ -831,6 +832,7 @@ const GLES2_Shader *GLES2_GetShader(GLES2_ShaderType type, SDL_BlendMode blendMo
         case SDL_BLENDMODE_NONE:
             return &GLES2_FragmentShader_None_TextureABGRSrc;
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             return &GLES2_FragmentShader_Alpha_TextureABGRSrc;
         case SDL_BLENDMODE_ADD:
             return &GLES2_FragmentShader_Additive_TextureABGRSrc;
@@ -844,6 +846,7 @@ const GLES2_Shader *GLES2_GetShader(GLES2_ShaderType type, SDL_BlendMode blendMo
         case SDL_BLENDMODE_NONE:
             return &GLES2_FragmentShader_None_TextureARGBSrc;
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             return &GLES2_FragmentShader_Alpha_TextureARGBSrc;
         case SDL_BLENDMODE_ADD:
             return &GLES2_FragmentShader_Additive_TextureARGBSrc;
@@ -858,6 +861,7 @@ const GLES2_Shader *GLES2_GetShader(GLES2_ShaderType type, SDL_BlendMode blendMo
         case SDL_BLENDMODE_NONE:
             return &GLES2_FragmentShader_None_TextureRGBSrc;
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             return &GLES2_FragmentShader_Alpha_TextureRGBSrc;
         case SDL_BLENDMODE_ADD:
             return &GLES2_FragmentShader_Additive_TextureRGBSrc;
@@ -872,6 +876,7 @@ const GLES2_Shader *GLES2_GetShader(GLES2_ShaderType type, SDL_BlendMode blendMo
         case SDL_BLENDMODE_NONE:
             return &GLES2_FragmentShader_None_TextureBGRSrc;
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             return &GLES2_FragmentShader_Alpha_TextureBGRSrc;
         case SDL_BLENDMODE_ADD:
             return &GLES2_FragmentShader_Additive_TextureBGRSrc;
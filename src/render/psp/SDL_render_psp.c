@@ -625,6 +625,11 @@ PSP_SetBlendMode(SDL_Renderer * renderer, int blendMode)
                 sceGuEnable(GU_BLEND);
                 sceGuBlendFunc( GU_ADD, GU_FIX, GU_SRC_COLOR, 0, 0);
             break;
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+                sceGuTexFunc(GU_TFX_MODULATE , GU_TCC_RGBA);
+                sceGuEnable(GU_BLEND);
+                sceGuBlendFunc(GU_ADD, GU_FIX, GU_ONE_MINUS_SRC_ALPHA, 0xFFFFFFFF, 0 );
+            break;
         }
         data->currentBlendMode = blendMode;
     }
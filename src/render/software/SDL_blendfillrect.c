@@ -24,6 +24,7 @@
 
 #include "SDL_draw.h"
 #include "SDL_blendfillrect.h"
+#include "SDL_blendspan.h"
 
 
 static int
@@ -192,11 +193,26 @@ SDL_BlendFillRect_RGBA(SDL_Surface * dst, const SDL_Rect * rect,
     }
 }
 
+static void
+SDL_BlendFillRectSpans(SDL_Surface * dst, const SDL_Rect * rect,
+                       const SDL_BlendSpanInfo * span)
+{
+    Uint8 *pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
+                                            rect->x * dst->format->BytesPerPixel;
+    int h = rect->h;
+
+    while (h--) {
+        SDL_BlendSpan(span, pixels, rect->w);
+        pixels += dst->pitch;
+    }
+}
+
 int
 SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     SDL_Rect clipped;
+    SDL_BlendSpanInfo span;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -222,6 +238,14 @@ SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
+
+    if (SDL_SetupBlendSpan(&span, dst->format, blendMode, r, g, b, a)) {
+        SDL_BlendFillRectSpans(dst, rect, &span);
+        return 0;
     }
 
     switch (dst->format->BitsPerPixel) {
@@ -267,6 +291,7 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
     int i;
     int (*func)(SDL_Surface * dst, const SDL_Rect * rect,
                 SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
+    SDL_BlendSpanInfo span;
     int status = 0;
 
     if (!dst) {
@@ -282,6 +307,20 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
+
+    if (SDL_SetupBlendSpan(&span, dst->format, blendMode, r, g, b, a)) {
+        for (i = 0; i < count; ++i) {
+            /* Perform clipping */
+            if (!SDL_IntersectRect(&rects[i], &dst->clip_rect, &rect)) {
+                continue;
+            }
+            SDL_BlendFillRectSpans(dst, &rect, &span);
+        }
+        return 0;
     }
 
     /* FIXME: Does this function pointer slow things down significantly? */
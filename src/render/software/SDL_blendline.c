@@ -25,6 +25,7 @@
 #include "SDL_draw.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
+#include "SDL_blendspan.h"
 
 
 static void
@@ -46,6 +47,10 @@ SDL_BlendLine_RGB2(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -137,6 +142,10 @@ SDL_BlendLine_RGB555(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -228,6 +237,10 @@ SDL_BlendLine_RGB565(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -320,6 +333,10 @@ SDL_BlendLine_RGB4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -412,6 +429,10 @@ SDL_BlendLine_RGBA4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -503,6 +524,10 @@ SDL_BlendLine_RGB888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -594,6 +619,10 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         b = _b;
         a = _a;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
     inva = (a ^ 0xff);
 
     if (y1 == y2) {
@@ -704,11 +733,45 @@ SDL_CalculateBlendLineFunc(const SDL_PixelFormat * fmt)
     return NULL;
 }
 
+/* Horizontal lines are blended as one span when the format has a span blender */
+static SDL_bool
+SDL_SetupBlendLineSpan(SDL_Surface * dst, SDL_BlendSpanInfo * span,
+                       SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
+        r = DRAW_MUL(r, a);
+        g = DRAW_MUL(g, a);
+        b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
+    return SDL_SetupBlendSpan(span, dst->format, blendMode, r, g, b, a);
+}
+
+static void
+SDL_BlendHLine(SDL_Surface * dst, int x1, int x2, int y,
+               const SDL_BlendSpanInfo * span, SDL_bool draw_end)
+{
+    int x, length;
+
+    if (x1 <= x2) {
+        x = x1;
+        length = draw_end ? (x2-x1+1) : (x2-x1);
+    } else {
+        x = draw_end ? x2 : (x2+1);
+        length = draw_end ? (x1-x2+1) : (x1-x2);
+    }
+    SDL_BlendSpan(span, (Uint8 *) dst->pixels + y * dst->pitch +
+                                  x * dst->format->BytesPerPixel, length);
+}
+
 int
 SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
               SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     BlendLineFunc func;
+    SDL_BlendSpanInfo span;
 
     if (!dst) {
         return SDL_SetError("SDL_BlendLine(): Passed NULL destination surface");
@@ -725,6 +788,11 @@ SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         return 0;
     }
 
+    if (y1 == y2 && SDL_SetupBlendLineSpan(dst, &span, blendMode, r, g, b, a)) {
+        SDL_BlendHLine(dst, x1, x2, y1, &span, SDL_TRUE);
+        return 0;
+    }
+
     func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, SDL_TRUE);
     return 0;
 }
@@ -738,6 +806,8 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     int x2, y2;
     SDL_bool draw_end;
     BlendLineFunc func;
+    SDL_BlendSpanInfo span;
+    SDL_bool have_span;
 
     if (!dst) {
         return SDL_SetError("SDL_BlendLines(): Passed NULL destination surface");
@@ -747,6 +817,7 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     if (!func) {
         return SDL_SetError("SDL_BlendLines(): Unsupported surface format");
     }
+    have_span = SDL_SetupBlendLineSpan(dst, &span, blendMode, r, g, b, a);
 
     for (i = 1; i < count; ++i) {
         x1 = points[i-1].x;
@@ -763,7 +834,11 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
         /* Draw the end if it was clipped */
         draw_end = (x2 != points[i].x || y2 != points[i].y);
 
-        func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end);
+        if (y1 == y2 && have_span) {
+            SDL_BlendHLine(dst, x1, x2, y1, &span, draw_end);
+        } else {
+            func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end);
+        }
     }
     if (points[0].x != points[count-1].x || points[0].y != points[count-1].y) {
         SDL_BlendPoint(dst, points[count-1].x, points[count-1].y,
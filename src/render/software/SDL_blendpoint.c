@@ -24,6 +24,7 @@
 
 #include "SDL_draw.h"
 #include "SDL_blendpoint.h"
+#include "SDL_blendspan.h"
 
 
 static int
@@ -192,6 +193,44 @@ SDL_BlendPoint_RGBA(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Ui
     }
 }
 
+SDL_BlendPointFunc
+SDL_GetBlendPointFunc(SDL_Surface * dst)
+{
+    switch (dst->format->BitsPerPixel) {
+    case 15:
+        switch (dst->format->Rmask) {
+        case 0x7C00:
+            return SDL_BlendPoint_RGB555;
+        }
+        break;
+    case 16:
+        switch (dst->format->Rmask) {
+        case 0xF800:
+            return SDL_BlendPoint_RGB565;
+        }
+        break;
+    case 32:
+        switch (dst->format->Rmask) {
+        case 0x00FF0000:
+            if (!dst->format->Amask) {
+                return SDL_BlendPoint_RGB888;
+            } else {
+                return SDL_BlendPoint_ARGB8888;
+            }
+            /* break; -Wunreachable-code-break */
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (!dst->format->Amask) {
+        return SDL_BlendPoint_RGB;
+    } else {
+        return SDL_BlendPoint_RGBA;
+    }
+}
+
 int
 SDL_BlendPoint(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r,
                Uint8 g, Uint8 b, Uint8 a)
@@ -216,6 +255,9 @@ SDL_BlendPoint(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
     }
 
     switch (dst->format->BitsPerPixel) {
@@ -261,8 +303,8 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
     int maxx, maxy;
     int i;
     int x, y;
-    int (*func)(SDL_Surface * dst, int x, int y,
-                SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
+    SDL_BlendPointFunc func;
+    SDL_BlendSpanInfo span;
     int status = 0;
 
     if (!dst) {
@@ -278,45 +320,9 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
-    }
-
-    /* FIXME: Does this function pointer slow things down significantly? */
-    switch (dst->format->BitsPerPixel) {
-    case 15:
-        switch (dst->format->Rmask) {
-        case 0x7C00:
-            func = SDL_BlendPoint_RGB555;
-            break;
-        }
-        break;
-    case 16:
-        switch (dst->format->Rmask) {
-        case 0xF800:
-            func = SDL_BlendPoint_RGB565;
-            break;
-        }
-        break;
-    case 32:
-        switch (dst->format->Rmask) {
-        case 0x00FF0000:
-            if (!dst->format->Amask) {
-                func = SDL_BlendPoint_RGB888;
-            } else {
-                func = SDL_BlendPoint_ARGB8888;
-            }
-            break;
-        }
-        break;
-    default:
-        break;
-    }
-
-    if (!func) {
-        if (!dst->format->Amask) {
-            func = SDL_BlendPoint_RGB;
-        } else {
-            func = SDL_BlendPoint_RGBA;
-        }
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already scaled by alpha */
+        blendMode = SDL_BLENDMODE_BLEND;
     }
 
     minx = dst->clip_rect.x;
@@ -324,6 +330,23 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
     miny = dst->clip_rect.y;
     maxy = dst->clip_rect.y + dst->clip_rect.h - 1;
 
+    if (SDL_SetupBlendSpan(&span, dst->format, blendMode, r, g, b, a)) {
+        const int bpp = dst->format->BytesPerPixel;
+
+        for (i = 0; i < count; ++i) {
+            x = points[i].x;
+            y = points[i].y;
+
+            if (x < minx || x > maxx || y < miny || y > maxy) {
+                continue;
+            }
+            SDL_BlendSpan(&span, (Uint8 *) dst->pixels + y * dst->pitch + x * bpp, 1);
+        }
+        return 0;
+    }
+
+    func = SDL_GetBlendPointFunc(dst);
+
     for (i = 0; i < count; ++i) {
         x = points[i].x;
         y = points[i].y;
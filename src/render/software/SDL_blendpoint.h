@@ -21,6 +21,13 @@
 #include "../../SDL_internal.h"
 
 
+typedef int (*SDL_BlendPointFunc) (SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+/* Returns the pixel blender for the format of dst.  It takes coordinates
+   inside the clip rect, and colors already multiplied by alpha for the
+   blend and add modes. */
+extern SDL_BlendPointFunc SDL_GetBlendPointFunc(SDL_Surface * dst);
+
 extern int SDL_BlendPoint(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 extern int SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
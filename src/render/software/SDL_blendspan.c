@@ -0,0 +1,322 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_draw.h"
+#include "SDL_blendspan.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SDL_NEON_BLENDSPAN 1
+#include <arm_neon.h>
+#endif
+
+/* The SIMD blenders give the same results as the SDL_draw.h macros.
+   DRAW_MUL() divides by 255 rounding down, which for products of two
+   bytes is (t + 1 + (t >> 8)) >> 8.  RGB_FROM_RGB565() expands with
+   SDL_expand_byte, also rounding down: 5 bit values v become
+   (v * 1053) >> 7, and 6 bit values shifted up by 5 become
+   (v * 8290) >> 16. */
+
+static SDL_INLINE Uint32
+SDL_BlendPixel8888(const SDL_BlendSpanInfo * info, Uint32 pixel)
+{
+    Uint32 blended = 0;
+    int shift;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        const unsigned d = (pixel >> shift) & 0xFF;
+        const unsigned s = (info->color >> shift) & 0xFF;
+        unsigned v;
+
+        switch (info->blendMode) {
+        case SDL_BLENDMODE_BLEND:
+            v = DRAW_MUL(info->inva, d) + s;
+            break;
+        case SDL_BLENDMODE_ADD:
+            v = d + s;
+            if (v > 0xff) v = 0xff;
+            break;
+        default:
+            v = DRAW_MUL(d, s);
+            break;
+        }
+        blended |= (Uint32) v << shift;
+    }
+    return (blended & info->opmask) | (pixel & info->keepmask);
+}
+
+static SDL_INLINE Uint16
+SDL_BlendPixel565(const SDL_BlendSpanInfo * info, Uint16 pixel)
+{
+    unsigned sr, sg, sb;
+    Uint32 blended;
+
+    RGB_FROM_RGB565(pixel, sr, sg, sb);
+    switch (info->blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        sr = DRAW_MUL(info->inva, sr) + info->r;
+        sg = DRAW_MUL(info->inva, sg) + info->g;
+        sb = DRAW_MUL(info->inva, sb) + info->b;
+        break;
+    case SDL_BLENDMODE_ADD:
+        sr += info->r; if (sr > 0xff) sr = 0xff;
+        sg += info->g; if (sg > 0xff) sg = 0xff;
+        sb += info->b; if (sb > 0xff) sb = 0xff;
+        break;
+    default:
+        sr = DRAW_MUL(sr, info->r);
+        sg = DRAW_MUL(sg, info->g);
+        sb = DRAW_MUL(sb, info->b);
+        break;
+    }
+    RGB565_FROM_RGB(blended, sr, sg, sb);
+    return (Uint16) blended;
+}
+
+static void
+SDL_BlendSpan8888(const SDL_BlendSpanInfo * info, void *pixels, int count)
+{
+    Uint32 *pixel = (Uint32 *) pixels;
+
+    while (count--) {
+        *pixel = SDL_BlendPixel8888(info, *pixel);
+        ++pixel;
+    }
+}
+
+static void
+SDL_BlendSpan565(const SDL_BlendSpanInfo * info, void *pixels, int count)
+{
+    Uint16 *pixel = (Uint16 *) pixels;
+
+    while (count--) {
+        *pixel = SDL_BlendPixel565(info, *pixel);
+        ++pixel;
+    }
+}
+
+#ifdef __SSE2__
+static SDL_INLINE __m128i
+SDL_Div255_SSE2(__m128i t)
+{
+    t = _mm_add_epi16(t, _mm_add_epi16(_mm_srli_epi16(t, 8), _mm_set1_epi16(1)));
+    return _mm_srli_epi16(t, 8);
+}
+
+/* Blends 16 bit channel values with the color channels in s */
+static SDL_INLINE __m128i
+SDL_BlendChannels_SSE2(SDL_BlendMode blendMode, __m128i d, __m128i s, __m128i inva)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return _mm_add_epi16(SDL_Div255_SSE2(_mm_mullo_epi16(d, inva)), s);
+    case SDL_BLENDMODE_ADD:
+        return _mm_min_epi16(_mm_add_epi16(d, s), _mm_set1_epi16(0xff));
+    default:
+        return SDL_Div255_SSE2(_mm_mullo_epi16(d, s));
+    }
+}
+
+/* Four pixels at a time */
+static void
+SDL_BlendSpan8888_SSE2(const SDL_BlendSpanInfo * info, void *pixels, int count)
+{
+    Uint32 *pixel = (Uint32 *) pixels;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i color = _mm_set1_epi32(info->color);
+    const __m128i color16 = _mm_unpacklo_epi8(color, zero);
+    const __m128i inva = _mm_set1_epi16(info->inva);
+    const __m128i opmask = _mm_set1_epi32(info->opmask);
+    const __m128i keepmask = _mm_set1_epi32(info->keepmask);
+
+    for (; count >= 4; count -= 4, pixel += 4) {
+        const __m128i d = _mm_loadu_si128((const __m128i *) pixel);
+        __m128i s;
+
+        if (info->blendMode == SDL_BLENDMODE_ADD) {
+            s = _mm_adds_epu8(d, color);
+        } else {
+            const __m128i lo = SDL_BlendChannels_SSE2(info->blendMode, _mm_unpacklo_epi8(d, zero), color16, inva);
+            const __m128i hi = SDL_BlendChannels_SSE2(info->blendMode, _mm_unpackhi_epi8(d, zero), color16, inva);
+            s = _mm_packus_epi16(lo, hi);
+        }
+        s = _mm_or_si128(_mm_and_si128(s, opmask), _mm_and_si128(d, keepmask));
+        _mm_storeu_si128((__m128i *) pixel, s);
+    }
+    SDL_BlendSpan8888(info, pixel, count);
+}
+
+/* Eight pixels at a time */
+static void
+SDL_BlendSpan565_SSE2(const SDL_BlendSpanInfo * info, void *pixels, int count)
+{
+    Uint16 *pixel = (Uint16 *) pixels;
+    const __m128i r = _mm_set1_epi16(info->r);
+    const __m128i g = _mm_set1_epi16(info->g);
+    const __m128i b = _mm_set1_epi16(info->b);
+    const __m128i inva = _mm_set1_epi16(info->inva);
+    const __m128i expand5 = _mm_set1_epi16(1053);
+    const __m128i expand6 = _mm_set1_epi16(8290);
+    const __m128i mask5 = _mm_set1_epi16(0x001F);
+    const __m128i mask6 = _mm_set1_epi16(0x07E0);
+
+    for (; count >= 8; count -= 8, pixel += 8) {
+        const __m128i d = _mm_loadu_si128((const __m128i *) pixel);
+        __m128i dr, dg, db;
+
+        dr = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(d, 11), expand5), 7);
+        dg = _mm_mulhi_epu16(_mm_and_si128(d, mask6), expand6);
+        db = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(d, mask5), expand5), 7);
+
+        dr = SDL_BlendChannels_SSE2(info->blendMode, dr, r, inva);
+        dg = SDL_BlendChannels_SSE2(info->blendMode, dg, g, inva);
+        db = SDL_BlendChannels_SSE2(info->blendMode, db, b, inva);
+
+        dr = _mm_slli_epi16(_mm_srli_epi16(dr, 3), 11);
+        dg = _mm_slli_epi16(_mm_srli_epi16(dg, 2), 5);
+        db = _mm_srli_epi16(db, 3);
+        _mm_storeu_si128((__m128i *) pixel, _mm_or_si128(_mm_or_si128(dr, dg), db));
+    }
+    SDL_BlendSpan565(info, pixel, count);
+}
+#endif /* __SSE2__ */
+
+#ifdef SDL_NEON_BLENDSPAN
+static SDL_INLINE uint16x8_t
+SDL_Div255_NEON(uint16x8_t t)
+{
+    t = vaddq_u16(t, vaddq_u16(vshrq_n_u16(t, 8), vdupq_n_u16(1)));
+    return vshrq_n_u16(t, 8);
+}
+
+/* Four pixels at a time */
+static void
+SDL_BlendSpan8888_NEON(const SDL_BlendSpanInfo * info, void *pixels, int count)
+{
+    Uint32 *pixel = (Uint32 *) pixels;
+    const uint8x8_t color = vreinterpret_u8_u32(vdup_n_u32(info->color));
+    const uint8x16_t colorq = vcombine_u8(color, color);
+    const uint16x8_t color16 = vmovl_u8(color);
+    const uint8x8_t inva = vdup_n_u8(info->inva);
+    const uint32x4_t opmask = vdupq_n_u32(info->opmask);
+    const uint32x4_t keepmask = vdupq_n_u32(info->keepmask);
+
+    for (; count >= 4; count -= 4, pixel += 4) {
+        const uint32x4_t d = vld1q_u32(pixel);
+        const uint8x16_t d8 = vreinterpretq_u8_u32(d);
+        uint16x8_t lo, hi;
+        uint32x4_t s;
+
+        switch (info->blendMode) {
+        case SDL_BLENDMODE_BLEND:
+            lo = vaddq_u16(SDL_Div255_NEON(vmull_u8(vget_low_u8(d8), inva)), color16);
+            hi = vaddq_u16(SDL_Div255_NEON(vmull_u8(vget_high_u8(d8), inva)), color16);
+            s = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+            break;
+        case SDL_BLENDMODE_ADD:
+            s = vreinterpretq_u32_u8(vqaddq_u8(d8, colorq));
+            break;
+        default:
+            lo = SDL_Div255_NEON(vmull_u8(vget_low_u8(d8), color));
+            hi = SDL_Div255_NEON(vmull_u8(vget_high_u8(d8), color));
+            s = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+            break;
+        }
+        s = vorrq_u32(vandq_u32(s, opmask), vandq_u32(d, keepmask));
+        vst1q_u32(pixel, s);
+    }
+    SDL_BlendSpan8888(info, pixel, count);
+}
+#endif /* SDL_NEON_BLENDSPAN */
+
+static SDL_bool
+SDL_IsByteMask(Uint32 mask)
+{
+    return (mask == 0x000000FF || mask == 0x0000FF00 ||
+            mask == 0x00FF0000 || mask == 0xFF000000);
+}
+
+SDL_bool
+SDL_SetupBlendSpan(SDL_BlendSpanInfo * info, const SDL_PixelFormat * fmt,
+                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    SDL_zerop(info);
+
+    if (blendMode != SDL_BLENDMODE_BLEND &&
+        blendMode != SDL_BLENDMODE_ADD &&
+        blendMode != SDL_BLENDMODE_MOD) {
+        return SDL_FALSE;
+    }
+    info->blendMode = blendMode;
+    info->r = r;
+    info->g = g;
+    info->b = b;
+    info->a = a;
+    info->inva = (a ^ 0xff);
+
+    if (fmt->BytesPerPixel == 4 &&
+        SDL_IsByteMask(fmt->Rmask) && SDL_IsByteMask(fmt->Gmask) &&
+        SDL_IsByteMask(fmt->Bmask) && (!fmt->Amask || SDL_IsByteMask(fmt->Amask))) {
+        info->color = ((Uint32) r << fmt->Rshift) |
+                      ((Uint32) g << fmt->Gshift) |
+                      ((Uint32) b << fmt->Bshift);
+        info->opmask = (fmt->Rmask | fmt->Gmask | fmt->Bmask);
+        if (fmt->Amask) {
+            info->color |= ((Uint32) a << fmt->Ashift);
+            /* Only the blend mode changes the destination alpha */
+            if (blendMode == SDL_BLENDMODE_BLEND) {
+                info->opmask |= fmt->Amask;
+            } else {
+                info->keepmask = fmt->Amask;
+            }
+        }
+        info->blend = SDL_BlendSpan8888;
+#ifdef __SSE2__
+        if (SDL_HasSSE2()) {
+            info->blend = SDL_BlendSpan8888_SSE2;
+        }
+#endif
+#ifdef SDL_NEON_BLENDSPAN
+        if (SDL_HasNEON()) {
+            info->blend = SDL_BlendSpan8888_NEON;
+        }
+#endif
+        return SDL_TRUE;
+    }
+
+    if (fmt->BytesPerPixel == 2 && fmt->Rmask == 0xF800 &&
+        fmt->Gmask == 0x07E0 && fmt->Bmask == 0x001F) {
+        info->blend = SDL_BlendSpan565;
+#ifdef __SSE2__
+        if (SDL_HasSSE2()) {
+            info->blend = SDL_BlendSpan565_SSE2;
+        }
+#endif
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,50 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#ifndef SDL_blendspan_h_
+#define SDL_blendspan_h_
+
+typedef struct SDL_BlendSpanInfo SDL_BlendSpanInfo;
+
+typedef void (*SDL_BlendSpanFunc) (const SDL_BlendSpanInfo * info, void *pixels, int count);
+
+struct SDL_BlendSpanInfo
+{
+    SDL_BlendSpanFunc blend;
+    SDL_BlendMode blendMode;
+    Uint32 color;       /* r, g, b, a in the destination layout (8888 only) */
+    Uint32 opmask;      /* destination bits replaced by the blended color */
+    Uint32 keepmask;    /* destination bits that are left alone */
+    Uint8 r, g, b, a, inva;
+};
+
+/* Sets up blending a run of pixels in a row with the given color, which
+   is already multiplied by alpha for the blend and add modes.  Returns
+   SDL_FALSE if there is no span blender for the format and blend mode, in
+   which case the per-pixel SDL_draw.h macros should be used. */
+extern SDL_bool SDL_SetupBlendSpan(SDL_BlendSpanInfo * info, const SDL_PixelFormat * fmt, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+#define SDL_BlendSpan(info, pixels, count) (info)->blend(info, pixels, count)
+
+#endif /* SDL_blendspan_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,605 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_draw.h"
+#include "SDL_blendfillrect.h"
+#include "SDL_blendpoint.h"
+#include "SDL_drawlinef.h"
+
+
+typedef struct
+{
+    SDL_Surface *dst;
+    SDL_Rect clip;
+    SDL_BlendMode blendMode;
+    Uint8 r, g, b, a;
+    Uint32 color;               /* mapped color for SDL_BLENDMODE_NONE */
+    SDL_BlendPointFunc blend;
+} SDL_LineContext;
+
+/* Blends one pixel, already clipped, covered by the given fraction of 255 */
+static void
+SDL_PlotCoverage(const SDL_LineContext * ctx, int x, int y, unsigned coverage)
+{
+    unsigned r = ctx->r, g = ctx->g, b = ctx->b, a = ctx->a;
+
+    if (coverage == 0) {
+        return;
+    }
+
+    switch (ctx->blendMode) {
+    case SDL_BLENDMODE_NONE:
+        /* Edges are blended over the background, full pixels replace it */
+        if (coverage >= 0xFF) {
+            ctx->blend(ctx->dst, x, y, SDL_BLENDMODE_NONE, r, g, b, a);
+        } else {
+            ctx->blend(ctx->dst, x, y, SDL_BLENDMODE_BLEND,
+                       DRAW_MUL(r, coverage), DRAW_MUL(g, coverage),
+                       DRAW_MUL(b, coverage), coverage);
+        }
+        break;
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_ADD:
+        a = DRAW_MUL(a, coverage);
+        ctx->blend(ctx->dst, x, y, ctx->blendMode,
+                   DRAW_MUL(r, a), DRAW_MUL(g, a), DRAW_MUL(b, a), a);
+        break;
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+        ctx->blend(ctx->dst, x, y, SDL_BLENDMODE_BLEND,
+                   DRAW_MUL(r, coverage), DRAW_MUL(g, coverage),
+                   DRAW_MUL(b, coverage), DRAW_MUL(a, coverage));
+        break;
+    case SDL_BLENDMODE_MOD:
+        /* Partial coverage moves the modulation color towards white */
+        ctx->blend(ctx->dst, x, y, SDL_BLENDMODE_MOD,
+                   0xFF - DRAW_MUL(0xFF - r, coverage),
+                   0xFF - DRAW_MUL(0xFF - g, coverage),
+                   0xFF - DRAW_MUL(0xFF - b, coverage), a);
+        break;
+    default:
+        break;
+    }
+}
+
+static SDL_INLINE void
+SDL_PlotCoverageClipped(const SDL_LineContext * ctx, int x, int y, float coverage)
+{
+    if (x >= ctx->clip.x && y >= ctx->clip.y &&
+        x < ctx->clip.x + ctx->clip.w && y < ctx->clip.y + ctx->clip.h) {
+        SDL_PlotCoverage(ctx, x, y, (unsigned) (coverage * 255.0f + 0.5f));
+    }
+}
+
+/* Fills pixels x0 through x1 of row y, already clipped, with full coverage */
+static void
+SDL_FillSpan(const SDL_LineContext * ctx, int x0, int x1, int y)
+{
+    SDL_Rect rect;
+
+    if (x0 > x1) {
+        return;
+    }
+    rect.x = x0;
+    rect.y = y;
+    rect.w = x1 - x0 + 1;
+    rect.h = 1;
+    if (ctx->blendMode == SDL_BLENDMODE_NONE) {
+        SDL_FillRect(ctx->dst, &rect, ctx->color);
+    } else {
+        SDL_BlendFillRect(ctx->dst, &rect, ctx->blendMode,
+                          ctx->r, ctx->g, ctx->b, ctx->a);
+    }
+}
+
+/* Callers clamp or clip coordinates to near the clip rect first, so they
+   fit in an int */
+static SDL_INLINE int
+SDL_ifloor(float x)
+{
+    const int i = (int) x;
+    return (x < (float) i) ? (i - 1) : i;
+}
+
+static SDL_INLINE int
+SDL_iceil(float x)
+{
+    return -SDL_ifloor(-x);
+}
+
+#define FPART(x)    ((x) - (float) SDL_ifloor(x))
+#define RFPART(x)   (1.0f - FPART(x))
+
+/* Clips one side of a segment in Liang-Barsky form, where p is the change
+   along the segment towards the outside and q the distance to the edge */
+static SDL_bool
+SDL_ClipLineEdge(double p, double q, double *t0, double *t1)
+{
+    double t;
+
+    if (p == 0.0) {
+        return (q >= 0.0);
+    }
+    t = q / p;
+    if (p < 0.0) {
+        if (t > *t1) {
+            return SDL_FALSE;
+        }
+        if (t > *t0) {
+            *t0 = t;
+        }
+    } else {
+        if (t < *t0) {
+            return SDL_FALSE;
+        }
+        if (t < *t1) {
+            *t1 = t;
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* Clips a segment to the clip rect grown by margin pixels on each side,
+   returns SDL_FALSE if nothing of it is left or it isn't finite.  This is
+   done in double precision, where the distances between any two floats
+   are finite. */
+static SDL_bool
+SDL_ClipLineF(const SDL_Rect * clip, float margin,
+              float *x0, float *y0, float *x1, float *y1)
+{
+    const double left = (double) clip->x - margin;
+    const double top = (double) clip->y - margin;
+    const double right = (double) (clip->x + clip->w - 1) + margin;
+    const double bottom = (double) (clip->y + clip->h - 1) + margin;
+    const double dx = (double) *x1 - *x0, dy = (double) *y1 - *y0;
+    double t0 = 0.0, t1 = 1.0;
+
+    /* NaN and infinity don't compare as finite numbers do */
+    if (!(dx - dx == 0.0 && dy - dy == 0.0)) {
+        return SDL_FALSE;
+    }
+    if (!SDL_ClipLineEdge(-dx, *x0 - left, &t0, &t1) ||
+        !SDL_ClipLineEdge(dx, right - *x0, &t0, &t1) ||
+        !SDL_ClipLineEdge(-dy, *y0 - top, &t0, &t1) ||
+        !SDL_ClipLineEdge(dy, bottom - *y0, &t0, &t1)) {
+        return SDL_FALSE;
+    }
+    if (t1 < 1.0) {
+        *x1 = (float) (*x0 + t1 * dx);
+        *y1 = (float) (*y0 + t1 * dy);
+    }
+    if (t0 > 0.0) {
+        *x0 = (float) (*x0 + t0 * dx);
+        *y0 = (float) (*y0 + t0 * dy);
+    }
+    return SDL_TRUE;
+}
+
+/* How the pixels of a Wu line end point are drawn */
+typedef enum
+{
+    SDL_WU_CAP,     /* covered by how far the line reaches into them */
+    SDL_WU_JOINED,  /* fully, as the line goes on in another segment */
+    SDL_WU_SKIP     /* not at all, another segment draws them */
+} SDL_WuEnd;
+
+/* Xiaolin Wu's anti-aliased line, with coverage scaled by intensity.  In a
+   polyline every segment but the last skips its end point and every one but
+   the first draws its start point as joined, so the shared points are
+   blended once and with full coverage. */
+static void
+SDL_DrawWuLine(const SDL_LineContext * ctx, float x0, float y0,
+               float x1, float y1, float intensity,
+               SDL_WuEnd start, SDL_WuEnd end)
+{
+    const SDL_bool steep = (SDL_fabs(y1 - y0) > SDL_fabs(x1 - x0));
+    SDL_WuEnd first = start, last = end;
+    float gradient, xend, yend, xgap, intery;
+    int xpxl1, xpxl2, x, xmin, xmax;
+
+    /* Keep the coordinates in int range.  The end points that clipping
+       makes are two pixels outside the clip rect, where their partial
+       coverage doesn't show. */
+    if (!SDL_ClipLineF(&ctx->clip, 2.0f, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+
+    if (steep) {
+        float tmp;
+        tmp = x0; x0 = y0; y0 = tmp;
+        tmp = x1; x1 = y1; y1 = tmp;
+        xmin = ctx->clip.y;
+        xmax = ctx->clip.y + ctx->clip.h - 1;
+    } else {
+        xmin = ctx->clip.x;
+        xmax = ctx->clip.x + ctx->clip.w - 1;
+    }
+    if (x0 > x1) {
+        float tmp;
+        tmp = x0; x0 = x1; x1 = tmp;
+        tmp = y0; y0 = y1; y1 = tmp;
+        first = end;
+        last = start;
+    }
+    if (x1 < xmin - 1 || x0 > xmax + 1) {
+        return;
+    }
+    gradient = (x1 > x0) ? (y1 - y0) / (x1 - x0) : 1.0f;
+
+#define WU_PLOT(X, Y, C) \
+    if (steep) { \
+        SDL_PlotCoverageClipped(ctx, Y, X, (C) * intensity); \
+    } else { \
+        SDL_PlotCoverageClipped(ctx, X, Y, (C) * intensity); \
+    }
+
+    /* First end point */
+    xpxl1 = SDL_ifloor(x0 + 0.5f);
+    xend = (float) xpxl1;
+    yend = y0 + gradient * (xend - x0);
+    xgap = (first == SDL_WU_CAP) ? RFPART(x0 + 0.5f) : 1.0f;
+    if (first != SDL_WU_SKIP) {
+        WU_PLOT(xpxl1, SDL_ifloor(yend), RFPART(yend) * xgap);
+        WU_PLOT(xpxl1, SDL_ifloor(yend) + 1, FPART(yend) * xgap);
+    }
+    intery = yend + gradient;
+
+    /* Second end point */
+    xpxl2 = SDL_ifloor(x1 + 0.5f);
+    xend = (float) xpxl2;
+    yend = y1 + gradient * (xend - x1);
+    xgap = (last == SDL_WU_CAP) ? FPART(x1 + 0.5f) : 1.0f;
+    if (xpxl2 != xpxl1 && last != SDL_WU_SKIP) {
+        WU_PLOT(xpxl2, SDL_ifloor(yend), RFPART(yend) * xgap);
+        WU_PLOT(xpxl2, SDL_ifloor(yend) + 1, FPART(yend) * xgap);
+    }
+
+    /* Only walk the part of the line inside the clip rect */
+    x = xpxl1 + 1;
+    if (x < xmin) {
+        intery += gradient * (xmin - x);
+        x = xmin;
+    }
+    if (xpxl2 - 1 < xmax) {
+        xmax = xpxl2 - 1;
+    }
+    for (; x <= xmax; ++x) {
+        const int y = SDL_ifloor(intery);
+        WU_PLOT(x, y, RFPART(intery));
+        WU_PLOT(x, y + 1, FPART(intery));
+        intery += gradient;
+    }
+#undef WU_PLOT
+}
+
+typedef struct
+{
+    float x0, y0, x1, y1;
+    float dx, dy;
+    float len2, len;
+} SDL_LineSegment;
+
+/* Finds the range of x on row y within radius of the segment.  The round
+   capped stroke is convex, so the ranges from the end caps and from the
+   band along the segment overlap and merge into a single span. */
+static SDL_bool
+SDL_GetStrokeSpan(const SDL_LineSegment * seg, float y, float radius,
+                  float *xmin, float *xmax)
+{
+    const float r2 = radius * radius;
+    float lo = 0.0f, hi = -1.0f, d;
+    SDL_bool found = SDL_FALSE;
+
+#define MERGE_SPAN(L, H) \
+    if (!found) { lo = (L); hi = (H); found = SDL_TRUE; } \
+    else { if ((L) < lo) lo = (L); if ((H) > hi) hi = (H); }
+
+    d = y - seg->y0;
+    if (d * d <= r2) {
+        const float h = SDL_sqrtf(r2 - d * d);
+        MERGE_SPAN(seg->x0 - h, seg->x0 + h);
+    }
+    d = y - seg->y1;
+    if (d * d <= r2) {
+        const float h = SDL_sqrtf(r2 - d * d);
+        MERGE_SPAN(seg->x1 - h, seg->x1 + h);
+    }
+
+    if (seg->len2 > 0.0f) {
+        const float ry = y - seg->y0;
+        float blo, bhi, t0, t1;
+        SDL_bool band = SDL_TRUE;
+
+        /* Points that project onto the segment */
+        if (seg->dx != 0.0f) {
+            t0 = seg->x0 - ry * seg->dy / seg->dx;
+            t1 = seg->x0 + (seg->len2 - ry * seg->dy) / seg->dx;
+            blo = SDL_min(t0, t1);
+            bhi = SDL_max(t0, t1);
+        } else {
+            const float t = ry * seg->dy / seg->len2;
+            band = (t >= 0.0f && t <= 1.0f);
+            blo = seg->x0 - radius;
+            bhi = seg->x0 + radius;
+        }
+
+        /* Points within radius of the line through the segment */
+        if (seg->dy != 0.0f) {
+            t0 = seg->x0 + (ry * seg->dx - radius * seg->len) / seg->dy;
+            t1 = seg->x0 + (ry * seg->dx + radius * seg->len) / seg->dy;
+            blo = SDL_max(blo, SDL_min(t0, t1));
+            bhi = SDL_min(bhi, SDL_max(t0, t1));
+        } else if (ry * ry > r2) {
+            band = SDL_FALSE;
+        }
+
+        if (band && blo <= bhi) {
+            MERGE_SPAN(blo, bhi);
+        }
+    }
+#undef MERGE_SPAN
+
+    *xmin = lo;
+    *xmax = hi;
+    return found;
+}
+
+static float
+SDL_GetSegmentDistance(const SDL_LineSegment * seg, float x, float y)
+{
+    float t = 0.0f, px, py;
+
+    if (seg->len2 > 0.0f) {
+        t = ((x - seg->x0) * seg->dx + (y - seg->y0) * seg->dy) / seg->len2;
+        t = SDL_max(0.0f, SDL_min(t, 1.0f));
+    }
+    px = x - (seg->x0 + t * seg->dx);
+    py = y - (seg->y0 + t * seg->dy);
+    return SDL_sqrtf(px * px + py * py);
+}
+
+static void
+SDL_SetupLineSegment(SDL_LineSegment * seg, const SDL_FPoint * p0,
+                     const SDL_FPoint * p1)
+{
+    seg->x0 = p0->x;
+    seg->y0 = p0->y;
+    seg->x1 = p1->x;
+    seg->y1 = p1->y;
+    seg->dx = seg->x1 - seg->x0;
+    seg->dy = seg->y1 - seg->y0;
+    seg->len2 = seg->dx * seg->dx + seg->dy * seg->dy;
+    seg->len = SDL_sqrtf(seg->len2);
+}
+
+/* The clipped pixels of a row that a wide segment touches */
+typedef struct
+{
+    int xa, xb;     /* every pixel with some coverage */
+    int ia, ib;     /* the fully covered ones, none if ia > ib */
+} SDL_StrokeRow;
+
+static SDL_bool
+SDL_GetStrokeRow(const SDL_LineContext * ctx, const SDL_LineSegment * seg,
+                 int y, float radius, SDL_bool antialias, SDL_StrokeRow * row)
+{
+    const float outer = antialias ? radius + 0.5f : radius;
+    const float inner = radius - 0.5f;
+    const int clipx0 = ctx->clip.x, clipx1 = ctx->clip.x + ctx->clip.w - 1;
+    float lo, hi;
+
+    if (!SDL_GetStrokeSpan(seg, (float) y, outer, &lo, &hi)) {
+        return SDL_FALSE;
+    }
+    if (hi < (float) clipx0 || lo > (float) clipx1) {
+        return SDL_FALSE;
+    }
+    row->xa = SDL_iceil(SDL_max(lo, (float) clipx0));
+    row->xb = SDL_ifloor(SDL_min(hi, (float) clipx1));
+    if (!antialias) {
+        row->ia = row->xa;
+        row->ib = row->xb;
+        return SDL_TRUE;
+    }
+
+    /* Pixels further in than half a pixel are fully covered */
+    row->ia = row->xb + 1;
+    row->ib = row->xb;
+    if (inner > 0.0f && SDL_GetStrokeSpan(seg, (float) y, inner, &lo, &hi)) {
+        const int ia = SDL_iceil(SDL_max(lo, (float) row->xa));
+        const int ib = SDL_ifloor(SDL_min(hi, (float) row->xb));
+        if (ia <= ib) {
+            row->ia = ia;
+            row->ib = ib;
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* Anti-aliased edge pixels are covered by how far their centers are from
+   the stroke */
+static unsigned
+SDL_GetStrokeCoverage(const SDL_LineSegment * seg, const SDL_StrokeRow * row,
+                      int x, int y, float outer)
+{
+    float d;
+
+    if (x < row->xa || x > row->xb) {
+        return 0;
+    }
+    if (x >= row->ia && x <= row->ib) {
+        return 0xFF;
+    }
+    d = SDL_GetSegmentDistance(seg, (float) x, (float) y);
+    return (unsigned) (SDL_max(0.0f, SDL_min(outer - d, 1.0f)) * 255.0f + 0.5f);
+}
+
+/* Rasterizes a wide segment one clipped row at a time.  The interior of each
+   row is filled as a span, and the edge pixels are blended by coverage.
+   Pixels that the previous or next segment of a polyline also touches are
+   drawn by whichever covers them most, so joins aren't blended twice. */
+static void
+SDL_DrawWideLine(const SDL_LineContext * ctx, const SDL_LineSegment * seg,
+                 const SDL_LineSegment * prev, const SDL_LineSegment * next,
+                 float width, SDL_bool antialias)
+{
+    const float radius = width * 0.5f;
+    const float outer = antialias ? radius + 0.5f : radius;
+    const int clipy1 = ctx->clip.y + ctx->clip.h - 1;
+    float top, bottom;
+    int y, ymin, ymax;
+
+    top = SDL_min(seg->y0, seg->y1) - outer;
+    bottom = SDL_max(seg->y0, seg->y1) + outer;
+    if (bottom < (float) ctx->clip.y || top >= (float) (ctx->clip.y + ctx->clip.h)) {
+        return;
+    }
+    ymin = SDL_max(SDL_iceil(SDL_max(top, (float) ctx->clip.y)), ctx->clip.y);
+    ymax = SDL_min(SDL_ifloor(SDL_min(bottom, (float) clipy1)), clipy1);
+
+    for (y = ymin; y <= ymax; ++y) {
+        SDL_StrokeRow row, prow, nrow;
+        SDL_bool shared_prev, shared_next;
+        int x;
+
+        if (!SDL_GetStrokeRow(ctx, seg, y, radius, antialias, &row)) {
+            continue;
+        }
+        shared_prev = (prev && SDL_GetStrokeRow(ctx, prev, y, radius, antialias, &prow) &&
+                       prow.xa <= row.xb && prow.xb >= row.xa);
+        shared_next = (next && SDL_GetStrokeRow(ctx, next, y, radius, antialias, &nrow) &&
+                       nrow.xa <= row.xb && nrow.xb >= row.xa);
+
+        if (shared_prev || shared_next) {
+            for (x = row.xa; x <= row.xb; ++x) {
+                const unsigned coverage = SDL_GetStrokeCoverage(seg, &row, x, y, outer);
+                if (shared_prev && SDL_GetStrokeCoverage(prev, &prow, x, y, outer) >= coverage) {
+                    continue;
+                }
+                if (shared_next && SDL_GetStrokeCoverage(next, &nrow, x, y, outer) > coverage) {
+                    continue;
+                }
+                if (coverage >= 0xFF) {
+                    SDL_FillSpan(ctx, x, x, y);
+                } else {
+                    SDL_PlotCoverage(ctx, x, y, coverage);
+                }
+            }
+            continue;
+        }
+
+        for (x = row.xa; x < row.ia && x <= row.xb; ++x) {
+            SDL_PlotCoverage(ctx, x, y, SDL_GetStrokeCoverage(seg, &row, x, y, outer));
+        }
+        SDL_FillSpan(ctx, row.ia, row.ib, y);
+        for (x = SDL_max(row.ib + 1, row.ia); x <= row.xb; ++x) {
+            SDL_PlotCoverage(ctx, x, y, SDL_GetStrokeCoverage(seg, &row, x, y, outer));
+        }
+    }
+}
+
+int
+SDL_DrawLinesF(SDL_Surface * dst, const SDL_FPoint * points, int count,
+               float width, SDL_bool antialias, SDL_BlendMode blendMode,
+               Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    SDL_LineContext ctx;
+    SDL_LineSegment segs[3];
+    SDL_bool closed;
+    int i;
+
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+
+    /* This function doesn't work on surfaces < 8 bpp */
+    if (dst->format->BitsPerPixel < 8) {
+        return SDL_SetError("SDL_DrawLinesF(): Unsupported surface format");
+    }
+
+    if (SDL_RectEmpty(&dst->clip_rect) || count < 2) {
+        return 0;
+    }
+
+    ctx.dst = dst;
+    ctx.clip = dst->clip_rect;
+    ctx.blendMode = blendMode;
+    ctx.r = r;
+    ctx.g = g;
+    ctx.b = b;
+    ctx.a = a;
+    ctx.color = SDL_MapRGBA(dst->format, r, g, b, a);
+    ctx.blend = SDL_GetBlendPointFunc(dst);
+
+    if (width <= 0.0f) {
+        width = 1.0f;
+    }
+
+    /* A closed polyline draws its first point for the last one as well */
+    closed = (count > 2 && points[0].x == points[count - 1].x &&
+              points[0].y == points[count - 1].y);
+
+    if (antialias && width <= 1.0f) {
+        for (i = 1; i < count; ++i) {
+            const SDL_FPoint *p0 = &points[i - 1];
+            const SDL_FPoint *p1 = &points[i];
+            const SDL_WuEnd start = (i > 1 || closed) ? SDL_WU_JOINED : SDL_WU_CAP;
+            const SDL_WuEnd end = (i < count - 1 || closed) ? SDL_WU_SKIP : SDL_WU_CAP;
+
+            SDL_DrawWuLine(&ctx, p0->x, p0->y, p1->x, p1->y, width, start, end);
+        }
+        return 0;
+    }
+
+    /* Wide segments are drawn knowing their neighbours, segs[1] is the
+       current one and segs[0] and segs[2] the ones before and after it */
+    SDL_SetupLineSegment(&segs[1], &points[0], &points[1]);
+    if (closed) {
+        SDL_SetupLineSegment(&segs[0], &points[count - 2], &points[count - 1]);
+    }
+    for (i = 1; i < count; ++i) {
+        const SDL_LineSegment *prev = NULL, *next = NULL;
+
+        if (i > 1 || closed) {
+            prev = &segs[0];
+        }
+        if (i < count - 1) {
+            SDL_SetupLineSegment(&segs[2], &points[i], &points[i + 1]);
+            next = &segs[2];
+        } else if (closed) {
+            SDL_SetupLineSegment(&segs[2], &points[0], &points[1]);
+            next = &segs[2];
+        }
+        SDL_DrawWideLine(&ctx, &segs[1], prev, next, width, antialias);
+
+        if (next) {
+            segs[0] = segs[1];
+            segs[1] = segs[2];
+        }
+    }
+    return 0;
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
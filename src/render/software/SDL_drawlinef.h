@@ -0,0 +1,32 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#include "../SDL_sysrender.h"
+
+/* Draws connected lines between points with floating point coordinates,
+   where integer coordinates are pixel centers.  Lines wider than one pixel
+   are filled as round capped strokes, and anti-aliased lines blend their
+   edges by coverage.  One pixel wide anti-aliased lines use Wu's algorithm.
+   The points that connected lines share are blended once. */
+extern int SDL_DrawLinesF(SDL_Surface * dst, const SDL_FPoint * points, int count, float width, SDL_bool antialias, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+/* vi: set ts=4 sw=4 expandtab: */
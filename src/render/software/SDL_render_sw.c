@@ -25,12 +25,14 @@
 #include "../SDL_sysrender.h"
 #include "SDL_render_sw_c.h"
 #include "SDL_hints.h"
+#include "SDL_cpuinfo.h"
 
 #include "SDL_draw.h"
 #include "SDL_blendfillrect.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
 #include "SDL_drawline.h"
+#include "SDL_drawlinef.h"
 #include "SDL_drawpoint.h"
 #include "SDL_rotate.h"
 
@@ -95,13 +97,224 @@ SDL_RenderDriver SW_RenderDriver = {
      0}
 };
 
+/* Everything that goes into a rotated copy made by SW_RenderCopyEx() */
+typedef struct
+{
+    SDL_Surface *src;
+    SDL_Rect srcrect;
+    double angle;
+    SDL_RendererFlip flip;
+    int scale_quality;
+    int w, h;
+    SDL_BlendMode blendmode;
+    Uint8 alphaMod, rMod, gMod, bMod;
+} SW_TransformKey;
+
+typedef struct SW_Transform
+{
+    SW_TransformKey key;
+    Uint32 hash;
+    SDL_Surface *rotated;
+    SDL_Surface *mask;
+    size_t size;
+    struct SW_Transform *prev;          /* more recently used */
+    struct SW_Transform *next;          /* less recently used */
+    struct SW_Transform *hash_next;
+} SW_Transform;
+
+#define SW_TRANSFORM_BUCKETS 64
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SDL_bool line_antialias;
+    float line_width;
+    SDL_Surface *tile;
+    SW_Transform *transforms[SW_TRANSFORM_BUCKETS];
+    SW_Transform *most_recent;
+    SW_Transform *least_recent;
+    size_t transform_size;
+    size_t transform_budget;
 } SW_RenderData;
 
 
+/* Rotated copies of textures are kept in a cache, in least recently used
+ * order, as long as they fit in the memory budget.  The copies of a texture
+ * are dropped whenever its pixels may change.
+ */
+static Uint32
+SW_HashTransformKey(const SW_TransformKey * key)
+{
+    const Uint8 *bytes = (const Uint8 *) key;
+    Uint32 hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < sizeof(*key); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void
+SW_FreeTransform(SW_RenderData * data, SW_Transform * transform)
+{
+    SW_Transform **link = &data->transforms[transform->hash % SW_TRANSFORM_BUCKETS];
+
+    while (*link != transform) {
+        link = &(*link)->hash_next;
+    }
+    *link = transform->hash_next;
+
+    if (transform->prev) {
+        transform->prev->next = transform->next;
+    } else {
+        data->most_recent = transform->next;
+    }
+    if (transform->next) {
+        transform->next->prev = transform->prev;
+    } else {
+        data->least_recent = transform->prev;
+    }
+    data->transform_size -= transform->size;
+
+    SDL_FreeSurface(transform->rotated);
+    if (transform->mask) {
+        SDL_FreeSurface(transform->mask);
+    }
+    SDL_free(transform);
+}
+
+static void
+SW_TrimTransforms(SW_RenderData * data, size_t budget)
+{
+    while (data->least_recent && data->transform_size > budget) {
+        SW_FreeTransform(data, data->least_recent);
+    }
+}
+
+/* Drops the rotated copies of src, or all of them if src is NULL */
+static void
+SW_InvalidateTransforms(SW_RenderData * data, SDL_Surface * src)
+{
+    SW_Transform *transform = data->most_recent;
+
+    while (transform) {
+        SW_Transform *next = transform->next;
+        if (!src || transform->key.src == src) {
+            SW_FreeTransform(data, transform);
+        }
+        transform = next;
+    }
+}
+
+static SW_Transform *
+SW_FindTransform(SW_RenderData * data, const SW_TransformKey * key)
+{
+    const Uint32 hash = SW_HashTransformKey(key);
+    SW_Transform *transform = data->transforms[hash % SW_TRANSFORM_BUCKETS];
+
+    while (transform) {
+        if (transform->hash == hash && SDL_memcmp(&transform->key, key, sizeof(*key)) == 0) {
+            break;
+        }
+        transform = transform->hash_next;
+    }
+    if (transform && transform->prev) {
+        /* Move it to the front of the list */
+        transform->prev->next = transform->next;
+        if (transform->next) {
+            transform->next->prev = transform->prev;
+        } else {
+            data->least_recent = transform->prev;
+        }
+        transform->prev = NULL;
+        transform->next = data->most_recent;
+        data->most_recent->prev = transform;
+        data->most_recent = transform;
+    }
+    return transform;
+}
+
+/* Takes ownership of the surfaces if they fit in the cache */
+static SW_Transform *
+SW_AddTransform(SW_RenderData * data, const SW_TransformKey * key,
+                SDL_Surface * rotated, SDL_Surface * mask)
+{
+    SW_Transform *transform;
+    size_t size = (size_t) rotated->pitch * rotated->h;
+
+    if (mask) {
+        size += (size_t) mask->pitch * mask->h;
+    }
+    if (size > data->transform_budget) {
+        return NULL;
+    }
+    transform = (SW_Transform *) SDL_malloc(sizeof(*transform));
+    if (!transform) {
+        return NULL;
+    }
+    SW_TrimTransforms(data, data->transform_budget - size);
+
+    /* Copied with the padding, which is compared too */
+    SDL_memcpy(&transform->key, key, sizeof(*key));
+    transform->hash = SW_HashTransformKey(key);
+    transform->rotated = rotated;
+    transform->mask = mask;
+    transform->size = size;
+    transform->hash_next = data->transforms[transform->hash % SW_TRANSFORM_BUCKETS];
+    data->transforms[transform->hash % SW_TRANSFORM_BUCKETS] = transform;
+    transform->prev = NULL;
+    transform->next = data->most_recent;
+    if (data->most_recent) {
+        data->most_recent->prev = transform;
+    } else {
+        data->least_recent = transform;
+    }
+    data->most_recent = transform;
+    data->transform_size += size;
+    return transform;
+}
+
+static void SDLCALL
+SW_TransformCacheChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SW_RenderData *data = (SW_RenderData *) userdata;
+
+    if (hint && *hint) {
+        data->transform_budget = (size_t) SDL_max(SDL_atoi(hint), 0) * 1024;
+    } else {
+        data->transform_budget = 4 * 1024 * 1024;
+    }
+    SW_TrimTransforms(data, data->transform_budget);
+}
+
+
+static void SDLCALL
+SW_LineAntialiasChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SW_RenderData *data = (SW_RenderData *) userdata;
+
+    if (hint && *hint == '1') {
+        data->line_antialias = SDL_TRUE;
+    } else {
+        data->line_antialias = SDL_FALSE;
+    }
+}
+
+static void SDLCALL
+SW_LineWidthChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SW_RenderData *data = (SW_RenderData *) userdata;
+
+    if (hint && *hint) {
+        data->line_width = (float)SDL_atof(hint);
+    } else {
+        data->line_width = 1.0f;
+    }
+}
+
+
 static SDL_Surface *
 SW_ActivateRenderer(SDL_Renderer * renderer)
 {
@@ -148,6 +361,13 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     data->surface = surface;
     data->window = surface;
 
+    SDL_AddHintCallback(SDL_HINT_RENDER_LINE_ANTIALIAS,
+                        SW_LineAntialiasChanged, data);
+    SDL_AddHintCallback(SDL_HINT_RENDER_LINE_WIDTH,
+                        SW_LineWidthChanged, data);
+    SDL_AddHintCallback(SDL_HINT_RENDER_TRANSFORM_CACHE,
+                        SW_TransformCacheChanged, data);
+
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
     renderer->CreateTexture = SW_CreateTexture;
@@ -283,10 +503,11 @@ static int
 SW_SetTextureBlendMode(SDL_Renderer * renderer, SDL_Texture * texture)
 {
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
-    /* If add or mod blending are ever enabled, permanently disable RLE (which doesn't support
-     * them) to avoid potentially frequent RLE encoding/decoding.
+    /* If add, mod or premultiplied blending are ever enabled, permanently disable RLE (which
+     * doesn't support them) to avoid potentially frequent RLE encoding/decoding.
      */
-    if ((texture->blendMode == SDL_BLENDMODE_ADD || texture->blendMode == SDL_BLENDMODE_MOD)) {
+    if ((texture->blendMode == SDL_BLENDMODE_ADD || texture->blendMode == SDL_BLENDMODE_MOD ||
+         texture->blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED)) {
         SDL_SetSurfaceRLE(surface, 0);
     }
     return SDL_SetSurfaceBlendMode(surface, texture->blendMode);
@@ -296,11 +517,13 @@ static int
 SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                  const SDL_Rect * rect, const void *pixels, int pitch)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
     Uint8 *src, *dst;
     int row;
     size_t length;
 
+    SW_InvalidateTransforms(data, surface);
     if(SDL_MUSTLOCK(surface))
         SDL_LockSurface(surface);
     src = (Uint8 *) pixels;
@@ -322,8 +545,13 @@ static int
 SW_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * rect, void **pixels, int *pitch)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
 
+    SW_InvalidateTransforms(data, surface);
+
+    /* The lock keeps an RLE encoding of the texture up to date */
+    SDL_LockSurface(surface);
     *pixels =
         (void *) ((Uint8 *) surface->pixels + rect->y * surface->pitch +
                   rect->x * surface->format->BytesPerPixel);
@@ -334,6 +562,7 @@ SW_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 static void
 SW_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    SDL_UnlockSurface((SDL_Surface *) texture->driverdata);
 }
 
 static int
@@ -343,6 +572,8 @@ SW_SetRenderTarget(SDL_Renderer * renderer, SDL_Texture * texture)
 
     if (texture ) {
         data->surface = (SDL_Surface *) texture->driverdata;
+        /* Rendering is going to change the texture */
+        SW_InvalidateTransforms(data, data->surface);
     } else {
         data->surface = data->window;
     }
@@ -454,6 +685,7 @@ static int
 SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
                    int count)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Point *final_points;
     int i, status;
@@ -462,6 +694,25 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         return -1;
     }
 
+    /* Anti-aliased and wide lines keep the sub-pixel end points */
+    if (data->line_antialias || data->line_width > 1.0f) {
+        SDL_FPoint *final_fpoints = SDL_stack_alloc(SDL_FPoint, count);
+        if (!final_fpoints) {
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < count; ++i) {
+            final_fpoints[i].x = renderer->viewport.x + points[i].x;
+            final_fpoints[i].y = renderer->viewport.y + points[i].y;
+        }
+        status = SDL_DrawLinesF(surface, final_fpoints, count,
+                                data->line_width, data->line_antialias,
+                                renderer->blendMode,
+                                renderer->r, renderer->g, renderer->b,
+                                renderer->a);
+        SDL_stack_free(final_fpoints);
+        return status;
+    }
+
     final_points = SDL_stack_alloc(SDL_Point, count);
     if (!final_points) {
         return SDL_OutOfMemory();
@@ -585,7 +836,14 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 static int
 GetScaleQuality(void)
 {
-    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+    static SDL_HintHandle *handle;
+    const char *hint;
+
+    /* This is checked on every rotated copy, so use a handle */
+    if (!handle) {
+        handle = SDL_GetHintHandle(SDL_HINT_RENDER_SCALE_QUALITY);
+    }
+    hint = SDL_GetHintFromHandle(handle);
 
     if (!hint || *hint == '0' || SDL_strcasecmp(hint, "nearest") == 0) {
         return 0;
@@ -594,48 +852,214 @@ GetScaleQuality(void)
     }
 }
 
+/* Finds out where the rotated copy goes by rotating the four final_rect
+   points around the center and then taking the extremes */
+static void
+SW_GetRotatedRect(const SDL_Rect * final_rect, const SDL_FPoint * center,
+                  double cangle, double sangle, int dstwidth, int dstheight,
+                  SDL_Rect * rect)
+{
+    const int abscenterx = final_rect->x + (int)center->x;
+    const int abscentery = final_rect->y + (int)center->y;
+    double px, py, p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y;
+
+    /* Compensate the angle inversion to match the behaviour of the other backends */
+    sangle = -sangle;
+
+    /* Top Left */
+    px = final_rect->x - abscenterx;
+    py = final_rect->y - abscentery;
+    p1x = px * cangle - py * sangle + abscenterx;
+    p1y = px * sangle + py * cangle + abscentery;
+
+    /* Top Right */
+    px = final_rect->x + final_rect->w - abscenterx;
+    py = final_rect->y - abscentery;
+    p2x = px * cangle - py * sangle + abscenterx;
+    p2y = px * sangle + py * cangle + abscentery;
+
+    /* Bottom Left */
+    px = final_rect->x - abscenterx;
+    py = final_rect->y + final_rect->h - abscentery;
+    p3x = px * cangle - py * sangle + abscenterx;
+    p3y = px * sangle + py * cangle + abscentery;
+
+    /* Bottom Right */
+    px = final_rect->x + final_rect->w - abscenterx;
+    py = final_rect->y + final_rect->h - abscentery;
+    p4x = px * cangle - py * sangle + abscenterx;
+    p4y = px * sangle + py * cangle + abscentery;
+
+    rect->x = (int)MIN(MIN(p1x, p2x), MIN(p3x, p4x));
+    rect->y = (int)MIN(MIN(p1y, p2y), MIN(p3y, p4y));
+    rect->w = dstwidth;
+    rect->h = dstheight;
+}
+
+/* Returns the size of the square, in pixels, that quarter turns are copied
+   through. The tile and the source rows it is gathered from should both fit
+   in the L1 data cache, so it's the largest power of two where they do. */
+static int
+SW_GetTileSize(int bpp)
+{
+    static int cache_size = 0;
+    int size = 256;
+
+    if (!cache_size) {
+        SDL_CPUTopology topology;
+
+        SDL_GetCPUTopology(&topology);
+        cache_size = (topology.l1d_cache_size > 0) ? topology.l1d_cache_size : 32 * 1024;
+    }
+    while (size > 16 && 2 * size * size * bpp > cache_size) {
+        size /= 2;
+    }
+    return size;
+}
+
+/* Copies a w x h block of pixels, where the source moves by xstep bytes for
+   each destination pixel and by ystep bytes for each destination row */
+static void
+SW_CopyTile(const Uint8 * src, int xstep, int ystep, Uint8 * dst, int dst_pitch,
+            int bpp, int w, int h)
+{
+    int x;
+
+    for (; h--; src += ystep, dst += dst_pitch) {
+        const Uint8 *sp = src;
+
+        if (xstep == bpp) {
+            SDL_memcpy(dst, src, w * bpp);
+            continue;
+        }
+        switch (bpp) {
+        case 4:
+            for (x = 0; x < w; ++x, sp += xstep) {
+                ((Uint32 *)dst)[x] = *(const Uint32 *)sp;
+            }
+            break;
+        case 2:
+            for (x = 0; x < w; ++x, sp += xstep) {
+                ((Uint16 *)dst)[x] = *(const Uint16 *)sp;
+            }
+            break;
+        default:
+            for (x = 0; x < w; ++x, sp += xstep) {
+                SDL_memcpy(dst + x * bpp, sp, bpp);
+            }
+            break;
+        }
+    }
+}
+
+/* Rotations by a multiple of 90 degrees and flips without scaling move each
+ * pixel to exactly one destination pixel.  Instead of rotating the whole
+ * source into a new surface and blitting that, the target area is walked in
+ * tiles: each tile is gathered from the source into a small reusable surface,
+ * which keeps the column-wise source reads of a quarter turn in cache, and is
+ * then blitted with the texture's blend mode and modulation.
+ */
 static int
-SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
-                const SDL_Rect * srcrect, const SDL_FRect * dstrect,
-                const double angle, const SDL_FPoint * center, const SDL_RendererFlip flip)
+SW_RenderCopyQuarterTurns(SW_RenderData * data, SDL_Surface * surface,
+                          SDL_Surface * src, const SDL_Rect * srcrect,
+                          const SDL_Rect * rect, int turns,
+                          const SDL_RendererFlip flip)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
-    SDL_Rect final_rect, tmp_rect;
-    SDL_Surface *src_clone, *src_rotated, *src_scaled;
-    SDL_Surface *mask = NULL, *mask_rotated = NULL;
-    int retval = 0, dstwidth, dstheight, abscenterx, abscentery;
-    double cangle, sangle, px, py, p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y;
+    const SDL_PixelFormat *fmt = src->format;
+    const int bpp = fmt->BytesPerPixel;
+    const int w = srcrect->w - 1, h = srcrect->h - 1;
+    const int tile_size = SW_GetTileSize(bpp);
+    SDL_Surface *tile = data->tile;
     SDL_BlendMode blendmode;
     Uint8 alphaMod, rMod, gMod, bMod;
-    int applyModulation = SDL_FALSE;
-    int blitRequired = SDL_FALSE;
-    int isOpaque = SDL_FALSE;
+    SDL_Rect clipped;
+    int ax, bx, cx, ay, by, cy;
+    int tx, ty;
 
-    if (!surface) {
-        return -1;
+    if (!SDL_IntersectRect(rect, &surface->clip_rect, &clipped)) {
+        return 0;
     }
 
-    if (renderer->viewport.x || renderer->viewport.y) {
-        final_rect.x = (int)(renderer->viewport.x + dstrect->x);
-        final_rect.y = (int)(renderer->viewport.y + dstrect->y);
-    } else {
-        final_rect.x = (int)dstrect->x;
-        final_rect.y = (int)dstrect->y;
+    /* The source pixel for target pixel (u, v) of the rotated rect is
+       (ax * u + bx * v + cx, ay * u + by * v + cy) inside srcrect */
+    switch (turns) {
+    case 0: ax = 1; bx = 0; cx = 0; ay = 0; by = 1; cy = 0; break;
+    case 1: ax = 0; bx = 1; cx = 0; ay = -1; by = 0; cy = h; break;
+    case 2: ax = -1; bx = 0; cx = w; ay = 0; by = -1; cy = h; break;
+    default: ax = 0; bx = -1; cx = w; ay = 1; by = 0; cy = 0; break;
+    }
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        ax = -ax;
+        bx = -bx;
+        cx = w - cx;
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        ay = -ay;
+        by = -by;
+        cy = h - cy;
     }
-    final_rect.w = (int)dstrect->w;
-    final_rect.h = (int)dstrect->h;
-
-    tmp_rect = final_rect;
-    tmp_rect.x = 0;
-    tmp_rect.y = 0;
 
-    /* It is possible to encounter an RLE encoded surface here and locking it is
-     * necessary because this code is going to access the pixel buffer directly.
-     */
-    if (SDL_MUSTLOCK(src)) {
-        SDL_LockSurface(src);
+    if (!tile || tile->w != tile_size || tile->format->BitsPerPixel != fmt->BitsPerPixel ||
+        tile->format->Rmask != fmt->Rmask || tile->format->Gmask != fmt->Gmask ||
+        tile->format->Bmask != fmt->Bmask || tile->format->Amask != fmt->Amask) {
+        SDL_FreeSurface(data->tile);
+        data->tile = tile = SDL_CreateRGBSurface(0, tile_size, tile_size,
+                                                 fmt->BitsPerPixel, fmt->Rmask,
+                                                 fmt->Gmask, fmt->Bmask, fmt->Amask);
+        if (!tile) {
+            return -1;
+        }
+    }
+    SDL_GetSurfaceBlendMode(src, &blendmode);
+    SDL_GetSurfaceAlphaMod(src, &alphaMod);
+    SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+    SDL_SetSurfaceBlendMode(tile, blendmode);
+    SDL_SetSurfaceAlphaMod(tile, alphaMod);
+    SDL_SetSurfaceColorMod(tile, rMod, gMod, bMod);
+
+    for (ty = clipped.y; ty < clipped.y + clipped.h; ty += tile_size) {
+        for (tx = clipped.x; tx < clipped.x + clipped.w; tx += tile_size) {
+            const int u = tx - rect->x, v = ty - rect->y;
+            const Uint8 *sp = (const Uint8 *)src->pixels +
+                (srcrect->y + ay * u + by * v + cy) * src->pitch +
+                (srcrect->x + ax * u + bx * v + cx) * bpp;
+            SDL_Rect tile_rect, dst_rect;
+
+            tile_rect.x = 0;
+            tile_rect.y = 0;
+            tile_rect.w = SDL_min(tile_size, clipped.x + clipped.w - tx);
+            tile_rect.h = SDL_min(tile_size, clipped.y + clipped.h - ty);
+            SW_CopyTile(sp, ax * bpp + ay * src->pitch, bx * bpp + by * src->pitch,
+                        (Uint8 *)tile->pixels, tile->pitch, bpp,
+                        tile_rect.w, tile_rect.h);
+
+            dst_rect.x = tx;
+            dst_rect.y = ty;
+            dst_rect.w = tile_rect.w;
+            dst_rect.h = tile_rect.h;
+            if (SDL_LowerBlit(tile, &tile_rect, surface, &dst_rect) < 0) {
+                return -1;
+            }
+        }
     }
+    return 0;
+}
+
+/* Makes the rotated copy of the source, and for the NONE blend mode the
+   rotated mask of the area it covers */
+static int
+SW_CreateRotatedSurfaces(SDL_Surface * src, const SDL_Rect * srcrect,
+                         const SDL_Rect * final_rect, const double angle,
+                         const SDL_RendererFlip flip, int scale_quality,
+                         SDL_BlendMode blendmode, int applyModulation, int isOpaque,
+                         int dstwidth, int dstheight, double cangle, double sangle,
+                         SDL_Surface ** rotated, SDL_Surface ** rotated_mask)
+{
+    SDL_Surface *src_clone, *src_scaled, *src_rotated = NULL;
+    SDL_Surface *mask = NULL, *mask_rotated = NULL;
+    Uint8 alphaMod, rMod, gMod, bMod;
+    int blitRequired = SDL_FALSE;
+    int retval = 0;
 
     /* Clone the source surface but use its pixel buffer directly.
      * The original source surface must be treated as read-only.
@@ -644,43 +1068,31 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                                          src->format->Rmask, src->format->Gmask,
                                          src->format->Bmask, src->format->Amask);
     if (src_clone == NULL) {
-        if (SDL_MUSTLOCK(src)) {
-            SDL_UnlockSurface(src);
-        }
         return -1;
     }
 
-    SDL_GetSurfaceBlendMode(src, &blendmode);
-    SDL_GetSurfaceAlphaMod(src, &alphaMod);
-    SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
-
     /* SDLgfx_rotateSurface only accepts 32-bit surfaces with a 8888 layout. Everything else has to be converted. */
     if (src->format->BitsPerPixel != 32 || SDL_PIXELLAYOUT(src->format->format) != SDL_PACKEDLAYOUT_8888 || !src->format->Amask) {
         blitRequired = SDL_TRUE;
     }
 
     /* If scaling and cropping is necessary, it has to be taken care of before the rotation. */
-    if (!(srcrect->w == final_rect.w && srcrect->h == final_rect.h && srcrect->x == 0 && srcrect->y == 0)) {
+    if (!(srcrect->w == final_rect->w && srcrect->h == final_rect->h && srcrect->x == 0 && srcrect->y == 0)) {
         blitRequired = SDL_TRUE;
     }
 
-    /* The color and alpha modulation has to be applied before the rotation when using the NONE and MOD blend modes. */
-    if ((blendmode == SDL_BLENDMODE_NONE || blendmode == SDL_BLENDMODE_MOD) && (alphaMod & rMod & gMod & bMod) != 255) {
-        applyModulation = SDL_TRUE;
+    if (applyModulation) {
+        SDL_GetSurfaceAlphaMod(src, &alphaMod);
+        SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
         SDL_SetSurfaceAlphaMod(src_clone, alphaMod);
         SDL_SetSurfaceColorMod(src_clone, rMod, gMod, bMod);
     }
 
-    /* Opaque surfaces are much easier to handle with the NONE blend mode. */
-    if (blendmode == SDL_BLENDMODE_NONE && !src->format->Amask && alphaMod == 255) {
-        isOpaque = SDL_TRUE;
-    }
-
     /* The NONE blend mode requires a mask for non-opaque surfaces. This mask will be used
      * to clear the pixels in the destination surface. The other steps are explained below.
      */
     if (blendmode == SDL_BLENDMODE_NONE && !isOpaque) {
-        mask = SDL_CreateRGBSurface(0, final_rect.w, final_rect.h, 32,
+        mask = SDL_CreateRGBSurface(0, final_rect->w, final_rect->h, 32,
                                     0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
         if (mask == NULL) {
             retval = -1;
@@ -693,8 +1105,12 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
      * or modulation is required. It's possible to use the source surface directly otherwise.
      */
     if (!retval && (blitRequired || applyModulation)) {
-        SDL_Rect scale_rect = tmp_rect;
-        src_scaled = SDL_CreateRGBSurface(0, final_rect.w, final_rect.h, 32,
+        SDL_Rect scale_rect;
+        scale_rect.x = 0;
+        scale_rect.y = 0;
+        scale_rect.w = final_rect->w;
+        scale_rect.h = final_rect->h;
+        src_scaled = SDL_CreateRGBSurface(0, final_rect->w, final_rect->h, 32,
                                           0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
         if (src_scaled == NULL) {
             retval = -1;
@@ -711,117 +1127,190 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     SDL_SetSurfaceBlendMode(src_clone, blendmode);
 
     if (!retval) {
-        SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, &dstwidth, &dstheight, &cangle, &sangle);
-        src_rotated = SDLgfx_rotateSurface(src_clone, angle, dstwidth/2, dstheight/2, GetScaleQuality(), flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL, dstwidth, dstheight, cangle, sangle);
+        src_rotated = SDLgfx_rotateSurface(src_clone, angle, dstwidth/2, dstheight/2, scale_quality, flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL, dstwidth, dstheight, cangle, sangle);
         if (src_rotated == NULL) {
             retval = -1;
         }
-        if (!retval && mask != NULL) {
-            /* The mask needed for the NONE blend mode gets rotated with the same parameters. */
-            mask_rotated = SDLgfx_rotateSurface(mask, angle, dstwidth/2, dstheight/2, SDL_FALSE, 0, 0, dstwidth, dstheight, cangle, sangle);
-            if (mask_rotated == NULL) {
-                retval = -1;
-            }
+    }
+    if (!retval && mask != NULL) {
+        /* The mask needed for the NONE blend mode gets rotated with the same parameters. */
+        mask_rotated = SDLgfx_rotateSurface(mask, angle, dstwidth/2, dstheight/2, SDL_FALSE, 0, 0, dstwidth, dstheight, cangle, sangle);
+        if (mask_rotated == NULL) {
+            retval = -1;
+        }
+    }
+
+    if (mask != NULL) {
+        SDL_FreeSurface(mask);
+    }
+    SDL_FreeSurface(src_clone);
+
+    if (retval < 0) {
+        if (src_rotated != NULL) {
+            SDL_FreeSurface(src_rotated);
+        }
+        return retval;
+    }
+    *rotated = src_rotated;
+    *rotated_mask = mask_rotated;
+    return 0;
+}
+
+static int
+SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
+                const SDL_Rect * srcrect, const SDL_FRect * dstrect,
+                const double angle, const SDL_FPoint * center, const SDL_RendererFlip flip)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+    SDL_Rect final_rect, tmp_rect;
+    SDL_Surface *src_rotated = NULL, *mask_rotated = NULL;
+    SW_TransformKey key;
+    SW_Transform *transform;
+    int retval = 0, dstwidth, dstheight, angle90;
+    double cangle, sangle;
+    SDL_BlendMode blendmode;
+    Uint8 alphaMod, rMod, gMod, bMod;
+    int applyModulation = SDL_FALSE;
+    int isOpaque = SDL_FALSE;
+
+    if (!surface) {
+        return -1;
+    }
+
+    if (renderer->viewport.x || renderer->viewport.y) {
+        final_rect.x = (int)(renderer->viewport.x + dstrect->x);
+        final_rect.y = (int)(renderer->viewport.y + dstrect->y);
+    } else {
+        final_rect.x = (int)dstrect->x;
+        final_rect.y = (int)dstrect->y;
+    }
+    final_rect.w = (int)dstrect->w;
+    final_rect.h = (int)dstrect->h;
+
+    tmp_rect = final_rect;
+    tmp_rect.x = 0;
+    tmp_rect.y = 0;
+
+    /* Quarter turns and flips without scaling don't need a rotated copy */
+    angle90 = (int)(angle/90);
+    if (angle90 == angle/90 && srcrect->w == final_rect.w && srcrect->h == final_rect.h) {
+        angle90 %= 4;
+        if (angle90 < 0) angle90 += 4; /* 0:0 deg, 1:90 deg, 2:180 deg, 3:270 deg */
+        if (angle90 == 0 && flip == SDL_FLIP_NONE) {
+            return SDL_BlitSurface(src, srcrect, surface, &final_rect);
         }
+        SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, &dstwidth, &dstheight, &cangle, &sangle);
+        SW_GetRotatedRect(&final_rect, center, cangle, sangle, dstwidth, dstheight, &tmp_rect);
+        return SW_RenderCopyQuarterTurns(data, surface, src, srcrect, &tmp_rect, angle90, flip);
+    }
+
+    SDL_GetSurfaceBlendMode(src, &blendmode);
+    SDL_GetSurfaceAlphaMod(src, &alphaMod);
+    SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+
+    /* The color and alpha modulation has to be applied before the rotation when using the NONE and MOD blend modes. */
+    if ((blendmode == SDL_BLENDMODE_NONE || blendmode == SDL_BLENDMODE_MOD) && (alphaMod & rMod & gMod & bMod) != 255) {
+        applyModulation = SDL_TRUE;
+    }
+
+    /* Opaque surfaces are much easier to handle with the NONE blend mode. */
+    if (blendmode == SDL_BLENDMODE_NONE && !src->format->Amask && alphaMod == 255) {
+        isOpaque = SDL_TRUE;
+    }
+
+    SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, &dstwidth, &dstheight, &cangle, &sangle);
+
+    /* Reuse the rotated copy from an earlier frame if nothing about it changed */
+    SDL_zero(key);
+    key.src = src;
+    key.srcrect = *srcrect;
+    key.angle = angle;
+    key.flip = flip;
+    key.scale_quality = GetScaleQuality();
+    key.w = final_rect.w;
+    key.h = final_rect.h;
+    key.blendmode = blendmode;
+    key.alphaMod = alphaMod;
+    key.rMod = rMod;
+    key.gMod = gMod;
+    key.bMod = bMod;
+    transform = SW_FindTransform(data, &key);
+    if (transform) {
+        src_rotated = transform->rotated;
+        mask_rotated = transform->mask;
+    } else {
+        retval = SW_CreateRotatedSurfaces(src, srcrect, &final_rect, angle, flip,
+                                          key.scale_quality, blendmode, applyModulation,
+                                          isOpaque, dstwidth, dstheight, cangle, sangle,
+                                          &src_rotated, &mask_rotated);
         if (!retval) {
-            /* Find out where the new origin is by rotating the four final_rect points around the center and then taking the extremes */
-            abscenterx = final_rect.x + (int)center->x;
-            abscentery = final_rect.y + (int)center->y;
-            /* Compensate the angle inversion to match the behaviour of the other backends */
-            sangle = -sangle;
-
-            /* Top Left */
-            px = final_rect.x - abscenterx;
-            py = final_rect.y - abscentery;
-            p1x = px * cangle - py * sangle + abscenterx;
-            p1y = px * sangle + py * cangle + abscentery;
-
-            /* Top Right */
-            px = final_rect.x + final_rect.w - abscenterx;
-            py = final_rect.y - abscentery;
-            p2x = px * cangle - py * sangle + abscenterx;
-            p2y = px * sangle + py * cangle + abscentery;
-
-            /* Bottom Left */
-            px = final_rect.x - abscenterx;
-            py = final_rect.y + final_rect.h - abscentery;
-            p3x = px * cangle - py * sangle + abscenterx;
-            p3y = px * sangle + py * cangle + abscentery;
-
-            /* Bottom Right */
-            px = final_rect.x + final_rect.w - abscenterx;
-            py = final_rect.y + final_rect.h - abscentery;
-            p4x = px * cangle - py * sangle + abscenterx;
-            p4y = px * sangle + py * cangle + abscentery;
-
-            tmp_rect.x = (int)MIN(MIN(p1x, p2x), MIN(p3x, p4x));
-            tmp_rect.y = (int)MIN(MIN(p1y, p2y), MIN(p3y, p4y));
-            tmp_rect.w = dstwidth;
-            tmp_rect.h = dstheight;
-
-            /* The NONE blend mode needs some special care with non-opaque surfaces.
-             * Other blend modes or opaque surfaces can be blitted directly.
+            transform = SW_AddTransform(data, &key, src_rotated, mask_rotated);
+        }
+    }
+
+    if (!retval) {
+        SW_GetRotatedRect(&final_rect, center, cangle, sangle, dstwidth, dstheight, &tmp_rect);
+
+        /* The NONE blend mode needs some special care with non-opaque surfaces.
+         * Other blend modes or opaque surfaces can be blitted directly.
+         */
+        if (blendmode != SDL_BLENDMODE_NONE || isOpaque) {
+            if (applyModulation == SDL_FALSE) {
+                /* If the modulation wasn't already applied, make it happen now. */
+                SDL_SetSurfaceAlphaMod(src_rotated, alphaMod);
+                SDL_SetSurfaceColorMod(src_rotated, rMod, gMod, bMod);
+            }
+            retval = SDL_BlitSurface(src_rotated, NULL, surface, &tmp_rect);
+        } else {
+            /* The NONE blend mode requires three steps to get the pixels onto the destination surface.
+             * First, the area where the rotated pixels will be blitted to get set to zero.
+             * This is accomplished by simply blitting a mask with the NONE blend mode.
+             * The colorkey set by the rotate function will discard the correct pixels.
              */
-            if (blendmode != SDL_BLENDMODE_NONE || isOpaque) {
-                if (applyModulation == SDL_FALSE) {
-                    /* If the modulation wasn't already applied, make it happen now. */
-                    SDL_SetSurfaceAlphaMod(src_rotated, alphaMod);
-                    SDL_SetSurfaceColorMod(src_rotated, rMod, gMod, bMod);
-                }
-                retval = SDL_BlitSurface(src_rotated, NULL, surface, &tmp_rect);
-            } else {
-                /* The NONE blend mode requires three steps to get the pixels onto the destination surface.
-                 * First, the area where the rotated pixels will be blitted to get set to zero.
-                 * This is accomplished by simply blitting a mask with the NONE blend mode.
-                 * The colorkey set by the rotate function will discard the correct pixels.
+            SDL_Rect mask_rect = tmp_rect;
+            SDL_SetSurfaceBlendMode(mask_rotated, SDL_BLENDMODE_NONE);
+            retval = SDL_BlitSurface(mask_rotated, NULL, surface, &mask_rect);
+            if (!retval) {
+                /* The next step copies the alpha value. This is done with the BLEND blend mode and
+                 * by modulating the source colors with 0. Since the destination is all zeros, this
+                 * will effectively set the destination alpha to the source alpha.
                  */
-                SDL_Rect mask_rect = tmp_rect;
-                SDL_SetSurfaceBlendMode(mask_rotated, SDL_BLENDMODE_NONE);
-                retval = SDL_BlitSurface(mask_rotated, NULL, surface, &mask_rect);
+                SDL_SetSurfaceColorMod(src_rotated, 0, 0, 0);
+                mask_rect = tmp_rect;
+                retval = SDL_BlitSurface(src_rotated, NULL, surface, &mask_rect);
                 if (!retval) {
-                    /* The next step copies the alpha value. This is done with the BLEND blend mode and
-                     * by modulating the source colors with 0. Since the destination is all zeros, this
-                     * will effectively set the destination alpha to the source alpha.
+                    /* The last step gets the color values in place. The ADD blend mode simply adds them to
+                     * the destination (where the color values are all zero). However, because the ADD blend
+                     * mode modulates the colors with the alpha channel, a surface without an alpha mask needs
+                     * to be created. This makes all source pixels opaque and the colors get copied correctly.
                      */
-                    SDL_SetSurfaceColorMod(src_rotated, 0, 0, 0);
-                    mask_rect = tmp_rect;
-                    retval = SDL_BlitSurface(src_rotated, NULL, surface, &mask_rect);
-                    if (!retval) {
-                        /* The last step gets the color values in place. The ADD blend mode simply adds them to
-                         * the destination (where the color values are all zero). However, because the ADD blend
-                         * mode modulates the colors with the alpha channel, a surface without an alpha mask needs
-                         * to be created. This makes all source pixels opaque and the colors get copied correctly.
-                         */
-                        SDL_Surface *src_rotated_rgb;
-                        src_rotated_rgb = SDL_CreateRGBSurfaceFrom(src_rotated->pixels, src_rotated->w, src_rotated->h,
-                                                                   src_rotated->format->BitsPerPixel, src_rotated->pitch,
-                                                                   src_rotated->format->Rmask, src_rotated->format->Gmask,
-                                                                   src_rotated->format->Bmask, 0);
-                        if (src_rotated_rgb == NULL) {
-                            retval = -1;
-                        } else {
-                            SDL_SetSurfaceBlendMode(src_rotated_rgb, SDL_BLENDMODE_ADD);
-                            retval = SDL_BlitSurface(src_rotated_rgb, NULL, surface, &tmp_rect);
-                            SDL_FreeSurface(src_rotated_rgb);
-                        }
+                    SDL_Surface *src_rotated_rgb;
+                    src_rotated_rgb = SDL_CreateRGBSurfaceFrom(src_rotated->pixels, src_rotated->w, src_rotated->h,
+                                                               src_rotated->format->BitsPerPixel, src_rotated->pitch,
+                                                               src_rotated->format->Rmask, src_rotated->format->Gmask,
+                                                               src_rotated->format->Bmask, 0);
+                    if (src_rotated_rgb == NULL) {
+                        retval = -1;
+                    } else {
+                        SDL_SetSurfaceBlendMode(src_rotated_rgb, SDL_BLENDMODE_ADD);
+                        retval = SDL_BlitSurface(src_rotated_rgb, NULL, surface, &tmp_rect);
+                        SDL_FreeSurface(src_rotated_rgb);
                     }
                 }
-                SDL_FreeSurface(mask_rotated);
-            }
-            if (src_rotated != NULL) {
-                SDL_FreeSurface(src_rotated);
             }
         }
     }
 
-    if (SDL_MUSTLOCK(src)) {
-        SDL_UnlockSurface(src);
-    }
-    if (mask != NULL) {
-        SDL_FreeSurface(mask);
-    }
-    if (src_clone != NULL) {
-        SDL_FreeSurface(src_clone);
+    /* Copies that didn't go into the cache are only needed for this call */
+    if (!transform) {
+        if (mask_rotated != NULL) {
+            SDL_FreeSurface(mask_rotated);
+        }
+        if (src_rotated != NULL) {
+            SDL_FreeSurface(src_rotated);
+        }
     }
     return retval;
 }
@@ -875,8 +1364,10 @@ SW_RenderPresent(SDL_Renderer * renderer)
 static void
 SW_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
 
+    SW_InvalidateTransforms(data, surface);
     SDL_FreeSurface(surface);
 }
 
@@ -885,6 +1376,16 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data) {
+        SDL_DelHintCallback(SDL_HINT_RENDER_LINE_ANTIALIAS,
+                            SW_LineAntialiasChanged, data);
+        SDL_DelHintCallback(SDL_HINT_RENDER_LINE_WIDTH,
+                            SW_LineWidthChanged, data);
+        SDL_DelHintCallback(SDL_HINT_RENDER_TRANSFORM_CACHE,
+                            SW_TransformCacheChanged, data);
+        SW_InvalidateTransforms(data, NULL);
+        SDL_FreeSurface(data->tile);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
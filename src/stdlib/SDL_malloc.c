@@ -28,28 +28,16 @@
 /* This file contains portable memory management functions for SDL */
 
 #include "SDL_stdinc.h"
+#include "SDL_atomic.h"
+#include "SDL_error.h"
+#include "SDL_malloc_c.h"
 
 #if defined(HAVE_MALLOC)
 
-void *SDL_malloc(size_t size)
-{
-    return malloc(size);
-}
-
-void *SDL_calloc(size_t nmemb, size_t size)
-{
-    return calloc(nmemb, size);
-}
-
-void *SDL_realloc(void *ptr, size_t size)
-{
-    return realloc(ptr, size);
-}
-
-void SDL_free(void *ptr)
-{
-    free(ptr);
-}
+#define real_malloc malloc
+#define real_calloc calloc
+#define real_realloc realloc
+#define real_free free
 
 #else  /* the rest of this is a LOT of tapdancing to implement malloc. :) */
 
@@ -60,6 +48,7 @@ void SDL_free(void *ptr)
 #define LACKS_STDLIB_H
 #define ABORT
 #define USE_LOCKS 1
+#define USE_DL_PREFIX
 
 /*
   This is a version (aka dlmalloc) of malloc/free/realloc written by
@@ -638,10 +627,6 @@ DEFAULT_MMAP_THRESHOLD       default: 256K
 
 #define memset  SDL_memset
 #define memcpy  SDL_memcpy
-#define malloc  SDL_malloc
-#define calloc  SDL_calloc
-#define realloc SDL_realloc
-#define free    SDL_free
 
 /*
   mallopt tuning options.  SVID/XPG defines four standard parameter
@@ -5259,6 +5244,198 @@ History:
 
 */
 
+#define real_malloc dlmalloc
+#define real_calloc dlcalloc
+#define real_realloc dlrealloc
+#define real_free dlfree
+
 #endif /* !HAVE_MALLOC */
 
+/* Memory functions used by SDL, which can be replaced by the application.
+   Tags without their own functions use the general ones. */
+static struct
+{
+    SDL_malloc_func malloc_func;
+    SDL_calloc_func calloc_func;
+    SDL_realloc_func realloc_func;
+    SDL_free_func free_func;
+    SDL_atomic_t num_allocations;
+} s_mem[SDL_NUM_MEMORY_TAGS] = {
+    { real_malloc, real_calloc, real_realloc, real_free, { 0 } }
+};
+
+void SDL_GetMemoryFunctions(SDL_malloc_func *malloc_func,
+                            SDL_calloc_func *calloc_func,
+                            SDL_realloc_func *realloc_func,
+                            SDL_free_func *free_func)
+{
+    SDL_GetMemoryFunctionsForTag(SDL_MEMORY_TAG_GENERAL, malloc_func, calloc_func, realloc_func, free_func);
+}
+
+int SDL_SetMemoryFunctions(SDL_malloc_func malloc_func,
+                           SDL_calloc_func calloc_func,
+                           SDL_realloc_func realloc_func,
+                           SDL_free_func free_func)
+{
+    return SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_GENERAL, malloc_func, calloc_func, realloc_func, free_func);
+}
+
+int SDL_GetNumAllocations(void)
+{
+    int tag, count = 0;
+
+    for (tag = 0; tag < SDL_NUM_MEMORY_TAGS; ++tag) {
+        count += SDL_AtomicGet(&s_mem[tag].num_allocations);
+    }
+    return count;
+}
+
+void SDL_GetMemoryFunctionsForTag(SDL_MemoryTag tag,
+                                  SDL_malloc_func *malloc_func,
+                                  SDL_calloc_func *calloc_func,
+                                  SDL_realloc_func *realloc_func,
+                                  SDL_free_func *free_func)
+{
+    if ((int)tag < 0 || tag >= SDL_NUM_MEMORY_TAGS || !s_mem[tag].malloc_func) {
+        tag = SDL_MEMORY_TAG_GENERAL;
+    }
+    if (malloc_func) {
+        *malloc_func = s_mem[tag].malloc_func;
+    }
+    if (calloc_func) {
+        *calloc_func = s_mem[tag].calloc_func;
+    }
+    if (realloc_func) {
+        *realloc_func = s_mem[tag].realloc_func;
+    }
+    if (free_func) {
+        *free_func = s_mem[tag].free_func;
+    }
+}
+
+int SDL_SetMemoryFunctionsForTag(SDL_MemoryTag tag,
+                                 SDL_malloc_func malloc_func,
+                                 SDL_calloc_func calloc_func,
+                                 SDL_realloc_func realloc_func,
+                                 SDL_free_func free_func)
+{
+    const SDL_bool reset = (!malloc_func && !calloc_func && !realloc_func && !free_func);
+
+    if ((int)tag < 0 || tag >= SDL_NUM_MEMORY_TAGS) {
+        return SDL_InvalidParamError("tag");
+    }
+    if (!reset || tag == SDL_MEMORY_TAG_GENERAL) {
+        if (!malloc_func) {
+            return SDL_InvalidParamError("malloc_func");
+        }
+        if (!calloc_func) {
+            return SDL_InvalidParamError("calloc_func");
+        }
+        if (!realloc_func) {
+            return SDL_InvalidParamError("realloc_func");
+        }
+        if (!free_func) {
+            return SDL_InvalidParamError("free_func");
+        }
+    }
+
+    s_mem[tag].malloc_func = malloc_func;
+    s_mem[tag].calloc_func = calloc_func;
+    s_mem[tag].realloc_func = realloc_func;
+    s_mem[tag].free_func = free_func;
+    return 0;
+}
+
+int SDL_GetNumAllocationsForTag(SDL_MemoryTag tag)
+{
+    if ((int)tag < 0 || tag >= SDL_NUM_MEMORY_TAGS) {
+        return SDL_InvalidParamError("tag");
+    }
+    return SDL_AtomicGet(&s_mem[tag].num_allocations);
+}
+
+void *SDL_TaggedMalloc(SDL_MemoryTag tag, size_t size)
+{
+    SDL_malloc_func malloc_func = s_mem[tag].malloc_func;
+    void *mem;
+
+    if (!malloc_func) {
+        malloc_func = s_mem[SDL_MEMORY_TAG_GENERAL].malloc_func;
+    }
+    mem = malloc_func(size);
+    if (mem) {
+        SDL_AtomicIncRef(&s_mem[tag].num_allocations);
+    }
+    return mem;
+}
+
+void *SDL_TaggedCalloc(SDL_MemoryTag tag, size_t nmemb, size_t size)
+{
+    SDL_calloc_func calloc_func = s_mem[tag].calloc_func;
+    void *mem;
+
+    if (!calloc_func) {
+        calloc_func = s_mem[SDL_MEMORY_TAG_GENERAL].calloc_func;
+    }
+    mem = calloc_func(nmemb, size);
+    if (mem) {
+        SDL_AtomicIncRef(&s_mem[tag].num_allocations);
+    }
+    return mem;
+}
+
+void *SDL_TaggedRealloc(SDL_MemoryTag tag, void *ptr, size_t size)
+{
+    SDL_realloc_func realloc_func = s_mem[tag].realloc_func;
+    void *mem;
+
+    /* Shrinking to nothing frees the block, count it like SDL_TaggedFree() */
+    if (ptr && !size) {
+        SDL_TaggedFree(tag, ptr);
+        return NULL;
+    }
+    if (!realloc_func) {
+        realloc_func = s_mem[SDL_MEMORY_TAG_GENERAL].realloc_func;
+    }
+    mem = realloc_func(ptr, size);
+    if (mem && !ptr) {
+        SDL_AtomicIncRef(&s_mem[tag].num_allocations);
+    }
+    return mem;
+}
+
+void SDL_TaggedFree(SDL_MemoryTag tag, void *ptr)
+{
+    SDL_free_func free_func = s_mem[tag].free_func;
+
+    if (!ptr) {
+        return;
+    }
+    if (!free_func) {
+        free_func = s_mem[SDL_MEMORY_TAG_GENERAL].free_func;
+    }
+    free_func(ptr);
+    (void)SDL_AtomicDecRef(&s_mem[tag].num_allocations);
+}
+
+void *SDL_malloc(size_t size)
+{
+    return SDL_TaggedMalloc(SDL_MEMORY_TAG_GENERAL, size);
+}
+
+void *SDL_calloc(size_t nmemb, size_t size)
+{
+    return SDL_TaggedCalloc(SDL_MEMORY_TAG_GENERAL, nmemb, size);
+}
+
+void *SDL_realloc(void *ptr, size_t size)
+{
+    return SDL_TaggedRealloc(SDL_MEMORY_TAG_GENERAL, ptr, size);
+}
+
+void SDL_free(void *ptr)
+{
+    SDL_TaggedFree(SDL_MEMORY_TAG_GENERAL, ptr);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,38 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#ifndef SDL_malloc_c_h_
+#define SDL_malloc_c_h_
+
+#include "SDL_stdinc.h"
+
+/* Allocations made on behalf of a subsystem, which go to the memory functions
+   set for its tag.  Memory has to be freed with the tag it was allocated
+   with, so only use these for memory that never leaves the subsystem. */
+extern void *SDL_TaggedMalloc(SDL_MemoryTag tag, size_t size);
+extern void *SDL_TaggedCalloc(SDL_MemoryTag tag, size_t nmemb, size_t size);
+extern void *SDL_TaggedRealloc(SDL_MemoryTag tag, void *ptr, size_t size);
+extern void SDL_TaggedFree(SDL_MemoryTag tag, void *ptr);
+
+#endif /* SDL_malloc_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -178,21 +178,31 @@ static char _ID[]="<qsort.c gjm 1.14 2016-02-21>";
 #define TRUNC_aligned		12
 #define TRUNC_words		12*WORD_BYTES	/* nb different meaning */
 
+/* BEGIN SDL CHANGE ... 8 byte objects (pointers, 64-bit integers and
+ * doubles) get the same treatment as words. */
+#define DWORD_BYTES sizeof(Uint64)
+#define TRUNC_dwords		12*DWORD_BYTES	/* nb different meaning */
+/* END SDL CHANGE ... 8 byte objects */
+
 /* We use a simple pivoting algorithm for shortish sub-arrays
  * and a more complicated one for larger ones. The threshold
  * is PIVOT_THRESHOLD.
  */
 #define PIVOT_THRESHOLD 40
 
-typedef struct { char * first; char * last; } stack_entry;
-#define pushLeft {stack[stacktop].first=ffirst;stack[stacktop++].last=last;}
-#define pushRight {stack[stacktop].first=first;stack[stacktop++].last=llast;}
+/* BEGIN SDL CHANGE ... each stack entry remembers how many times its
+ * subarray has been partitioned, see note 5 below. */
+typedef struct { char * first; char * last; int depth; } stack_entry;
+#define pushLeft {stack[stacktop].first=ffirst;stack[stacktop].last=last;stack[stacktop++].depth=depth;}
+#define pushRight {stack[stacktop].first=first;stack[stacktop].last=llast;stack[stacktop++].depth=depth;}
 #define doLeft {first=ffirst;llast=last;continue;}
 #define doRight {ffirst=first;last=llast;continue;}
 #define pop {if (--stacktop<0) break;\
   first=ffirst=stack[stacktop].first;\
   last=llast=stack[stacktop].last;\
+  depth=stack[stacktop].depth;\
   continue;}
+/* END SDL CHANGE ... stack depth */
 
 /* Some comments on the implementation.
  * 1. When we finish partitioning the array into "low"
@@ -234,6 +244,11 @@ typedef struct { char * first; char * last; } stack_entry;
  *    have that n^2 worst case.) However, the overhead
  *    from the extra bookkeeping means that it's just
  *    not worth while.
+ * 5' SDL change: instead, a subarray that has been
+ *    partitioned more than 2*log_2(nmemb) times is
+ *    heapsorted, as in Musser's introsort. That never
+ *    happens with reasonable data, and puts a bound of
+ *    order n log n on the worst case.
  * 6. This is pretty clean and portable code. Here are
  *    all the potential portability pitfalls and problems
  *    I know of:
@@ -264,6 +279,7 @@ typedef struct { char * first; char * last; } stack_entry;
  * strictly less than Trunc; we leave these unsorted. */
 #define Recurse(Trunc)				\
       { size_t l=last-ffirst,r=llast-first;	\
+        ++depth;				\
         if (l<Trunc) {				\
           if (r>=Trunc) doRight			\
           else pop				\
@@ -358,6 +374,11 @@ typedef struct { char * first; char * last; } stack_entry;
 #define SWAP_words(a,b) { \
   register int t=*((int*)a); *((int*)a)=*((int*)b); *((int*)b)=t; }
 
+/* BEGIN SDL CHANGE ... 8 byte objects */
+#define SWAP_dwords(a,b) { \
+  register Uint64 t=*((Uint64*)a); *((Uint64*)a)=*((Uint64*)b); *((Uint64*)b)=t; }
+/* END SDL CHANGE ... 8 byte objects */
+
 /* ---------------------------------------------------------------------- */
 
 static char * pivot_big(char *first, char *mid, char *last, size_t size,
@@ -401,11 +422,54 @@ fprintf(stderr,"-> %d %d %d @ %p %p %p\n",*(int*)m1,*(int*)m2,*(int*)m3, m1,m2,m
 
 /* ---------------------------------------------------------------------- */
 
+/* BEGIN SDL CHANGE ... heapsort for subarrays that pivoting does badly on */
+static int max_depth(size_t nmemb) {
+  int depth=0;
+  while (nmemb>>=1) depth+=2;
+  return depth;
+}
+
+static void swap_bytes(char *a, char *b, size_t size) {
+  do { char t=*a; *a++=*b; *b++=t; } while (--size);
+}
+
+static void sift_down(char *base, size_t root, size_t nmemb, size_t size,
+                      int compare(const void *, const void *)) {
+  size_t child;
+  while ((child=2*root+1)<nmemb) {
+    if (child+1<nmemb && compare(base+child*size,base+(child+1)*size)<0) ++child;
+    if (compare(base+root*size,base+child*size)>=0) break;
+    swap_bytes(base+root*size,base+child*size,size);
+    root=child;
+  }
+}
+
+/* Sorts [first,last], last being inclusive */
+static void heapsort_range(char *first, char *last, size_t size,
+                           int compare(const void *, const void *)) {
+  size_t nmemb=(last-first)/size+1, i;
+  for (i=nmemb/2;i>0;--i) sift_down(first,i-1,nmemb,size,compare);
+  for (i=nmemb-1;i>0;--i) {
+    swap_bytes(first,first+i*size,size);
+    sift_down(first,0,i,size,compare);
+  }
+}
+
+#define DepthCheck(sz)				\
+  if (depth>maxdepth) {				\
+    heapsort_range(first,last,sz,compare);	\
+    pop						\
+  }
+/* END SDL CHANGE ... heapsort */
+
+/* ---------------------------------------------------------------------- */
+
 static void qsort_nonaligned(void *base, size_t nmemb, size_t size,
            int (*compare)(const void *, const void *)) {
 
   stack_entry stack[STACK_SIZE];
   int stacktop=0;
+  int depth=0, maxdepth=max_depth(nmemb);
   char *first,*last;
   char *pivot=malloc(size);
   size_t trunc=TRUNC_nonaligned*size;
@@ -416,6 +480,7 @@ static void qsort_nonaligned(void *base, size_t nmemb, size_t size,
   if ((size_t)(last-first)>=trunc) {
     char *ffirst=first, *llast=last;
     while (1) {
+      DepthCheck(size);
       /* Select pivot */
       { char * mid=first+size*((last-first)/size >> 1);
         Pivot(SWAP_nonaligned,size);
@@ -437,6 +502,7 @@ static void qsort_aligned(void *base, size_t nmemb, size_t size,
 
   stack_entry stack[STACK_SIZE];
   int stacktop=0;
+  int depth=0, maxdepth=max_depth(nmemb);
   char *first,*last;
   char *pivot=malloc(size);
   size_t trunc=TRUNC_aligned*size;
@@ -447,6 +513,7 @@ static void qsort_aligned(void *base, size_t nmemb, size_t size,
   if ((size_t)(last-first)>=trunc) {
     char *ffirst=first,*llast=last;
     while (1) {
+      DepthCheck(size);
       /* Select pivot */
       { char * mid=first+size*((last-first)/size >> 1);
         Pivot(SWAP_aligned,size);
@@ -468,6 +535,7 @@ static void qsort_words(void *base, size_t nmemb,
 
   stack_entry stack[STACK_SIZE];
   int stacktop=0;
+  int depth=0, maxdepth=max_depth(nmemb);
   char *first,*last;
   char *pivot=malloc(WORD_BYTES);
   assert(pivot!=0);
@@ -482,6 +550,7 @@ fprintf(stderr,"Doing %d:%d: ",
         (first-(char*)base)/WORD_BYTES,
         (last-(char*)base)/WORD_BYTES);
 #endif
+      DepthCheck(WORD_BYTES);
       /* Select pivot */
       { char * mid=first+WORD_BYTES*((last-first) / (2*WORD_BYTES));
         Pivot(SWAP_words,WORD_BYTES);
@@ -513,18 +582,65 @@ fprintf(stderr, "after partitioning first=#%lu last=#%lu\n", (first-(char*)base)
   free(pivot);
 }
 
+/* BEGIN SDL CHANGE ... 8 byte objects, as qsort_words */
+static void qsort_dwords(void *base, size_t nmemb,
+           int (*compare)(const void *, const void *)) {
+
+  stack_entry stack[STACK_SIZE];
+  int stacktop=0;
+  int depth=0, maxdepth=max_depth(nmemb);
+  char *first,*last;
+  Uint64 pivot_value;
+  char *pivot=(char*)&pivot_value;
+
+  first=(char*)base; last=first+(nmemb-1)*DWORD_BYTES;
+
+  if (last-first>=TRUNC_dwords) {
+    char *ffirst=first, *llast=last;
+    while (1) {
+      DepthCheck(DWORD_BYTES);
+      /* Select pivot */
+      { char * mid=first+DWORD_BYTES*((last-first) / (2*DWORD_BYTES));
+        Pivot(SWAP_dwords,DWORD_BYTES);
+        *(Uint64*)pivot=*(Uint64*)mid;
+      }
+      /* Partition. */
+      Partition(SWAP_dwords,DWORD_BYTES);
+      /* Prepare to recurse/iterate. */
+      Recurse(TRUNC_dwords)
+    }
+  }
+  PreInsertion(SWAP_dwords,(TRUNC_dwords/DWORD_BYTES),DWORD_BYTES);
+  /* Now do insertion sort. */
+  last=((char*)base)+nmemb*DWORD_BYTES;
+  for (first=((char*)base)+DWORD_BYTES;first!=last;first+=DWORD_BYTES) {
+    /* Find the right place for |first|. */
+    Uint64 *pl=(Uint64*)(first-DWORD_BYTES),*pr=(Uint64*)first;
+    *(Uint64*)pivot=*(Uint64*)first;
+    for (;compare(pl,pivot)>0;pr=pl,--pl) {
+      *pr=*pl; }
+    if (pr!=(Uint64*)first) *pr=*(Uint64*)pivot;
+  }
+}
+/* END SDL CHANGE ... 8 byte objects */
+
 /* ---------------------------------------------------------------------- */
 
 extern void qsortG(void *base, size_t nmemb, size_t size,
            int (*compare)(const void *, const void *)) {
 
   if (nmemb<=1) return;
-  if (((int)base|size)&(WORD_BYTES-1))
+  /* BEGIN SDL CHANGE ... size_t rather than int, which truncates 64-bit
+   * pointers, and 8 byte objects. */
+  if (((size_t)base|size)&(WORD_BYTES-1))
     qsort_nonaligned(base,nmemb,size,compare);
-  else if (size!=WORD_BYTES)
-    qsort_aligned(base,nmemb,size,compare);
-  else
+  else if (size==WORD_BYTES)
     qsort_words(base,nmemb,compare);
+  else if (size==DWORD_BYTES && !((size_t)base&(DWORD_BYTES-1)))
+    qsort_dwords(base,nmemb,compare);
+  else
+    qsort_aligned(base,nmemb,size,compare);
+  /* END SDL CHANGE */
 }
 
 
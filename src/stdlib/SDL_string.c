@@ -262,46 +262,287 @@ SDL_ScanFloat(const char *text, double *valuep)
 }
 #endif
 
+#if !defined(HAVE_MEMSET) || !defined(HAVE_MEMCPY) || !defined(HAVE_MEMCMP) || !defined(HAVE_STRLEN) || !defined(HAVE_STRCHR)
+/* Without a C runtime these are used for every blit and audio copy, so
+   they work on 16 byte SSE2 or NEON vectors where the CPU has them, and
+   on machine words otherwise.
+ */
+#include "SDL_cpuinfo.h"
+
+#if defined(__SSE2__)
+#define SDL_STRING_SSE2 1
+#define SDL_TARGET_SSE2
+#elif defined(__i386__) && (defined(__clang__) || \
+      (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+/* 32-bit x86 isn't compiled for SSE2 by default, so only the SSE2 versions
+   are, and they are called if the CPU turns out to have it. */
+#define SDL_STRING_SSE2 1
+#define SDL_TARGET_SSE2 __attribute__((target("sse2")))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+/* The compiler only defines this when NEON is part of the target */
+#define SDL_STRING_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define SDL_WORD_ONES       (~(size_t)0 / 0xFF)
+#define SDL_WORD_HIGHS      (SDL_WORD_ONES << 7)
+#define SDL_WORD_HASZERO(w) (((w) - SDL_WORD_ONES) & ~(w) & SDL_WORD_HIGHS)
+#define SDL_IS_ALIGNED(p, n) (((uintptr_t)(p) & ((n) - 1)) == 0)
+
+#ifdef SDL_STRING_SSE2
+static SDL_INLINE SDL_bool
+SDL_StringHasSSE2(void)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return SDL_TRUE;
+#else
+    static int has_sse2 = -1;
+    if (has_sse2 < 0) {
+        has_sse2 = SDL_HasSSE2() ? 1 : 0;
+    }
+    return has_sse2 ? SDL_TRUE : SDL_FALSE;
+#endif
+}
+
+static SDL_INLINE int
+SDL_FirstBitIndex(Uint32 x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+#else
+    int index = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+#ifndef HAVE_MEMSET
+static void SDL_TARGET_SSE2
+SDL_memset_SSE2(Uint8 *dstp, Uint8 value, size_t len)
+{
+    const __m128i value_vec = _mm_set1_epi8((char) value);
+    const size_t head = 16 - ((uintptr_t)dstp & 15);
+
+    /* One unaligned store covers everything up to the first aligned
+       address, and another one the tail, overlapping if needed. */
+    _mm_storeu_si128((__m128i *) dstp, value_vec);
+    dstp += head;
+    len -= head;
+    while (len >= 64) {
+        _mm_store_si128((__m128i *) dstp, value_vec);
+        _mm_store_si128((__m128i *) (dstp + 16), value_vec);
+        _mm_store_si128((__m128i *) (dstp + 32), value_vec);
+        _mm_store_si128((__m128i *) (dstp + 48), value_vec);
+        dstp += 64;
+        len -= 64;
+    }
+    while (len >= 16) {
+        _mm_store_si128((__m128i *) dstp, value_vec);
+        dstp += 16;
+        len -= 16;
+    }
+    if (len) {
+        _mm_storeu_si128((__m128i *) (dstp + len - 16), value_vec);
+    }
+}
+#endif
+
+#if !defined(HAVE_MEMCPY) && !defined(HAVE_BCOPY)
+static void SDL_TARGET_SSE2
+SDL_memcpy_SSE2(Uint8 *dstp, const Uint8 *srcp, size_t len)
+{
+    const size_t head = 16 - ((uintptr_t)dstp & 15);
+
+    /* Align the stores, the loads can stay unaligned. The head and the
+       tail are unaligned copies that may overlap the aligned part. */
+    _mm_storeu_si128((__m128i *) dstp, _mm_loadu_si128((const __m128i *) srcp));
+    dstp += head;
+    srcp += head;
+    len -= head;
+    while (len >= 64) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) srcp);
+        const __m128i b = _mm_loadu_si128((const __m128i *) (srcp + 16));
+        const __m128i c = _mm_loadu_si128((const __m128i *) (srcp + 32));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (srcp + 48));
+        _mm_store_si128((__m128i *) dstp, a);
+        _mm_store_si128((__m128i *) (dstp + 16), b);
+        _mm_store_si128((__m128i *) (dstp + 32), c);
+        _mm_store_si128((__m128i *) (dstp + 48), d);
+        dstp += 64;
+        srcp += 64;
+        len -= 64;
+    }
+    while (len >= 16) {
+        _mm_store_si128((__m128i *) dstp, _mm_loadu_si128((const __m128i *) srcp));
+        dstp += 16;
+        srcp += 16;
+        len -= 16;
+    }
+    if (len) {
+        _mm_storeu_si128((__m128i *) (dstp + len - 16), _mm_loadu_si128((const __m128i *) (srcp + len - 16)));
+    }
+}
+#endif
+
+#ifndef HAVE_MEMCMP
+/* Compares whole vectors, returning the difference of the first bytes that
+   differ, or 0 with the pointers and length moved past the equal vectors */
+static int SDL_TARGET_SSE2
+SDL_memcmp_SSE2(const Uint8 **s1p, const Uint8 **s2p, size_t *len)
+{
+    const Uint8 *p1 = *s1p;
+    const Uint8 *p2 = *s2p;
+    size_t left = *len;
+
+    while (left >= 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) p1);
+        const __m128i b = _mm_loadu_si128((const __m128i *) p2);
+        const int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+        if (equal != 0xFFFF) {
+            const int i = SDL_FirstBitIndex(~equal & 0xFFFF);
+            return ((int) p1[i] - (int) p2[i]);
+        }
+        p1 += 16;
+        p2 += 16;
+        left -= 16;
+    }
+    *s1p = p1;
+    *s2p = p2;
+    *len = left;
+    return 0;
+}
+#endif
+
+#ifndef HAVE_STRLEN
+/* Returns the length of a string starting at a 16 byte aligned address */
+static size_t SDL_TARGET_SSE2
+SDL_strlen_SSE2(const char *string)
+{
+    const char *p = string;
+    const __m128i zero = _mm_setzero_si128();
+    int mask;
+
+    /* Check 64 bytes at a time, as the minimum of four vectors, once
+       p is aligned so that the block can't cross a page either. */
+    while (!SDL_IS_ALIGNED(p, 64)) {
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *) p), zero));
+        if (mask) {
+            return (p + SDL_FirstBitIndex(mask) - string);
+        }
+        p += 16;
+    }
+    for ( ; ; ) {
+        const __m128i a = _mm_load_si128((const __m128i *) p);
+        const __m128i b = _mm_load_si128((const __m128i *) (p + 16));
+        const __m128i c = _mm_load_si128((const __m128i *) (p + 32));
+        const __m128i d = _mm_load_si128((const __m128i *) (p + 48));
+        const __m128i m = _mm_min_epu8(_mm_min_epu8(a, b), _mm_min_epu8(c, d));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(m, zero))) {
+            break;
+        }
+        p += 64;
+    }
+    for ( ; ; ) {
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *) p), zero));
+        if (mask) {
+            return (p + SDL_FirstBitIndex(mask) - string);
+        }
+        p += 16;
+    }
+}
+#endif
+
+#if !defined(HAVE_STRCHR) && !defined(HAVE_INDEX)
+/* Finds ch in a string starting at a 16 byte aligned address */
+static char * SDL_TARGET_SSE2
+SDL_strchr_SSE2(const char *string, char ch)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ch_vec = _mm_set1_epi8(ch);
+
+    for ( ; ; ) {
+        const __m128i v = _mm_load_si128((const __m128i *) string);
+        const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero), _mm_cmpeq_epi8(v, ch_vec)));
+        if (mask) {
+            string += SDL_FirstBitIndex(mask);
+            return (*string == ch) ? (char *) string : NULL;
+        }
+        string += 16;
+    }
+}
+#endif
+#endif /* SDL_STRING_SSE2 */
+
+#ifdef SDL_STRING_NEON
+static SDL_INLINE SDL_bool
+SDL_AnyBitsNEON(uint8x16_t v)
+{
+    const uint64x2_t v64 = vreinterpretq_u64_u8(v);
+    return (vgetq_lane_u64(v64, 0) | vgetq_lane_u64(v64, 1)) ? SDL_TRUE : SDL_FALSE;
+}
+#endif
+#endif /* !HAVE_MEMSET || !HAVE_MEMCPY || !HAVE_MEMCMP || !HAVE_STRLEN || !HAVE_STRCHR */
+
 void *
 SDL_memset(SDL_OUT_BYTECAP(len) void *dst, int c, size_t len)
 {
 #if defined(HAVE_MEMSET)
     return memset(dst, c, len);
 #else
-    size_t left;
-    Uint32 *dstp4;
-    Uint8 *dstp1 = (Uint8 *) dst;
-    Uint32 value4 = (c | (c << 8) | (c << 16) | (c << 24));
-    Uint8 value1 = (Uint8) c;
-
-    /* The destination pointer needs to be aligned on a 4-byte boundary to
-     * execute a 32-bit set. Set first bytes manually if needed until it is
-     * aligned. */
-    while ((intptr_t)dstp1 & 0x3) {
-        if (len--) {
-            *dstp1++ = value1;
-        } else {
-            return dst;
+    Uint8 *dstp = (Uint8 *) dst;
+    const Uint8 value = (Uint8) c;
+    const size_t value_word = SDL_WORD_ONES * value;
+
+#if defined(SDL_STRING_SSE2)
+    if (len >= 16 && SDL_StringHasSSE2()) {
+        SDL_memset_SSE2(dstp, value, len);
+        return dst;
+    }
+#elif defined(SDL_STRING_NEON)
+    if (len >= 16) {
+        const uint8x16_t value_vec = vdupq_n_u8(value);
+        while (len >= 64) {
+            vst1q_u8(dstp, value_vec);
+            vst1q_u8(dstp + 16, value_vec);
+            vst1q_u8(dstp + 32, value_vec);
+            vst1q_u8(dstp + 48, value_vec);
+            dstp += 64;
+            len -= 64;
+        }
+        while (len >= 16) {
+            vst1q_u8(dstp, value_vec);
+            dstp += 16;
+            len -= 16;
+        }
+        if (len) {
+            vst1q_u8(dstp + len - 16, value_vec);
         }
+        return dst;
     }
+#endif
 
-    dstp4 = (Uint32 *) dstp1;
-    left = (len % 4);
-    len /= 4;
-    while (len--) {
-        *dstp4++ = value4;
+    /* The destination pointer needs to be aligned to execute word sized
+     * stores. Set first bytes manually if needed until it is aligned. */
+    while (len && !SDL_IS_ALIGNED(dstp, sizeof(size_t))) {
+        *dstp++ = value;
+        --len;
     }
-
-    dstp1 = (Uint8 *) dstp4;
-    switch (left) {
-    case 3:
-        *dstp1++ = value1;
-    case 2:
-        *dstp1++ = value1;
-    case 1:
-        *dstp1++ = value1;
+    while (len >= sizeof(size_t)) {
+        *(size_t *) dstp = value_word;
+        dstp += sizeof(size_t);
+        len -= sizeof(size_t);
+    }
+    while (len--) {
+        *dstp++ = value;
     }
-
     return dst;
 #endif /* HAVE_MEMSET */
 }
@@ -309,54 +550,81 @@ SDL_memset(SDL_OUT_BYTECAP(len) void *dst, int c, size_t len)
 void *
 SDL_memcpy(SDL_OUT_BYTECAP(len) void *dst, SDL_IN_BYTECAP(len) const void *src, size_t len)
 {
-#ifdef __GNUC__
-    /* Presumably this is well tuned for speed.
-       On my machine this is twice as fast as the C code below.
-     */
-    return __builtin_memcpy(dst, src, len);
-#elif defined(HAVE_MEMCPY)
+#if defined(HAVE_MEMCPY)
     return memcpy(dst, src, len);
 #elif defined(HAVE_BCOPY)
     bcopy(src, dst, len);
     return dst;
 #else
+    /* __builtin_memcpy() isn't used here: for sizes that aren't known at
+       compile time it is just a call to the C runtime's memcpy(). */
+    Uint8 *dstp = (Uint8 *) dst;
+    const Uint8 *srcp = (const Uint8 *) src;
+
+#if defined(SDL_STRING_SSE2)
+    if (len >= 16 && SDL_StringHasSSE2()) {
+        SDL_memcpy_SSE2(dstp, srcp, len);
+        return dst;
+    }
+#elif defined(SDL_STRING_NEON)
+    if (len >= 16) {
+        while (len >= 64) {
+            const uint8x16_t a = vld1q_u8(srcp);
+            const uint8x16_t b = vld1q_u8(srcp + 16);
+            const uint8x16_t c = vld1q_u8(srcp + 32);
+            const uint8x16_t d = vld1q_u8(srcp + 48);
+            vst1q_u8(dstp, a);
+            vst1q_u8(dstp + 16, b);
+            vst1q_u8(dstp + 32, c);
+            vst1q_u8(dstp + 48, d);
+            dstp += 64;
+            srcp += 64;
+            len -= 64;
+        }
+        while (len >= 16) {
+            vst1q_u8(dstp, vld1q_u8(srcp));
+            dstp += 16;
+            srcp += 16;
+            len -= 16;
+        }
+        if (len) {
+            vst1q_u8(dstp + len - 16, vld1q_u8(srcp + len - 16));
+        }
+        return dst;
+    }
+#endif
+
     /* GCC 4.9.0 with -O3 will generate movaps instructions with the loop
-       using Uint32* pointers, so we need to make sure the pointers are
+       using word pointers, so we need to make sure the pointers are
        aligned before we loop using them.
      */
-    if (((intptr_t)src & 0x3) || ((intptr_t)dst & 0x3)) {
-        /* Do an unaligned byte copy */
-        Uint8 *srcp1 = (Uint8 *)src;
-        Uint8 *dstp1 = (Uint8 *)dst;
-
-        while (len--) {
-            *dstp1++ = *srcp1++;
+    if (SDL_IS_ALIGNED((uintptr_t)srcp ^ (uintptr_t)dstp, sizeof(size_t))) {
+        while (len && !SDL_IS_ALIGNED(dstp, sizeof(size_t))) {
+            *dstp++ = *srcp++;
+            --len;
         }
-    } else {
-        size_t left = (len % 4);
-        Uint32 *srcp4, *dstp4;
-        Uint8 *srcp1, *dstp1;
-
-        srcp4 = (Uint32 *) src;
-        dstp4 = (Uint32 *) dst;
-        len /= 4;
-        while (len--) {
-            *dstp4++ = *srcp4++;
+        while (len >= 4 * sizeof(size_t)) {
+            ((size_t *) dstp)[0] = ((const size_t *) srcp)[0];
+            ((size_t *) dstp)[1] = ((const size_t *) srcp)[1];
+            ((size_t *) dstp)[2] = ((const size_t *) srcp)[2];
+            ((size_t *) dstp)[3] = ((const size_t *) srcp)[3];
+            dstp += 4 * sizeof(size_t);
+            srcp += 4 * sizeof(size_t);
+            len -= 4 * sizeof(size_t);
         }
-
-        srcp1 = (Uint8 *) srcp4;
-        dstp1 = (Uint8 *) dstp4;
-        switch (left) {
-        case 3:
-            *dstp1++ = *srcp1++;
-        case 2:
-            *dstp1++ = *srcp1++;
-        case 1:
-            *dstp1++ = *srcp1++;
+        while (len >= sizeof(size_t)) {
+            *(size_t *) dstp = *(const size_t *) srcp;
+            dstp += sizeof(size_t);
+            srcp += sizeof(size_t);
+            len -= sizeof(size_t);
         }
     }
+    /* Do an unaligned byte copy of whatever is left */
+    while (len--) {
+        *dstp++ = *srcp++;
+    }
     return dst;
-#endif /* __GNUC__ */
+#endif /* HAVE_MEMCPY */
 }
 
 void *
@@ -389,11 +657,38 @@ SDL_memcmp(const void *s1, const void *s2, size_t len)
 #if defined(HAVE_MEMCMP)
     return memcmp(s1, s2, len);
 #else
-    char *s1p = (char *) s1;
-    char *s2p = (char *) s2;
+    const Uint8 *s1p = (const Uint8 *) s1;
+    const Uint8 *s2p = (const Uint8 *) s2;
+
+#if defined(SDL_STRING_SSE2)
+    if (SDL_StringHasSSE2()) {
+        const int result = SDL_memcmp_SSE2(&s1p, &s2p, &len);
+        if (result) {
+            return result;
+        }
+    }
+#elif defined(SDL_STRING_NEON)
+    while (len >= 16) {
+        const uint8x16_t diff = veorq_u8(vld1q_u8(s1p), vld1q_u8(s2p));
+        if (SDL_AnyBitsNEON(diff)) {
+            break;  /* The byte loop below finds where */
+        }
+        s1p += 16;
+        s2p += 16;
+        len -= 16;
+    }
+#endif
+
+    if (SDL_IS_ALIGNED(s1p, sizeof(size_t)) && SDL_IS_ALIGNED(s2p, sizeof(size_t))) {
+        while (len >= sizeof(size_t) && *(const size_t *) s1p == *(const size_t *) s2p) {
+            s1p += sizeof(size_t);
+            s2p += sizeof(size_t);
+            len -= sizeof(size_t);
+        }
+    }
     while (len--) {
         if (*s1p != *s2p) {
-            return (*s1p - *s2p);
+            return ((int) *s1p - (int) *s2p);
         }
         ++s1p;
         ++s2p;
@@ -408,11 +703,34 @@ SDL_strlen(const char *string)
 #if defined(HAVE_STRLEN)
     return strlen(string);
 #else
-    size_t len = 0;
-    while (*string++) {
-        ++len;
+    const char *p = string;
+
+    /* Once p is aligned, whole vectors or words can be read without
+       crossing into a page that the string doesn't touch. */
+    while (!SDL_IS_ALIGNED(p, 16)) {
+        if (!*p) {
+            return (p - string);
+        }
+        ++p;
     }
-    return len;
+
+#if defined(SDL_STRING_SSE2)
+    if (SDL_StringHasSSE2()) {
+        return (p - string) + SDL_strlen_SSE2(p);
+    }
+#elif defined(SDL_STRING_NEON)
+    while (!SDL_AnyBitsNEON(vceqq_u8(vld1q_u8((const Uint8 *) p), vdupq_n_u8(0)))) {
+        p += 16;
+    }
+#endif
+
+    while (!SDL_WORD_HASZERO(*(const size_t *) p)) {
+        p += sizeof(size_t);
+    }
+    while (*p) {
+        ++p;
+    }
+    return (p - string);
 #endif /* HAVE_STRLEN */
 }
 
@@ -596,13 +914,52 @@ SDL_strchr(const char *string, int c)
 #elif defined(HAVE_INDEX)
     return SDL_const_cast(char*,index(string, c));
 #else
-    while (*string) {
-        if (*string == c) {
+    const char ch = (char) c;
+    const size_t ch_word = SDL_WORD_ONES * (Uint8) ch;
+
+    /* Once string is aligned, whole vectors or words can be read without
+       crossing into a page that the string doesn't touch. */
+    while (!SDL_IS_ALIGNED(string, 16)) {
+        if (*string == ch) {
             return (char *) string;
+        } else if (!*string) {
+            return NULL;
         }
         ++string;
     }
-    return NULL;
+
+#if defined(SDL_STRING_SSE2)
+    if (SDL_StringHasSSE2()) {
+        return SDL_strchr_SSE2(string, ch);
+    }
+#elif defined(SDL_STRING_NEON)
+    {
+        const uint8x16_t zero = vdupq_n_u8(0);
+        const uint8x16_t ch_vec = vdupq_n_u8((Uint8) ch);
+        for ( ; ; ) {
+            const uint8x16_t v = vld1q_u8((const Uint8 *) string);
+            if (SDL_AnyBitsNEON(vorrq_u8(vceqq_u8(v, zero), vceqq_u8(v, ch_vec)))) {
+                break;
+            }
+            string += 16;
+        }
+    }
+#endif
+
+    for ( ; ; ) {
+        const size_t w = *(const size_t *) string;
+        if (SDL_WORD_HASZERO(w) || SDL_WORD_HASZERO(w ^ ch_word)) {
+            break;
+        }
+        string += sizeof(size_t);
+    }
+    while (*string != ch) {
+        if (!*string) {
+            return NULL;
+        }
+        ++string;
+    }
+    return (char *) string;
 #endif /* HAVE_STRCHR */
 }
 
@@ -46,6 +46,10 @@ extern void SDL_SYS_SetupThread(const char *name);
 /* This function sets the current thread priority */
 extern int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority);
 
+/* These functions set and get the CPUs the current thread may run on */
+extern int SDL_SYS_SetThreadAffinityMask(Uint64 mask);
+extern Uint64 SDL_SYS_GetThreadAffinityMask(void);
+
 /* This function waits for the thread to finish and frees any data
    allocated by SDL_SYS_CreateThread()
  */
@@ -65,6 +69,11 @@ extern SDL_Thread *
 SDL_CreateThreadInternal(int (SDLCALL * fn) (void *), const char *name,
                          const size_t stacksize, void *data);
 
+/* Sets the priority of one of SDL's own threads, using real-time scheduling
+   and CPU affinity instead if SDL_HINT_THREAD_REALTIME and
+   SDL_HINT_THREAD_AFFINITY ask for them. Call from the thread itself. */
+extern void SDL_ApplyThreadHints(SDL_ThreadPriority priority);
+
 #endif /* SDL_systhread_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -30,6 +30,23 @@
 #include "../SDL_error_c.h"
 
 
+#if SDL_HAVE_THREAD_LOCAL
+/* The compiler keeps a per-thread pointer for us, no system calls needed */
+static SDL_THREAD_LOCAL SDL_TLSData *SDL_tls_data;
+
+#define SDL_GetTLSData()    SDL_tls_data
+
+static int
+SDL_SetTLSData(SDL_TLSData *data)
+{
+    SDL_tls_data = data;
+    return 0;
+}
+#else
+#define SDL_GetTLSData()        SDL_SYS_GetTLSData()
+#define SDL_SetTLSData(data)    SDL_SYS_SetTLSData(data)
+#endif /* SDL_HAVE_THREAD_LOCAL */
+
 SDL_TLSID
 SDL_TLSCreate()
 {
@@ -42,7 +59,7 @@ SDL_TLSGet(SDL_TLSID id)
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (!storage || id == 0 || id > storage->limit) {
         return NULL;
     }
@@ -58,7 +75,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (*destructor)(void *))
         return SDL_InvalidParamError("id");
     }
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (!storage || (id > storage->limit)) {
         unsigned int i, oldlimit, newlimit;
 
@@ -73,7 +90,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (*destructor)(void *))
             storage->array[i].data = NULL;
             storage->array[i].destructor = NULL;
         }
-        if (SDL_SYS_SetTLSData(storage) != 0) {
+        if (SDL_SetTLSData(storage) != 0) {
             return -1;
         }
     }
@@ -88,7 +105,7 @@ SDL_TLSCleanup()
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (storage) {
         unsigned int i;
         for (i = 0; i < storage->limit; ++i) {
@@ -96,7 +113,7 @@ SDL_TLSCleanup()
                 storage->array[i].destructor(storage->array[i].data);
             }
         }
-        SDL_SYS_SetTLSData(NULL);
+        SDL_SetTLSData(NULL);
         SDL_free(storage);
     }
 }
@@ -202,6 +219,15 @@ SDL_Generic_SetTLSData(SDL_TLSData *storage)
 }
 
 /* Routine to get the thread-specific error variable */
+#if SDL_HAVE_THREAD_LOCAL
+SDL_error *
+SDL_GetErrBuf(void)
+{
+    /* Zero initialized per thread and released by the runtime at thread exit */
+    static SDL_THREAD_LOCAL SDL_error SDL_thread_errbuf;
+    return &SDL_thread_errbuf;
+}
+#else
 SDL_error *
 SDL_GetErrBuf(void)
 {
@@ -250,6 +276,7 @@ SDL_GetErrBuf(void)
     }
     return errbuf;
 }
+#endif /* SDL_HAVE_THREAD_LOCAL */
 
 
 /* Arguments and callback to setup and run the user thread function */
@@ -459,9 +486,82 @@ SDL_GetThreadName(SDL_Thread * thread)
 int
 SDL_SetThreadPriority(SDL_ThreadPriority priority)
 {
+    if ((int)priority < SDL_THREAD_PRIORITY_LOW || priority > SDL_THREAD_PRIORITY_TIME_CRITICAL) {
+        return SDL_InvalidParamError("priority");
+    }
     return SDL_SYS_SetThreadPriority(priority);
 }
 
+int
+SDL_SetThreadAffinityMask(Uint64 mask)
+{
+    if (!mask) {
+        return SDL_InvalidParamError("mask");
+    }
+    return SDL_SYS_SetThreadAffinityMask(mask);
+}
+
+Uint64
+SDL_GetThreadAffinityMask(void)
+{
+    return SDL_SYS_GetThreadAffinityMask();
+}
+
+/* Parses a CPU list like "0,4-7" into a mask, 0 if there are no valid CPUs */
+static Uint64
+SDL_ParseCPUList(const char *list)
+{
+    Uint64 mask = 0;
+
+    while (*list) {
+        char *end;
+        long first = SDL_strtol(list, &end, 10), last;
+        if (end == list) {
+            return 0;
+        }
+        last = first;
+        if (*end == '-') {
+            list = end + 1;
+            last = SDL_strtol(list, &end, 10);
+            if (end == list) {
+                return 0;
+            }
+        }
+        for (; first <= last && first < 64; ++first) {
+            if (first >= 0) {
+                mask |= ((Uint64)1 << first);
+            }
+        }
+        list = end;
+        while (*list == ',' || *list == ' ') {
+            ++list;
+        }
+    }
+    return mask;
+}
+
+void
+SDL_ApplyThreadHints(SDL_ThreadPriority priority)
+{
+    const char *affinity = SDL_GetHint(SDL_HINT_THREAD_AFFINITY);
+
+    if (SDL_GetHintBoolean(SDL_HINT_THREAD_REALTIME, SDL_FALSE)) {
+        if (SDL_SYS_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL) == 0) {
+            priority = SDL_THREAD_PRIORITY_NORMAL;
+        }
+    }
+    if (priority != SDL_THREAD_PRIORITY_NORMAL) {
+        SDL_SYS_SetThreadPriority(priority);
+    }
+
+    if (affinity && *affinity) {
+        const Uint64 mask = SDL_ParseCPUList(affinity);
+        if (mask) {
+            SDL_SYS_SetThreadAffinityMask(mask);
+        }
+    }
+}
+
 void
 SDL_WaitThread(SDL_Thread * thread, int *status)
 {
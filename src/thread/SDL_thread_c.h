@@ -78,6 +78,24 @@ typedef struct {
 /* This is how many TLS entries we allocate at once */
 #define TLS_ALLOC_CHUNKSIZE 4
 
+/* Compiler-provided thread-local variables, used in preference to the
+   system TLS calls where the toolchain and runtime are known to support
+   them in shared libraries. Define SDL_NO_THREAD_LOCAL to disable them, or
+   SDL_THREAD_LOCAL to the storage class keyword to enable them elsewhere.
+ */
+#if !defined(SDL_NO_THREAD_LOCAL) && !SDL_THREADS_DISABLED
+#ifndef SDL_THREAD_LOCAL
+#if defined(__GNUC__) && (defined(__LINUX__) || defined(__FREEBSD__) || defined(__NETBSD__) || defined(__OPENBSD__) || defined(__SOLARIS__))
+#define SDL_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__) && !defined(__APPLE__) && !defined(__WINDOWS__)
+#define SDL_THREAD_LOCAL _Thread_local
+#endif
+#endif
+#ifdef SDL_THREAD_LOCAL
+#define SDL_HAVE_THREAD_LOCAL 1
+#endif
+#endif
+
 /* Get cross-platform, slow, thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
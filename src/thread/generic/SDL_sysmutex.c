@@ -56,6 +56,13 @@ SDL_CreateMutex(void)
     return mutex;
 }
 
+/* The semaphore based mutex is the only kind available here */
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return SDL_CreateMutex();
+}
+
 /* Free the mutex */
 void
 SDL_DestroyMutex(SDL_mutex * mutex)
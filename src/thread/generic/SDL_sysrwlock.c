@@ -0,0 +1,164 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* An implementation of reader-writer locks using a mutex and a condition
+   variable.  Readers only hold the mutex while they update the reader
+   count, a writer holds it for as long as it has the lock.
+ */
+
+#include "SDL_thread.h"
+
+struct SDL_RWLock
+{
+    SDL_mutex *lock;
+    SDL_cond *readers_done;
+    int readers;
+    SDL_threadID writer;
+};
+
+SDL_RWLock *
+SDL_CreateRWLock(void)
+{
+    SDL_RWLock *rwlock;
+
+    rwlock = (SDL_RWLock *) SDL_calloc(1, sizeof(*rwlock));
+    if (!rwlock) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    rwlock->lock = SDL_CreateFastMutex();
+    rwlock->readers_done = SDL_CreateCond();
+    if (!rwlock->lock || !rwlock->readers_done) {
+        SDL_DestroyRWLock(rwlock);
+        return NULL;
+    }
+    return rwlock;
+}
+
+void
+SDL_DestroyRWLock(SDL_RWLock * rwlock)
+{
+    if (rwlock) {
+        if (rwlock->readers_done) {
+            SDL_DestroyCond(rwlock->readers_done);
+        }
+        if (rwlock->lock) {
+            SDL_DestroyMutex(rwlock->lock);
+        }
+        SDL_free(rwlock);
+    }
+}
+
+int
+SDL_LockRWLockForReading(SDL_RWLock * rwlock)
+{
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+    if (SDL_LockMutex(rwlock->lock) < 0) {
+        return -1;
+    }
+    ++rwlock->readers;
+    return SDL_UnlockMutex(rwlock->lock);
+}
+
+int
+SDL_LockRWLockForWriting(SDL_RWLock * rwlock)
+{
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+    if (SDL_LockMutex(rwlock->lock) < 0) {
+        return -1;
+    }
+    while (rwlock->readers > 0) {
+        SDL_CondWait(rwlock->readers_done, rwlock->lock);
+    }
+    /* Keep the mutex locked until SDL_UnlockRWLock() */
+    rwlock->writer = SDL_ThreadID();
+    return 0;
+}
+
+int
+SDL_TryLockRWLockForReading(SDL_RWLock * rwlock)
+{
+    int retval;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+    retval = SDL_TryLockMutex(rwlock->lock);
+    if (retval != 0) {
+        return retval;
+    }
+    ++rwlock->readers;
+    return SDL_UnlockMutex(rwlock->lock);
+}
+
+int
+SDL_TryLockRWLockForWriting(SDL_RWLock * rwlock)
+{
+    int retval;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+    retval = SDL_TryLockMutex(rwlock->lock);
+    if (retval != 0) {
+        return retval;
+    }
+    if (rwlock->readers > 0) {
+        SDL_UnlockMutex(rwlock->lock);
+        return SDL_MUTEX_TIMEDOUT;
+    }
+    rwlock->writer = SDL_ThreadID();
+    return 0;
+}
+
+int
+SDL_UnlockRWLock(SDL_RWLock * rwlock)
+{
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    /* Only the writer can have set this to its own thread id */
+    if (rwlock->writer && rwlock->writer == SDL_ThreadID()) {
+        rwlock->writer = 0;
+        return SDL_UnlockMutex(rwlock->lock);
+    }
+
+    if (SDL_LockMutex(rwlock->lock) < 0) {
+        return -1;
+    }
+    if (rwlock->readers == 0) {
+        SDL_UnlockMutex(rwlock->lock);
+        return SDL_SetError("rwlock not locked");
+    }
+    if (--rwlock->readers == 0) {
+        SDL_CondBroadcast(rwlock->readers_done);
+    }
+    return SDL_UnlockMutex(rwlock->lock);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -56,6 +56,18 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     return (0);
 }
 
+int
+SDL_SYS_SetThreadAffinityMask(Uint64 mask)
+{
+    return SDL_Unsupported();
+}
+
+Uint64
+SDL_SYS_GetThreadAffinityMask(void)
+{
+    return 0;
+}
+
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
 {
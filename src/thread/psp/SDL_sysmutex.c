@@ -58,6 +58,13 @@ SDL_CreateMutex(void)
     return mutex;
 }
 
+/* There is no cheaper mutex here, so use a regular one */
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return SDL_CreateMutex();
+}
+
 /* Free the mutex */
 void
 SDL_DestroyMutex(SDL_mutex * mutex)
@@ -96,7 +96,7 @@ int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
 
     if (priority == SDL_THREAD_PRIORITY_LOW) {
         value = 19;
-    } else if (priority == SDL_THREAD_PRIORITY_HIGH) {
+    } else if (priority == SDL_THREAD_PRIORITY_HIGH || priority == SDL_THREAD_PRIORITY_TIME_CRITICAL) {
         value = -20;
     } else {
         value = 0;
@@ -106,6 +106,16 @@ int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
 
 }
 
+int SDL_SYS_SetThreadAffinityMask(Uint64 mask)
+{
+    return SDL_Unsupported();
+}
+
+Uint64 SDL_SYS_GetThreadAffinityMask(void)
+{
+    return 0;
+}
+
 #endif /* SDL_THREAD_PSP */
 
 /* vim: ts=4 sw=4
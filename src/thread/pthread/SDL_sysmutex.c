@@ -24,23 +24,56 @@
 #include <pthread.h>
 
 #include "SDL_thread.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_hints.h"
+#include "../../atomic/SDL_spinlock_c.h"
 
 #if !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX && \
     !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
 #define FAKE_RECURSIVE_MUTEX 1
 #endif
 
+/* How many times SDL_LockMutex() polls a busy mutex before sleeping, by
+   default */
+#define SDL_MUTEX_SPIN_COUNT    100
+
+/* The spin count for new mutexes, -1 until it has been worked out */
+static SDL_atomic_t SDL_mutex_spin_count = { -1 };
+
+static int
+GetMutexSpinCount(void)
+{
+    int spin_count = SDL_AtomicGet(&SDL_mutex_spin_count);
+
+    if (spin_count < 0) {
+        /* This can't be an SDL_GetHint(), which needs mutexes itself */
+        const char *hint = SDL_getenv(SDL_HINT_MUTEX_SPIN_COUNT);
+
+        if (hint && *hint) {
+            spin_count = SDL_max(SDL_atoi(hint), 0);
+        } else if (SDL_GetCPUCount() > 1) {
+            /* Spinning only helps if the owner is running on another CPU */
+            spin_count = SDL_MUTEX_SPIN_COUNT;
+        } else {
+            spin_count = 0;
+        }
+        SDL_AtomicSet(&SDL_mutex_spin_count, spin_count);
+    }
+    return spin_count;
+}
+
 struct SDL_mutex
 {
     pthread_mutex_t id;
+    int spin_count;
 #if FAKE_RECURSIVE_MUTEX
     int recursive;
     pthread_t owner;
 #endif
 };
 
-SDL_mutex *
-SDL_CreateMutex(void)
+static SDL_mutex *
+CreateMutex(SDL_bool recursive)
 {
     SDL_mutex *mutex;
     pthread_mutexattr_t attr;
@@ -49,17 +82,21 @@ SDL_CreateMutex(void)
     mutex = (SDL_mutex *) SDL_calloc(1, sizeof(*mutex));
     if (mutex) {
         pthread_mutexattr_init(&attr);
+        if (recursive) {
 #if SDL_THREAD_PTHREAD_RECURSIVE_MUTEX
-        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+            pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
 #elif SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
-        pthread_mutexattr_setkind_np(&attr, PTHREAD_MUTEX_RECURSIVE_NP);
+            pthread_mutexattr_setkind_np(&attr, PTHREAD_MUTEX_RECURSIVE_NP);
 #else
-        /* No extra attributes necessary */
+            /* No extra attributes necessary */
 #endif
+        }
         if (pthread_mutex_init(&mutex->id, &attr) != 0) {
             SDL_SetError("pthread_mutex_init() failed");
             SDL_free(mutex);
             mutex = NULL;
+        } else {
+            mutex->spin_count = GetMutexSpinCount();
         }
     } else {
         SDL_OutOfMemory();
@@ -67,6 +104,18 @@ SDL_CreateMutex(void)
     return (mutex);
 }
 
+SDL_mutex *
+SDL_CreateMutex(void)
+{
+    return CreateMutex(SDL_TRUE);
+}
+
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return CreateMutex(SDL_FALSE);
+}
+
 void
 SDL_DestroyMutex(SDL_mutex * mutex)
 {
@@ -76,6 +125,30 @@ SDL_DestroyMutex(SDL_mutex * mutex)
     }
 }
 
+/* Spin for a little while before sleeping, since the owner of a busy
+   mutex is usually about to release it */
+static int
+LockMutexAdaptive(SDL_mutex * mutex)
+{
+    int i, j;
+
+    if (pthread_mutex_trylock(&mutex->id) == 0) {
+        return 0;
+    }
+    SDL_CountLockStat(SDL_LOCKSTAT_MUTEX_CONTENDED);
+
+    for (i = 0; i < mutex->spin_count; ++i) {
+        for (j = 0; j < 8; ++j) {
+            SDL_CPUPauseInstruction();
+        }
+        if (pthread_mutex_trylock(&mutex->id) == 0) {
+            return 0;
+        }
+    }
+    SDL_CountLockStat(SDL_LOCKSTAT_MUTEX_SLEEPS);
+    return pthread_mutex_lock(&mutex->id);
+}
+
 /* Lock the mutex */
 int
 SDL_LockMutex(SDL_mutex * mutex)
@@ -97,7 +170,7 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        if (pthread_mutex_lock(&mutex->id) == 0) {
+        if (LockMutexAdaptive(mutex) == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
         } else {
@@ -105,7 +178,7 @@ SDL_LockMutex(SDL_mutex * mutex)
         }
     }
 #else
-    if (pthread_mutex_lock(&mutex->id) < 0) {
+    if (LockMutexAdaptive(mutex) < 0) {
         return SDL_SetError("pthread_mutex_lock() failed");
     }
 #endif
@@ -144,8 +217,10 @@ SDL_TryLockMutex(SDL_mutex * mutex)
         }
     }
 #else
-    if (pthread_mutex_trylock(&mutex->id) != 0) {
-        if (errno == EBUSY) {
+    retval = pthread_mutex_trylock(&mutex->id);
+    if (retval != 0) {
+        /* pthread functions return the error instead of setting errno */
+        if (retval == EBUSY) {
             retval = SDL_MUTEX_TIMEDOUT;
         } else {
             retval = SDL_SetError("pthread_mutex_trylock() failed");
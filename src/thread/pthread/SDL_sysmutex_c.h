@@ -26,6 +26,7 @@
 struct SDL_mutex
 {
     pthread_mutex_t id;
+    int spin_count;
 };
 
 #endif /* SDL_mutex_c_h_ */
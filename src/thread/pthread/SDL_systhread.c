@@ -47,6 +47,9 @@
 #include "SDL_thread.h"
 #include "../SDL_thread_c.h"
 #include "../SDL_systhread.h"
+#ifdef __LINUX__
+#include "../../core/linux/SDL_dbus.h"
+#endif
 #ifdef __ANDROID__
 #include "../../core/android/SDL_android.h"
 #endif
@@ -180,6 +183,59 @@ SDL_ThreadID(void)
     return ((SDL_threadID) pthread_self());
 }
 
+#if !__NACL__
+/* The SCHED_RR priority used for SDL_THREAD_PRIORITY_TIME_CRITICAL.  It's
+   enough to run ahead of all normal threads, while leaving the top of the
+   range to kernel threads, audio servers and watchdogs. */
+#define SDL_REALTIME_THREAD_PRIORITY    10
+
+static int
+SDL_GetRealtimeThreadPriority(void)
+{
+    const int min_priority = sched_get_priority_min(SCHED_RR);
+    const int max_priority = sched_get_priority_max(SCHED_RR);
+
+    return SDL_min(SDL_max(SDL_REALTIME_THREAD_PRIORITY, min_priority), max_priority);
+}
+
+/* The policy each thread had before SDL made it real-time, so that a later
+   priority change undoes only real-time scheduling that SDL set up, not any
+   the application or the system gave the thread */
+static SDL_TLSID SDL_realtime_policy;
+static SDL_SpinLock SDL_realtime_policy_lock;
+
+static SDL_TLSID
+SDL_GetRealtimePolicyID(void)
+{
+    SDL_AtomicLock(&SDL_realtime_policy_lock);
+    if (!SDL_realtime_policy) {
+        SDL_realtime_policy = SDL_TLSCreate();
+    }
+    SDL_AtomicUnlock(&SDL_realtime_policy_lock);
+    return SDL_realtime_policy;
+}
+
+/* Returns the policy from before SDL made this thread real-time, or -1 */
+static int
+SDL_GetPolicyBeforeRealtime(void)
+{
+    return (int) (uintptr_t) SDL_TLSGet(SDL_GetRealtimePolicyID()) - 1;
+}
+
+/* Records the policy to go back to, or -1 when there is none */
+static void
+SDL_SetPolicyBeforeRealtime(int policy)
+{
+    SDL_TLSSet(SDL_GetRealtimePolicyID(), (void *) (uintptr_t) (policy + 1), NULL);
+}
+
+static SDL_bool
+SDL_IsRealtimePolicy(int policy)
+{
+    return (policy == SCHED_RR || policy == SCHED_FIFO);
+}
+#endif /* !__NACL__ */
+
 int
 SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
 {
@@ -187,8 +243,48 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     /* FIXME: Setting thread priority does not seem to be supported in NACL */
     return 0;
 #elif __LINUX__
+    const pid_t tid = (pid_t)syscall(SYS_gettid);
+    pthread_t thread = pthread_self();
+    const int old_policy = SDL_GetPolicyBeforeRealtime();
+    struct sched_param sched;
+    int policy;
     int value;
 
+    if (priority == SDL_THREAD_PRIORITY_TIME_CRITICAL) {
+        SDL_bool realtime = SDL_FALSE;
+
+        if (pthread_getschedparam(thread, &policy, &sched) != 0) {
+            policy = SCHED_OTHER;
+        }
+        SDL_zero(sched);
+        sched.sched_priority = SDL_GetRealtimeThreadPriority();
+        if (pthread_setschedparam(thread, SCHED_RR, &sched) == 0) {
+            realtime = SDL_TRUE;
+        }
+#if SDL_USE_LIBDBUS
+        /* Desktop sessions usually hand out real-time scheduling to
+           unprivileged processes through RealtimeKit instead. */
+        if (!realtime && SDL_DBus_MakeThreadRealtime(tid, sched.sched_priority)) {
+            realtime = SDL_TRUE;
+        }
+#endif
+        if (!realtime) {
+            return SDL_SetError("Couldn't set real-time thread scheduling");
+        }
+        if (old_policy < 0 && !SDL_IsRealtimePolicy(policy)) {
+            SDL_SetPolicyBeforeRealtime(policy);
+        }
+        return 0;
+    }
+
+    /* Leave real-time scheduling from an earlier call */
+    if (old_policy >= 0) {
+        SDL_zero(sched);
+        if (pthread_setschedparam(thread, old_policy, &sched) == 0) {
+            SDL_SetPolicyBeforeRealtime(-1);
+        }
+    }
+
     if (priority == SDL_THREAD_PRIORITY_LOW) {
         value = 19;
     } else if (priority == SDL_THREAD_PRIORITY_HIGH) {
@@ -196,7 +292,12 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     } else {
         value = 0;
     }
-    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), value) < 0) {
+    if (setpriority(PRIO_PROCESS, tid, value) < 0) {
+#if SDL_USE_LIBDBUS
+        if (value < 0 && SDL_DBus_MakeThreadHighPriority(tid, value)) {
+            return 0;
+        }
+#endif
         /* Note that this fails if you're trying to set high priority
            and you don't have root permission. BUT DON'T RUN AS ROOT!
 
@@ -211,11 +312,24 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     struct sched_param sched;
     int policy;
     pthread_t thread = pthread_self();
+    const int old_policy = SDL_GetPolicyBeforeRealtime();
+    int new_old_policy = old_policy;
 
     if (pthread_getschedparam(thread, &policy, &sched) < 0) {
         return SDL_SetError("pthread_getschedparam() failed");
     }
-    if (priority == SDL_THREAD_PRIORITY_LOW) {
+    if (priority != SDL_THREAD_PRIORITY_TIME_CRITICAL && old_policy >= 0) {
+        /* Leave real-time scheduling from an earlier call */
+        policy = old_policy;
+        new_old_policy = -1;
+    }
+    if (priority == SDL_THREAD_PRIORITY_TIME_CRITICAL) {
+        if (old_policy < 0 && !SDL_IsRealtimePolicy(policy)) {
+            new_old_policy = policy;
+        }
+        policy = SCHED_RR;
+        sched.sched_priority = SDL_GetRealtimeThreadPriority();
+    } else if (priority == SDL_THREAD_PRIORITY_LOW) {
         sched.sched_priority = sched_get_priority_min(policy);
     } else if (priority == SDL_THREAD_PRIORITY_HIGH) {
         sched.sched_priority = sched_get_priority_max(policy);
@@ -227,10 +341,59 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     if (pthread_setschedparam(thread, policy, &sched) < 0) {
         return SDL_SetError("pthread_setschedparam() failed");
     }
+    if (new_old_policy != old_policy) {
+        SDL_SetPolicyBeforeRealtime(new_old_policy);
+    }
     return 0;
 #endif /* linux */
 }
 
+int
+SDL_SYS_SetThreadAffinityMask(Uint64 mask)
+{
+#if defined(__LINUX__) && defined(SYS_sched_setaffinity)
+    /* The kernel wants a buffer at least as large as its CPU mask size */
+    unsigned long cpus[1024 / (8 * sizeof(unsigned long))];
+    int i;
+
+    SDL_zero(cpus);
+    for (i = 0; i < 64; ++i) {
+        if (mask & ((Uint64)1 << i)) {
+            cpus[i / (8 * sizeof(unsigned long))] |= 1UL << (i % (8 * sizeof(unsigned long)));
+        }
+    }
+    if (syscall(SYS_sched_setaffinity, 0, sizeof(cpus), cpus) < 0) {
+        return SDL_SetError("sched_setaffinity() failed");
+    }
+    return 0;
+#else
+    return SDL_Unsupported();
+#endif
+}
+
+Uint64
+SDL_SYS_GetThreadAffinityMask(void)
+{
+#if defined(__LINUX__) && defined(SYS_sched_getaffinity)
+    unsigned long cpus[1024 / (8 * sizeof(unsigned long))];
+    Uint64 mask = 0;
+    int i;
+
+    SDL_zero(cpus);
+    if (syscall(SYS_sched_getaffinity, 0, sizeof(cpus), cpus) < 0) {
+        return 0;
+    }
+    for (i = 0; i < 64; ++i) {
+        if (cpus[i / (8 * sizeof(unsigned long))] & (1UL << (i % (8 * sizeof(unsigned long))))) {
+            mask |= ((Uint64)1 << i);
+        }
+    }
+    return mask;
+#else
+    return 0;
+#endif
+}
+
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
 {
@@ -50,6 +50,14 @@ SDL_CreateMutex(void)
     }
 }
 
+/* SDL_mutex wraps a std::recursive_mutex, so use a regular one */
+extern "C"
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return SDL_CreateMutex();
+}
+
 /* Free the mutex */
 extern "C"
 void
@@ -111,6 +111,21 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     return (0);
 }
 
+extern "C"
+int
+SDL_SYS_SetThreadAffinityMask(Uint64 mask)
+{
+    // As with priorities, std::thread has no notion of CPU affinity.
+    return SDL_Unsupported();
+}
+
+extern "C"
+Uint64
+SDL_SYS_GetThreadAffinityMask(void)
+{
+    return 0;
+}
+
 extern "C"
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
@@ -56,6 +56,13 @@ SDL_CreateMutex(void)
     return (mutex);
 }
 
+/* Critical sections are always recursive, and already cheap when uncontended */
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return SDL_CreateMutex();
+}
+
 /* Free the mutex */
 void
 SDL_DestroyMutex(SDL_mutex * mutex)
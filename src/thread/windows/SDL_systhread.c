@@ -202,6 +202,8 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
         value = THREAD_PRIORITY_LOWEST;
     } else if (priority == SDL_THREAD_PRIORITY_HIGH) {
         value = THREAD_PRIORITY_HIGHEST;
+    } else if (priority == SDL_THREAD_PRIORITY_TIME_CRITICAL) {
+        value = THREAD_PRIORITY_TIME_CRITICAL;
     } else {
         value = THREAD_PRIORITY_NORMAL;
     }
@@ -211,6 +213,42 @@ SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
     return 0;
 }
 
+int
+SDL_SYS_SetThreadAffinityMask(Uint64 mask)
+{
+    DWORD_PTR process_mask, system_mask;
+
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        return WIN_SetError("GetProcessAffinityMask()");
+    }
+    /* A thread can't run on CPUs outside of its process' affinity */
+    mask &= process_mask;
+    if (!mask) {
+        return SDL_SetError("No usable CPUs in affinity mask");
+    }
+    if (!SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask)) {
+        return WIN_SetError("SetThreadAffinityMask()");
+    }
+    return 0;
+}
+
+Uint64
+SDL_SYS_GetThreadAffinityMask(void)
+{
+    DWORD_PTR process_mask, system_mask, thread_mask;
+
+    /* There is no GetThreadAffinityMask(), but setting the mask returns
+       the previous one, which we then put back. */
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        return 0;
+    }
+    thread_mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+    if (thread_mask && thread_mask != process_mask) {
+        SetThreadAffinityMask(GetCurrentThread(), thread_mask);
+    }
+    return (Uint64)thread_mask;
+}
+
 void
 SDL_SYS_WaitThread(SDL_Thread * thread)
 {
@@ -107,6 +107,8 @@ SDL_TimerThread(void *_data)
     SDL_Timer *freelist_tail = NULL;
     Uint32 tick, now, interval, delay;
 
+    SDL_ApplyThreadHints(SDL_THREAD_PRIORITY_NORMAL);
+
     /* Threaded timer loop:
      *  1. Queue timers added by other threads
      *  2. Handle any timers that should dispatch this cycle
@@ -60,9 +60,6 @@
  *
  * Encoding of surfaces with per-pixel alpha:
  *
- *   The sequence begins with a struct RLEDestFormat describing the target
- *   pixel format, to provide reliable un-encoding.
- *
  *   Each scan line is encoded twice: First all completely opaque pixels,
  *   encoded in the target format as described above, and then all
  *   partially transparent (translucent) pixels (where 1 <= alpha <= 254),
@@ -83,19 +80,86 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * The source pixels are kept next to the encoding, so locking the surface
+ * never has to decode it. The encoding records the generation of the pixels
+ * it was made from (SDL_BlitMap::pixels_generation, advanced whenever they
+ * may have changed, which for a lock means the pixels checksum differs at
+ * unlock) and what it was made for, so it survives remapping the
+ * surface to compatible targets. An out of date encoding is redone on the
+ * next blit, on a background thread if SDL_HINT_VIDEO_RLE_BACKGROUND is set,
+ * and the regular blitter is used until it is ready.
  */
 
 #include "SDL_video.h"
+#include "SDL_hints.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
+#include "../thread/SDL_systhread.h"
+
+/* An encoding of the surface pixels, and what it was made for */
+struct SDL_RLEData
+{
+    Uint32 kind;            /* SDL_COPY_RLE_COLORKEY or SDL_COPY_RLE_ALPHAKEY */
+    Uint32 colorkey;        /* the colorkey, for SDL_COPY_RLE_COLORKEY */
+    Uint32 dst_format;      /* the target format, for SDL_COPY_RLE_ALPHAKEY */
+    Uint32 generation;      /* the pixels_generation that was encoded */
+    Uint8 *buf;             /* the encoding, NULL if it couldn't be made */
+};
+
+/* An encoding being made on a background thread, of a copy of the pixels
+   so the application can keep writing to the surface meanwhile */
+struct SDL_RLEJob
+{
+    SDL_RLEData *rle;
+    SDL_Surface surface;    /* just enough of a surface to encode */
+    SDL_PixelFormat srcfmt;
+    SDL_PixelFormat dstfmt; /* copied, the target may go away meanwhile */
+    SDL_sem *done;
+};
+
+/* Background encodings are queued for a single worker thread, started when
+   there is work and leaving after it has been idle for a while */
+#define RLE_QUEUE_SIZE      64
+#define RLE_WORKER_IDLE_MS  1000
+
+static SDL_SpinLock rle_worker_lock;
+static SDL_AtomicQueue *rle_queue;
+static SDL_sem *rle_wakeup;
+static SDL_bool rle_worker_running;
 
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
 #define PIXEL_COPY(to, from, len, bpp)          \
-    SDL_memcpy(to, from, (size_t)(len) * (bpp))
+    RLECopyRun(to, from, len, bpp)
+
+/*
+ * Copy a run of opaque pixels. Runs of 32bpp pixels are copied eight at a
+ * time with SSE2, the rest (and the tail) with SDL_memcpy.
+ */
+static SDL_INLINE void
+RLECopyRun(void *to, const void *from, int len, int bpp)
+{
+    size_t n = (size_t) len * bpp;
+#ifdef __SSE2__
+    if (bpp == 4 && len >= 8 && SDL_HasSSE2()) {
+        Uint8 *dst = (Uint8 *) to;
+        const Uint8 *src = (const Uint8 *) from;
+        for (; n >= 32; n -= 32, src += 32, dst += 32) {
+            const __m128i a = _mm_loadu_si128((const __m128i *) src);
+            const __m128i b = _mm_loadu_si128((const __m128i *) (src + 16));
+            _mm_storeu_si128((__m128i *) dst, a);
+            _mm_storeu_si128((__m128i *) (dst + 16), b);
+        }
+        to = dst;
+        from = src;
+    }
+#endif
+    SDL_memcpy(to, from, n);
+}
 
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
@@ -467,7 +531,7 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels
         + y * surf_dst->pitch + x * surf_src->format->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data;
+    srcbuf = surf_src->map->rle->buf;
 
     {
         /* skip lines at the top if necessary */
@@ -610,25 +674,62 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
-/* used to save the destination format in the encoding. Designed to be
-   macro-compatible with SDL_PixelFormat but without the unneeded fields */
-typedef struct
+/*
+ * Blend a run of translucent pixels. The 32bpp run does four pixels at a
+ * time with SSE2, computing exactly what BLIT_TRANSL_888 does; SSE2 has no
+ * 32-bit multiply, so that is built from the 64-bit one.
+ */
+#define BLIT_TRANSL_RUN(do_blend, dst, src, n)  \
+    do {                                        \
+        int i;                                  \
+        for (i = 0; i < (int)(n); i++)          \
+            do_blend((src)[i], (dst)[i]);       \
+    } while(0)
+
+#define BLIT_TRANSL_RUN_565(dst, src, n) BLIT_TRANSL_RUN(BLIT_TRANSL_565, dst, src, n)
+#define BLIT_TRANSL_RUN_555(dst, src, n) BLIT_TRANSL_RUN(BLIT_TRANSL_555, dst, src, n)
+#define BLIT_TRANSL_RUN_888(dst, src, n) BlitTranslRun888(dst, src, n)
+
+#ifdef __SSE2__
+static SDL_INLINE __m128i
+MulLo32_SSE2(__m128i a, __m128i b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+static void
+BlitTranslRun888(Uint32 * dst, const Uint32 * src, int n)
 {
-    Uint8 BytesPerPixel;
-    Uint8 padding[3];
-    Uint32 Rmask;
-    Uint32 Gmask;
-    Uint32 Bmask;
-    Uint32 Amask;
-    Uint8 Rloss;
-    Uint8 Gloss;
-    Uint8 Bloss;
-    Uint8 Aloss;
-    Uint8 Rshift;
-    Uint8 Gshift;
-    Uint8 Bshift;
-    Uint8 Ashift;
-} RLEDestFormat;
+    int i = 0;
+
+#ifdef __SSE2__
+    if (n >= 4 && SDL_HasSSE2()) {
+        const __m128i rbmask = _mm_set1_epi32(0x00ff00ff);
+        const __m128i gmask = _mm_set1_epi32(0x0000ff00);
+        const __m128i opaque = _mm_set1_epi32(0xff000000);
+        for (; i + 4 <= n; i += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+            const __m128i alpha = _mm_srli_epi32(s, 24);
+            __m128i s1 = _mm_and_si128(s, rbmask);
+            __m128i d1 = _mm_and_si128(d, rbmask);
+            __m128i s2 = _mm_and_si128(s, gmask);
+            __m128i d2 = _mm_and_si128(d, gmask);
+            d1 = _mm_add_epi32(d1, _mm_srli_epi32(MulLo32_SSE2(_mm_sub_epi32(s1, d1), alpha), 8));
+            d2 = _mm_add_epi32(d2, _mm_srli_epi32(MulLo32_SSE2(_mm_sub_epi32(s2, d2), alpha), 8));
+            d1 = _mm_or_si128(_mm_and_si128(d1, rbmask), _mm_and_si128(d2, gmask));
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_or_si128(d1, opaque));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        BLIT_TRANSL_888(src[i], dst[i]);
+    }
+}
 
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
@@ -641,7 +742,7 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
      * Ctype the translucent count type, and do_blend the macro
      * to blend one pixel.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend_run)          \
     do {                                  \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
@@ -697,9 +798,7 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             if(crun > 0) {                    \
             Ptype *dst = (Ptype *)dstbuf + cofs;          \
             Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-            int i;                        \
-            for(i = 0; i < crun; i++)             \
-                do_blend(src[i], dst[i]);             \
+            do_blend_run(dst, src, crun);             \
             }                             \
             srcbuf += run * 4;                    \
             ofs += run;                       \
@@ -712,12 +811,12 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0)
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
         else
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
         break;
     }
 }
@@ -742,7 +841,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels + y * surf_dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data + sizeof(RLEDestFormat);
+    srcbuf = surf_src->map->rle->buf;
 
     {
         /* skip lines at the top if necessary */
@@ -807,10 +906,10 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the translucent count type, and do_blend_run the
+         * macro to blend a run of pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                 \
+#define RLEALPHABLIT(Ptype, Ctype, do_blend_run)             \
     do {                                 \
         int linecount = srcrect->h;                  \
         do {                             \
@@ -841,13 +940,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
             srcbuf += 4;                     \
             if(run) {                        \
             Ptype *dst = (Ptype *)dstbuf + ofs;      \
-            unsigned i;                  \
-            for(i = 0; i < run; i++) {           \
-                Uint32 src = *(Uint32 *)srcbuf;      \
-                do_blend(src, *dst);             \
-                srcbuf += 4;                 \
-                dst++;                   \
-            }                        \
+            do_blend_run(dst, (Uint32 *)srcbuf, run);    \
+            srcbuf += 4 * run;               \
             ofs += run;                  \
             }                            \
         } while(ofs < w);                    \
@@ -859,12 +953,12 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0
                 || df->Bmask == 0x07e0)
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
             else
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
             break;
         }
     }
@@ -881,9 +975,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
+ * These are only used in the encoder and are therefore not
  * highly optimised.
  */
 
@@ -904,26 +996,6 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
@@ -962,25 +1034,6 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
-static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 /* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
 static int
 copy_32(void *dst, Uint32 * src, int n,
@@ -998,35 +1051,15 @@ copy_32(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
-static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 #define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
 
 #define ISTRANSL(pixel, fmt)    \
     ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
 
-/* convert surface to be quickly alpha-blittable onto dest, if possible */
-static int
-RLEAlphaSurface(SDL_Surface * surface)
+/* encode surface to be quickly alpha-blittable onto df, if possible */
+static Uint8 *
+RLEAlphaSurface(SDL_Surface * surface, SDL_PixelFormat * df)
 {
-    SDL_Surface *dest;
-    SDL_PixelFormat *df;
     int maxsize = 0;
     int max_opaque_run;
     int max_transl_run = 65535;
@@ -1037,12 +1070,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     int (*copy_transl) (void *, Uint32 *, int,
                         SDL_PixelFormat *, SDL_PixelFormat *);
 
-    dest = surface->map->dst;
-    if (!dest)
-        return -1;
-    df = dest->format;
     if (surface->format->BitsPerPixel != 32)
-        return -1;              /* only 32bpp source supported */
+        return NULL;            /* only 32bpp source supported */
 
     /* find out whether the destination is one we support,
        and determine the max size of the encoded result */
@@ -1057,7 +1086,7 @@ RLEAlphaSurface(SDL_Surface * surface)
                 copy_opaque = copy_opaque_16;
                 copy_transl = copy_transl_565;
             } else
-                return -1;
+                return NULL;
             break;
         case 0x7fff:
             if (df->Gmask == 0x03e0
@@ -1065,10 +1094,10 @@ RLEAlphaSurface(SDL_Surface * surface)
                 copy_opaque = copy_opaque_16;
                 copy_transl = copy_transl_555;
             } else
-                return -1;
+                return NULL;
             break;
         default:
-            return -1;
+            return NULL;
         }
         max_opaque_run = 255;   /* runs stored as bytes */
 
@@ -1078,7 +1107,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         break;
     case 4:
         if (masksum != 0x00ffffff)
-            return -1;          /* requires unused high byte */
+            return NULL;          /* requires unused high byte */
         copy_opaque = copy_32;
         copy_transl = copy_32;
         max_opaque_run = 255;   /* runs stored as short ints */
@@ -1087,32 +1116,15 @@ RLEAlphaSurface(SDL_Surface * surface)
         maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
         break;
     default:
-        return -1;              /* anything else unsupported right now */
+        return NULL;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (!rlebuf) {
-        return SDL_OutOfMemory();
+        SDL_OutOfMemory();
+        return NULL;
     }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    dst = rlebuf;
 
     /* Do the actual encoding */
     {
@@ -1218,21 +1230,13 @@ RLEAlphaSurface(SDL_Surface * surface)
 #undef ADD_OPAQUE_COUNTS
 #undef ADD_TRANSL_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
     /* realloc the buffer to release unused memory */
     {
         Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
         if (!p)
             p = rlebuf;
-        surface->map->data = p;
+        return p;
     }
-
-    return 0;
 }
 
 static Uint32
@@ -1269,8 +1273,8 @@ static const getpix_func getpixes[4] = {
     getpix_8, getpix_16, getpix_24, getpix_32
 };
 
-static int
-RLEColorkeySurface(SDL_Surface * surface)
+static Uint8 *
+RLEColorkeySurface(SDL_Surface * surface, Uint32 colorkey)
 {
     Uint8 *rlebuf, *dst;
     int maxn;
@@ -1302,12 +1306,13 @@ RLEColorkeySurface(SDL_Surface * surface)
         break;
 
     default:
-        return -1;
+        return NULL;
     }
 
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (rlebuf == NULL) {
-        return SDL_OutOfMemory();
+        SDL_OutOfMemory();
+        return NULL;
     }
 
     /* Set up the conversion */
@@ -1315,7 +1320,7 @@ RLEColorkeySurface(SDL_Surface * surface)
     maxn = bpp == 4 ? 65535 : 255;
     dst = rlebuf;
     rgbmask = ~surface->format->Amask;
-    ckey = surface->map->info.colorkey & rgbmask;
+    ckey = colorkey & rgbmask;
     lastline = dst;
     getpix = getpixes[bpp - 1];
     w = surface->w;
@@ -1381,34 +1386,245 @@ RLEColorkeySurface(SDL_Surface * surface)
 
 #undef ADD_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
     /* realloc the buffer to release unused memory */
     {
         /* If realloc returns NULL, the original block is left intact */
         Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
         if (!p)
             p = rlebuf;
-        surface->map->data = p;
+        return p;
     }
+}
 
-    return 0;
+
+static void
+RLEFreeData(SDL_RLEData * rle)
+{
+    if (rle) {
+        SDL_free(rle->buf);
+        SDL_free(rle);
+    }
+}
+
+/* Does an encoding (or one in progress) fit what the surface needs now? */
+static SDL_bool
+RLEMatches(const SDL_RLEData * rle, const SDL_RLEData * want)
+{
+    return (rle->kind == want->kind &&
+            rle->colorkey == want->colorkey &&
+            rle->dst_format == want->dst_format &&
+            rle->generation == want->generation);
+}
+
+static void
+RLEEncode(SDL_Surface * surface, SDL_PixelFormat * dstfmt, SDL_RLEData * rle)
+{
+    if (rle->kind == SDL_COPY_RLE_COLORKEY) {
+        rle->buf = RLEColorkeySurface(surface, rle->colorkey);
+    } else {
+        rle->buf = RLEAlphaSurface(surface, dstfmt);
+    }
+}
+
+static void
+RLERunJob(SDL_RLEJob * job)
+{
+    RLEEncode(&job->surface, &job->dstfmt, job->rle);
+
+    /* The job belongs to the surface again after this */
+    SDL_SemPost(job->done);
+}
+
+static int SDLCALL
+RLEWorkerThread(void *data)
+{
+    SDL_RLEJob *job;
+
+    for (;;) {
+        while (SDL_AtomicQueuePop(rle_queue, &job)) {
+            RLERunJob(job);
+        }
+        if (SDL_SemWaitTimeout(rle_wakeup, RLE_WORKER_IDLE_MS) == SDL_MUTEX_TIMEDOUT) {
+            /* Jobs are queued under the lock, so nothing can be missed */
+            SDL_AtomicLock(&rle_worker_lock);
+            if (!SDL_AtomicQueuePop(rle_queue, &job)) {
+                rle_worker_running = SDL_FALSE;
+                SDL_AtomicUnlock(&rle_worker_lock);
+                return 0;
+            }
+            SDL_AtomicUnlock(&rle_worker_lock);
+            RLERunJob(job);
+        }
+    }
+}
+
+/* Hand a job to the worker, starting it if needed */
+static SDL_bool
+RLEQueueJob(SDL_RLEJob * job)
+{
+    SDL_Thread *thread;
+    SDL_bool start = SDL_FALSE;
+
+    SDL_AtomicLock(&rle_worker_lock);
+    if (!rle_queue) {
+        rle_queue = SDL_CreateAtomicQueue(sizeof(job), RLE_QUEUE_SIZE);
+    }
+    if (!rle_wakeup) {
+        rle_wakeup = SDL_CreateSemaphore(0);
+    }
+    if (!rle_queue || !rle_wakeup || !SDL_AtomicQueuePush(rle_queue, &job)) {
+        SDL_AtomicUnlock(&rle_worker_lock);
+        return SDL_FALSE;
+    }
+    if (!rle_worker_running) {
+        rle_worker_running = SDL_TRUE;
+        start = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&rle_worker_lock);
+
+    if (!start) {
+        SDL_SemPost(rle_wakeup);
+        return SDL_TRUE;
+    }
+
+    thread = SDL_CreateThreadInternal(RLEWorkerThread, "SDLRLEEncode", 0, NULL);
+    if (thread) {
+        SDL_DetachThread(thread);
+        return SDL_TRUE;
+    }
+
+    /* No worker, so run whatever is queued, including this job */
+    SDL_AtomicLock(&rle_worker_lock);
+    rle_worker_running = SDL_FALSE;
+    SDL_AtomicUnlock(&rle_worker_lock);
+    while (SDL_AtomicQueuePop(rle_queue, &job)) {
+        RLERunJob(job);
+    }
+    return SDL_TRUE;
+}
+
+static SDL_bool
+RLEStartJob(SDL_Surface * surface, const SDL_RLEData * want)
+{
+    const size_t rowlen = (size_t) surface->w * surface->format->BytesPerPixel;
+    SDL_RLEJob *job;
+    Uint8 *dst;
+    const Uint8 *src;
+    int y;
+
+    job = (SDL_RLEJob *) SDL_calloc(1, sizeof(*job));
+    if (!job) {
+        return SDL_FALSE;
+    }
+    job->rle = (SDL_RLEData *) SDL_malloc(sizeof(*job->rle));
+    job->done = SDL_CreateSemaphore(0);
+    job->surface.pixels = SDL_malloc(rowlen * surface->h);
+    if (!job->rle || !job->done || !job->surface.pixels) {
+        goto failed;
+    }
+    *job->rle = *want;
+
+    /* The encoders only look at the format, size and pixels */
+    job->srcfmt = *surface->format;
+    job->srcfmt.palette = NULL;
+    job->srcfmt.next = NULL;
+    job->surface.format = &job->srcfmt;
+    job->surface.w = surface->w;
+    job->surface.h = surface->h;
+    job->surface.pitch = (int) rowlen;
+    src = (const Uint8 *) surface->pixels;
+    dst = (Uint8 *) job->surface.pixels;
+    for (y = 0; y < surface->h; ++y) {
+        SDL_memcpy(dst, src, rowlen);
+        src += surface->pitch;
+        dst += rowlen;
+    }
+
+    job->dstfmt = *surface->map->dst->format;
+    job->dstfmt.palette = NULL;
+    job->dstfmt.next = NULL;
+
+    if (!RLEQueueJob(job)) {
+        goto failed;
+    }
+    surface->map->rle_job = job;
+    return SDL_TRUE;
+
+failed:
+    if (job->done) {
+        SDL_DestroySemaphore(job->done);
+    }
+    SDL_free(job->surface.pixels);
+    SDL_free(job->rle);
+    SDL_free(job);
+    return SDL_FALSE;
+}
+
+/* Take over the result of a background encoding once it has finished,
+   returns SDL_FALSE if it is still running */
+static SDL_bool
+RLEFinishJob(SDL_Surface * surface, SDL_bool wait)
+{
+    SDL_BlitMap *map = surface->map;
+    SDL_RLEJob *job = map->rle_job;
+
+    if (!job) {
+        return SDL_TRUE;
+    }
+    if (wait) {
+        SDL_SemWait(job->done);
+    } else if (SDL_SemTryWait(job->done) != 0) {
+        return SDL_FALSE;
+    }
+    map->rle_job = NULL;
+
+    if (job->rle->generation == map->pixels_generation) {
+        RLEFreeData(map->rle);
+        map->rle = job->rle;
+    } else {
+        /* The pixels changed while they were being encoded */
+        RLEFreeData(job->rle);
+    }
+    SDL_DestroySemaphore(job->done);
+    SDL_free(job->surface.pixels);
+    SDL_free(job);
+    return SDL_TRUE;
+}
+
+static void
+RLEUpdateFlags(SDL_Surface * surface)
+{
+    SDL_BlitMap *map = surface->map;
+
+    if ((map->rle && map->rle->buf) || map->rle_job) {
+        surface->flags |= SDL_RLEACCEL;
+    } else {
+        surface->flags &= ~SDL_RLEACCEL;
+    }
+}
+
+/* The blitter of a surface whose encoding isn't ready */
+static int
+SDL_RLEPendingBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
+                   SDL_Surface * surf_dst, SDL_Rect * dstrect)
+{
+    if (RLEFinishJob(surf_src, SDL_FALSE)) {
+        if (SDL_RLESurface(surf_src) < 0) {
+            surf_src->map->blit = SDL_SoftBlit;
+        } else if (surf_src->map->blit != SDL_RLEPendingBlit) {
+            return surf_src->map->blit(surf_src, srcrect, surf_dst, dstrect);
+        }
+    }
+    return SDL_SoftBlit(surf_src, srcrect, surf_dst, dstrect);
 }
 
 int
 SDL_RLESurface(SDL_Surface * surface)
 {
+    SDL_BlitMap *map = surface->map;
+    SDL_RLEData want;
     int flags;
 
-    /* Clear any previous RLE conversion */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
-    }
-
     /* We don't support RLE encoding of bitmaps */
     if (surface->format->BitsPerPixel < 8) {
         return -1;
@@ -1420,7 +1636,7 @@ SDL_RLESurface(SDL_Surface * surface)
     }
 
     /* If we don't have colorkey or blending, nothing to do... */
-    flags = surface->map->info.flags;
+    flags = map->info.flags;
     if (!(flags & (SDL_COPY_COLORKEY | SDL_COPY_BLEND))) {
         return -1;
     }
@@ -1428,154 +1644,159 @@ SDL_RLESurface(SDL_Surface * surface)
     /* Pass on combinations not supported */
     if ((flags & SDL_COPY_MODULATE_COLOR) ||
         ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
-        (flags & (SDL_COPY_ADD | SDL_COPY_MOD)) ||
+        (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_BLEND_PREMULTIPLIED)) ||
         (flags & SDL_COPY_NEAREST)) {
         return -1;
     }
 
-    /* Encode and set up the blit */
+    /* Work out which encoding this mapping needs */
+    SDL_zero(want);
+    want.generation = map->pixels_generation;
     if (!surface->format->Amask || !(flags & SDL_COPY_BLEND)) {
-        if (!surface->map->identity) {
-            return -1;
-        }
-        if (RLEColorkeySurface(surface) < 0) {
+        if (!map->identity) {
             return -1;
         }
-        surface->map->blit = SDL_RLEBlit;
-        surface->map->info.flags |= SDL_COPY_RLE_COLORKEY;
+        want.kind = SDL_COPY_RLE_COLORKEY;
+        want.colorkey = map->info.colorkey;
     } else {
-        if (RLEAlphaSurface(surface) < 0) {
+        want.kind = SDL_COPY_RLE_ALPHAKEY;
+        want.dst_format = map->dst->format->format;
+        if (want.dst_format == SDL_PIXELFORMAT_UNKNOWN) {
             return -1;
         }
-        surface->map->blit = SDL_RLEAlphaBlit;
-        surface->map->info.flags |= SDL_COPY_RLE_ALPHAKEY;
     }
 
-    /* The surface is now accelerated */
-    surface->flags |= SDL_RLEACCEL;
+    /* Use a finished background encoding if there is one */
+    RLEFinishJob(surface, SDL_FALSE);
+
+    if (!map->rle || !RLEMatches(map->rle, &want)) {
+        if (map->rle_job) {
+            /* Wait for the running encoding before starting another one */
+            map->blit = SDL_RLEPendingBlit;
+            return 0;
+        }
+        RLEFreeData(map->rle);
+        map->rle = NULL;
+
+        if (SDL_GetHintBoolean(SDL_HINT_VIDEO_RLE_BACKGROUND, SDL_FALSE) &&
+            RLEStartJob(surface, &want)) {
+            map->blit = SDL_RLEPendingBlit;
+            RLEUpdateFlags(surface);
+            return 0;
+        }
+
+        map->rle = (SDL_RLEData *) SDL_malloc(sizeof(*map->rle));
+        if (!map->rle) {
+            return SDL_OutOfMemory();
+        }
+        *map->rle = want;
+        RLEEncode(surface, map->dst->format, map->rle);
+    }
+    RLEUpdateFlags(surface);
+
+    /* The encoding is kept even if it failed, so we don't retry it */
+    if (!map->rle->buf) {
+        return -1;
+    }
+
+    /* Set up the blit */
+    if (want.kind == SDL_COPY_RLE_COLORKEY) {
+        map->blit = SDL_RLEBlit;
+    } else {
+        map->blit = SDL_RLEAlphaBlit;
+    }
+    map->info.flags |= want.kind;
 
     return (0);
 }
 
-/*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
- */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
+void
+SDL_MarkRLESurfaceDirty(SDL_Surface * surface)
 {
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
-
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
-    } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
-    }
+    SDL_BlitMap *map = surface->map;
 
-    surface->pixels = SDL_malloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
+    /* Any encoding made so far describes old pixels */
+    ++map->pixels_generation;
+    RLEFreeData(map->rle);
+    map->rle = NULL;
+
+    /* Encode again when the surface is next blitted */
+    if (map->info.flags & (SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY)) {
+        map->info.flags &= ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
+        map->blit = SDL_RLEPendingBlit;
     }
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
+    RLEUpdateFlags(surface);
+}
 
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs)
-                return (SDL_TRUE);
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
-
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
+/* 64-bit FNV-1a over the visible part of each row */
+static Uint64
+RLEChecksum(SDL_Surface * surface)
+{
+    const Uint64 prime = 0x100000001b3ULL;
+    Uint64 hash = 0xcbf29ce484222325ULL;
+    const size_t rowlen = (size_t) surface->w * surface->format->BytesPerPixel;
+    const Uint8 *row = (const Uint8 *) surface->pixels;
+    int y;
+
+    for (y = 0; y < surface->h; ++y) {
+        size_t i = 0;
+        Uint32 word;
+
+        for (; i + 4 <= rowlen; i += 4) {
+            SDL_memcpy(&word, row + i, 4);
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < rowlen; ++i) {
+            hash = (hash ^ row[i]) * prime;
+        }
+        row += surface->pitch;
     }
-    /* Make the compiler happy */
-    return (SDL_TRUE);
+    return hash;
 }
 
 void
-SDL_UnRLESurface(SDL_Surface * surface, int recode)
+SDL_RLELockSurface(SDL_Surface * surface)
 {
-    if (surface->flags & SDL_RLEACCEL) {
-        surface->flags &= ~SDL_RLEACCEL;
+    SDL_BlitMap *map = surface->map;
 
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
-
-                /* re-create the original surface */
-                surface->pixels = SDL_malloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
+    map->pixels_checksummed = SDL_FALSE;
+    if ((surface->flags & SDL_RLEACCEL) && surface->pixels) {
+        map->pixels_checksum = RLEChecksum(surface);
+        map->pixels_checksummed = SDL_TRUE;
+    }
+}
 
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
+void
+SDL_RLEUnlockSurface(SDL_Surface * surface)
+{
+    SDL_BlitMap *map = surface->map;
 
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-            }
+    /* Keep the encoding if nothing was written through the lock */
+    if (surface->flags & SDL_RLEACCEL) {
+        if (!map->pixels_checksummed || !surface->pixels ||
+            RLEChecksum(surface) != map->pixels_checksum) {
+            SDL_MarkRLESurfaceDirty(surface);
         }
-        surface->map->info.flags &=
-            ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
+    }
+    map->pixels_checksummed = SDL_FALSE;
+}
+
+void
+SDL_UnRLESurface(SDL_Surface * surface)
+{
+    SDL_BlitMap *map = surface->map;
+
+    RLEFinishJob(surface, SDL_TRUE);
+    RLEFreeData(map->rle);
+    map->rle = NULL;
 
-        SDL_free(surface->map->data);
-        surface->map->data = NULL;
+    if (map->info.flags & (SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY)) {
+        map->info.flags &= ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
+        map->blit = SDL_SoftBlit;
+    } else if (map->blit == SDL_RLEPendingBlit) {
+        map->blit = SDL_SoftBlit;
     }
+    surface->flags &= ~SDL_RLEACCEL;
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -21,6 +21,7 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_atomic.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
@@ -30,12 +31,11 @@
 #include "SDL_pixels_c.h"
 
 /* The general purpose software blit routine */
-static int
+int
 SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
              SDL_Surface * dst, SDL_Rect * dstrect)
 {
     int okay;
-    int src_locked;
     int dst_locked;
 
     /* Everything is okay at the beginning...  */
@@ -50,15 +50,8 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
             dst_locked = 1;
         }
     }
-    /* Lock the source if it's in hardware */
-    src_locked = 0;
-    if (SDL_MUSTLOCK(src)) {
-        if (SDL_LockSurface(src) < 0) {
-            okay = 0;
-        } else {
-            src_locked = 1;
-        }
-    }
+    /* The source is only read, and RLE encoded surfaces keep their pixels,
+       so it doesn't need to be locked */
 
     /* Set up source and destination buffer pointers, and BLIT! */
     if (okay && !SDL_RectEmpty(srcrect)) {
@@ -92,43 +85,29 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
     if (dst_locked) {
         SDL_UnlockSurface(dst);
     }
-    if (src_locked) {
-        SDL_UnlockSurface(src);
-    }
     /* Blit is done! */
     return (okay ? 0 : -1);
 }
 
-#ifdef __MACOSX__
-#include <sys/sysctl.h>
-
+/* Prefetching helps the G4, but not the G5, which has no L3 cache */
 static SDL_bool
 SDL_UseAltivecPrefetch()
 {
-    const char key[] = "hw.l3cachesize";
-    u_int64_t result = 0;
-    size_t typeSize = sizeof(result);
+    SDL_CPUTopology topology;
 
-    if (sysctlbyname(key, &result, &typeSize, NULL, 0) == 0 && result > 0) {
+    SDL_GetCPUTopology(&topology);
+#ifndef __MACOSX__
+    if (topology.l3_cache_size == 0) {
+        /* Just guess G4 */
         return SDL_TRUE;
-    } else {
-        return SDL_FALSE;
     }
+#endif
+    return (topology.l3_cache_size > 0) ? SDL_TRUE : SDL_FALSE;
 }
-#else
-static SDL_bool
-SDL_UseAltivecPrefetch()
-{
-    /* Just guess G4 */
-    return SDL_TRUE;
-}
-#endif /* __MACOSX__ */
 
-static SDL_BlitFunc
-SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
-                   SDL_BlitFuncEntry * entries)
+static Uint32
+SDL_GetBlitFeatures(void)
 {
-    int i, flagcheck;
     static Uint32 features = 0xffffffff;
 
     /* Get the available CPU features */
@@ -162,6 +141,15 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
             }
         }
     }
+    return features;
+}
+
+static SDL_BlitFunc
+SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
+                   SDL_BlitFuncEntry * entries)
+{
+    const Uint32 features = SDL_GetBlitFeatures();
+    int i, flagcheck;
 
     for (i = 0; entries[i].func; ++i) {
         /* Check for matching pixel formats */
@@ -180,9 +168,7 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
         }
 
         /* Check blend flags */
-        flagcheck =
-            (flags &
-             (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD));
+        flagcheck = (flags & SDL_COPY_BLEND_MASK);
         if ((flagcheck & entries[i].flags) != flagcheck) {
             continue;
         }
@@ -211,38 +197,89 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
     return NULL;
 }
 
-/* Figure out which of many blit routines to set up on a surface */
-int
-SDL_CalculateBlit(SDL_Surface * surface)
+/* Blit selections only depend on the formats, the copy flags, whether the
+   mapping is an identity copy and the CPU features, so they are resolved
+   once and shared by every surface.  Code that alternates between targets
+   then pays for a lookup rather than walking the selection logic again.
+ */
+#define SDL_BLIT_CACHE_SIZE 128     /* Must be a power of two */
+
+typedef struct
 {
-    SDL_BlitFunc blit = NULL;
-    SDL_BlitMap *map = surface->map;
-    SDL_Surface *dst = map->dst;
+    Uint32 src_format;
+    Uint32 dst_format;
+    int flags;
+    int identity;
+    Uint32 features;
+    SDL_BlitFunc func;
+} SDL_BlitCacheEntry;
+
+static SDL_BlitCacheEntry SDL_blit_cache[SDL_BLIT_CACHE_SIZE];
+static SDL_SpinLock SDL_blit_cache_lock;
+
+static SDL_BlitCacheEntry *
+SDL_GetBlitCacheEntry(Uint32 src_format, Uint32 dst_format, int flags, int identity)
+{
+    Uint32 hash = src_format;
 
-    /* We don't currently support blitting to < 8 bpp surfaces */
-    if (dst->format->BitsPerPixel < 8) {
-        SDL_InvalidateMap(map);
-        return SDL_SetError("Blit combination not supported");
+    hash = hash * 31 + dst_format;
+    hash = hash * 31 + (Uint32) flags;
+    hash = hash * 31 + (Uint32) identity;
+    hash ^= (hash >> 16);
+    return &SDL_blit_cache[hash & (SDL_BLIT_CACHE_SIZE - 1)];
+}
+
+static SDL_BlitFunc
+SDL_LookupBlitCache(Uint32 src_format, Uint32 dst_format, int flags,
+                    int identity, Uint32 features)
+{
+    SDL_BlitCacheEntry *entry;
+    SDL_BlitFunc func = NULL;
+
+    if (src_format == SDL_PIXELFORMAT_UNKNOWN || dst_format == SDL_PIXELFORMAT_UNKNOWN) {
+        return NULL;
     }
 
-    /* Clean everything out to start */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
+    entry = SDL_GetBlitCacheEntry(src_format, dst_format, flags, identity);
+    SDL_AtomicLock(&SDL_blit_cache_lock);
+    if (entry->func && entry->src_format == src_format &&
+        entry->dst_format == dst_format && entry->flags == flags &&
+        entry->identity == identity && entry->features == features) {
+        func = entry->func;
     }
-    map->blit = SDL_SoftBlit;
-    map->info.src_fmt = surface->format;
-    map->info.src_pitch = surface->pitch;
-    map->info.dst_fmt = dst->format;
-    map->info.dst_pitch = dst->pitch;
+    SDL_AtomicUnlock(&SDL_blit_cache_lock);
+    return func;
+}
 
-    /* See if we can do RLE acceleration */
-    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
-        if (SDL_RLESurface(surface) == 0) {
-            return 0;
-        }
+static void
+SDL_UpdateBlitCache(Uint32 src_format, Uint32 dst_format, int flags,
+                    int identity, Uint32 features, SDL_BlitFunc func)
+{
+    SDL_BlitCacheEntry *entry;
+
+    if (src_format == SDL_PIXELFORMAT_UNKNOWN || dst_format == SDL_PIXELFORMAT_UNKNOWN) {
+        return;
     }
 
-    /* Choose a standard blit function */
+    /* Colliding selections simply replace each other */
+    entry = SDL_GetBlitCacheEntry(src_format, dst_format, flags, identity);
+    SDL_AtomicLock(&SDL_blit_cache_lock);
+    entry->src_format = src_format;
+    entry->dst_format = dst_format;
+    entry->flags = flags;
+    entry->identity = identity;
+    entry->features = features;
+    entry->func = func;
+    SDL_AtomicUnlock(&SDL_blit_cache_lock);
+}
+
+static SDL_BlitFunc
+SDL_SelectBlitFunc(SDL_Surface * surface)
+{
+    SDL_BlitFunc blit = NULL;
+    SDL_BlitMap *map = surface->map;
+    SDL_Surface *dst = map->dst;
+
     if (map->identity && !(map->info.flags & ~SDL_COPY_RLE_DESIRED)) {
         blit = SDL_BlitCopy;
     } else if (surface->format->BitsPerPixel < 8 &&
@@ -251,7 +288,7 @@ SDL_CalculateBlit(SDL_Surface * surface)
     } else if (surface->format->BytesPerPixel == 1 &&
                SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
         blit = SDL_CalculateBlit1(surface);
-    } else if (map->info.flags & SDL_COPY_BLEND) {
+    } else if (map->info.flags & (SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED)) {
         blit = SDL_CalculateBlitA(surface);
     } else {
         blit = SDL_CalculateBlitN(surface);
@@ -278,6 +315,47 @@ SDL_CalculateBlit(SDL_Surface * surface)
             blit = SDL_Blit_Slow;
         }
     }
+    return blit;
+}
+
+/* Figure out which of many blit routines to set up on a surface */
+int
+SDL_CalculateBlit(SDL_Surface * surface)
+{
+    SDL_BlitFunc blit = NULL;
+    SDL_BlitMap *map = surface->map;
+    SDL_Surface *dst = map->dst;
+    Uint32 src_format, dst_format, features;
+
+    /* We don't currently support blitting to < 8 bpp surfaces */
+    if (dst->format->BitsPerPixel < 8) {
+        SDL_InvalidateMap(map);
+        return SDL_SetError("Blit combination not supported");
+    }
+
+    /* Clean everything out to start, an RLE encoding is kept around in
+       case it still fits this mapping */
+    map->info.flags &= ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
+    map->blit = SDL_SoftBlit;
+    map->info.src_fmt = surface->format;
+    map->info.src_pitch = surface->pitch;
+    map->info.dst_fmt = dst->format;
+    map->info.dst_pitch = dst->pitch;
+
+    /* Choose a standard blit function, the selection is shared by every
+       surface with the same formats and flags */
+    src_format = surface->format->format;
+    dst_format = dst->format->format;
+    features = SDL_GetBlitFeatures();
+    blit = SDL_LookupBlitCache(src_format, dst_format, map->info.flags,
+                               map->identity, features);
+    if (blit == NULL) {
+        blit = SDL_SelectBlitFunc(surface);
+        if (blit != NULL) {
+            SDL_UpdateBlitCache(src_format, dst_format, map->info.flags,
+                                map->identity, features, blit);
+        }
+    }
     map->data = blit;
 
     /* Make sure we have a blit function */
@@ -286,6 +364,12 @@ SDL_CalculateBlit(SDL_Surface * surface)
         return SDL_SetError("Blit combination not supported");
     }
 
+    /* See if we can do RLE acceleration, the blit function above is
+       used while the encoding isn't ready */
+    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
+        SDL_RLESurface(surface);
+    }
+
     return 0;
 }
 
@@ -36,6 +36,8 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_COPY_BLEND              0x00000010
 #define SDL_COPY_ADD                0x00000020
 #define SDL_COPY_MOD                0x00000040
+#define SDL_COPY_BLEND_PREMULTIPLIED 0x00000080
+#define SDL_COPY_BLEND_MASK         (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD|SDL_COPY_BLEND_PREMULTIPLIED)
 #define SDL_COPY_COLORKEY           0x00000100
 #define SDL_COPY_NEAREST            0x00000200
 #define SDL_COPY_RLE_DESIRED        0x00001000
@@ -81,6 +83,9 @@ typedef struct
     SDL_BlitFunc func;
 } SDL_BlitFuncEntry;
 
+typedef struct SDL_RLEData SDL_RLEData;
+typedef struct SDL_RLEJob SDL_RLEJob;
+
 /* Blit mapping definition */
 typedef struct SDL_BlitMap
 {
@@ -94,10 +99,22 @@ typedef struct SDL_BlitMap
        an invalid mapping */
     Uint32 dst_palette_version;
     Uint32 src_palette_version;
+
+    /* RLE encoding of the source and a background encoding in progress,
+       pixels_generation changes whenever the source pixels may have */
+    SDL_RLEData *rle;
+    SDL_RLEJob *rle_job;
+    Uint32 pixels_generation;
+
+    /* checksum of the source pixels taken when the surface was locked */
+    Uint64 pixels_checksum;
+    SDL_bool pixels_checksummed;
 } SDL_BlitMap;
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern int SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
+                        SDL_Surface * dst, SDL_Rect * dstrect);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
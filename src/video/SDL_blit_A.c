@@ -509,6 +509,109 @@ BlitRGBtoRGBPixelAlpha(SDL_BlitInfo * info)
     }
 }
 
+/* Premultiplied 8888->8888 blending, every channel including alpha is
+   dst = src + dst * (255 - srcA) / 255 so the byte order doesn't matter
+   as long as source and destination agree. */
+static void
+BlitRGBtoRGBPremultipliedPixelAlpha(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    int ashift = info->src_fmt->Ashift;
+
+    while (height--) {
+	    /* *INDENT-OFF* */
+	    DUFFS_LOOP4({
+		Uint32 s = *srcp;
+		Uint32 alpha = (s >> ashift) & 0xff;
+		if (alpha == SDL_ALPHA_OPAQUE) {
+		    *dstp = s;
+		} else if (s) {
+		    /* Scale two channels at a time, exact division by 255 */
+		    Uint32 inva = alpha ^ 0xff;
+		    Uint32 d = *dstp;
+		    Uint32 rb = (d & 0xff00ff) * inva + 0x800080;
+		    Uint32 ag = ((d >> 8) & 0xff00ff) * inva + 0x800080;
+		    rb = ((rb + ((rb >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+		    ag = ((ag + ((ag >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+		    /* Add with saturation, as the SSE2 version does, in case
+		       a color channel is larger than alpha */
+		    rb += s & 0xff00ff;
+		    ag += (s >> 8) & 0xff00ff;
+		    rb |= ((rb >> 8) & 0x10001) * 0xff;
+		    ag |= ((ag >> 8) & 0x10001) * 0xff;
+		    *dstp = (rb & 0xff00ff) | ((ag & 0xff00ff) << 8);
+		}
+		++srcp;
+		++dstp;
+	    }, width);
+	    /* *INDENT-ON* */
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+#ifdef __SSE2__
+/* SSE2 version of the above, four pixels at a time */
+static void
+BlitRGBtoRGBPremultipliedPixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const int ashift = info->src_fmt->Ashift;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphamask = _mm_set1_epi32(0xff);
+    const __m128i all255 = _mm_set1_epi16(0xff);
+    const __m128i round = _mm_set1_epi16(0x80);
+
+    while (height--) {
+        int n = width;
+
+        for ( ; n >= 4; n -= 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            __m128i a, lo, hi;
+
+            /* Spread each pixel's alpha across its four 16-bit channels */
+            a = _mm_and_si128(_mm_srl_epi32(s, _mm_cvtsi32_si128(ashift)), alphamask);
+            a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+            lo = _mm_sub_epi16(all255, _mm_unpacklo_epi32(a, a));
+            hi = _mm_sub_epi16(all255, _mm_unpackhi_epi32(a, a));
+
+            /* d * inva / 255, rounded exactly */
+            lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), lo), round);
+            hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), hi), round);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+            _mm_storeu_si128((__m128i *) dstp, _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+            srcp += 4;
+            dstp += 4;
+        }
+        if (n > 0) {
+            SDL_BlitInfo tail = *info;
+            tail.src = (Uint8 *) srcp;
+            tail.dst = (Uint8 *) dstp;
+            tail.dst_w = n;
+            tail.dst_h = 1;
+            BlitRGBtoRGBPremultipliedPixelAlpha(&tail);
+            srcp += n;
+            dstp += n;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* __SSE2__ */
+
 #ifdef __3dNOW__
 /* fast (as in MMX with prefetch) ARGB888->(A)RGB888 blending with pixel alpha */
 static void
@@ -1371,6 +1474,22 @@ SDL_CalculateBlitA(SDL_Surface * surface)
         }
         break;
 
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        /* Per-pixel premultiplied alpha blits between matching 8888 formats */
+        if (sf->BytesPerPixel == 4 && df->BytesPerPixel == 4
+            && sf->Amask && sf->Aloss == 0 && sf->Ashift % 8 == 0
+            && sf->Rmask == df->Rmask
+            && sf->Gmask == df->Gmask
+            && sf->Bmask == df->Bmask
+            && (df->Amask == 0 || df->Amask == sf->Amask)) {
+#ifdef __SSE2__
+            if (SDL_HasSSE2())
+                return BlitRGBtoRGBPremultipliedPixelAlphaSSE2;
+#endif
+            return BlitRGBtoRGBPremultipliedPixelAlpha;
+        }
+        break;
+
     case SDL_COPY_COLORKEY | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND:
         if (sf->Amask == 0) {
             if (df->BytesPerPixel == 1) {
@@ -27,36 +27,31 @@
 
 #include "SDL_assert.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SDL_NEON_BLITTERS 1
+#include <arm_neon.h>
+#endif
+
 /* Functions to blit from N-bit surfaces to other surfaces */
 
 #if SDL_ALTIVEC_BLITTERS
 #ifdef HAVE_ALTIVEC_H
 #include <altivec.h>
 #endif
-#ifdef __MACOSX__
-#include <sys/sysctl.h>
 static size_t
 GetL3CacheSize(void)
 {
-    const char key[] = "hw.l3cachesize";
-    u_int64_t result = 0;
-    size_t typeSize = sizeof(result);
-
+    SDL_CPUTopology topology;
 
-    int err = sysctlbyname(key, &result, &typeSize, NULL, 0);
-    if (0 != err)
-        return 0;
-
-    return result;
-}
-#else
-static size_t
-GetL3CacheSize(void)
-{
-    /* XXX: Just guess G4 */
-    return 2097152;
+    SDL_GetCPUTopology(&topology);
+#ifndef __MACOSX__
+    if (topology.l3_cache_size == 0) {
+        /* XXX: Just guess G4 */
+        return 2097152;
+    }
+#endif
+    return (size_t) topology.l3_cache_size;
 }
-#endif /* __MACOSX__ */
 
 #if (defined(__MACOSX__) && (__GNUC__ < 4))
 #define VECUINT8_LITERAL(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p) \
@@ -874,8 +869,10 @@ GetBlitFeatures(void)
 #pragma altivec_model off
 #endif
 #else
-/* Feature 1 is has-MMX */
-#define GetBlitFeatures() ((Uint32)(SDL_HasMMX() ? 1 : 0))
+/* Feature 1 is has-MMX, feature 8 is has-SSE2, feature 16 is has-NEON */
+#define GetBlitFeatures() ((Uint32)((SDL_HasMMX() ? 1 : 0) | \
+                                    (SDL_HasSSE2() ? 8 : 0) | \
+                                    (SDL_HasNEON() ? 16 : 0)))
 #endif
 
 /* This is now endian dependent */
@@ -2462,6 +2459,486 @@ BlitNto2101010(SDL_BlitInfo * info)
     }
 }
 
+/* Conversions between formats whose R, G, B (and A) channels are all whole
+   bytes reduce to moving bytes around: describe the move once per blit as a
+   set of masks that shift by the same amount, plus the byte each destination
+   byte is taken from for the table lookup kernels. */
+typedef struct
+{
+    int count;
+    Uint32 mask[4];     /* source bits that move by shift[i] */
+    int shift[4];       /* > 0 shifts left, < 0 shifts right */
+    int byte[4];        /* source byte for each destination byte, or -1 */
+    Uint32 fill;        /* constant alpha when not copied from the source */
+} PixelSwizzle;
+
+static SDL_bool
+IsByteAligned(const SDL_PixelFormat * fmt)
+{
+    if (fmt->BytesPerPixel < 3 ||
+        fmt->Rloss || fmt->Gloss || fmt->Bloss ||
+        (fmt->Rshift | fmt->Gshift | fmt->Bshift) & 7) {
+        return SDL_FALSE;
+    }
+    if (fmt->Amask && (fmt->Aloss || (fmt->Ashift & 7))) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static int
+ByteOfShift(int shift, int bpp)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    return shift / 8;
+#else
+    return bpp - 1 - shift / 8;
+#endif
+}
+
+static void
+CalculateSwizzle(const SDL_PixelFormat * srcfmt,
+                 const SDL_PixelFormat * dstfmt, Uint8 alpha,
+                 PixelSwizzle * swizzle)
+{
+    Uint32 srcmask[4];
+    int srcshift[4], dstshift[4];
+    int channels = 3;
+    int i, j;
+
+    srcmask[0] = srcfmt->Rmask;
+    srcmask[1] = srcfmt->Gmask;
+    srcmask[2] = srcfmt->Bmask;
+    srcshift[0] = srcfmt->Rshift;
+    srcshift[1] = srcfmt->Gshift;
+    srcshift[2] = srcfmt->Bshift;
+    dstshift[0] = dstfmt->Rshift;
+    dstshift[1] = dstfmt->Gshift;
+    dstshift[2] = dstfmt->Bshift;
+
+    swizzle->fill = 0;
+    if (dstfmt->Amask) {
+        if (srcfmt->Amask) {
+            srcmask[3] = srcfmt->Amask;
+            srcshift[3] = srcfmt->Ashift;
+            dstshift[3] = dstfmt->Ashift;
+            channels = 4;
+        } else {
+            swizzle->fill = (Uint32) alpha << dstfmt->Ashift;
+        }
+    }
+
+    swizzle->count = 0;
+    for (i = 0; i < 4; ++i) {
+        swizzle->byte[i] = -1;
+    }
+    for (i = 0; i < channels; ++i) {
+        const int shift = dstshift[i] - srcshift[i];
+        for (j = 0; j < swizzle->count; ++j) {
+            if (swizzle->shift[j] == shift) {
+                break;
+            }
+        }
+        if (j == swizzle->count) {
+            swizzle->mask[j] = 0;
+            swizzle->shift[j] = shift;
+            ++swizzle->count;
+        }
+        swizzle->mask[j] |= srcmask[i];
+        swizzle->byte[ByteOfShift(dstshift[i], dstfmt->BytesPerPixel)] =
+            ByteOfShift(srcshift[i], srcfmt->BytesPerPixel);
+    }
+}
+
+static SDL_INLINE Uint32
+SwizzlePixel(const PixelSwizzle * swizzle, Uint32 pixel)
+{
+    Uint32 result = swizzle->fill;
+    int i;
+
+    for (i = 0; i < swizzle->count; ++i) {
+        const Uint32 bits = pixel & swizzle->mask[i];
+        if (swizzle->shift[i] >= 0) {
+            result |= bits << swizzle->shift[i];
+        } else {
+            result |= bits >> -swizzle->shift[i];
+        }
+    }
+    return result;
+}
+
+#define STORE_RGB24_PIXEL(buf, Pixel)                                   \
+do {                                                                    \
+    Uint8 *B = (Uint8 *)(buf);                                          \
+    if (SDL_BYTEORDER == SDL_LIL_ENDIAN) {                              \
+        B[0] = (Uint8)(Pixel);                                          \
+        B[1] = (Uint8)((Pixel) >> 8);                                   \
+        B[2] = (Uint8)((Pixel) >> 16);                                  \
+    } else {                                                            \
+        B[0] = (Uint8)((Pixel) >> 16);                                  \
+        B[1] = (Uint8)((Pixel) >> 8);                                   \
+        B[2] = (Uint8)(Pixel);                                          \
+    }                                                                   \
+} while (0)
+
+/* blits 32 bit RGB(A) -> RGB(A) with any byte order */
+static void
+Blit8888to8888(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+        {
+            *dst = SwizzlePixel(&swizzle, *src);
+            ++dst;
+            ++src;
+        },
+        width);
+        /* *INDENT-ON* */
+        src = (Uint32 *) ((Uint8 *) src + srcskip);
+        dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+    }
+}
+
+/* blits 24 bit RGB -> 32 bit RGB(A) with any byte order */
+static void
+Blit888to8888(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+        {
+            Uint32 Pixel;
+            RETRIEVE_RGB_PIXEL(src, 3, Pixel);
+            *dst = SwizzlePixel(&swizzle, Pixel);
+            ++dst;
+            src += 3;
+        },
+        width);
+        /* *INDENT-ON* */
+        src += srcskip;
+        dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+    }
+}
+
+/* blits 32 bit RGB(A) -> 24 bit RGB with any byte order */
+static void
+Blit8888to888(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+        {
+            const Uint32 Pixel = SwizzlePixel(&swizzle, *src);
+            STORE_RGB24_PIXEL(dst, Pixel);
+            dst += 3;
+            ++src;
+        },
+        width);
+        /* *INDENT-ON* */
+        src = (Uint32 *) ((Uint8 *) src + srcskip);
+        dst += dstskip;
+    }
+}
+
+/* colorkey blits 32 bit RGB(A) -> RGB(A) with any byte order */
+static void
+Blit8888to8888Key(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    Uint32 rgbmask = ~info->src_fmt->Amask;
+    Uint32 ckey = info->colorkey & rgbmask;
+    PixelSwizzle swizzle;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP(
+        {
+            if ((*src & rgbmask) != ckey) {
+                *dst = SwizzlePixel(&swizzle, *src);
+            }
+            ++dst;
+            ++src;
+        },
+        width);
+        /* *INDENT-ON* */
+        src = (Uint32 *) ((Uint8 *) src + srcskip);
+        dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+    }
+}
+
+#ifdef __SSE2__
+/* SSE2 has no byte shuffle, so move each group of channels with a
+   mask and a shift; every permutation needs at most four of those. */
+#define SWIZZLE_SSE2_SETUP(swizzle)                                     \
+    __m128i mask[4], lshift[4], rshift[4];                              \
+    const __m128i fill = _mm_set1_epi32((int) (swizzle).fill);          \
+    int i;                                                              \
+    for (i = 0; i < (swizzle).count; ++i) {                             \
+        const int shift = (swizzle).shift[i];                           \
+        mask[i] = _mm_set1_epi32((int) (swizzle).mask[i]);              \
+        lshift[i] = _mm_cvtsi32_si128(shift > 0 ? shift : 0);           \
+        rshift[i] = _mm_cvtsi32_si128(shift < 0 ? -shift : 0);          \
+    }
+
+#define SWIZZLE_SSE2(swizzle, pixels, result)                           \
+do {                                                                    \
+    result = fill;                                                      \
+    for (i = 0; i < (swizzle).count; ++i) {                             \
+        __m128i bits = _mm_and_si128(pixels, mask[i]);                  \
+        bits = _mm_srl_epi32(_mm_sll_epi32(bits, lshift[i]), rshift[i]);\
+        result = _mm_or_si128(result, bits);                            \
+    }                                                                   \
+} while (0)
+
+static void
+Blit8888to8888SSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+    {
+        SWIZZLE_SSE2_SETUP(swizzle);
+
+        while (height--) {
+            int n = width;
+
+            for (; n >= 4; n -= 4) {
+                const __m128i pixels = _mm_loadu_si128((const __m128i *) src);
+                __m128i result;
+                SWIZZLE_SSE2(swizzle, pixels, result);
+                _mm_storeu_si128((__m128i *) dst, result);
+                src += 4;
+                dst += 4;
+            }
+            while (n--) {
+                *dst++ = SwizzlePixel(&swizzle, *src++);
+            }
+            src = (Uint32 *) ((Uint8 *) src + srcskip);
+            dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+        }
+    }
+}
+
+static void
+Blit8888to8888KeySSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    Uint32 rgbmask = ~info->src_fmt->Amask;
+    Uint32 ckey = info->colorkey & rgbmask;
+    PixelSwizzle swizzle;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+    {
+        const __m128i keymask = _mm_set1_epi32((int) rgbmask);
+        const __m128i key = _mm_set1_epi32((int) ckey);
+        SWIZZLE_SSE2_SETUP(swizzle);
+
+        while (height--) {
+            int n = width;
+
+            for (; n >= 4; n -= 4) {
+                const __m128i pixels = _mm_loadu_si128((const __m128i *) src);
+                const __m128i keyed =
+                    _mm_cmpeq_epi32(_mm_and_si128(pixels, keymask), key);
+                const __m128i old = _mm_loadu_si128((const __m128i *) dst);
+                __m128i result;
+                SWIZZLE_SSE2(swizzle, pixels, result);
+                result = _mm_or_si128(_mm_and_si128(keyed, old),
+                                      _mm_andnot_si128(keyed, result));
+                _mm_storeu_si128((__m128i *) dst, result);
+                src += 4;
+                dst += 4;
+            }
+            while (n--) {
+                if ((*src & rgbmask) != ckey) {
+                    *dst = SwizzlePixel(&swizzle, *src);
+                }
+                ++dst;
+                ++src;
+            }
+            src = (Uint32 *) ((Uint8 *) src + srcskip);
+            dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+        }
+    }
+}
+#endif /* __SSE2__ */
+
+#ifdef SDL_NEON_BLITTERS
+/* NEON does byte shuffles directly: vtbl for packed 32 bit pixels, and
+   structured loads/stores to split 24 and 32 bit pixels into planes. */
+static void
+Blit8888to8888NEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+    Uint8 index[8];
+    uint8x8_t table;
+    uint8x16_t fill;
+    int i;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+    for (i = 0; i < 8; ++i) {
+        const int byte = swizzle.byte[i % 4];
+        /* out of range indices make vtbl produce zero */
+        index[i] = (byte < 0) ? 0xFF : (Uint8) ((i & ~3) + byte);
+    }
+    table = vld1_u8(index);
+    fill = vreinterpretq_u8_u32(vdupq_n_u32(swizzle.fill));
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 4; n -= 4) {
+            const uint8x16_t pixels = vld1q_u8((const uint8_t *) src);
+            const uint8x8_t lo = vtbl1_u8(vget_low_u8(pixels), table);
+            const uint8x8_t hi = vtbl1_u8(vget_high_u8(pixels), table);
+            vst1q_u8((uint8_t *) dst, vorrq_u8(vcombine_u8(lo, hi), fill));
+            src += 4;
+            dst += 4;
+        }
+        while (n--) {
+            *dst++ = SwizzlePixel(&swizzle, *src++);
+        }
+        src = (Uint32 *) ((Uint8 *) src + srcskip);
+        dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+    }
+}
+
+static void
+Blit888to8888NEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint32 *dst = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+    uint8x8_t fill[4];
+    int i;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+    for (i = 0; i < 4; ++i) {
+        fill[i] = vdup_n_u8(((const Uint8 *) &swizzle.fill)[i]);
+    }
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 8; n -= 8) {
+            const uint8x8x3_t pixels = vld3_u8(src);
+            uint8x8x4_t result;
+            for (i = 0; i < 4; ++i) {
+                const int byte = swizzle.byte[i];
+                result.val[i] = (byte < 0) ? fill[i] : pixels.val[byte];
+            }
+            vst4_u8((uint8_t *) dst, result);
+            src += 3 * 8;
+            dst += 8;
+        }
+        while (n--) {
+            Uint32 Pixel;
+            RETRIEVE_RGB_PIXEL(src, 3, Pixel);
+            *dst++ = SwizzlePixel(&swizzle, Pixel);
+            src += 3;
+        }
+        src += srcskip;
+        dst = (Uint32 *) ((Uint8 *) dst + dstskip);
+    }
+}
+
+static void
+Blit8888to888NEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *src = (Uint32 *) info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    PixelSwizzle swizzle;
+    int i;
+
+    CalculateSwizzle(info->src_fmt, info->dst_fmt, info->a, &swizzle);
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 8; n -= 8) {
+            const uint8x8x4_t pixels = vld4_u8((const uint8_t *) src);
+            uint8x8x3_t result;
+            for (i = 0; i < 3; ++i) {
+                result.val[i] = pixels.val[swizzle.byte[i]];
+            }
+            vst3_u8(dst, result);
+            src += 8;
+            dst += 3 * 8;
+        }
+        while (n--) {
+            const Uint32 Pixel = SwizzlePixel(&swizzle, *src++);
+            STORE_RGB24_PIXEL(dst, Pixel);
+            dst += 3;
+        }
+        src = (Uint32 *) ((Uint8 *) src + srcskip);
+        dst += dstskip;
+    }
+}
+#endif /* SDL_NEON_BLITTERS */
+
 /* Normal N to N optimized blitters */
 #define NO_ALPHA   1
 #define SET_ALPHA  2
@@ -2501,8 +2978,57 @@ static const struct blit_table normal_blit_2[] = {
     {0, 0, 0, 0, 0, 0, 0, 0, BlitNtoN, 0}
 };
 
+/* The byte aligned RGB layouts, as masks of the 32 or 24 bit pixel value */
+#define MASKS_XRGB  0x00FF0000, 0x0000FF00, 0x000000FF
+#define MASKS_XBGR  0x000000FF, 0x0000FF00, 0x00FF0000
+#define MASKS_RGBX  0xFF000000, 0x00FF0000, 0x0000FF00
+#define MASKS_BGRX  0x0000FF00, 0x00FF0000, 0xFF000000
+
+/* Every 32-bit layout to every other one; matching layouts are left to the
+   cheaper Blit4to4MaskAlpha and Blit4to4CopyAlpha */
+#define SWIZZLE_8888_ENTRIES(features, blitfunc) \
+    {MASKS_XRGB, 4, MASKS_XBGR, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_XRGB, 4, MASKS_RGBX, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_XRGB, 4, MASKS_BGRX, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_XRGB, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_RGBX, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_BGRX, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_RGBX, 4, MASKS_XRGB, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_RGBX, 4, MASKS_XBGR, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_RGBX, 4, MASKS_BGRX, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_BGRX, 4, MASKS_XRGB, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_BGRX, 4, MASKS_XBGR, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}, \
+    {MASKS_BGRX, 4, MASKS_RGBX, features, blitfunc, NO_ALPHA | COPY_ALPHA | SET_ALPHA}
+
+/* 24-bit RGB or BGR to every 32-bit layout */
+#define EXPAND_888_ENTRIES(features, blitfunc) \
+    {MASKS_XRGB, 4, MASKS_XRGB, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XRGB, 4, MASKS_XBGR, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XRGB, 4, MASKS_RGBX, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XRGB, 4, MASKS_BGRX, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_XRGB, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_XBGR, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_RGBX, features, blitfunc, NO_ALPHA | SET_ALPHA}, \
+    {MASKS_XBGR, 4, MASKS_BGRX, features, blitfunc, NO_ALPHA | SET_ALPHA}
+
+/* Every 32-bit layout to 24-bit RGB or BGR */
+#define PACK_888_ENTRIES(features, blitfunc) \
+    {MASKS_XRGB, 3, MASKS_XRGB, features, blitfunc, NO_ALPHA}, \
+    {MASKS_XRGB, 3, MASKS_XBGR, features, blitfunc, NO_ALPHA}, \
+    {MASKS_XBGR, 3, MASKS_XRGB, features, blitfunc, NO_ALPHA}, \
+    {MASKS_XBGR, 3, MASKS_XBGR, features, blitfunc, NO_ALPHA}, \
+    {MASKS_RGBX, 3, MASKS_XRGB, features, blitfunc, NO_ALPHA}, \
+    {MASKS_RGBX, 3, MASKS_XBGR, features, blitfunc, NO_ALPHA}, \
+    {MASKS_BGRX, 3, MASKS_XRGB, features, blitfunc, NO_ALPHA}, \
+    {MASKS_BGRX, 3, MASKS_XBGR, features, blitfunc, NO_ALPHA}
+
 static const struct blit_table normal_blit_3[] = {
-    /* Default for 24-bit RGB source, never optimized */
+#ifdef SDL_NEON_BLITTERS
+    /* has-NEON */
+    EXPAND_888_ENTRIES(16, Blit888to8888NEON),
+#endif
+    EXPAND_888_ENTRIES(0, Blit888to8888),
+    /* Default for 24-bit RGB source, used if no other blitter matches */
     {0, 0, 0, 0, 0, 0, 0, 0, BlitNtoN, 0}
 };
 
@@ -2522,6 +3048,17 @@ static const struct blit_table normal_blit_4[] = {
      0, Blit_RGB888_RGB565, NO_ALPHA},
     {0x00FF0000, 0x0000FF00, 0x000000FF, 2, 0x00007C00, 0x000003E0, 0x0000001F,
      0, Blit_RGB888_RGB555, NO_ALPHA},
+#ifdef __SSE2__
+    /* has-SSE2 */
+    SWIZZLE_8888_ENTRIES(8, Blit8888to8888SSE2),
+#endif
+#ifdef SDL_NEON_BLITTERS
+    /* has-NEON */
+    SWIZZLE_8888_ENTRIES(16, Blit8888to8888NEON),
+    PACK_888_ENTRIES(16, Blit8888to888NEON),
+#endif
+    SWIZZLE_8888_ENTRIES(0, Blit8888to8888),
+    PACK_888_ENTRIES(0, Blit8888to888),
     /* Default for 32-bit RGB source, used if no other blitter matches */
     {0, 0, 0, 0, 0, 0, 0, 0, BlitNtoN, 0}
 };
@@ -2633,7 +3170,15 @@ SDL_CalculateBlitN(SDL_Surface * surface)
                 return Blit32to32KeyAltivec;
             } else
 #endif
-            if (srcfmt->Amask && dstfmt->Amask) {
+            if (srcfmt->BytesPerPixel == 4 && dstfmt->BytesPerPixel == 4 &&
+                IsByteAligned(srcfmt) && IsByteAligned(dstfmt)) {
+#ifdef __SSE2__
+                if (SDL_HasSSE2()) {
+                    return Blit8888to8888KeySSE2;
+                }
+#endif
+                return Blit8888to8888Key;
+            } else if (srcfmt->Amask && dstfmt->Amask) {
                 return BlitNtoNKeyCopyAlpha;
             } else {
                 return BlitNtoNKey;
@@ -29,7 +29,8 @@
    and save, and since PNG is so complex that it would bloat the library,
    BMP is a good alternative.
 
-   This code currently supports Win32 DIBs in uncompressed 8 and 24 bpp.
+   This code currently supports Win32 DIBs in uncompressed 1, 4, 8, 15, 16,
+   24 and 32 bpp, and RLE compressed 4 and 8 bpp.
 */
 
 #include "SDL_hints.h"
@@ -54,28 +55,33 @@
 #define LCS_WINDOWS_COLOR_SPACE    0x57696E20
 #endif
 
-static void CorrectAlphaChannel(SDL_Surface *surface)
-{
-    /* Check to see if there is any alpha channel data */
-    SDL_bool hasAlpha = SDL_FALSE;
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-    int alphaChannelOffset = 0;
+#define ALPHA_CHANNEL_OFFSET 0
 #else
-    int alphaChannelOffset = 3;
+#define ALPHA_CHANNEL_OFFSET 3
 #endif
-    Uint8 *alpha = ((Uint8*)surface->pixels) + alphaChannelOffset;
-    Uint8 *end = alpha + surface->h * surface->pitch;
+
+/* Check to see if there is any alpha channel data in 32-bit pixels */
+static SDL_bool HasAlphaChannel(const Uint8 *pixels, size_t size)
+{
+    const Uint8 *alpha = pixels + ALPHA_CHANNEL_OFFSET;
+    const Uint8 *end = pixels + size;
 
     while (alpha < end) {
         if (*alpha != 0) {
-            hasAlpha = SDL_TRUE;
-            break;
+            return SDL_TRUE;
         }
         alpha += 4;
     }
+    return SDL_FALSE;
+}
 
-    if (!hasAlpha) {
-        alpha = ((Uint8*)surface->pixels) + alphaChannelOffset;
+static void CorrectAlphaChannel(SDL_Surface *surface)
+{
+    Uint8 *alpha = ((Uint8*)surface->pixels) + ALPHA_CHANNEL_OFFSET;
+    Uint8 *end = ((Uint8*)surface->pixels) + surface->h * surface->pitch;
+
+    if (!HasAlphaChannel((Uint8*)surface->pixels, surface->h * surface->pitch)) {
         while (alpha < end) {
             *alpha = SDL_ALPHA_OPAQUE;
             alpha += 4;
@@ -83,6 +89,158 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     }
 }
 
+/* Returns the data at offset in a memory stream or mapped file, if it holds
+   size bytes there, so it can be used without reading it into another buffer */
+static Uint8 *GetBMPMemory(SDL_RWops *src, Sint64 offset, Sint64 size)
+{
+    const Uint8 *data;
+    size_t available;
+    Sint64 here;
+
+    data = (const Uint8 *)SDL_RWGetPointer(src, &available);
+    if (!data) {
+        return NULL;
+    }
+    here = SDL_RWtell(src);
+    if (here < 0 || offset < here || size < 0 ||
+        size > (Sint64)available - (offset - here)) {
+        return NULL;
+    }
+    return (Uint8 *)data + (offset - here);
+}
+
+/* Swaps the rows of a surface to turn a bottom-up image upright */
+static void FlipBMPRows(SDL_Surface *surface)
+{
+    Uint8 *top = (Uint8 *)surface->pixels;
+    Uint8 *bottom = top + (surface->h - 1) * surface->pitch;
+
+    while (top < bottom) {
+        Uint32 *a, *b;
+        int len = surface->pitch;
+#ifdef __SSE2__
+        if (SDL_HasSSE2()) {
+            for (; len >= 16; len -= 16, top += 16, bottom += 16) {
+                const __m128i x = _mm_loadu_si128((const __m128i *)top);
+                const __m128i y = _mm_loadu_si128((const __m128i *)bottom);
+                _mm_storeu_si128((__m128i *)top, y);
+                _mm_storeu_si128((__m128i *)bottom, x);
+            }
+        }
+#endif
+        /* BMP rows are a multiple of 4 bytes long */
+        a = (Uint32 *)top;
+        b = (Uint32 *)bottom;
+        for (; len > 0; len -= 4) {
+            const Uint32 t = *a;
+            *a++ = *b;
+            *b++ = t;
+        }
+        top = (Uint8 *)a;
+        bottom = (Uint8 *)b - 2 * surface->pitch;
+    }
+}
+
+/* Decodes BI_RLE8 and BI_RLE4 pixel data, which is always stored bottom-up.
+   Pixels skipped by the delta and end of line codes, or missing from
+   truncated data, are left at 0. */
+static void DecodeBMPRLE(SDL_Surface *surface, const Uint8 *data, size_t size, SDL_bool rle4)
+{
+    const Uint8 *end = data + size;
+    Uint8 *bits;
+    int x = 0, y = surface->h - 1;
+    int i, count;
+
+    while (y >= 0 && end - data >= 2) {
+        const int code = data[0];
+        const Uint8 value = data[1];
+
+        data += 2;
+        bits = (Uint8 *)surface->pixels + y * surface->pitch;
+        if (code) {
+            /* A run of one color, or of two alternating colors with RLE4 */
+            count = SDL_min(code, surface->w - x);
+            if (!rle4) {
+                if (count > 0) {
+                    SDL_memset(bits + x, value, count);
+                }
+            } else {
+                for (i = 0; i < count; ++i) {
+                    bits[x + i] = (i & 1) ? (value & 0x0F) : (value >> 4);
+                }
+            }
+            x += code;
+        } else if (value == 0) {
+            /* End of line */
+            x = 0;
+            --y;
+        } else if (value == 1) {
+            /* End of bitmap */
+            break;
+        } else if (value == 2) {
+            /* Move right and up */
+            if (end - data < 2) {
+                break;
+            }
+            x += data[0];
+            y -= data[1];
+            data += 2;
+        } else {
+            /* Pixels stored as they are, padded to a 16-bit boundary */
+            const size_t bytes = rle4 ? ((value + 1) >> 1) : value;
+
+            if ((size_t)(end - data) < bytes) {
+                break;
+            }
+            count = SDL_min(value, surface->w - x);
+            if (!rle4) {
+                if (count > 0) {
+                    SDL_memcpy(bits + x, data, count);
+                }
+            } else {
+                for (i = 0; i < count; ++i) {
+                    bits[x + i] = (i & 1) ? (data[i >> 1] & 0x0F) : (data[i >> 1] >> 4);
+                }
+            }
+            x += value;
+            data += (bytes + 1) & ~1;
+            if (data > end) {
+                break;
+            }
+        }
+    }
+}
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+/* Wraps the pixels of a top-down 32-bit image in a memory stream */
+static SDL_Surface *LoadBMPInPlace(SDL_RWops *src, Sint64 offset, int w, int h,
+                                   Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask,
+                                   SDL_bool correctAlpha)
+{
+    SDL_Surface *surface;
+    Sint64 size;
+    Uint8 *pixels;
+
+    if (w <= 0 || h <= 0 || w > 0x7FFFFFFF / 4) {
+        return NULL;
+    }
+    size = (Sint64)w * h * 4;
+    pixels = GetBMPMemory(src, offset, size);
+    if (!pixels || ((uintptr_t)pixels & 3)) {
+        return NULL;
+    }
+    if (correctAlpha && !HasAlphaChannel(pixels, (size_t)size)) {
+        /* The alpha channel has to be made opaque, which would change the stream */
+        return NULL;
+    }
+    surface = SDL_CreateRGBSurfaceFrom(pixels, w, h, 32, w * 4, Rmask, Gmask, Bmask, Amask);
+    if (surface) {
+        SDL_RWseek(src, offset + size, RW_SEEK_SET);
+    }
+    return surface;
+}
+#endif
+
 SDL_Surface *
 SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 {
@@ -97,7 +255,9 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     Uint32 Amask = 0;
     SDL_Palette *palette;
     Uint8 *bits;
-    Uint8 *top, *end;
+    Uint8 *data;
+    Uint8 *row = NULL;
+    Sint64 size;
     SDL_bool topDown;
     int ExpandBMP;
     SDL_bool haveRGBMasks = SDL_FALSE;
@@ -118,7 +278,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     /* Uint16 biPlanes = 0; */
     Uint16 biBitCount = 0;
     Uint32 biCompression = 0;
-    /* Uint32 biSizeImage = 0; */
+    Uint32 biSizeImage = 0;
     /* Sint32 biXPelsPerMeter = 0; */
     /* Sint32 biYPelsPerMeter = 0; */
     Uint32 biClrUsed = 0;
@@ -132,6 +292,15 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         goto done;
     }
 
+    /* The headers are read a field at a time, so buffer custom streams */
+    if (src->type == SDL_RWOPS_UNKNOWN) {
+        SDL_RWops *buffered = SDL_RWFromBufferedRW(src, 0, freesrc ? SDL_TRUE : SDL_FALSE);
+        if (buffered) {
+            src = buffered;
+            freesrc = 1;
+        }
+    }
+
     /* Read in the BMP file header */
     fp_offset = SDL_RWtell(src);
     SDL_ClearError();
@@ -165,7 +334,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         /* biPlanes = */ SDL_ReadLE16(src);
         biBitCount = SDL_ReadLE16(src);
         biCompression = SDL_ReadLE32(src);
-        /* biSizeImage = */ SDL_ReadLE32(src);
+        biSizeImage = SDL_ReadLE32(src);
         /* biXPelsPerMeter = */ SDL_ReadLE32(src);
         /* biYPelsPerMeter = */ SDL_ReadLE32(src);
         biClrUsed = SDL_ReadLE32(src);
@@ -248,7 +417,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         break;
     }
 
-    /* We don't support any BMP compression right now */
+    /* We support run length encoding, but no other BMP compression */
     switch (biCompression) {
     case BI_RGB:
         /* If there are no masks, use the defaults */
@@ -289,12 +458,38 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     case BI_BITFIELDS:
         break;  /* we handled this in the info header. */
 
+    case BI_RLE8:
+    case BI_RLE4:
+        /* These are palettized and always stored bottom-up */
+        if (biBitCount != 8 || topDown ||
+            ExpandBMP != (biCompression == BI_RLE4 ? 4 : 0)) {
+            SDL_SetError("Corrupt BMP RLE data");
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        break;
+
     default:
         SDL_SetError("Compressed BMP files not supported");
         was_error = SDL_TRUE;
         goto done;
     }
 
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    /* Top-down 32-bit images in memory can be used without a copy, if the
+       application keeps the memory around as long as the surface.  Closing
+       a mapped file unmaps it, so that only works if the caller closes it. */
+    if (biBitCount == 32 && topDown &&
+        !(freesrc && src->type == SDL_RWOPS_MAPPED) &&
+        SDL_GetHintBoolean(SDL_HINT_BMP_LOAD_IN_PLACE, SDL_FALSE)) {
+        surface = LoadBMPInPlace(src, fp_offset + bfOffBits, biWidth, biHeight,
+                                 Rmask, Gmask, Bmask, Amask, correctAlpha);
+        if (surface) {
+            goto done;
+        }
+    }
+#endif
+
     /* Create a compatible surface, note that the colors are RGB ordered */
     surface =
         SDL_CreateRGBSurface(0, biWidth, biHeight, biBitCount, Rmask, Gmask,
@@ -357,56 +552,99 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         was_error = SDL_TRUE;
         goto done;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
-    switch (ExpandBMP) {
-    case 1:
-        bmpPitch = (biWidth + 7) >> 3;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
-        break;
-    case 4:
-        bmpPitch = (biWidth + 1) >> 1;
+    if (biCompression == BI_RLE8 || biCompression == BI_RLE4) {
+        /* Decode all the compressed data at once.  A stream of two byte
+           runs of one pixel, with an end of line after every row, is the
+           most a sane encoder produces, which also bounds biSizeImage when
+           the size of the data source isn't known. */
+        const Sint64 max_size = 2 * ((Sint64)surface->w * surface->h + surface->h + 1);
+
+        size = SDL_RWsize(src) - (fp_offset + bfOffBits);
+        if (size < 0) {
+            size = (biSizeImage && biSizeImage < max_size) ? biSizeImage : max_size;
+        } else if (biSizeImage && biSizeImage < size) {
+            size = biSizeImage;
+        }
+        data = GetBMPMemory(src, fp_offset + bfOffBits, size);
+        if (data) {
+            SDL_RWseek(src, size, RW_SEEK_CUR);
+        } else if (size > 0) {
+            row = (Uint8 *)SDL_malloc((size_t)size);
+            if (!row) {
+                SDL_OutOfMemory();
+                was_error = SDL_TRUE;
+                goto done;
+            }
+            size = SDL_RWread(src, row, 1, (size_t)size);
+            data = row;
+        }
+        DecodeBMPRLE(surface, data, (size_t)size, (biCompression == BI_RLE4));
+
+    } else if (ExpandBMP) {
+        /* Read a row at a time and expand it to 8 bits per pixel */
+        const int mask = (1 << ExpandBMP) - 1;
+
+        bmpPitch = ((biWidth * ExpandBMP) + 7) >> 3;
         pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
-        break;
-    default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
-        break;
-    }
-    if (topDown) {
-        bits = top;
+        row = (Uint8 *)SDL_malloc(bmpPitch + pad);
+        if (!row) {
+            SDL_OutOfMemory();
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        for (i = 0; i < surface->h; ++i) {
+            int x;
+
+            if (topDown) {
+                bits = (Uint8 *)surface->pixels + i * surface->pitch;
+            } else {
+                bits = (Uint8 *)surface->pixels + (surface->h - i - 1) * surface->pitch;
+            }
+            /* The padding of the last row may be missing */
+            if (SDL_RWread(src, row, 1, bmpPitch + pad) < (size_t)bmpPitch) {
+                SDL_SetError("Error reading from BMP");
+                was_error = SDL_TRUE;
+                goto done;
+            }
+            for (x = 0; x < surface->w; ++x) {
+                const int bit = x * ExpandBMP;
+                bits[x] = (row[bit >> 3] >> (8 - ExpandBMP - (bit & 7))) & mask;
+            }
+        }
+
     } else {
-        bits = end - surface->pitch;
-    }
-    while (bits >= top && bits < end) {
-        switch (ExpandBMP) {
-        case 1:
-        case 4:{
-                Uint8 pixel = 0;
-                int shift = (8 - ExpandBMP);
-                for (i = 0; i < surface->w; ++i) {
-                    if (i % (8 / ExpandBMP) == 0) {
-                        if (!SDL_RWread(src, &pixel, 1, 1)) {
-                            SDL_SetError("Error reading from BMP");
-                            was_error = SDL_TRUE;
-                            goto done;
-                        }
-                    }
-                    *(bits + i) = (pixel >> shift);
-                    pixel <<= ExpandBMP;
+        /* The rows are padded to 4 bytes, just like the surface pitch */
+        size = (Sint64)surface->h * surface->pitch;
+        data = GetBMPMemory(src, fp_offset + bfOffBits, size);
+        if (data) {
+            /* Copy the rows straight to where they belong */
+            if (topDown) {
+                SDL_memcpy(surface->pixels, data, (size_t)size);
+            } else {
+                bits = (Uint8 *)surface->pixels + size;
+                for (i = 0; i < surface->h; ++i) {
+                    bits -= surface->pitch;
+                    SDL_memcpy(bits, data, surface->pitch);
+                    data += surface->pitch;
                 }
             }
-            break;
-
-        default:
-            if (SDL_RWread(src, bits, 1, surface->pitch)
-                != surface->pitch) {
+            SDL_RWseek(src, size, RW_SEEK_CUR);
+        } else {
+            if (SDL_RWread(src, surface->pixels, surface->pitch, surface->h)
+                != (size_t)surface->h) {
                 SDL_Error(SDL_EFREAD);
                 was_error = SDL_TRUE;
                 goto done;
             }
+            if (!topDown) {
+                FlipBMPRows(surface);
+            }
+        }
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            /* Byte-swap the pixels if needed. Note that the 24bpp
-               case has already been taken care of above. */
+        /* Byte-swap the pixels if needed. Note that the 24bpp
+           case has already been taken care of above. */
+        for (bits = (Uint8 *)surface->pixels;
+             bits < (Uint8 *)surface->pixels + size; bits += surface->pitch) {
             switch (biBitCount) {
             case 15:
             case 16:{
@@ -423,26 +661,14 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
                     break;
                 }
             }
-#endif
-            break;
-        }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
-            }
-        }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
         }
+#endif
     }
     if (correctAlpha) {
         CorrectAlphaChannel(surface);
     }
   done:
+    SDL_free(row);
     if (was_error) {
         if (src) {
             SDL_RWseek(src, fp_offset, RW_SEEK_SET);
@@ -562,6 +788,15 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         bfReserved2 = 0;
         bfOffBits = 0;          /* We'll write this when we're done */
 
+        /* The headers are written a field at a time, so buffer custom streams */
+        if (dst->type == SDL_RWOPS_UNKNOWN) {
+            SDL_RWops *buffered = SDL_RWFromBufferedRW(dst, 0, freedst ? SDL_TRUE : SDL_FALSE);
+            if (buffered) {
+                dst = buffered;
+                freedst = 1;
+            }
+        }
+
         /* Write the BMP file header values */
         fp_offset = SDL_RWtell(dst);
         SDL_ClearError();
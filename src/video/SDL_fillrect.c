@@ -22,117 +22,197 @@
 
 #include "SDL_video.h"
 #include "SDL_blit.h"
+#include "SDL_RLEaccel_c.h"
 
 
-#ifdef __SSE__
-/* *INDENT-OFF* */
-
-#ifdef _MSC_VER
-#define SSE_BEGIN \
-    __m128 c128; \
-    c128.m128_u32[0] = color; \
-    c128.m128_u32[1] = color; \
-    c128.m128_u32[2] = color; \
-    c128.m128_u32[3] = color;
-#else
-#define SSE_BEGIN \
-    __m128 c128; \
-    DECLARE_ALIGNED(Uint32, cccc[4], 16); \
-    cccc[0] = color; \
-    cccc[1] = color; \
-    cccc[2] = color; \
-    cccc[3] = color; \
-    c128 = *(__m128 *)cccc;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SDL_NEON_FILLRECT 1
+#include <arm_neon.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
 #endif
 
-#define SSE_WORK \
-    for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
-        p += 64; \
+/* The SIMD fills repeat a block of this many bytes, which holds a whole
+   number of pixels of every size and a whole number of vector registers */
+#define FILL_BLOCK_SIZE 96
+
+/* Rows shorter than this many bytes are filled by the scalar functions */
+#define FILL_SIMD_MIN_ROW 64
+
+/* Fills covering at least this many bytes, about the size of a typical L2
+   cache, bypass the cache with non-temporal stores.  Smaller fills are
+   likely to be read back soon, so they are written through the cache. */
+#define FILL_STREAM_SIZE (256 * 1024)
+
+typedef struct SDL_FillInfo SDL_FillInfo;
+
+typedef void (*SDL_FillRectFunc) (SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h);
+
+struct SDL_FillInfo
+{
+    int bpp;
+    Uint32 color;               /* 1 and 2 byte colors are replicated to 32 bits */
+    SDL_FillRectFunc fill;      /* scalar fill */
+    SDL_FillRectFunc fill_simd; /* fill for long rows, or NULL */
+    SDL_bool have_pattern;
+    /* The color bytes repeated from a pixel boundary, with enough extra
+       bytes to start the block at any byte of a pixel */
+    Uint8 pattern[FILL_BLOCK_SIZE + 4];
+};
+
+static const Uint8 *
+SDL_GetFillPattern(SDL_FillInfo * info)
+{
+    if (!info->have_pattern) {
+        Uint8 bytes[4];
+        int i;
+
+        if (info->bpp == 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            bytes[0] = (Uint8) (info->color & 0xFF);
+            bytes[1] = (Uint8) ((info->color >> 8) & 0xFF);
+            bytes[2] = (Uint8) ((info->color >> 16) & 0xFF);
+#else
+            bytes[0] = (Uint8) ((info->color >> 16) & 0xFF);
+            bytes[1] = (Uint8) ((info->color >> 8) & 0xFF);
+            bytes[2] = (Uint8) (info->color & 0xFF);
+#endif
+            for (i = 0; i < SDL_arraysize(info->pattern); ++i) {
+                info->pattern[i] = bytes[i % 3];
+            }
+        } else {
+            SDL_memcpy(bytes, &info->color, sizeof(bytes));
+            for (i = 0; i < SDL_arraysize(info->pattern); ++i) {
+                info->pattern[i] = bytes[i & 3];
+            }
+        }
+        info->have_pattern = SDL_TRUE;
     }
+    return info->pattern;
+}
 
-#define SSE_END
-
-#define DEFINE_SSE_FILLRECT(bpp, type) \
-static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
-{ \
-    int i, n; \
-    Uint8 *p = NULL; \
- \
-    SSE_BEGIN; \
- \
-    while (h--) { \
-        n = w * bpp; \
-        p = pixels; \
- \
-        if (n > 63) { \
-            int adjust = 16 - ((uintptr_t)p & 15); \
-            if (adjust < 16) { \
-                n -= adjust; \
-                adjust /= bpp; \
-                while (adjust--) { \
-                    *((type *)p) = (type)color; \
-                    p += bpp; \
-                } \
-            } \
-            SSE_WORK; \
-        } \
-        if (n & 63) { \
-            int remainder = (n & 63); \
-            remainder /= bpp; \
-            while (remainder--) { \
-                *((type *)p) = (type)color; \
-                p += bpp; \
-            } \
-        } \
-        pixels += pitch; \
+/* Each SIMD fill writes the bytes up to the first aligned address from the
+   pattern, fills the aligned middle of the row with whole blocks, and copies
+   the rest.  Since a block holds whole pixels, the middle and the rest of the
+   row start at the same byte of a pixel as the first aligned address. */
+#define FILL_ROW_BEGIN(align) \
+    const Uint8 *phase; \
+    Uint8 *p = pixels; \
+    int n = w * info->bpp; \
+    int head = (int) ((align) - ((uintptr_t) p & ((align) - 1))) & ((align) - 1); \
+    if (head > n) { \
+        head = n; \
     } \
- \
-    SSE_END; \
-}
+    SDL_memcpy(p, pattern, head); \
+    p += head; \
+    n -= head; \
+    phase = pattern + (head % info->bpp);
 
+#define FILL_ROW_END(block) \
+    SDL_memcpy(p, phase, n % (block)); \
+    pixels += pitch;
+
+#ifdef __SSE__
 static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRectSSE(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
 {
-    int i, n;
+    const Uint8 *pattern = SDL_GetFillPattern(info);
+    const SDL_bool stream = ((size_t) w * info->bpp * h >= FILL_STREAM_SIZE);
+    int i;
 
-    SSE_BEGIN;
     while (h--) {
-        Uint8 *p = pixels;
-        n = w;
-
-        if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
-            if (adjust) {
-                n -= adjust;
-                SDL_memset(p, color, adjust);
-                p += adjust;
+        __m128 c0, c1, c2;
+        FILL_ROW_BEGIN(16);
+        c0 = _mm_loadu_ps((const float *) (phase + 0));
+        c1 = _mm_loadu_ps((const float *) (phase + 16));
+        c2 = _mm_loadu_ps((const float *) (phase + 32));
+        if (stream) {
+            for (i = n / 48; i--; p += 48) {
+                _mm_stream_ps((float *) (p + 0), c0);
+                _mm_stream_ps((float *) (p + 16), c1);
+                _mm_stream_ps((float *) (p + 32), c2);
+            }
+        } else {
+            for (i = n / 48; i--; p += 48) {
+                _mm_store_ps((float *) (p + 0), c0);
+                _mm_store_ps((float *) (p + 16), c1);
+                _mm_store_ps((float *) (p + 32), c2);
             }
-            SSE_WORK;
-        }
-        if (n & 63) {
-            int remainder = (n & 63);
-            SDL_memset(p, color, remainder);
         }
-        pixels += pitch;
+        FILL_ROW_END(48);
     }
+    if (stream) {
+        _mm_sfence();
+    }
+}
+#endif /* __SSE__ */
+
+#ifdef __AVX__
+static void
+SDL_FillRectAVX(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
+{
+    const Uint8 *pattern = SDL_GetFillPattern(info);
+    const SDL_bool stream = ((size_t) w * info->bpp * h >= FILL_STREAM_SIZE);
+    int i;
 
-    SSE_END;
+    while (h--) {
+        __m256i c0, c1, c2;
+        FILL_ROW_BEGIN(32);
+        c0 = _mm256_loadu_si256((const __m256i *) (phase + 0));
+        c1 = _mm256_loadu_si256((const __m256i *) (phase + 32));
+        c2 = _mm256_loadu_si256((const __m256i *) (phase + 64));
+        if (stream) {
+            for (i = n / 96; i--; p += 96) {
+                _mm256_stream_si256((__m256i *) (p + 0), c0);
+                _mm256_stream_si256((__m256i *) (p + 32), c1);
+                _mm256_stream_si256((__m256i *) (p + 64), c2);
+            }
+        } else {
+            for (i = n / 96; i--; p += 96) {
+                _mm256_store_si256((__m256i *) (p + 0), c0);
+                _mm256_store_si256((__m256i *) (p + 32), c1);
+                _mm256_store_si256((__m256i *) (p + 64), c2);
+            }
+        }
+        FILL_ROW_END(96);
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+    _mm256_zeroupper();
 }
-/* DEFINE_SSE_FILLRECT(1, Uint8) */
-DEFINE_SSE_FILLRECT(2, Uint16)
-DEFINE_SSE_FILLRECT(4, Uint32)
+#endif /* __AVX__ */
 
-/* *INDENT-ON* */
-#endif /* __SSE__ */
+#ifdef SDL_NEON_FILLRECT
+/* There are no non-temporal store intrinsics for NEON, plain stores of
+   aligned blocks are the fastest portable option. */
+static void
+SDL_FillRectNEON(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
+{
+    const Uint8 *pattern = SDL_GetFillPattern(info);
+    int i;
+
+    while (h--) {
+        uint8x16_t c0, c1, c2;
+        FILL_ROW_BEGIN(16);
+        c0 = vld1q_u8(phase + 0);
+        c1 = vld1q_u8(phase + 16);
+        c2 = vld1q_u8(phase + 32);
+        for (i = n / 48; i--; p += 48) {
+            vst1q_u8(p + 0, c0);
+            vst1q_u8(p + 16, c1);
+            vst1q_u8(p + 32, c2);
+        }
+        FILL_ROW_END(48);
+    }
+}
+#endif /* SDL_NEON_FILLRECT */
 
 static void
-SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect1(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
 {
+    const Uint32 color = info->color;
     int n;
     Uint8 *p = NULL;
     
@@ -170,8 +250,9 @@ SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 }
 
 static void
-SDL_FillRect2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect2(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
 {
+    const Uint32 color = info->color;
     int n;
     Uint16 *p = NULL;
     
@@ -194,8 +275,9 @@ SDL_FillRect2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 }
 
 static void
-SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect3(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
 {
+    const Uint32 color = info->color;
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
     Uint8 b1 = (Uint8) (color & 0xFF);
     Uint8 b2 = (Uint8) ((color >> 8) & 0xFF);
@@ -222,122 +304,187 @@ SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 }
 
 static void
-SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect4(SDL_FillInfo * info, Uint8 * pixels, int pitch, int w, int h)
 {
+    const Uint32 color = info->color;
+
     while (h--) {
         SDL_memset4(pixels, color, w);
         pixels += pitch;
     }
 }
 
+/* Pick the fill functions once for all the rectangles of a fill */
+static int
+SDL_SetupFill(SDL_Surface * dst, Uint32 color, SDL_FillInfo * info)
+{
+    /* This function doesn't work on surfaces < 8 bpp */
+    if (dst->format->BitsPerPixel < 8) {
+        return SDL_SetError("SDL_FillRect(): Unsupported surface format");
+    }
+
+    info->bpp = dst->format->BytesPerPixel;
+    info->have_pattern = SDL_FALSE;
+    info->fill_simd = NULL;
+
+    switch (info->bpp) {
+    case 1:
+        color &= 0xFF;
+        color |= (color << 8);
+        color |= (color << 16);
+        info->fill = SDL_FillRect1;
+        break;
+    case 2:
+        color &= 0xFFFF;
+        color |= (color << 16);
+        info->fill = SDL_FillRect2;
+        break;
+    case 3:
+        info->fill = SDL_FillRect3;
+        break;
+    default:
+        info->fill = SDL_FillRect4;
+        break;
+    }
+    info->color = color;
+
+#ifdef __AVX__
+    if (!info->fill_simd && SDL_HasAVX()) {
+        info->fill_simd = SDL_FillRectAVX;
+    }
+#endif
+#ifdef __SSE__
+    if (!info->fill_simd && SDL_HasSSE()) {
+        info->fill_simd = SDL_FillRectSSE;
+    }
+#endif
+#ifdef SDL_NEON_FILLRECT
+    if (!info->fill_simd && SDL_HasNEON()) {
+        info->fill_simd = SDL_FillRectNEON;
+    }
+#endif
+    return 0;
+}
+
+static void
+SDL_FillClippedRect(SDL_Surface * dst, const SDL_Rect * rect, SDL_FillInfo * info)
+{
+    Uint8 *pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
+                                            rect->x * info->bpp;
+
+    if (info->fill_simd && rect->w * info->bpp >= FILL_SIMD_MIN_ROW) {
+        info->fill_simd(info, pixels, dst->pitch, rect->w, rect->h);
+    } else {
+        info->fill(info, pixels, dst->pitch, rect->w, rect->h);
+    }
+}
+
+static int
+SDL_CompareRectRows(const void *a, const void *b)
+{
+    const SDL_Rect *A = (const SDL_Rect *) a;
+    const SDL_Rect *B = (const SDL_Rect *) b;
+
+    if (A->y != B->y) {
+        return (A->y < B->y) ? -1 : 1;
+    }
+    if (A->x != B->x) {
+        return (A->x < B->x) ? -1 : 1;
+    }
+    return 0;
+}
+
 /* 
  * This function performs a fast fill of the given rectangle with 'color'
  */
 int
 SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
 {
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+
+    /* If 'rect' == NULL, then fill the whole surface */
+    if (!rect) {
+        rect = &dst->clip_rect;
+    }
+    return SDL_FillRects(dst, rect, 1, color);
+}
+
+int
+SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
+              Uint32 color)
+{
+    SDL_FillInfo info;
+    SDL_Rect *sorted = NULL;
     SDL_Rect clipped;
-    Uint8 *pixels;
+    SDL_bool in_order = SDL_TRUE;
+    int i, num_clipped = 0;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
     }
-
-    /* This function doesn't work on surfaces < 8 bpp */
-    if (dst->format->BitsPerPixel < 8) {
-        return SDL_SetError("SDL_FillRect(): Unsupported surface format");
+    if (!rects) {
+        return SDL_SetError("SDL_FillRects() passed NULL rects");
+    }
+    if (SDL_SetupFill(dst, color, &info) < 0) {
+        return -1;
     }
 
-    /* If 'rect' == NULL, then fill the whole surface */
-    if (rect) {
-        /* Perform clipping */
-        if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
-            return 0;
-        }
-        rect = &clipped;
-    } else {
-        rect = &dst->clip_rect;
-        /* Don't attempt to fill if the surface's clip_rect is empty */
-        if (SDL_RectEmpty(rect)) {
-            return 0;
+    /* Rectangles that don't overlap the clip rect don't need pixels */
+    for (i = 0; i < count; ++i) {
+        if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &clipped)) {
+            break;
         }
     }
+    if (i == count) {
+        return 0;
+    }
 
     /* Perform software fill */
     if (!dst->pixels) {
         return SDL_SetError("SDL_FillRect(): You must lock the surface");
     }
 
-    pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                     rect->x * dst->format->BytesPerPixel;
-
-    switch (dst->format->BytesPerPixel) {
-    case 1:
-        {
-            color |= (color << 8);
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect1SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
+    /* All the rectangles have the same color, so they can be filled in any
+       order.  Large batches that jump around the surface are sorted by row,
+       so that consecutive fills touch neighboring memory. */
+    if (count - i > 64) {
+        sorted = (SDL_Rect *) SDL_malloc((count - i) * sizeof(*sorted));
+    }
+    if (sorted) {
+        for (; i < count; ++i) {
+            if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &clipped)) {
+                if (num_clipped > 0 &&
+                    SDL_CompareRectRows(&sorted[num_clipped - 1], &clipped) > 0) {
+                    in_order = SDL_FALSE;
+                }
+                sorted[num_clipped++] = clipped;
             }
-#endif
-            SDL_FillRect1(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
         }
-
-    case 2:
-        {
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect2SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect2(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
+        if (!in_order) {
+            SDL_qsort(sorted, num_clipped, sizeof(*sorted), SDL_CompareRectRows);
         }
-
-    case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
-        {
-            SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
+        for (i = 0; i < num_clipped; ++i) {
+            SDL_FillClippedRect(dst, &sorted[i], &info);
         }
-
-    case 4:
-        {
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect4SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
+        SDL_free(sorted);
+    } else {
+        /* Small batch, or out of memory, fill them as they come */
+        for (; i < count; ++i) {
+            if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &clipped)) {
+                SDL_FillClippedRect(dst, &clipped, &info);
             }
-#endif
-            SDL_FillRect4(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
         }
     }
 
-    /* We're done! */
-    return 0;
-}
-
-int
-SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
-              Uint32 color)
-{
-    int i;
-    int status = 0;
-
-    if (!rects) {
-        return SDL_SetError("SDL_FillRects() passed NULL rects");
+    /* Any RLE encoding of the surface is out of date now */
+    if (dst->flags & SDL_RLEACCEL) {
+        SDL_MarkRLESurfaceDirty(dst);
     }
 
-    for (i = 0; i < count; ++i) {
-        status += SDL_FillRect(dst, &rects[i], color);
-    }
-    return status;
+    /* We're done! */
+    return 0;
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
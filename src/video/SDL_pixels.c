@@ -27,7 +27,6 @@
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_pixels_c.h"
-#include "SDL_RLEaccel_c.h"
 
 
 /* Lookup tables to expand partial bytes to the full 0..255 range */
@@ -996,11 +995,26 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     SDL_PixelFormat *dstfmt;
     SDL_BlitMap *map;
 
-    /* Clear out any previous mapping */
     map = src->map;
-    if ((src->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(src, 1);
+
+    /* Switching to another destination with the same RGB format keeps the
+       blitter and palette map, only the surface reference changes */
+    if (map->dst && map->dst != dst && map->dst->format == dst->format &&
+        !dst->format->palette &&
+        (!src->format->palette ||
+         map->src_palette_version == src->format->palette->version)) {
+        SDL_Surface *prev = map->dst;
+
+        map->dst = dst;
+        ++dst->refcount;
+        map->info.dst_pitch = dst->pitch;
+        if (--prev->refcount <= 0) {
+            SDL_FreeSurface(prev);
+        }
+        return 0;
     }
+
+    /* Clear out any previous mapping */
     SDL_InvalidateMap(map);
 
     /* Figure out what kind of mapping we're doing */
@@ -25,6 +25,8 @@
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_yuv_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 /* Public routines */
 
@@ -80,7 +82,7 @@ SDL_CreateRGBSurfaceWithFormat(Uint32 flags, int width, int height, int depth,
 
     /* Get the pixels */
     if (surface->w && surface->h) {
-        surface->pixels = SDL_malloc(surface->h * surface->pitch);
+        surface->pixels = SDL_TaggedMalloc(SDL_MEMORY_TAG_VIDEO, surface->h * surface->pitch);
         if (!surface->pixels) {
             SDL_FreeSurface(surface);
             SDL_OutOfMemory();
@@ -201,6 +203,7 @@ SDL_SetSurfaceRLE(SDL_Surface * surface, int flag)
         surface->map->info.flags |= SDL_COPY_RLE_DESIRED;
     } else {
         surface->map->info.flags &= ~SDL_COPY_RLE_DESIRED;
+        SDL_UnRLESurface(surface);
     }
     if (surface->map->info.flags != flags) {
         SDL_InvalidateMap(surface->map);
@@ -270,11 +273,93 @@ SDL_GetColorKey(SDL_Surface * surface, Uint32 * key)
     return 0;
 }
 
-/* This is a fairly slow function to switch from colorkey to alpha */
+/* Clears the alpha of the pixels matching the colorkey, eight 16-bit or
+   four 32-bit pixels at a time with SSE2 */
+static void
+SDL_ClearColorkeyAlpha16(Uint16 * row, int w, Uint16 ckey, Uint16 mask)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    if (w >= 8 && SDL_HasSSE2()) {
+        const __m128i vmask = _mm_set1_epi16((short) mask);
+        const __m128i vckey = _mm_set1_epi16((short) ckey);
+        const __m128i valpha = _mm_set1_epi16((short) ~mask);
+        for (; x + 8 <= w; x += 8) {
+            const __m128i v = _mm_loadu_si128((const __m128i *) (row + x));
+            const __m128i eq = _mm_cmpeq_epi16(_mm_and_si128(v, vmask), vckey);
+            _mm_storeu_si128((__m128i *) (row + x),
+                             _mm_andnot_si128(_mm_and_si128(eq, valpha), v));
+        }
+    }
+#endif
+    for (; x < w; ++x) {
+        if ((row[x] & mask) == ckey) {
+            row[x] &= mask;
+        }
+    }
+}
+
+static void
+SDL_ClearColorkeyAlpha32(Uint32 * row, int w, Uint32 ckey, Uint32 mask)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    if (w >= 4 && SDL_HasSSE2()) {
+        const __m128i vmask = _mm_set1_epi32((int) mask);
+        const __m128i vckey = _mm_set1_epi32((int) ckey);
+        const __m128i valpha = _mm_set1_epi32((int) ~mask);
+        for (; x + 4 <= w; x += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i *) (row + x));
+            const __m128i eq = _mm_cmpeq_epi32(_mm_and_si128(v, vmask), vckey);
+            _mm_storeu_si128((__m128i *) (row + x),
+                             _mm_andnot_si128(_mm_and_si128(eq, valpha), v));
+        }
+    }
+#endif
+    for (; x < w; ++x) {
+        if ((row[x] & mask) == ckey) {
+            row[x] &= mask;
+        }
+    }
+}
+
+static void
+SDL_ClearColorkeyAlpha24(Uint8 * row, int w, Uint32 ckey, Uint32 mask)
+{
+    int x;
+
+    for (x = 0; x < w; ++x, row += 3) {
+        Uint32 pixel;
+        if (SDL_BYTEORDER == SDL_LIL_ENDIAN) {
+            pixel = row[0] | ((Uint32) row[1] << 8) | ((Uint32) row[2] << 16);
+        } else {
+            pixel = ((Uint32) row[0] << 16) | ((Uint32) row[1] << 8) | row[2];
+        }
+        if ((pixel & mask) == ckey) {
+            pixel &= mask;
+            if (SDL_BYTEORDER == SDL_LIL_ENDIAN) {
+                row[0] = (Uint8) pixel;
+                row[1] = (Uint8) (pixel >> 8);
+                row[2] = (Uint8) (pixel >> 16);
+            } else {
+                row[0] = (Uint8) (pixel >> 16);
+                row[1] = (Uint8) (pixel >> 8);
+                row[2] = (Uint8) pixel;
+            }
+        }
+    }
+}
+
+/* Switches a surface from colorkey to alpha, the alpha of the pixels
+   matching the colorkey (ignoring alpha) is cleared */
 static void
 SDL_ConvertColorkeyToAlpha(SDL_Surface * surface)
 {
-    int x, y;
+    Uint8 *row;
+    Uint32 ckey, mask;
+    int y;
 
     if (!surface) {
         return;
@@ -287,52 +372,22 @@ SDL_ConvertColorkeyToAlpha(SDL_Surface * surface)
 
     SDL_LockSurface(surface);
 
-    switch (surface->format->BytesPerPixel) {
-    case 2:
-        {
-            Uint16 *row, *spot;
-            Uint16 ckey = (Uint16) surface->map->info.colorkey;
-            Uint16 mask = (Uint16) (~surface->format->Amask);
-
-            /* Ignore alpha in colorkey comparison */
-            ckey &= mask;
-            row = (Uint16 *) surface->pixels;
-            for (y = surface->h; y--;) {
-                spot = row;
-                for (x = surface->w; x--;) {
-                    if ((*spot & mask) == ckey) {
-                        *spot &= mask;
-                    }
-                    ++spot;
-                }
-                row += surface->pitch / 2;
-            }
-        }
-        break;
-    case 3:
-        /* FIXME */
-        break;
-    case 4:
-        {
-            Uint32 *row, *spot;
-            Uint32 ckey = surface->map->info.colorkey;
-            Uint32 mask = ~surface->format->Amask;
-
-            /* Ignore alpha in colorkey comparison */
-            ckey &= mask;
-            row = (Uint32 *) surface->pixels;
-            for (y = surface->h; y--;) {
-                spot = row;
-                for (x = surface->w; x--;) {
-                    if ((*spot & mask) == ckey) {
-                        *spot &= mask;
-                    }
-                    ++spot;
-                }
-                row += surface->pitch / 4;
-            }
+    /* Ignore alpha in colorkey comparison */
+    mask = ~surface->format->Amask;
+    ckey = surface->map->info.colorkey & mask;
+    row = (Uint8 *) surface->pixels;
+    for (y = 0; y < surface->h; ++y, row += surface->pitch) {
+        switch (surface->format->BytesPerPixel) {
+        case 2:
+            SDL_ClearColorkeyAlpha16((Uint16 *) row, surface->w, (Uint16) ckey, (Uint16) mask);
+            break;
+        case 3:
+            SDL_ClearColorkeyAlpha24(row, surface->w, ckey & 0x00FFFFFF, mask & 0x00FFFFFF);
+            break;
+        case 4:
+            SDL_ClearColorkeyAlpha32((Uint32 *) row, surface->w, ckey, mask);
+            break;
         }
-        break;
     }
 
     SDL_UnlockSurface(surface);
@@ -345,11 +400,18 @@ int
 SDL_SetSurfaceColorMod(SDL_Surface * surface, Uint8 r, Uint8 g, Uint8 b)
 {
     int flags;
+    SDL_bool remap = SDL_FALSE;
 
     if (!surface) {
         return -1;
     }
 
+    /* Palette mappings have the color modulation built in */
+    if (surface->format->palette &&
+        (surface->map->info.r != r || surface->map->info.g != g ||
+         surface->map->info.b != b)) {
+        remap = SDL_TRUE;
+    }
     surface->map->info.r = r;
     surface->map->info.g = g;
     surface->map->info.b = b;
@@ -360,7 +422,7 @@ SDL_SetSurfaceColorMod(SDL_Surface * surface, Uint8 r, Uint8 g, Uint8 b)
     } else {
         surface->map->info.flags &= ~SDL_COPY_MODULATE_COLOR;
     }
-    if (surface->map->info.flags != flags) {
+    if (surface->map->info.flags != flags || remap) {
         SDL_InvalidateMap(surface->map);
     }
     return 0;
@@ -390,11 +452,16 @@ int
 SDL_SetSurfaceAlphaMod(SDL_Surface * surface, Uint8 alpha)
 {
     int flags;
+    SDL_bool remap = SDL_FALSE;
 
     if (!surface) {
         return -1;
     }
 
+    /* Palette mappings have the alpha modulation built in */
+    if (surface->format->palette && surface->map->info.a != alpha) {
+        remap = SDL_TRUE;
+    }
     surface->map->info.a = alpha;
 
     flags = surface->map->info.flags;
@@ -403,7 +470,7 @@ SDL_SetSurfaceAlphaMod(SDL_Surface * surface, Uint8 alpha)
     } else {
         surface->map->info.flags &= ~SDL_COPY_MODULATE_ALPHA;
     }
-    if (surface->map->info.flags != flags) {
+    if (surface->map->info.flags != flags || remap) {
         SDL_InvalidateMap(surface->map);
     }
     return 0;
@@ -433,8 +500,7 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
 
     status = 0;
     flags = surface->map->info.flags;
-    surface->map->info.flags &=
-        ~(SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD);
+    surface->map->info.flags &= ~SDL_COPY_BLEND_MASK;
     switch (blendMode) {
     case SDL_BLENDMODE_NONE:
         break;
@@ -447,6 +513,9 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     case SDL_BLENDMODE_MOD:
         surface->map->info.flags |= SDL_COPY_MOD;
         break;
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+        surface->map->info.flags |= SDL_COPY_BLEND_PREMULTIPLIED;
+        break;
     default:
         status = SDL_Unsupported();
         break;
@@ -470,8 +539,7 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
         return 0;
     }
 
-    switch (surface->map->
-            info.flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD)) {
+    switch (surface->map->info.flags & SDL_COPY_BLEND_MASK) {
     case SDL_COPY_BLEND:
         *blendMode = SDL_BLENDMODE_BLEND;
         break;
@@ -481,6 +549,9 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     case SDL_COPY_MOD:
         *blendMode = SDL_BLENDMODE_MOD;
         break;
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        *blendMode = SDL_BLENDMODE_BLEND_PREMULTIPLIED;
+        break;
     default:
         *blendMode = SDL_BLENDMODE_NONE;
         break;
@@ -813,8 +884,7 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 {
     static const Uint32 complex_copy_flags = (
         SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
-        SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD |
-        SDL_COPY_COLORKEY
+        SDL_COPY_BLEND_MASK | SDL_COPY_COLORKEY
     );
 
     if (!(src->map->info.flags & SDL_COPY_NEAREST)) {
@@ -837,12 +907,10 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 int
 SDL_LockSurface(SDL_Surface * surface)
 {
+    /* RLE encoded surfaces keep their pixels, so remember what they were
+       to tell at unlock whether the encoding is still good */
     if (!surface->locked) {
-        /* Perform the lock */
-        if (surface->flags & SDL_RLEACCEL) {
-            SDL_UnRLESurface(surface, 1);
-            surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
-        }
+        SDL_RLELockSurface(surface);
     }
 
     /* Increment the surface lock count, for recursive locks */
@@ -863,11 +931,8 @@ SDL_UnlockSurface(SDL_Surface * surface)
         return;
     }
 
-    /* Update RLE encoded surface with new data */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        surface->flags &= ~SDL_RLEACCEL;        /* stop lying */
-        SDL_RLESurface(surface);
-    }
+    /* If the pixels changed, the RLE encoding is redone lazily */
+    SDL_RLEUnlockSurface(surface);
 }
 
 /*
@@ -984,9 +1049,10 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     SDL_SetClipRect(convert, &surface->clip_rect);
 
     /* Enable alpha blending by default if the new surface has an
-     * alpha channel or alpha modulation */
-    if ((surface->format->Amask && format->Amask) ||
-        (copy_flags & (SDL_COPY_COLORKEY|SDL_COPY_MODULATE_ALPHA))) {
+     * alpha channel or alpha modulation, unless it is premultiplied */
+    if (((surface->format->Amask && format->Amask) ||
+         (copy_flags & (SDL_COPY_COLORKEY|SDL_COPY_MODULATE_ALPHA))) &&
+        !(copy_flags & SDL_COPY_BLEND_PREMULTIPLIED)) {
         SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_BLEND);
     }
     if ((copy_flags & SDL_COPY_RLE_DESIRED) || (flags & SDL_RLEACCEL)) {
@@ -1126,6 +1192,12 @@ int SDL_ConvertPixels(int width, int height,
         return 0;
     }
 
+    if (SDL_ISPIXELFORMAT_FOURCC(src_format)) {
+        return SDL_ConvertPixels_YUV_to_RGB(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    } else if (SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
+        return SDL_ConvertPixels_RGB_to_YUV(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    }
+
     if (!SDL_CreateSurfaceOnStack(width, height, src_format, nonconst_src,
                                   src_pitch,
                                   &src_surface, &src_fmt, &src_blitmap)) {
@@ -1144,6 +1216,122 @@ int SDL_ConvertPixels(int width, int height,
     return SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
 }
 
+/*
+ * Premultiply a block of 8888 pixels in place, alpha is at ashift
+ */
+static void
+SDL_PremultiplyAlpha8888(int width, int height, Uint32 ashift, void *pixels, int pitch)
+{
+    const Uint32 amask = (Uint32) 0xFF << ashift;
+    Uint8 *row = (Uint8 *) pixels;
+    int x, y;
+
+    for (y = 0; y < height; ++y) {
+        Uint32 *p = (Uint32 *) row;
+
+        x = 0;
+#ifdef __SSE2__
+        if (SDL_HasSSE2()) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alpha = _mm_set1_epi32(amask);
+            const __m128i round = _mm_set1_epi16(0x80);
+            const __m128i shift = _mm_cvtsi32_si128(ashift);
+
+            for ( ; x + 4 <= width; x += 4) {
+                const __m128i s = _mm_loadu_si128((const __m128i *) (p + x));
+                __m128i a, lo, hi;
+
+                a = _mm_srl_epi32(_mm_and_si128(s, alpha), shift);
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+                lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi32(a, a)), round);
+                hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi32(a, a)), round);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+                _mm_storeu_si128((__m128i *) (p + x),
+                                 _mm_or_si128(_mm_and_si128(s, alpha),
+                                              _mm_andnot_si128(alpha, _mm_packus_epi16(lo, hi))));
+            }
+        }
+#endif
+        for ( ; x < width; ++x) {
+            const Uint32 s = p[x];
+            const Uint32 a = (s & amask) >> ashift;
+            Uint32 rb = (s & 0xFF00FF) * a + 0x800080;
+            Uint32 ag = ((s >> 8) & 0xFF00FF) * a + 0x800080;
+
+            rb = ((rb + ((rb >> 8) & 0xFF00FF)) >> 8) & 0xFF00FF;
+            ag = (ag + ((ag >> 8) & 0xFF00FF)) & 0xFF00FF00;
+            p[x] = ((rb | ag) & ~amask) | (s & amask);
+        }
+        row += pitch;
+    }
+}
+
+/*
+ * Premultiply the alpha of a block of pixels, converting the format too
+ */
+int SDL_PremultiplyAlpha(int width, int height,
+                         Uint32 src_format, const void * src, int src_pitch,
+                         Uint32 dst_format, void * dst, int dst_pitch)
+{
+    SDL_PixelFormat *format;
+    Uint32 ashift = 0;
+    SDL_bool direct;
+
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (!dst_pitch) {
+        return SDL_InvalidParamError("dst_pitch");
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(dst_format) || SDL_ISPIXELFORMAT_INDEXED(dst_format)) {
+        return SDL_SetError("Can't premultiply alpha into %s", SDL_GetPixelFormatName(dst_format));
+    }
+
+    /* 8888 formats with alpha are premultiplied in place in the destination */
+    format = SDL_AllocFormat(dst_format);
+    if (!format) {
+        return -1;
+    }
+    direct = (format->BytesPerPixel == 4 && format->Amask &&
+              format->Aloss == 0 && (format->Ashift % 8) == 0 &&
+              format->Rloss == 0 && format->Gloss == 0 && format->Bloss == 0);
+    ashift = format->Ashift;
+    SDL_FreeFormat(format);
+
+    if (direct) {
+        if (src != dst || src_format != dst_format || src_pitch != dst_pitch) {
+            if (SDL_ConvertPixels(width, height, src_format, src, src_pitch,
+                                  dst_format, dst, dst_pitch) < 0) {
+                return -1;
+            }
+        }
+        SDL_PremultiplyAlpha8888(width, height, ashift, dst, dst_pitch);
+    } else {
+        /* Go through ARGB8888 and convert to the final format afterwards */
+        const int tmp_pitch = width * 4;
+        void *tmp = SDL_malloc(tmp_pitch * height);
+        int retval;
+
+        if (!tmp) {
+            return SDL_OutOfMemory();
+        }
+        retval = SDL_ConvertPixels(width, height, src_format, src, src_pitch,
+                                   SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch);
+        if (retval == 0) {
+            SDL_PremultiplyAlpha8888(width, height, 24, tmp, tmp_pitch);
+            retval = SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch,
+                                       dst_format, dst, dst_pitch);
+        }
+        SDL_free(tmp);
+        return retval;
+    }
+    return 0;
+}
+
 /*
  * Free a surface created by the above function.
  */
@@ -1162,8 +1350,8 @@ SDL_FreeSurface(SDL_Surface * surface)
     while (surface->locked > 0) {
         SDL_UnlockSurface(surface);
     }
-    if (surface->flags & SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 0);
+    if (surface->map != NULL) {
+        SDL_UnRLESurface(surface);
     }
     if (surface->format) {
         SDL_SetSurfacePalette(surface, NULL);
@@ -1175,7 +1363,7 @@ SDL_FreeSurface(SDL_Surface * surface)
         surface->map = NULL;
     }
     if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
+        SDL_TaggedFree(SDL_MEMORY_TAG_VIDEO, surface->pixels);
     }
     SDL_free(surface);
 }
@@ -30,6 +30,7 @@
 #include "SDL_rect_c.h"
 #include "../events/SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 #include "SDL_syswm.h"
 
@@ -310,7 +311,7 @@ SDL_CreateWindowTexture(SDL_VideoDevice *unused, SDL_Window * window, Uint32 * f
         SDL_DestroyTexture(data->texture);
         data->texture = NULL;
     }
-    SDL_free(data->pixels);
+    SDL_TaggedFree(SDL_MEMORY_TAG_VIDEO, data->pixels);
     data->pixels = NULL;
 
     {
@@ -347,7 +348,7 @@ SDL_CreateWindowTexture(SDL_VideoDevice *unused, SDL_Window * window, Uint32 * f
     {
         /* Make static analysis happy about potential malloc(0) calls. */
         const size_t allocsize = window->h * data->pitch;
-        data->pixels = SDL_malloc((allocsize > 0) ? allocsize : 1);
+        data->pixels = SDL_TaggedMalloc(SDL_MEMORY_TAG_VIDEO, (allocsize > 0) ? allocsize : 1);
         if (!data->pixels) {
             return SDL_OutOfMemory();
         }
@@ -407,7 +408,7 @@ SDL_DestroyWindowTexture(SDL_VideoDevice *unused, SDL_Window * window)
     if (data->renderer) {
         SDL_DestroyRenderer(data->renderer);
     }
-    SDL_free(data->pixels);
+    SDL_TaggedFree(SDL_MEMORY_TAG_VIDEO, data->pixels);
     SDL_free(data);
 }
 
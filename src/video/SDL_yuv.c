@@ -0,0 +1,647 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_endian.h"
+#include "SDL_video.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_yuv_c.h"
+
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+
+static SDL_YUV_CONVERSION_MODE SDL_YUV_ConversionMode = SDL_YUV_CONVERSION_BT601;
+
+/* The tallest content SDL_YUV_CONVERSION_AUTOMATIC considers SD */
+#define YUV_SD_THRESHOLD    576
+
+void SDL_SetYUVConversionMode(SDL_YUV_CONVERSION_MODE mode)
+{
+    SDL_YUV_ConversionMode = mode;
+}
+
+SDL_YUV_CONVERSION_MODE SDL_GetYUVConversionMode(void)
+{
+    return SDL_YUV_ConversionMode;
+}
+
+SDL_YUV_CONVERSION_MODE SDL_GetYUVConversionModeForResolution(int width, int height)
+{
+    SDL_YUV_CONVERSION_MODE mode = SDL_GetYUVConversionMode();
+    if (mode == SDL_YUV_CONVERSION_AUTOMATIC) {
+        if (height <= YUV_SD_THRESHOLD) {
+            mode = SDL_YUV_CONVERSION_BT601;
+        } else {
+            mode = SDL_YUV_CONVERSION_BT709;
+        }
+    }
+    return mode;
+}
+
+
+/* YUV to RGB coefficients in 3.13 fixed point.  The samples are scaled up
+   by 64 first, so the high half of a 16x16 bit multiply leaves the result
+   scaled by 8, which fits in 16 bits with room for the sums.
+ */
+#define FIX13(x)    ((Sint16)((x) * 8192 + ((x) < 0 ? -0.5 : 0.5)))
+#define MULHI(a, b) (((a) * (b)) >> 16)
+
+typedef struct
+{
+    Sint16 y_offset;
+    Sint16 y;
+    Sint16 r_v;
+    Sint16 g_u;
+    Sint16 g_v;
+    Sint16 b_u;
+} YUVToRGBMatrix;
+
+static const YUVToRGBMatrix yuv_to_rgb_matrix[] = {
+    /* SDL_YUV_CONVERSION_JPEG */
+    { 0, FIX13(1.0), FIX13(1.402), FIX13(-0.344136), FIX13(-0.714136), FIX13(1.772) },
+    /* SDL_YUV_CONVERSION_BT601 */
+    { 16, FIX13(1.164), FIX13(1.596), FIX13(-0.392), FIX13(-0.813), FIX13(2.017) },
+    /* SDL_YUV_CONVERSION_BT709 */
+    { 16, FIX13(1.164), FIX13(1.793), FIX13(-0.213), FIX13(-0.533), FIX13(2.112) },
+    /* SDL_YUV_CONVERSION_BT709_FULL */
+    { 0, FIX13(1.0), FIX13(1.5748), FIX13(-0.187324), FIX13(-0.468124), FIX13(1.8556) }
+};
+
+/* RGB to YUV coefficients in 16.16 fixed point */
+#define FIX16(x)    ((int)((x) * 65536 + ((x) < 0 ? -0.5 : 0.5)))
+
+typedef struct
+{
+    int y_offset;
+    int y[3];
+    int u[3];
+    int v[3];
+} RGBToYUVMatrix;
+
+static const RGBToYUVMatrix rgb_to_yuv_matrix[] = {
+    /* SDL_YUV_CONVERSION_JPEG */
+    { 0,
+      { FIX16(0.299), FIX16(0.587), FIX16(0.114) },
+      { FIX16(-0.168736), FIX16(-0.331264), FIX16(0.5) },
+      { FIX16(0.5), FIX16(-0.418688), FIX16(-0.081312) } },
+    /* SDL_YUV_CONVERSION_BT601 */
+    { 16,
+      { FIX16(0.256788), FIX16(0.504129), FIX16(0.097906) },
+      { FIX16(-0.148223), FIX16(-0.290993), FIX16(0.439216) },
+      { FIX16(0.439216), FIX16(-0.367788), FIX16(-0.071427) } },
+    /* SDL_YUV_CONVERSION_BT709 */
+    { 16,
+      { FIX16(0.182586), FIX16(0.614231), FIX16(0.062007) },
+      { FIX16(-0.100644), FIX16(-0.338572), FIX16(0.439216) },
+      { FIX16(0.439216), FIX16(-0.398942), FIX16(-0.040274) } },
+    /* SDL_YUV_CONVERSION_BT709_FULL */
+    { 0,
+      { FIX16(0.2126), FIX16(0.7152), FIX16(0.0722) },
+      { FIX16(-0.114572), FIX16(-0.385428), FIX16(0.5) },
+      { FIX16(0.5), FIX16(-0.454153), FIX16(-0.045847) } }
+};
+
+/* Where the samples of a YUV image are, the chroma pointers point at the
+   first sample of the first row, and the steps are in bytes per sample */
+typedef struct
+{
+    Uint8 *y;
+    Uint8 *u;
+    Uint8 *v;
+    int y_pitch;
+    int uv_pitch;
+    int y_step;
+    int uv_step;
+    SDL_bool half_height;       /* 4:2:0 rather than 4:2:2 chroma */
+} YUVPlanes;
+
+/* How a 32-bit pixel with 8-bit color channels is laid out */
+typedef struct
+{
+    int shift[3];       /* Bit position of R, G and B */
+    Uint32 fill;        /* Bits set in every pixel, alpha or padding */
+    int order[4];       /* Channel at each byte in memory, 0-2 for RGB, 3 for fill */
+} RGB32Layout;
+
+
+static int
+GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, int yuv_pitch, YUVPlanes *planes)
+{
+    Uint8 *base = (Uint8 *) yuv;
+    Uint8 *first, *second;
+
+    planes->y = base;
+    planes->y_pitch = yuv_pitch;
+
+    switch (format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        /* U and V planes are a quarter the size of the Y plane, rounded up */
+        planes->uv_pitch = (yuv_pitch + 1) / 2;
+        first = base + height * yuv_pitch;
+        second = first + ((height + 1) / 2) * planes->uv_pitch;
+        planes->u = (format == SDL_PIXELFORMAT_YV12) ? second : first;
+        planes->v = (format == SDL_PIXELFORMAT_YV12) ? first : second;
+        planes->y_step = 1;
+        planes->uv_step = 1;
+        planes->half_height = SDL_TRUE;
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        /* The U/V plane is interleaved and half the height of the Y plane */
+        planes->uv_pitch = ((yuv_pitch + 1) / 2) * 2;
+        first = base + height * yuv_pitch;
+        planes->u = (format == SDL_PIXELFORMAT_NV12) ? first : first + 1;
+        planes->v = (format == SDL_PIXELFORMAT_NV12) ? first + 1 : first;
+        planes->y_step = 1;
+        planes->uv_step = 2;
+        planes->half_height = SDL_TRUE;
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+        planes->u = base + 1;
+        planes->v = base + 3;
+        goto packed;
+    case SDL_PIXELFORMAT_UYVY:
+        planes->y = base + 1;
+        planes->u = base;
+        planes->v = base + 2;
+        goto packed;
+    case SDL_PIXELFORMAT_YVYU:
+        planes->u = base + 3;
+        planes->v = base + 1;
+    packed:
+        planes->uv_pitch = yuv_pitch;
+        planes->y_step = 2;
+        planes->uv_step = 4;
+        planes->half_height = SDL_FALSE;
+        break;
+    default:
+        return SDL_SetError("Unsupported YUV format");
+    }
+    return 0;
+}
+
+static SDL_bool
+GetRGB32Layout(Uint32 format, RGB32Layout *layout)
+{
+    Uint32 masks[4];
+    int bpp, i, j;
+
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_BYTESPERPIXEL(format) != 4 ||
+        !SDL_PixelFormatEnumToMasks(format, &bpp, &masks[0], &masks[1], &masks[2], &masks[3])) {
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < 4; ++i) {
+        layout->order[i] = 3;
+    }
+    for (i = 0; i < 3; ++i) {
+        for (j = 0; j < 4; ++j) {
+            if (masks[i] == (0xFFu << (j * 8))) {
+                break;
+            }
+        }
+        if (j == 4) {
+            return SDL_FALSE;
+        }
+        layout->shift[i] = j * 8;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        layout->order[j] = i;
+#else
+        layout->order[3 - j] = i;
+#endif
+    }
+    layout->fill = ~(masks[0] | masks[1] | masks[2]);
+    return SDL_TRUE;
+}
+
+static const YUVToRGBMatrix *
+GetYUVToRGBMatrix(int width, int height)
+{
+    return &yuv_to_rgb_matrix[SDL_GetYUVConversionModeForResolution(width, height)];
+}
+
+static const RGBToYUVMatrix *
+GetRGBToYUVMatrix(int width, int height)
+{
+    return &rgb_to_yuv_matrix[SDL_GetYUVConversionModeForResolution(width, height)];
+}
+
+static SDL_INLINE Uint32
+Clamp8(int value)
+{
+    return (Uint32) ((value < 0) ? 0 : ((value > 255) ? 255 : value));
+}
+
+static SDL_INLINE Uint32
+YUVToRGB32Pixel(int Y, int r_v, int g_uv, int b_u,
+                const YUVToRGBMatrix *matrix, const RGB32Layout *layout)
+{
+    const int luma = MULHI((Y - matrix->y_offset) * 64, matrix->y) + 4;
+
+    return (Clamp8((luma + r_v) >> 3) << layout->shift[0]) |
+           (Clamp8((luma + g_uv) >> 3) << layout->shift[1]) |
+           (Clamp8((luma + b_u) >> 3) << layout->shift[2]) |
+           layout->fill;
+}
+
+typedef void (*YUVRowFunc) (const Uint8 *y, const Uint8 *u, const Uint8 *v,
+                            int y_step, int uv_step, Uint32 *dst, int width,
+                            const YUVToRGBMatrix *matrix,
+                            const RGB32Layout *layout);
+
+static void
+YUVRowToRGB32_Std(const Uint8 *y, const Uint8 *u, const Uint8 *v,
+                  int y_step, int uv_step, Uint32 *dst, int width,
+                  const YUVToRGBMatrix *matrix, const RGB32Layout *layout)
+{
+    int x;
+
+    for (x = 0; x < width; x += 2) {
+        const int cu = (*u - 128) * 64;
+        const int cv = (*v - 128) * 64;
+        const int r_v = MULHI(cv, matrix->r_v);
+        const int g_uv = MULHI(cu, matrix->g_u) + MULHI(cv, matrix->g_v);
+        const int b_u = MULHI(cu, matrix->b_u);
+
+        dst[0] = YUVToRGB32Pixel(y[0], r_v, g_uv, b_u, matrix, layout);
+        if (x + 1 < width) {
+            dst[1] = YUVToRGB32Pixel(y[y_step], r_v, g_uv, b_u, matrix, layout);
+        }
+        y += 2 * y_step;
+        u += uv_step;
+        v += uv_step;
+        dst += 2;
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+/* Convert 16 pixels, the chroma samples are in the low 8 bytes of u and v */
+static SDL_INLINE void
+YUV16ToRGB32_SSE2(__m128i y, __m128i u, __m128i v, Uint32 *dst,
+                  const YUVToRGBMatrix *matrix, const RGB32Layout *layout)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i round = _mm_set1_epi16(4);
+    __m128i ylo, yhi, cu, cv, r_v, g_uv, b_u;
+    __m128i channels[4];
+    __m128i lo01, hi01, lo23, hi23;
+
+    ylo = _mm_sub_epi16(_mm_unpacklo_epi8(y, zero), _mm_set1_epi16(matrix->y_offset));
+    yhi = _mm_sub_epi16(_mm_unpackhi_epi8(y, zero), _mm_set1_epi16(matrix->y_offset));
+    ylo = _mm_add_epi16(_mm_mulhi_epi16(_mm_slli_epi16(ylo, 6), _mm_set1_epi16(matrix->y)), round);
+    yhi = _mm_add_epi16(_mm_mulhi_epi16(_mm_slli_epi16(yhi, 6), _mm_set1_epi16(matrix->y)), round);
+
+    cu = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(u, zero), bias), 6);
+    cv = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(v, zero), bias), 6);
+    r_v = _mm_mulhi_epi16(cv, _mm_set1_epi16(matrix->r_v));
+    g_uv = _mm_add_epi16(_mm_mulhi_epi16(cu, _mm_set1_epi16(matrix->g_u)),
+                         _mm_mulhi_epi16(cv, _mm_set1_epi16(matrix->g_v)));
+    b_u = _mm_mulhi_epi16(cu, _mm_set1_epi16(matrix->b_u));
+
+    /* Each chroma sample covers two neighbouring pixels */
+#define YUV_CHANNEL_SSE2(c) \
+    _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(ylo, _mm_unpacklo_epi16(c, c)), 3), \
+                     _mm_srai_epi16(_mm_add_epi16(yhi, _mm_unpackhi_epi16(c, c)), 3))
+    channels[0] = YUV_CHANNEL_SSE2(r_v);
+    channels[1] = YUV_CHANNEL_SSE2(g_uv);
+    channels[2] = YUV_CHANNEL_SSE2(b_u);
+    channels[3] = _mm_set1_epi8(-1);
+#undef YUV_CHANNEL_SSE2
+
+    lo01 = _mm_unpacklo_epi8(channels[layout->order[0]], channels[layout->order[1]]);
+    hi01 = _mm_unpackhi_epi8(channels[layout->order[0]], channels[layout->order[1]]);
+    lo23 = _mm_unpacklo_epi8(channels[layout->order[2]], channels[layout->order[3]]);
+    hi23 = _mm_unpackhi_epi8(channels[layout->order[2]], channels[layout->order[3]]);
+    _mm_storeu_si128((__m128i *) (dst + 0), _mm_unpacklo_epi16(lo01, lo23));
+    _mm_storeu_si128((__m128i *) (dst + 4), _mm_unpackhi_epi16(lo01, lo23));
+    _mm_storeu_si128((__m128i *) (dst + 8), _mm_unpacklo_epi16(hi01, hi23));
+    _mm_storeu_si128((__m128i *) (dst + 12), _mm_unpackhi_epi16(hi01, hi23));
+}
+
+static void
+YUVRowToRGB32_SSE2(const Uint8 *y, const Uint8 *u, const Uint8 *v,
+                   int y_step, int uv_step, Uint32 *dst, int width,
+                   const YUVToRGBMatrix *matrix, const RGB32Layout *layout)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowbytes = _mm_set1_epi16(0x00FF);
+    const SDL_bool u_first = (u < v);
+    int x = 0;
+
+    if (uv_step == 1) {
+        /* Planar */
+        for ( ; x + 16 <= width; x += 16) {
+            YUV16ToRGB32_SSE2(_mm_loadu_si128((const __m128i *) y),
+                              _mm_loadl_epi64((const __m128i *) u),
+                              _mm_loadl_epi64((const __m128i *) v),
+                              dst, matrix, layout);
+            y += 16;
+            u += 8;
+            v += 8;
+            dst += 16;
+        }
+    } else if (uv_step == 2) {
+        /* Semi-planar, U and V interleaved */
+        const Uint8 *uv = u_first ? u : v;
+        for ( ; x + 16 <= width; x += 16) {
+            const __m128i c = _mm_loadu_si128((const __m128i *) uv);
+            const __m128i even = _mm_packus_epi16(_mm_and_si128(c, lowbytes), zero);
+            const __m128i odd = _mm_packus_epi16(_mm_srli_epi16(c, 8), zero);
+            YUV16ToRGB32_SSE2(_mm_loadu_si128((const __m128i *) y),
+                              u_first ? even : odd, u_first ? odd : even,
+                              dst, matrix, layout);
+            y += 16;
+            uv += 16;
+            dst += 16;
+        }
+        u += x;
+        v += x;
+    } else {
+        /* Packed, two pixels in every four bytes */
+        const SDL_bool y_first = (y < u && y < v);
+        const Uint8 *p = y_first ? y : (u_first ? u : v);
+        for ( ; x + 16 <= width; x += 16) {
+            const __m128i a = _mm_loadu_si128((const __m128i *) p);
+            const __m128i b = _mm_loadu_si128((const __m128i *) (p + 16));
+            __m128i luma, c, even, odd;
+            if (y_first) {
+                luma = _mm_packus_epi16(_mm_and_si128(a, lowbytes), _mm_and_si128(b, lowbytes));
+                c = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+            } else {
+                luma = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+                c = _mm_packus_epi16(_mm_and_si128(a, lowbytes), _mm_and_si128(b, lowbytes));
+            }
+            even = _mm_packus_epi16(_mm_and_si128(c, lowbytes), zero);
+            odd = _mm_packus_epi16(_mm_srli_epi16(c, 8), zero);
+            YUV16ToRGB32_SSE2(luma, u_first ? even : odd, u_first ? odd : even,
+                              dst, matrix, layout);
+            p += 32;
+            dst += 16;
+        }
+        y += x * 2;
+        u += x * 2;
+        v += x * 2;
+    }
+
+    if (x < width) {
+        YUVRowToRGB32_Std(y, u, v, y_step, uv_step, dst, width - x, matrix, layout);
+    }
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+/* Nearest neighbour scaling, the source position is a 16.16 fixed point
+   offset from the start of the row */
+static void
+YUVRowToRGB32_Scaled(const Uint8 *y, const Uint8 *u, const Uint8 *v,
+                     int y_step, int uv_step, int pos, int inc,
+                     Uint32 *dst, int width,
+                     const YUVToRGBMatrix *matrix, const RGB32Layout *layout)
+{
+    int x;
+
+    for (x = 0; x < width; ++x) {
+        const int sx = pos >> 16;
+        const int cu = (u[(sx >> 1) * uv_step] - 128) * 64;
+        const int cv = (v[(sx >> 1) * uv_step] - 128) * 64;
+        const int r_v = MULHI(cv, matrix->r_v);
+        const int g_uv = MULHI(cu, matrix->g_u) + MULHI(cv, matrix->g_v);
+        const int b_u = MULHI(cu, matrix->b_u);
+
+        dst[x] = YUVToRGB32Pixel(y[sx * y_step], r_v, g_uv, b_u, matrix, layout);
+        pos += inc;
+    }
+}
+
+/* Convert srcrect of the planes into a dst_w x dst_h image, scaling if the
+   sizes differ.  The row kernels only ever see pointers into the source,
+   so clipped and scaled conversions need no intermediate surfaces. */
+static void
+ConvertYUVToRGB32(const YUVPlanes *planes, const SDL_Rect *srcrect,
+                  int dst_w, int dst_h,
+                  const YUVToRGBMatrix *matrix, const RGB32Layout *layout,
+                  void *dst, int dst_pitch)
+{
+    int j;
+
+    if (srcrect->w == dst_w && srcrect->h == dst_h) {
+        YUVRowFunc row_func = YUVRowToRGB32_Std;
+        const int odd = (srcrect->x & 1);
+
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            row_func = YUVRowToRGB32_SSE2;
+        }
+#endif
+
+        for (j = 0; j < dst_h; ++j) {
+            const int sy = srcrect->y + j;
+            const int uv_row = planes->half_height ? (sy / 2) : sy;
+            const Uint8 *y = planes->y + sy * planes->y_pitch + srcrect->x * planes->y_step;
+            const Uint8 *u = planes->u + uv_row * planes->uv_pitch + (srcrect->x / 2) * planes->uv_step;
+            const Uint8 *v = planes->v + uv_row * planes->uv_pitch + (srcrect->x / 2) * planes->uv_step;
+            Uint32 *d = (Uint32 *) ((Uint8 *) dst + j * dst_pitch);
+            int width = dst_w;
+
+            if (odd) {
+                /* The first pixel shares its chroma sample with a pixel
+                   outside the rectangle, after that the pairs line up */
+                YUVRowToRGB32_Std(y, u, v, planes->y_step, planes->uv_step, d, 1, matrix, layout);
+                y += planes->y_step;
+                u += planes->uv_step;
+                v += planes->uv_step;
+                ++d;
+                --width;
+            }
+            if (width > 0) {
+                row_func(y, u, v, planes->y_step, planes->uv_step, d, width, matrix, layout);
+            }
+        }
+    } else {
+        const int x_inc = (int) (((Sint64) srcrect->w << 16) / dst_w);
+        const int y_inc = (int) (((Sint64) srcrect->h << 16) / dst_h);
+        const int x_pos = (srcrect->x << 16) + x_inc / 2;
+        int y_pos = (srcrect->y << 16) + y_inc / 2;
+
+        for (j = 0; j < dst_h; ++j) {
+            const int sy = y_pos >> 16;
+            const int uv_row = planes->half_height ? (sy / 2) : sy;
+
+            YUVRowToRGB32_Scaled(planes->y + sy * planes->y_pitch,
+                                 planes->u + uv_row * planes->uv_pitch,
+                                 planes->v + uv_row * planes->uv_pitch,
+                                 planes->y_step, planes->uv_step, x_pos, x_inc,
+                                 (Uint32 *) ((Uint8 *) dst + j * dst_pitch),
+                                 dst_w, matrix, layout);
+            y_pos += y_inc;
+        }
+    }
+}
+
+int
+SDL_ConvertPixelsRect_YUV_to_RGB(int width, int height,
+                                 Uint32 src_format, const void *src, int src_pitch,
+                                 const SDL_Rect *srcrect, int dst_w, int dst_h,
+                                 Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const YUVToRGBMatrix *matrix = GetYUVToRGBMatrix(width, height);
+    YUVPlanes planes;
+    RGB32Layout layout;
+    SDL_Rect full_rect;
+
+    if (SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
+        return SDL_SetError("Conversion between YUV formats is not supported");
+    }
+    if (!srcrect) {
+        full_rect.x = 0;
+        full_rect.y = 0;
+        full_rect.w = width;
+        full_rect.h = height;
+        srcrect = &full_rect;
+    }
+    if (srcrect->x < 0 || srcrect->y < 0 ||
+        srcrect->x + srcrect->w > width || srcrect->y + srcrect->h > height) {
+        return SDL_SetError("Source rectangle is outside the image");
+    }
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dst_w <= 0 || dst_h <= 0) {
+        return 0;
+    }
+    if (GetYUVPlanes(width, height, src_format, src, src_pitch, &planes) < 0) {
+        return -1;
+    }
+
+    if (!GetRGB32Layout(dst_format, &layout)) {
+        /* Convert to ARGB8888 and let the blitters take it from there */
+        const int tmp_pitch = dst_w * 4;
+        void *tmp = SDL_malloc(tmp_pitch * dst_h);
+        int retval;
+
+        if (!tmp) {
+            return SDL_OutOfMemory();
+        }
+        GetRGB32Layout(SDL_PIXELFORMAT_ARGB8888, &layout);
+        ConvertYUVToRGB32(&planes, srcrect, dst_w, dst_h, matrix, &layout, tmp, tmp_pitch);
+        retval = SDL_ConvertPixels(dst_w, dst_h, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch,
+                                   dst_format, dst, dst_pitch);
+        SDL_free(tmp);
+        return retval;
+    }
+
+    ConvertYUVToRGB32(&planes, srcrect, dst_w, dst_h, matrix, &layout, dst, dst_pitch);
+    return 0;
+}
+
+int
+SDL_ConvertPixels_YUV_to_RGB(int width, int height,
+                             Uint32 src_format, const void *src, int src_pitch,
+                             Uint32 dst_format, void *dst, int dst_pitch)
+{
+    return SDL_ConvertPixelsRect_YUV_to_RGB(width, height, src_format, src, src_pitch,
+                                            NULL, width, height,
+                                            dst_format, dst, dst_pitch);
+}
+
+static SDL_INLINE Uint8
+RGBToYUVComponent(const int *coeffs, int offset, int r, int g, int b)
+{
+    return (Uint8) Clamp8(((coeffs[0] * r + coeffs[1] * g + coeffs[2] * b + 32768) >> 16) + offset);
+}
+
+int
+SDL_ConvertPixels_RGB_to_YUV(int width, int height,
+                             Uint32 src_format, const void *src, int src_pitch,
+                             Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const RGBToYUVMatrix *matrix = GetRGBToYUVMatrix(width, height);
+    YUVPlanes planes;
+    RGB32Layout layout;
+    void *tmp = NULL;
+    int i, j, k, rows;
+
+    if (GetYUVPlanes(width, height, dst_format, dst, dst_pitch, &planes) < 0) {
+        return -1;
+    }
+
+    if (!GetRGB32Layout(src_format, &layout)) {
+        /* Let the blitters convert to ARGB8888 first */
+        const int tmp_pitch = width * 4;
+
+        tmp = SDL_malloc(tmp_pitch * height);
+        if (!tmp) {
+            return SDL_OutOfMemory();
+        }
+        if (SDL_ConvertPixels(width, height, src_format, src, src_pitch,
+                              SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch) < 0) {
+            SDL_free(tmp);
+            return -1;
+        }
+        GetRGB32Layout(SDL_PIXELFORMAT_ARGB8888, &layout);
+        src = tmp;
+        src_pitch = tmp_pitch;
+    }
+
+    rows = planes.half_height ? 2 : 1;
+    for (j = 0; j < height; j += rows) {
+        const int uv_row = planes.half_height ? (j / 2) : j;
+        Uint8 *u = planes.u + uv_row * planes.uv_pitch;
+        Uint8 *v = planes.v + uv_row * planes.uv_pitch;
+
+        for (i = 0; i < width; i += 2) {
+            int r = 0, g = 0, b = 0, n = 0;
+
+            /* Store the luma of each pixel of the block, and average the
+               color of the block for its chroma sample */
+            for (k = 0; k < rows && j + k < height; ++k) {
+                const Uint32 *srcp = (const Uint32 *) ((const Uint8 *) src + (j + k) * src_pitch) + i;
+                Uint8 *y = planes.y + (j + k) * planes.y_pitch + i * planes.y_step;
+                int l;
+
+                for (l = 0; l < 2 && i + l < width; ++l) {
+                    const Uint32 pixel = srcp[l];
+                    const int pr = (pixel >> layout.shift[0]) & 0xFF;
+                    const int pg = (pixel >> layout.shift[1]) & 0xFF;
+                    const int pb = (pixel >> layout.shift[2]) & 0xFF;
+
+                    y[l * planes.y_step] = RGBToYUVComponent(matrix->y, matrix->y_offset, pr, pg, pb);
+                    r += pr;
+                    g += pg;
+                    b += pb;
+                    ++n;
+                }
+            }
+            r = (r + n / 2) / n;
+            g = (g + n / 2) / n;
+            b = (b + n / 2) / n;
+            *u = RGBToYUVComponent(matrix->u, 128, r, g, b);
+            *v = RGBToYUVComponent(matrix->v, 128, r, g, b);
+            u += planes.uv_step;
+            v += planes.uv_step;
+        }
+    }
+
+    SDL_free(tmp);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
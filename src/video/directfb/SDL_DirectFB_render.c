@@ -263,6 +263,12 @@ SetBlendMode(DirectFB_RenderData * data, int blendMode,
             SDL_DFB_CHECK(destsurf->SetSrcBlendFunction(destsurf, DSBF_SRCALPHA));
             SDL_DFB_CHECK(destsurf->SetDstBlendFunction(destsurf, DSBF_INVSRCALPHA));
             break;
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+            data->blitFlags = DSBLIT_BLEND_ALPHACHANNEL;
+            data->drawFlags = DSDRAW_BLEND;
+            SDL_DFB_CHECK(destsurf->SetSrcBlendFunction(destsurf, DSBF_ONE));
+            SDL_DFB_CHECK(destsurf->SetDstBlendFunction(destsurf, DSBF_INVSRCALPHA));
+            break;
         case SDL_BLENDMODE_ADD:
             data->blitFlags = DSBLIT_BLEND_ALPHACHANNEL;
             data->drawFlags = DSDRAW_BLEND;
@@ -703,6 +709,7 @@ DirectFB_SetTextureBlendMode(SDL_Renderer * renderer, SDL_Texture * texture)
     case SDL_BLENDMODE_NONE:
     /* case SDL_BLENDMODE_MASK: */
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
     case SDL_BLENDMODE_ADD:
     case SDL_BLENDMODE_MOD:
         return 0;
@@ -719,6 +726,7 @@ DirectFB_SetDrawBlendMode(SDL_Renderer * renderer)
     case SDL_BLENDMODE_NONE:
     /* case SDL_BLENDMODE_MASK: */
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
     case SDL_BLENDMODE_ADD:
     case SDL_BLENDMODE_MOD:
         return 0;
@@ -918,6 +926,7 @@ PrepareDraw(SDL_Renderer * renderer)
     case SDL_BLENDMODE_NONE:
     /* case SDL_BLENDMODE_MASK: */
     case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
         break;
     case SDL_BLENDMODE_ADD:
     case SDL_BLENDMODE_MOD:
@@ -601,6 +601,7 @@ static void RunFIFOTest(SDL_bool lock_free)
     int grand_total;
     char textBuffer[1024];
     int len;
+    SDL_LockStats stats;
 
     SDL_Log("\nFIFO test---------------------------------------\n\n");
     SDL_Log("Mode: %s\n", lock_free ? "LockFree" : "Mutex");
@@ -615,6 +616,7 @@ static void RunFIFOTest(SDL_bool lock_free)
         queue.mutex = SDL_CreateMutex();
     }
 
+    SDL_ResetLockStats();
     start = SDL_GetTicks();
 
 #ifdef TEST_SPINLOCK_FIFO
@@ -673,6 +675,10 @@ static void RunFIFOTest(SDL_bool lock_free)
 
     SDL_Log("Finished in %f sec\n", (end - start) / 1000.f);
 
+    SDL_GetLockStats(&stats);
+    SDL_Log("Spinlock contended %u times, slept %u times\n", stats.spinlock_contended, stats.spinlock_sleeps);
+    SDL_Log("Mutex contended %u times, slept %u times\n", stats.mutex_contended, stats.mutex_sleeps);
+
     SDL_Log("\n");
     for (i = 0; i < NUM_WRITERS; ++i) {
         SDL_Log("Writer %d wrote %d events, had %d waits\n", i, EVENTS_PER_WRITER, writerData[i].waits);
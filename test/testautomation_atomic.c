@@ -0,0 +1,362 @@
+/**
+ * Atomic test suite
+ */
+
+#include <stdio.h>
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+/* Number of items pushed through the queues by the threaded tests */
+#define ATOMIC_TEST_ITEMS       100000
+#define ATOMIC_TEST_PRODUCERS   2
+#define ATOMIC_TEST_CONSUMERS   2
+
+typedef struct
+{
+    SDL_RingBuffer *ring;
+} RingTestData;
+
+typedef struct
+{
+    SDL_AtomicQueue *queue;
+    SDL_atomic_t *popped;
+    int producer;
+    Uint32 checksum;
+    Uint32 count;
+    SDL_bool in_order;
+} QueueTestData;
+
+/* Test case functions */
+
+/**
+ * @brief Write to and read from a ring buffer on one thread
+ */
+int
+atomic_ringBuffer(void *arg)
+{
+  SDL_RingBuffer *ring;
+  Uint8 in[100], out[100];
+  size_t result;
+  int i, lap;
+
+  ring = SDL_CreateRingBuffer(50);
+  SDLTest_AssertPass("Call to SDL_CreateRingBuffer(50)");
+  SDLTest_AssertCheck(ring != NULL, "Verify ring buffer is not NULL");
+  if (ring == NULL) {
+    return TEST_ABORTED;
+  }
+
+  result = SDL_GetRingBufferCapacity(ring);
+  SDLTest_AssertCheck(result == 64, "Verify capacity is rounded up to 64, got: %d", (int)result);
+  result = SDL_ReadRingBuffer(ring, out, sizeof(out));
+  SDLTest_AssertCheck(result == 0, "Verify reading an empty ring returns 0, got: %d", (int)result);
+
+  for (i = 0; i < (int)sizeof(in); i++) {
+    in[i] = (Uint8)i;
+  }
+
+  /* Filling past the capacity is a partial write */
+  result = SDL_WriteRingBuffer(ring, in, sizeof(in));
+  SDLTest_AssertCheck(result == 64, "Verify write stops at capacity, got: %d", (int)result);
+  result = SDL_GetRingBufferAvailable(ring);
+  SDLTest_AssertCheck(result == 64, "Verify 64 bytes are available, got: %d", (int)result);
+  result = SDL_WriteRingBuffer(ring, in, 1);
+  SDLTest_AssertCheck(result == 0, "Verify writing a full ring returns 0, got: %d", (int)result);
+  result = SDL_ReadRingBuffer(ring, out, sizeof(out));
+  SDLTest_AssertCheck(result == 64, "Verify read returns 64 bytes, got: %d", (int)result);
+  SDLTest_AssertCheck(SDL_memcmp(in, out, 64) == 0, "Verify data read matches data written");
+
+  /* Odd sized chunks make the data wrap around the end of the ring */
+  for (lap = 0; lap < 10; lap++) {
+    result = SDL_WriteRingBuffer(ring, in + lap, 37);
+    SDLTest_AssertCheck(result == 37, "Verify write %d returns 37, got: %d", lap, (int)result);
+    SDL_memset(out, 0, sizeof(out));
+    result = SDL_ReadRingBuffer(ring, out, 37);
+    SDLTest_AssertCheck(result == 37, "Verify read %d returns 37, got: %d", lap, (int)result);
+    SDLTest_AssertCheck(SDL_memcmp(in + lap, out, 37) == 0, "Verify wrapped data %d matches", lap);
+  }
+  result = SDL_GetRingBufferAvailable(ring);
+  SDLTest_AssertCheck(result == 0, "Verify ring is empty, got: %d", (int)result);
+
+  SDL_DestroyRingBuffer(ring);
+  SDLTest_AssertPass("Call to SDL_DestroyRingBuffer()");
+
+  /* Invalid parameters */
+  ring = SDL_CreateRingBuffer(0);
+  SDLTest_AssertCheck(ring == NULL, "Verify SDL_CreateRingBuffer(0) returns NULL");
+  result = SDL_WriteRingBuffer(NULL, in, 1);
+  SDLTest_AssertCheck(result == 0, "Verify SDL_WriteRingBuffer(NULL) returns 0");
+  result = SDL_ReadRingBuffer(NULL, out, 1);
+  SDLTest_AssertCheck(result == 0, "Verify SDL_ReadRingBuffer(NULL) returns 0");
+
+  return TEST_COMPLETED;
+}
+
+static int SDLCALL
+_ringProducer(void *arg)
+{
+  RingTestData *data = (RingTestData *)arg;
+  Uint32 next = 0;
+  Uint32 chunk[7];
+  Uint32 i;
+
+  while (next < ATOMIC_TEST_ITEMS) {
+    size_t len = 0;
+    for (i = 0; i < SDL_arraysize(chunk) && next + i < ATOMIC_TEST_ITEMS; i++) {
+      chunk[i] = next + i;
+    }
+    /* Write whole items, retrying the remainder when the ring is full */
+    while (len < i * sizeof(Uint32)) {
+      len += SDL_WriteRingBuffer(data->ring, (Uint8 *)chunk + len, i * sizeof(Uint32) - len);
+      if (len < i * sizeof(Uint32)) {
+        SDL_Delay(0);
+      }
+    }
+    next += i;
+  }
+  return 0;
+}
+
+/**
+ * @brief Pass data through a ring buffer between two threads
+ */
+int
+atomic_ringBufferThreaded(void *arg)
+{
+  RingTestData data;
+  SDL_Thread *thread;
+  Uint32 value, expected = 0;
+  SDL_bool in_order = SDL_TRUE;
+  size_t len = 0;
+
+  SDL_zero(data);
+  data.ring = SDL_CreateRingBuffer(256);
+  SDLTest_AssertCheck(data.ring != NULL, "Verify ring buffer is not NULL");
+  if (data.ring == NULL) {
+    return TEST_ABORTED;
+  }
+
+  thread = SDL_CreateThread(_ringProducer, "RingProducer", &data);
+  SDLTest_AssertCheck(thread != NULL, "Verify producer thread was created");
+  if (thread == NULL) {
+    SDL_DestroyRingBuffer(data.ring);
+    return TEST_ABORTED;
+  }
+
+  while (expected < ATOMIC_TEST_ITEMS) {
+    len += SDL_ReadRingBuffer(data.ring, (Uint8 *)&value + len, sizeof(value) - len);
+    if (len < sizeof(value)) {
+      SDL_Delay(0);
+      continue;
+    }
+    len = 0;
+    if (value != expected) {
+      in_order = SDL_FALSE;
+    }
+    expected++;
+  }
+  SDL_WaitThread(thread, NULL);
+
+  SDLTest_AssertCheck(in_order, "Verify all items arrived in order");
+  SDLTest_AssertCheck(SDL_GetRingBufferAvailable(data.ring) == 0, "Verify ring is empty");
+  SDL_DestroyRingBuffer(data.ring);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Push to and pop from an atomic queue on one thread
+ */
+int
+atomic_queue(void *arg)
+{
+  SDL_AtomicQueue *queue;
+  SDL_bool result;
+  Uint32 value;
+  int i;
+
+  queue = SDL_CreateAtomicQueue(sizeof(value), 5);
+  SDLTest_AssertPass("Call to SDL_CreateAtomicQueue(4, 5)");
+  SDLTest_AssertCheck(queue != NULL, "Verify queue is not NULL");
+  if (queue == NULL) {
+    return TEST_ABORTED;
+  }
+
+  result = SDL_AtomicQueuePop(queue, &value);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify popping an empty queue fails");
+
+  /* The capacity is rounded up to 8 */
+  for (i = 0; i < 8; i++) {
+    value = 1000 + i;
+    result = SDL_AtomicQueuePush(queue, &value);
+    SDLTest_AssertCheck(result == SDL_TRUE, "Verify push %d succeeds", i);
+  }
+  result = SDL_AtomicQueuePush(queue, &value);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify pushing a full queue fails");
+
+  for (i = 0; i < 8; i++) {
+    value = 0;
+    result = SDL_AtomicQueuePop(queue, &value);
+    SDLTest_AssertCheck(result == SDL_TRUE && value == (Uint32)(1000 + i), "Verify pop %d returns %d, got: %d", i, 1000 + i, (int)value);
+  }
+  result = SDL_AtomicQueuePop(queue, &value);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify queue is empty again");
+
+  /* Go around the ring a few more times */
+  for (i = 0; i < 100; i++) {
+    value = i;
+    SDL_AtomicQueuePush(queue, &value);
+    value = 0;
+    result = SDL_AtomicQueuePop(queue, &value);
+    if (!result || value != (Uint32)i) {
+      break;
+    }
+  }
+  SDLTest_AssertCheck(i == 100, "Verify 100 push/pop pairs round trip, stopped at: %d", i);
+
+  SDL_DestroyAtomicQueue(queue);
+  SDLTest_AssertPass("Call to SDL_DestroyAtomicQueue()");
+
+  /* Invalid parameters */
+  queue = SDL_CreateAtomicQueue(0, 8);
+  SDLTest_AssertCheck(queue == NULL, "Verify SDL_CreateAtomicQueue(0, 8) returns NULL");
+  queue = SDL_CreateAtomicQueue(4, 0);
+  SDLTest_AssertCheck(queue == NULL, "Verify SDL_CreateAtomicQueue(4, 0) returns NULL");
+  result = SDL_AtomicQueuePush(NULL, &value);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify SDL_AtomicQueuePush(NULL) fails");
+
+  return TEST_COMPLETED;
+}
+
+static int SDLCALL
+_queueProducer(void *arg)
+{
+  QueueTestData *data = (QueueTestData *)arg;
+  Uint32 i, item;
+
+  for (i = 0; i < ATOMIC_TEST_ITEMS; i++) {
+    /* The top byte says which producer sent it */
+    item = ((Uint32)data->producer << 24) | i;
+    while (!SDL_AtomicQueuePush(data->queue, &item)) {
+      SDL_Delay(0);
+    }
+    data->checksum += item;
+  }
+  return 0;
+}
+
+static int SDLCALL
+_queueConsumer(void *arg)
+{
+  QueueTestData *data = (QueueTestData *)arg;
+  Uint32 item, last[ATOMIC_TEST_PRODUCERS];
+  int producer;
+
+  SDL_memset(last, 0xFF, sizeof(last));
+  data->in_order = SDL_TRUE;
+  while (SDL_AtomicGet(data->popped) < ATOMIC_TEST_ITEMS * ATOMIC_TEST_PRODUCERS) {
+    if (!SDL_AtomicQueuePop(data->queue, &item)) {
+      SDL_Delay(0);
+      continue;
+    }
+    SDL_AtomicIncRef(data->popped);
+
+    /* Each consumer sees any one producer's items in increasing order */
+    producer = (int)(item >> 24);
+    if (producer >= ATOMIC_TEST_PRODUCERS ||
+        (last[producer] != 0xFFFFFFFF && (item & 0xFFFFFF) <= last[producer])) {
+      data->in_order = SDL_FALSE;
+    } else {
+      last[producer] = item & 0xFFFFFF;
+    }
+    data->checksum += item;
+    data->count++;
+  }
+  return 0;
+}
+
+/**
+ * @brief Pass items through an atomic queue between several threads
+ */
+int
+atomic_queueThreaded(void *arg)
+{
+  QueueTestData producers[ATOMIC_TEST_PRODUCERS];
+  QueueTestData consumers[ATOMIC_TEST_CONSUMERS];
+  SDL_Thread *threads[ATOMIC_TEST_PRODUCERS + ATOMIC_TEST_CONSUMERS];
+  SDL_AtomicQueue *queue;
+  SDL_atomic_t popped;
+  Uint32 sent = 0, received = 0, count = 0;
+  SDL_bool in_order = SDL_TRUE;
+  int i;
+
+  queue = SDL_CreateAtomicQueue(sizeof(Uint32), 64);
+  SDLTest_AssertCheck(queue != NULL, "Verify queue is not NULL");
+  if (queue == NULL) {
+    return TEST_ABORTED;
+  }
+
+  SDL_AtomicSet(&popped, 0);
+  SDL_zero(producers);
+  SDL_zero(consumers);
+  for (i = 0; i < ATOMIC_TEST_CONSUMERS; i++) {
+    consumers[i].queue = queue;
+    consumers[i].popped = &popped;
+    threads[ATOMIC_TEST_PRODUCERS + i] = SDL_CreateThread(_queueConsumer, "QueueConsumer", &consumers[i]);
+    SDLTest_AssertCheck(threads[ATOMIC_TEST_PRODUCERS + i] != NULL, "Verify consumer thread %d was created", i);
+  }
+  for (i = 0; i < ATOMIC_TEST_PRODUCERS; i++) {
+    producers[i].queue = queue;
+    producers[i].producer = i;
+    threads[i] = SDL_CreateThread(_queueProducer, "QueueProducer", &producers[i]);
+    SDLTest_AssertCheck(threads[i] != NULL, "Verify producer thread %d was created", i);
+  }
+  for (i = 0; i < SDL_arraysize(threads); i++) {
+    SDL_WaitThread(threads[i], NULL);
+  }
+
+  for (i = 0; i < ATOMIC_TEST_PRODUCERS; i++) {
+    sent += producers[i].checksum;
+  }
+  for (i = 0; i < ATOMIC_TEST_CONSUMERS; i++) {
+    received += consumers[i].checksum;
+    count += consumers[i].count;
+    in_order = in_order && consumers[i].in_order;
+  }
+  SDLTest_AssertCheck(count == ATOMIC_TEST_ITEMS * ATOMIC_TEST_PRODUCERS, "Verify every item was received once, got: %d", (int)count);
+  SDLTest_AssertCheck(sent == received, "Verify checksums match, sent: %u, received: %u", sent, received);
+  SDLTest_AssertCheck(in_order, "Verify each producer's items arrived in order");
+
+  SDL_DestroyAtomicQueue(queue);
+
+  return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Atomic test cases */
+static const SDLTest_TestCaseReference atomicTest1 =
+        { (SDLTest_TestCaseFp)atomic_ringBuffer, "atomic_ringBuffer", "Write to and read from a ring buffer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference atomicTest2 =
+        { (SDLTest_TestCaseFp)atomic_ringBufferThreaded, "atomic_ringBufferThreaded", "Pass data through a ring buffer between threads", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference atomicTest3 =
+        { (SDLTest_TestCaseFp)atomic_queue, "atomic_queue", "Push to and pop from an atomic queue", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference atomicTest4 =
+        { (SDLTest_TestCaseFp)atomic_queueThreaded, "atomic_queueThreaded", "Pass items through an atomic queue between threads", TEST_ENABLED };
+
+/* Sequence of Atomic test cases */
+static const SDLTest_TestCaseReference *atomicTests[] =  {
+    &atomicTest1, &atomicTest2, &atomicTest3, &atomicTest4, NULL
+};
+
+/* Atomic test suite (global) */
+SDLTest_TestSuiteReference atomicTestSuite = {
+    "Atomic",
+    NULL,
+    atomicTests,
+    NULL
+};
@@ -77,7 +77,7 @@ hints_getHint(void *arg)
 {
   char *result1;
   char *result2;
-  int i;
+  int i, allocations;
     
   for (i=0; i<_numHintsEnum; i++) {
     result1 = (char *)SDL_GetHint((char*)_HintsEnum[i]);
@@ -90,6 +90,16 @@ hints_getHint(void *arg)
       (result1 == NULL) ? "null" : result1,
       (result2 == NULL) ? "null" : result2);
   }
+
+  /* Looking up a hint that was never set doesn't allocate anything */
+  allocations = SDL_GetNumAllocations();
+  result1 = (char *)SDL_GetHint("SDL_AUTOMATION_TEST_UNSET_HINT");
+  SDLTest_AssertPass("Call to SDL_GetHint(SDL_AUTOMATION_TEST_UNSET_HINT)");
+  SDLTest_AssertCheck(result1 == NULL, "Verify unset hint is NULL");
+  SDLTest_AssertCheck(
+    SDL_GetNumAllocations() == allocations,
+    "Verify no memory was allocated, expected: %i allocations, got: %i",
+    allocations, SDL_GetNumAllocations());
   
   return TEST_COMPLETED;
 }
@@ -145,6 +155,73 @@ hints_setHint(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_GetHintHandle and SDL_GetHintFromHandle
+ */
+int
+hints_getHintHandle(void *arg)
+{
+  const char *name = "SDL_AUTOMATION_TEST_HINT_HANDLE";
+  SDL_HintHandle *handle;
+  SDL_HintHandle *handle2;
+  const char *value;
+  const char *value2;
+  SDL_bool result;
+
+  handle = SDL_GetHintHandle(name);
+  SDLTest_AssertPass("Call to SDL_GetHintHandle(%s)", name);
+  SDLTest_AssertCheck(handle != NULL, "Verify handle is not NULL");
+
+  handle2 = SDL_GetHintHandle(name);
+  SDLTest_AssertPass("Call to SDL_GetHintHandle(%s) again", name);
+  SDLTest_AssertCheck(handle == handle2, "Verify the same handle is returned");
+
+  /* Set a value and check that the handle sees it */
+  result = SDL_SetHint(name, "first");
+  SDLTest_AssertPass("Call to SDL_SetHint(%s, \"first\")", name);
+  SDLTest_AssertCheck(result == SDL_TRUE, "Verify result is SDL_TRUE, got: %i", (int)result);
+  value = SDL_GetHintFromHandle(handle);
+  SDLTest_AssertPass("Call to SDL_GetHintFromHandle()");
+  SDLTest_AssertCheck(
+    value != NULL && SDL_strcmp(value, "first") == 0,
+    "Verify handle value is 'first', got: '%s'",
+    (value == NULL) ? "null" : value);
+  value2 = SDL_GetHint(name);
+  SDLTest_AssertCheck(value == value2, "Verify SDL_GetHint() returns the same string as the handle");
+
+  /* Change it and check that the old string is reused when it comes back */
+  SDL_SetHint(name, "second");
+  value2 = SDL_GetHintFromHandle(handle);
+  SDLTest_AssertCheck(
+    value2 != NULL && SDL_strcmp(value2, "second") == 0,
+    "Verify handle value is 'second', got: '%s'",
+    (value2 == NULL) ? "null" : value2);
+  SDLTest_AssertCheck(SDL_strcmp(value, "first") == 0, "Verify the old value is still valid");
+  SDL_SetHint(name, "first");
+  value2 = SDL_GetHintFromHandle(handle);
+  SDLTest_AssertCheck(value == value2, "Verify the same string is returned for the same value");
+
+  /* Lower priorities don't replace the value */
+  result = SDL_SetHintWithPriority(name, "override", SDL_HINT_OVERRIDE);
+  SDLTest_AssertCheck(result == SDL_TRUE, "Verify override result is SDL_TRUE, got: %i", (int)result);
+  result = SDL_SetHintWithPriority(name, "normal", SDL_HINT_NORMAL);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify normal result is SDL_FALSE, got: %i", (int)result);
+  value = SDL_GetHintFromHandle(handle);
+  SDLTest_AssertCheck(
+    value != NULL && SDL_strcmp(value, "override") == 0,
+    "Verify handle value is 'override', got: '%s'",
+    (value == NULL) ? "null" : value);
+
+
+  /* Invalid parameters */
+  handle = SDL_GetHintHandle(NULL);
+  SDLTest_AssertCheck(handle == NULL, "Verify SDL_GetHintHandle(NULL) returns NULL");
+  value = SDL_GetHintFromHandle(NULL);
+  SDLTest_AssertCheck(value == NULL, "Verify SDL_GetHintFromHandle(NULL) returns NULL");
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Hints test cases */
@@ -154,9 +231,12 @@ static const SDLTest_TestCaseReference hintsTest1 =
 static const SDLTest_TestCaseReference hintsTest2 =
         { (SDLTest_TestCaseFp)hints_setHint, "hints_setHint", "Call to SDL_SetHint", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference hintsTest3 =
+        { (SDLTest_TestCaseFp)hints_getHintHandle, "hints_getHintHandle", "Call to SDL_GetHintHandle and SDL_GetHintFromHandle", TEST_ENABLED };
+
 /* Sequence of Hints test cases */
 static const SDLTest_TestCaseReference *hintsTests[] =  {
-    &hintsTest1, &hintsTest2, NULL
+    &hintsTest1, &hintsTest2, &hintsTest3, NULL
 };
 
 /* Hints test suite (global) */
@@ -0,0 +1,175 @@
+/**
+ * Log test suite
+ */
+
+#include <stdio.h>
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+#define LOG_TEST_CATEGORY   (SDL_LOG_CATEGORY_CUSTOM + 1)
+#define LOG_TEST_MESSAGES   1000
+
+typedef struct
+{
+    SDL_LogOutputFunction original;
+    void *original_userdata;
+    SDL_atomic_t count;
+    int next[2];
+    SDL_bool in_order;
+} LogTestData;
+
+static void
+_logOutput(void *userdata, int category, SDL_LogPriority priority, const char *message)
+{
+  LogTestData *data = (LogTestData *)userdata;
+  int source, index;
+
+  if (category != LOG_TEST_CATEGORY) {
+    if (data->original) {
+      data->original(data->original_userdata, category, priority, message);
+    }
+    return;
+  }
+
+  /* Messages are "<source> <index>", and must arrive in order per source */
+  if (SDL_sscanf(message, "%d %d", &source, &index) != 2 || source < 0 || source > 1) {
+    data->in_order = SDL_FALSE;
+  } else {
+    if (index != data->next[source]) {
+      data->in_order = SDL_FALSE;
+    }
+    data->next[source] = index + 1;
+  }
+  SDL_AtomicIncRef(&data->count);
+}
+
+static int SDLCALL
+_logThread(void *arg)
+{
+  int i;
+
+  for (i = 0; i < LOG_TEST_MESSAGES; i++) {
+    SDL_LogInfo(LOG_TEST_CATEGORY, "1 %d", i);
+  }
+  return 0;
+}
+
+/* Test case functions */
+
+/**
+ * @brief Set and get the priorities of SDL and application categories
+ */
+int
+log_priorities(void *arg)
+{
+  const int custom = SDL_LOG_CATEGORY_CUSTOM + 100;
+  SDL_LogPriority priority;
+
+  SDL_LogResetPriorities();
+  SDLTest_AssertPass("Call to SDL_LogResetPriorities()");
+
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_APPLICATION);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_INFO, "Verify application default is INFO, got: %d", priority);
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_CRITICAL, "Verify video default is CRITICAL, got: %d", priority);
+  priority = SDL_LogGetPriority(custom);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_CRITICAL, "Verify custom default is CRITICAL, got: %d", priority);
+
+  SDL_LogSetPriority(SDL_LOG_CATEGORY_VIDEO, SDL_LOG_PRIORITY_DEBUG);
+  SDL_LogSetPriority(custom, SDL_LOG_PRIORITY_WARN);
+  SDLTest_AssertPass("Call to SDL_LogSetPriority()");
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_DEBUG, "Verify video is DEBUG, got: %d", priority);
+  priority = SDL_LogGetPriority(custom);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_WARN, "Verify custom is WARN, got: %d", priority);
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_AUDIO);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_CRITICAL, "Verify audio is still CRITICAL, got: %d", priority);
+
+  SDL_LogSetAllPriority(SDL_LOG_PRIORITY_ERROR);
+  SDLTest_AssertPass("Call to SDL_LogSetAllPriority()");
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_ERROR, "Verify video is ERROR, got: %d", priority);
+  priority = SDL_LogGetPriority(custom);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_ERROR, "Verify custom is ERROR, got: %d", priority);
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_AUDIO);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_ERROR, "Verify audio is ERROR, got: %d", priority);
+
+  SDL_LogResetPriorities();
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_CRITICAL, "Verify video is reset to CRITICAL, got: %d", priority);
+  priority = SDL_LogGetPriority(custom);
+  SDLTest_AssertCheck(priority == SDL_LOG_PRIORITY_CRITICAL, "Verify custom is reset to CRITICAL, got: %d", priority);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Queue messages from two threads in async mode and flush them
+ */
+int
+log_async(void *arg)
+{
+  LogTestData data;
+  SDL_Thread *thread;
+  int result, i;
+
+  SDL_zero(data);
+  data.in_order = SDL_TRUE;
+  SDL_LogGetOutputFunction(&data.original, &data.original_userdata);
+  SDL_LogSetOutputFunction(_logOutput, &data);
+  SDL_LogSetPriority(LOG_TEST_CATEGORY, SDL_LOG_PRIORITY_INFO);
+
+  result = SDL_LogSetAsync(SDL_TRUE);
+  SDLTest_AssertPass("Call to SDL_LogSetAsync(SDL_TRUE)");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %d", result);
+
+  thread = SDL_CreateThread(_logThread, "LogThread", NULL);
+  SDLTest_AssertCheck(thread != NULL, "Verify log thread was created");
+  for (i = 0; i < LOG_TEST_MESSAGES; i++) {
+    SDL_LogInfo(LOG_TEST_CATEGORY, "0 %d", i);
+  }
+  SDL_WaitThread(thread, NULL);
+
+  SDL_LogFlush();
+  SDLTest_AssertPass("Call to SDL_LogFlush()");
+  result = SDL_AtomicGet(&data.count);
+  SDLTest_AssertCheck(result == 2 * LOG_TEST_MESSAGES, "Verify all messages were output, expected: %d, got: %d", 2 * LOG_TEST_MESSAGES, result);
+  SDLTest_AssertCheck(data.in_order, "Verify messages from each thread were output in order");
+
+  result = SDL_LogSetAsync(SDL_FALSE);
+  SDLTest_AssertPass("Call to SDL_LogSetAsync(SDL_FALSE)");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %d", result);
+
+  /* Back to synchronous output */
+  SDL_LogInfo(LOG_TEST_CATEGORY, "0 %d", LOG_TEST_MESSAGES);
+  result = SDL_AtomicGet(&data.count);
+  SDLTest_AssertCheck(result == 2 * LOG_TEST_MESSAGES + 1, "Verify message was output immediately, got: %d", result);
+
+  SDL_LogSetOutputFunction(data.original, data.original_userdata);
+  SDL_LogSetPriority(LOG_TEST_CATEGORY, SDL_LOG_PRIORITY_CRITICAL);
+
+  return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Log test cases */
+static const SDLTest_TestCaseReference logTest1 =
+        { (SDLTest_TestCaseFp)log_priorities, "log_priorities", "Set and get log category priorities", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference logTest2 =
+        { (SDLTest_TestCaseFp)log_async, "log_async", "Queue messages in async mode and flush them", TEST_ENABLED };
+
+/* Sequence of Log test cases */
+static const SDLTest_TestCaseReference *logTests[] =  {
+    &logTest1, &logTest2, NULL
+};
+
+/* Log test suite (global) */
+SDLTest_TestSuiteReference logTestSuite = {
+    "Log",
+    NULL,
+    logTests,
+    NULL
+};
@@ -523,6 +523,148 @@ int platform_testGetPowerInfo(void *arg)
    return TEST_COMPLETED;
 }
 
+/* !
+ * \brief Tests SDL_GetCPUTopology
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetCPUTopology
+ */
+int platform_testGetCPUTopology(void *arg)
+{
+   SDL_CPUTopology topology;
+   int ret;
+
+   SDL_memset(&topology, 0xff, sizeof(topology));
+   ret = SDL_GetCPUTopology(&topology);
+   SDLTest_AssertPass("SDL_GetCPUTopology()");
+   SDLTest_AssertCheck(ret == 0, "SDL_GetCPUTopology(): expected 0, got: %i", ret);
+   SDLTest_AssertCheck(topology.logical_cores == SDL_GetCPUCount(),
+             "Verify logical_cores matches SDL_GetCPUCount(), expected: %i, got: %i",
+             SDL_GetCPUCount(), topology.logical_cores);
+   SDLTest_AssertCheck(topology.physical_cores > 0 && topology.physical_cores <= topology.logical_cores,
+             "Verify 0 < physical_cores <= logical_cores, got: %i", topology.physical_cores);
+   SDLTest_AssertCheck(topology.packages > 0 && topology.packages <= topology.physical_cores,
+             "Verify 0 < packages <= physical_cores, got: %i", topology.packages);
+   SDLTest_AssertCheck(topology.numa_nodes > 0, "Verify numa_nodes > 0, got: %i", topology.numa_nodes);
+   SDLTest_AssertCheck(topology.performance_cores > 0 && topology.efficiency_cores >= 0,
+             "Verify performance_cores > 0 and efficiency_cores >= 0, got: %i and %i",
+             topology.performance_cores, topology.efficiency_cores);
+   SDLTest_AssertCheck(topology.cache_line_size > 0, "Verify cache_line_size > 0, got: %i", topology.cache_line_size);
+   SDLTest_AssertCheck(topology.l1d_cache_size >= 0 && topology.l1i_cache_size >= 0 &&
+             topology.l2_cache_size >= 0 && topology.l3_cache_size >= 0,
+             "Verify cache sizes are not negative, got: %i, %i, %i, %i",
+             topology.l1d_cache_size, topology.l1i_cache_size,
+             topology.l2_cache_size, topology.l3_cache_size);
+
+   ret = SDL_GetCPUTopology(NULL);
+   SDLTest_AssertCheck(ret == -1, "SDL_GetCPUTopology(NULL): expected -1, got: %i", ret);
+   SDL_ClearError();
+
+   return TEST_COMPLETED;
+}
+
+static int SDLCALL
+_setErrorThread(void *arg)
+{
+   char *threadError = (char *)arg;
+
+   SDL_SetError("Thread error %d: %s", 2, "other");
+   SDL_strlcpy(threadError, SDL_GetError(), 64);
+   return 0;
+}
+
+/* !
+ * \brief Tests that each thread sees its own SDL_GetError message
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetError
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetError
+ */
+int platform_testErrorPerThread(void *arg)
+{
+   const char *expectedError = "Thread error 1: main";
+   const char *expectedThreadError = "Thread error 2: other";
+   char threadError[64];
+   const char *lastError;
+   SDL_Thread *thread;
+
+   SDL_SetError("Thread error %d: %s", 1, "main");
+   SDLTest_AssertPass("SDL_SetError()");
+
+   SDL_zero(threadError);
+   thread = SDL_CreateThread(_setErrorThread, "SetErrorThread", threadError);
+   SDLTest_AssertCheck(thread != NULL, "SDL_CreateThread() != NULL");
+   if (thread == NULL) {
+     return TEST_ABORTED;
+   }
+   SDL_WaitThread(thread, NULL);
+
+   SDLTest_AssertCheck(SDL_strcmp(threadError, expectedThreadError) == 0,
+             "Thread SDL_GetError(): expected message %s, was message: %s",
+             expectedThreadError,
+             threadError);
+   lastError = SDL_GetError();
+   SDLTest_AssertCheck(SDL_strcmp(lastError, expectedError) == 0,
+             "SDL_GetError(): expected message %s, was message: %s",
+             expectedError,
+             lastError);
+
+   /* A new error replaces the already formatted message */
+   SDL_SetError("Thread error %d: %s", 3, "again");
+   lastError = SDL_GetError();
+   SDLTest_AssertCheck(SDL_strcmp(lastError, "Thread error 3: again") == 0,
+             "SDL_GetError(): expected message Thread error 3: again, was message: %s",
+             lastError);
+
+   /* Clean up */
+   SDL_ClearError();
+   SDLTest_AssertPass("SDL_ClearError()");
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Restrict the current thread to one CPU and restore its affinity
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_SetThreadAffinityMask
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_GetThreadAffinityMask
+ */
+int platform_testThreadAffinity(void *arg)
+{
+   Uint64 original;
+   Uint64 single;
+   Uint64 mask;
+   int result;
+
+   original = SDL_GetThreadAffinityMask();
+   SDLTest_AssertPass("SDL_GetThreadAffinityMask()");
+   if (original == 0) {
+     SDLTest_Log("CPU affinity is not supported on this platform");
+     return TEST_SKIPPED;
+   }
+
+   /* Lowest CPU we may currently run on */
+   single = original & (~original + 1);
+   result = SDL_SetThreadAffinityMask(single);
+   SDLTest_AssertPass("SDL_SetThreadAffinityMask(0x%" SDL_PRIx64 ")", single);
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+   mask = SDL_GetThreadAffinityMask();
+   SDLTest_AssertCheck(mask == single,
+             "Validate affinity mask; expected: 0x%" SDL_PRIx64 ", got: 0x%" SDL_PRIx64, single, mask);
+
+   result = SDL_SetThreadAffinityMask(0);
+   SDLTest_AssertPass("SDL_SetThreadAffinityMask(0)");
+   SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+
+   result = SDL_SetThreadAffinityMask(original);
+   SDLTest_AssertPass("SDL_SetThreadAffinityMask(0x%" SDL_PRIx64 ")", original);
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+   mask = SDL_GetThreadAffinityMask();
+   SDLTest_AssertCheck(mask == original,
+             "Validate affinity mask restored; expected: 0x%" SDL_PRIx64 ", got: 0x%" SDL_PRIx64, original, mask);
+
+   SDL_ClearError();
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Platform test cases */
@@ -559,6 +701,15 @@ static const SDLTest_TestCaseReference platformTest10 =
 static const SDLTest_TestCaseReference platformTest11 =
         { (SDLTest_TestCaseFp)platform_testGetPowerInfo, "platform_testGetPowerInfo", "Tests SDL_GetPowerInfo function", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference platformTest12 =
+        { (SDLTest_TestCaseFp)platform_testErrorPerThread, "platform_testErrorPerThread", "Tests SDL_GetError is per thread", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference platformTest13 =
+        { (SDLTest_TestCaseFp)platform_testGetCPUTopology, "platform_testGetCPUTopology", "Tests SDL_GetCPUTopology function", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference platformTest14 =
+        { (SDLTest_TestCaseFp)platform_testThreadAffinity, "platform_testThreadAffinity", "Tests SDL_SetThreadAffinityMask and SDL_GetThreadAffinityMask", TEST_ENABLED };
+
 /* Sequence of Platform test cases */
 static const SDLTest_TestCaseReference *platformTests[] =  {
     &platformTest1,
@@ -572,6 +723,9 @@ static const SDLTest_TestCaseReference *platformTests[] =  {
     &platformTest9,
     &platformTest10,
     &platformTest11,
+    &platformTest12,
+    &platformTest13,
+    &platformTest14,
     NULL
 };
 
@@ -766,6 +766,973 @@ render_testBlitBlend (void *arg)
 }
 
 
+/**
+ * @brief Tests packing, drawing, removing and evicting texture atlas entries.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateTextureAtlas
+ * http://wiki.libsdl.org/moin.cgi/SDL_AtlasAddSurface
+ * http://wiki.libsdl.org/moin.cgi/SDL_AtlasRepack
+ */
+int
+render_testTextureAtlas(void *arg)
+{
+   int ret, i, j;
+   SDL_TextureAtlas *atlas;
+   SDL_Surface *surface;
+   SDL_Texture *texture;
+   SDL_AtlasEntryID ids[6];
+   SDL_Rect rects[6], rect;
+   Uint32 pixel;
+
+   atlas = SDL_CreateTextureAtlas(renderer, SDL_PIXELFORMAT_ARGB8888, 32, 32, 1, SDL_ATLAS_DEFAULT);
+   SDLTest_AssertPass("Call to SDL_CreateTextureAtlas()");
+   SDLTest_AssertCheck(atlas != NULL, "Verify atlas is not NULL");
+   if (atlas == NULL) {
+      return TEST_ABORTED;
+   }
+
+   /* Fill the atlas with 15x15 squares of distinct colors */
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 15, 15, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+   if (surface == NULL) {
+      SDL_DestroyTextureAtlas(atlas);
+      return TEST_ABORTED;
+   }
+   for (i = 0; i < 4; i++) {
+      SDL_FillRect(surface, NULL, 0xFF000000 | (0x40 * (i + 1)));
+      ids[i] = SDL_AtlasAddSurface(atlas, surface);
+      SDLTest_AssertCheck(ids[i] != 0, "Validate result from SDL_AtlasAddSurface, expected: !0, got: %u", ids[i]);
+      ret = SDL_AtlasQueryEntry(atlas, ids[i], &texture, &rects[i]);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AtlasQueryEntry, expected: 0, got: %i", ret);
+      SDLTest_AssertCheck(rects[i].w == 15 && rects[i].h == 15, "Verify entry size, expected: 15x15, got: %ix%i", rects[i].w, rects[i].h);
+      SDLTest_AssertCheck(rects[i].x >= 0 && rects[i].y >= 0 && rects[i].x + rects[i].w <= 32 && rects[i].y + rects[i].h <= 32,
+         "Verify entry lies within the page");
+      for (j = 0; j < i; j++) {
+         SDLTest_AssertCheck(!SDL_HasIntersection(&rects[i], &rects[j]), "Verify entries %i and %i don't overlap", i, j);
+      }
+   }
+
+   /* The single page is full now */
+   ids[4] = SDL_AtlasAddSurface(atlas, surface);
+   SDLTest_AssertCheck(ids[4] == 0, "Validate adding to a full atlas fails, got: %u", ids[4]);
+
+   /* Draw each entry and read it back */
+   _clearScreen();
+   for (i = 0; i < 4; i++) {
+      rect.x = i * 16;
+      rect.y = 0;
+      rect.w = 15;
+      rect.h = 15;
+      ret = SDL_RenderCopyAtlasEntry(atlas, ids[i], NULL, &rect);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyAtlasEntry, expected: 0, got: %i", ret);
+   }
+   for (i = 0; i < 4; i++) {
+      rect.x = i * 16 + 7;
+      rect.y = 7;
+      rect.w = 1;
+      rect.h = 1;
+      ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, sizeof(pixel));
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+      SDLTest_AssertCheck((pixel & 0x00FFFFFF) == (Uint32)(0x40 * (i + 1)),
+         "Verify color of entry %i, expected: 0x%.6x, got: 0x%.6x", i, 0x40 * (i + 1), pixel & 0x00FFFFFF);
+   }
+
+   /* Removing an entry invalidates its handle and makes room after repacking */
+   ret = SDL_AtlasRemoveEntry(atlas, ids[1]);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AtlasRemoveEntry, expected: 0, got: %i", ret);
+   ret = SDL_AtlasQueryEntry(atlas, ids[1], NULL, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate querying a removed entry fails, got: %i", ret);
+   ids[4] = SDL_AtlasAddSurface(atlas, surface);
+   SDLTest_AssertCheck(ids[4] != 0 && ids[4] != ids[1], "Validate result from SDL_AtlasAddSurface after removal, got: %u", ids[4]);
+   ret = SDL_AtlasRepack(atlas);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AtlasRepack, expected: 0, got: %i", ret);
+   ret = SDL_AtlasQueryEntry(atlas, ids[3], NULL, &rect);
+   SDLTest_AssertCheck(ret == 0, "Validate entries survive repacking, got: %i", ret);
+   SDL_DestroyTextureAtlas(atlas);
+
+   /* With LRU eviction the entry used least recently makes room */
+   atlas = SDL_CreateTextureAtlas(renderer, SDL_PIXELFORMAT_ARGB8888, 32, 32, 1, SDL_ATLAS_EVICT_LRU);
+   SDLTest_AssertCheck(atlas != NULL, "Verify atlas is not NULL");
+   if (atlas == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   for (i = 0; i < 4; i++) {
+      ids[i] = SDL_AtlasAddSurface(atlas, surface);
+   }
+   for (i = 0; i < 4; i++) {
+      if (i != 2) {
+         SDL_AtlasQueryEntry(atlas, ids[i], NULL, NULL);
+      }
+   }
+   ids[5] = SDL_AtlasAddSurface(atlas, surface);
+   SDLTest_AssertCheck(ids[5] != 0, "Validate result from SDL_AtlasAddSurface with eviction, got: %u", ids[5]);
+   SDLTest_AssertCheck(SDL_AtlasQueryEntry(atlas, ids[2], NULL, NULL) == -1, "Verify the least recently used entry was evicted");
+   SDLTest_AssertCheck(SDL_AtlasQueryEntry(atlas, ids[0], NULL, NULL) == 0, "Verify recently used entries are kept");
+   SDL_DestroyTextureAtlas(atlas);
+   SDLTest_AssertPass("Call to SDL_DestroyTextureAtlas()");
+
+   SDL_FreeSurface(surface);
+   return TEST_COMPLETED;
+}
+
+/* Surface allocations of at least a page's size fail once this reaches 0 */
+static int _atlasPageAllocsLeft = -1;
+static SDL_malloc_func _atlasRealMalloc;
+static SDL_calloc_func _atlasRealCalloc;
+static SDL_realloc_func _atlasRealRealloc;
+static SDL_free_func _atlasRealFree;
+
+static void * SDLCALL
+_atlasFailingMalloc(size_t size)
+{
+   if (size >= 32 * 32 * 4 && _atlasPageAllocsLeft >= 0 && _atlasPageAllocsLeft-- == 0) {
+      return NULL;
+   }
+   return _atlasRealMalloc(size);
+}
+
+static void * SDLCALL
+_atlasFailingCalloc(size_t nmemb, size_t size)
+{
+   if (nmemb * size >= 32 * 32 * 4 && _atlasPageAllocsLeft >= 0 && _atlasPageAllocsLeft-- == 0) {
+      return NULL;
+   }
+   return _atlasRealCalloc(nmemb, size);
+}
+
+static void * SDLCALL
+_atlasFailingRealloc(void *mem, size_t size)
+{
+   return _atlasRealRealloc(mem, size);
+}
+
+static void SDLCALL
+_atlasFailingFree(void *mem)
+{
+   _atlasRealFree(mem);
+}
+
+/* Draw each entry to the top left corner and check its color */
+static void
+_checkAtlasEntries(SDL_Renderer *soft, SDL_Surface *target, SDL_TextureAtlas *atlas,
+                   const SDL_AtlasEntryID *ids, const Uint32 *colors, int count)
+{
+   SDL_Rect rect;
+   Uint32 pixel;
+   int i, ret;
+
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = 15;
+   rect.h = 15;
+   for (i = 0; i < count; i++) {
+      SDL_SetRenderDrawColor(soft, 0, 0, 0, SDL_ALPHA_OPAQUE);
+      SDL_RenderClear(soft);
+      ret = SDL_RenderCopyAtlasEntry(atlas, ids[i], NULL, &rect);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyAtlasEntry, expected: 0, got: %i", ret);
+      pixel = ((Uint32 *)target->pixels)[7 * target->pitch / 4 + 7] & 0x00FFFFFF;
+      SDLTest_AssertCheck(pixel == colors[i], "Verify color of entry %i, expected: 0x%.6x, got: 0x%.6x", i, colors[i], pixel);
+   }
+}
+
+/**
+ * @brief Tests that a texture atlas is unchanged when repacking fails partway.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_AtlasRepack
+ */
+int
+render_testTextureAtlasRepackFailure(void *arg)
+{
+   SDL_Surface *target, *surface;
+   SDL_Renderer *soft;
+   SDL_TextureAtlas *atlas;
+   SDL_AtlasEntryID ids[8];
+   Uint32 colors[8];
+   SDL_Rect before[8], after;
+   int ret, i, count;
+
+   target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 15, 15, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(target != NULL && surface != NULL, "Verify surfaces are not NULL");
+   if (target == NULL || surface == NULL) {
+      SDL_FreeSurface(target);
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   soft = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(soft != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   atlas = soft ? SDL_CreateTextureAtlas(soft, SDL_PIXELFORMAT_ARGB8888, 32, 32, 0, SDL_ATLAS_DEFAULT) : NULL;
+   SDLTest_AssertCheck(atlas != NULL, "Verify atlas is not NULL");
+   if (atlas == NULL) {
+      if (soft) {
+         SDL_DestroyRenderer(soft);
+      }
+      SDL_FreeSurface(target);
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   /* Two full pages, then a hole in each so repacking still needs both */
+   for (i = 0; i < 8; i++) {
+      colors[i] = 0x10 * (i + 1);
+      SDL_FillRect(surface, NULL, 0xFF000000 | colors[i]);
+      ids[i] = SDL_AtlasAddSurface(atlas, surface);
+      SDLTest_AssertCheck(ids[i] != 0, "Validate result from SDL_AtlasAddSurface, expected: !0, got: %u", ids[i]);
+   }
+   SDL_AtlasRemoveEntry(atlas, ids[0]);
+   SDL_AtlasRemoveEntry(atlas, ids[4]);
+   for (i = 0, count = 0; i < 8; i++) {
+      if (i != 0 && i != 4) {
+         ids[count] = ids[i];
+         colors[count] = colors[i];
+         SDL_AtlasQueryEntry(atlas, ids[count], NULL, &before[count]);
+         count++;
+      }
+   }
+
+   /* Let the two page surfaces and the first texture through, so the
+      texture of the second page fails after the first one was uploaded */
+   SDL_GetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, &_atlasRealMalloc, &_atlasRealCalloc, &_atlasRealRealloc, &_atlasRealFree);
+   SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, _atlasFailingMalloc, _atlasFailingCalloc, _atlasFailingRealloc, _atlasFailingFree);
+   _atlasPageAllocsLeft = 3;
+   ret = SDL_AtlasRepack(atlas);
+   _atlasPageAllocsLeft = -1;
+   SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, NULL, NULL, NULL, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_AtlasRepack with failing allocations, expected: -1, got: %i", ret);
+
+   for (i = 0; i < count; i++) {
+      ret = SDL_AtlasQueryEntry(atlas, ids[i], NULL, &after);
+      SDLTest_AssertCheck(ret == 0 && SDL_RectEquals(&before[i], &after), "Verify entry %i wasn't moved by the failed repack", i);
+   }
+   _checkAtlasEntries(soft, target, atlas, ids, colors, count);
+
+   /* It works once memory is available again */
+   ret = SDL_AtlasRepack(atlas);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AtlasRepack, expected: 0, got: %i", ret);
+   _checkAtlasEntries(soft, target, atlas, ids, colors, count);
+
+   SDL_DestroyTextureAtlas(atlas);
+   SDL_DestroyRenderer(soft);
+   SDL_FreeSurface(target);
+   SDL_FreeSurface(surface);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests NV12/NV21 textures with partial updates and clipped, scaled copies.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_UpdateTexture
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopy
+ */
+int
+render_testYUVTexture(void *arg)
+{
+   const Uint32 formats[] = { SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21 };
+   Uint8 yuv[32 * 16 + 32 * 8];
+   Uint8 patch[8 * 4 + 8 * 2];
+   SDL_Texture *texture;
+   SDL_Rect srcrect, dstrect, rect;
+   Uint32 pixel;
+   int ret, i, x, y;
+
+   /* Left half white, right half black, neutral chroma */
+   for (y = 0; y < 16; y++) {
+      for (x = 0; x < 32; x++) {
+         yuv[y * 32 + x] = (x < 16) ? 235 : 16;
+      }
+   }
+   SDL_memset(&yuv[32 * 16], 128, 32 * 8);
+   SDL_memset(patch, 16, 8 * 4);
+   SDL_memset(&patch[8 * 4], 128, 8 * 2);
+
+   for (i = 0; i < SDL_arraysize(formats); i++) {
+      texture = SDL_CreateTexture(renderer, formats[i], SDL_TEXTUREACCESS_STREAMING, 32, 16);
+      SDLTest_AssertPass("Call to SDL_CreateTexture(%s)", SDL_GetPixelFormatName(formats[i]));
+      SDLTest_AssertCheck(texture != NULL, "Verify texture is not NULL");
+      if (texture == NULL) {
+         return TEST_ABORTED;
+      }
+      ret = SDL_UpdateTexture(texture, NULL, yuv, 32);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+
+      /* Stretch the black half across the top left corner */
+      _clearScreen();
+      srcrect.x = 16;
+      srcrect.y = 0;
+      srcrect.w = 16;
+      srcrect.h = 16;
+      dstrect.x = 0;
+      dstrect.y = 0;
+      dstrect.w = 40;
+      dstrect.h = 40;
+      SDL_SetRenderDrawColor(renderer, 128, 128, 128, SDL_ALPHA_OPAQUE);
+      SDL_RenderClear(renderer);
+      ret = SDL_RenderCopy(renderer, texture, &srcrect, &dstrect);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+      rect.x = 1;
+      rect.y = 1;
+      rect.w = 1;
+      rect.h = 1;
+      SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, sizeof(pixel));
+      SDLTest_AssertCheck((pixel & 0x00FFFFFF) == 0, "Verify clipped copy is black, got: 0x%.6x", pixel & 0x00FFFFFF);
+      rect.x = 39;
+      rect.y = 39;
+      SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, sizeof(pixel));
+      SDLTest_AssertCheck((pixel & 0x00FFFFFF) == 0, "Verify scaled copy is black, got: 0x%.6x", pixel & 0x00FFFFFF);
+
+      /* Blacken a corner of the white half, starting on an odd column */
+      rect.x = 3;
+      rect.y = 2;
+      rect.w = 5;
+      rect.h = 4;
+      ret = SDL_UpdateTexture(texture, &rect, patch, 8);
+      SDLTest_AssertCheck(ret == 0, "Validate result from partial SDL_UpdateTexture, expected: 0, got: %i", ret);
+      ret = SDL_RenderCopy(renderer, texture, NULL, NULL);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+      SDL_RenderGetViewport(renderer, &dstrect);
+      rect.x = (4 * dstrect.w) / 32;
+      rect.y = (3 * dstrect.h) / 16;
+      rect.w = 1;
+      rect.h = 1;
+      SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, sizeof(pixel));
+      SDLTest_AssertCheck((pixel & 0x00FFFFFF) == 0, "Verify updated area is black, got: 0x%.6x", pixel & 0x00FFFFFF);
+      rect.x = (12 * dstrect.w) / 32;
+      rect.y = (12 * dstrect.h) / 16;
+      SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, &pixel, sizeof(pixel));
+      SDLTest_AssertCheck((pixel & 0x00FFFFFF) == 0x00FFFFFF, "Verify the rest is still white, got: 0x%.6x", pixel & 0x00FFFFFF);
+
+      SDL_DestroyTexture(texture);
+   }
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests a partial update of a planar YUV texture at an odd position.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_UpdateTexture
+ */
+int
+render_testYUVTextureOddRect(void *arg)
+{
+   Uint8 yuv[16 * 16 + 2 * 8 * 8];
+   /* A 4x4 update has 2x2 samples in each chroma plane, followed here by
+      values that must not be read */
+   Uint8 patch[4 * 4 + 2 * 2 * 2 + 16];
+   SDL_Surface *surface;
+   SDL_Renderer *soft;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   Uint8 r, g, b;
+   int ret, x, y, errors;
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_RGB888);
+   SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   soft = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(soft != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   if (soft == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   texture = SDL_CreateTexture(soft, SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   SDLTest_AssertCheck(texture != NULL, "Verify texture is not NULL");
+   if (texture == NULL) {
+      SDL_DestroyRenderer(soft);
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   /* White with neutral chroma, then a grey patch at an odd position */
+   SDL_memset(yuv, 235, 16 * 16);
+   SDL_memset(&yuv[16 * 16], 128, 2 * 8 * 8);
+   ret = SDL_UpdateTexture(texture, NULL, yuv, 16);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   SDL_memset(patch, 126, 4 * 4);
+   SDL_memset(&patch[4 * 4], 128, 2 * 2 * 2);
+   SDL_memset(&patch[4 * 4 + 2 * 2 * 2], 255, 16);
+   rect.x = 3;
+   rect.y = 3;
+   rect.w = 4;
+   rect.h = 4;
+   ret = SDL_UpdateTexture(texture, &rect, patch, 4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from partial SDL_UpdateTexture, expected: 0, got: %i", ret);
+
+   ret = SDL_RenderCopy(soft, texture, NULL, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+   errors = 0;
+   for (y = 0; y < 16; y++) {
+      for (x = 0; x < 16; x++) {
+         SDL_GetRGB(((Uint32 *)surface->pixels)[y * surface->pitch / 4 + x], surface->format, &r, &g, &b);
+         if (SDL_abs(r - g) > 2 || SDL_abs(g - b) > 2) {
+            ++errors;
+         }
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify the texture has no color after the update, expected: 0 errors, got: %i", errors);
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(soft);
+   SDL_FreeSurface(surface);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests anti-aliased and wide lines of the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderDrawLines
+ */
+static Uint32
+_surfacePixel(SDL_Surface *surface, int x, int y)
+{
+   return ((Uint32 *)surface->pixels)[y * surface->pitch / 4 + x] & 0x00FFFFFF;
+}
+
+int
+render_testLineRaster(void *arg)
+{
+   SDL_Surface *surface;
+   SDL_Renderer *soft;
+   SDL_Rect clip;
+   SDL_Point points[4];
+   int ret, x, y, errors;
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGB888);
+   SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+
+   /* Anti-aliased lines */
+   SDL_SetHint(SDL_HINT_RENDER_LINE_ANTIALIAS, "1");
+   soft = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(soft != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   if (soft == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   SDL_SetRenderDrawColor(soft, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(soft);
+   SDL_SetRenderDrawColor(soft, 255, 255, 255, SDL_ALPHA_OPAQUE);
+   ret = SDL_RenderDrawLine(soft, 2, 5, 20, 5);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+   errors = 0;
+   for (x = 3; x < 20; x++) {
+      if (_surfacePixel(surface, x, 5) != 0xFFFFFF || _surfacePixel(surface, x, 4) || _surfacePixel(surface, x, 6)) {
+         ++errors;
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify horizontal line covers one row, expected: 0 errors, got: %i", errors);
+   SDLTest_AssertCheck((_surfacePixel(surface, 2, 5) & 0xFF) > 0 && (_surfacePixel(surface, 2, 5) & 0xFF) < 0xFF,
+                       "Verify end point is partially covered, got: 0x%.6x", _surfacePixel(surface, 2, 5));
+
+   /* The coverage of a shallow line adds up to one pixel in each column */
+   ret = SDL_RenderDrawLine(soft, 10, 20, 50, 33);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+   errors = 0;
+   for (x = 11; x < 50; x++) {
+      int sum = 0;
+      for (y = 16; y < 38; y++) {
+         sum += _surfacePixel(surface, x, y) & 0xFF;
+      }
+      if (sum < 250 || sum > 260) {
+         ++errors;
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify column coverage of diagonal line, expected: 0 errors, got: %i", errors);
+
+   /* End points far outside the surface are clipped before rasterizing */
+   ret = SDL_RenderDrawLine(soft, -2147483647, 60, 2147483647, 60);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+   errors = 0;
+   for (x = 0; x < 64; x++) {
+      if (_surfacePixel(surface, x, 60) != 0xFFFFFF || _surfacePixel(surface, x, 59) || _surfacePixel(surface, x, 61)) {
+         ++errors;
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify very long line covers one row, expected: 0 errors, got: %i", errors);
+
+   /* Connected lines blend the point they share once */
+   SDL_SetRenderDrawBlendMode(soft, SDL_BLENDMODE_BLEND);
+   SDL_SetRenderDrawColor(soft, 255, 255, 255, 128);
+   points[0].x = 5;
+   points[0].y = 50;
+   points[1].x = 25;
+   points[1].y = 50;
+   points[2].x = 45;
+   points[2].y = 50;
+   ret = SDL_RenderDrawLines(soft, points, 3);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLines, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(_surfacePixel(surface, 25, 50) == _surfacePixel(surface, 15, 50) && _surfacePixel(surface, 15, 50) != 0,
+                       "Verify shared point of anti-aliased lines is blended once, got: 0x%.6x", _surfacePixel(surface, 25, 50));
+   SDL_SetRenderDrawBlendMode(soft, SDL_BLENDMODE_NONE);
+   SDL_DestroyRenderer(soft);
+
+   /* Wide lines with round caps, clipped */
+   SDL_SetHint(SDL_HINT_RENDER_LINE_ANTIALIAS, "0");
+   SDL_SetHint(SDL_HINT_RENDER_LINE_WIDTH, "5");
+   soft = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(soft != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   if (soft == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   SDL_SetRenderDrawColor(soft, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(soft);
+   clip.x = 0;
+   clip.y = 0;
+   clip.w = 30;
+   clip.h = 64;
+   SDL_RenderSetClipRect(soft, &clip);
+   SDL_SetRenderDrawColor(soft, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   ret = SDL_RenderDrawLine(soft, 10, 20, 40, 20);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+   errors = 0;
+   for (y = 0; y < 64; y++) {
+      for (x = 0; x < 64; x++) {
+         const SDL_bool inside = (x >= 10 && x < 30 && y >= 18 && y <= 22);
+         if (inside != (_surfacePixel(surface, x, y) == 0xFF0000) && !(x >= 7 && x < 10)) {
+            ++errors;
+         }
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify wide line is 5 pixels thick and clipped, expected: 0 errors, got: %i", errors);
+   SDLTest_AssertCheck(_surfacePixel(surface, 8, 20) == 0xFF0000 && _surfacePixel(surface, 7, 20) == 0 && _surfacePixel(surface, 8, 18) == 0,
+                       "Verify wide line has a round cap");
+
+   /* Connected wide lines blend their join once */
+   SDL_RenderSetClipRect(soft, NULL);
+   SDL_SetRenderDrawColor(soft, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(soft);
+   SDL_SetRenderDrawBlendMode(soft, SDL_BLENDMODE_BLEND);
+   SDL_SetRenderDrawColor(soft, 255, 255, 255, 128);
+   points[0].x = 10;
+   points[0].y = 10;
+   points[1].x = 30;
+   points[1].y = 10;
+   points[2].x = 30;
+   points[2].y = 30;
+   ret = SDL_RenderDrawLines(soft, points, 3);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLines, expected: 0, got: %i", ret);
+   errors = 0;
+   for (y = 0; y < 64; y++) {
+      for (x = 0; x < 64; x++) {
+         if (_surfacePixel(surface, x, y) != 0 && _surfacePixel(surface, x, y) != _surfacePixel(surface, 20, 10)) {
+            ++errors;
+         }
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify join of wide lines is blended once, expected: 0 errors, got: %i", errors);
+   SDL_SetRenderDrawBlendMode(soft, SDL_BLENDMODE_NONE);
+   SDL_DestroyRenderer(soft);
+
+   /* Wide anti-aliased lines blend the pixels on their edges */
+   SDL_SetHint(SDL_HINT_RENDER_LINE_ANTIALIAS, "1");
+   SDL_SetHint(SDL_HINT_RENDER_LINE_WIDTH, "4");
+   soft = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(soft != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   if (soft == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   SDL_SetRenderDrawColor(soft, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(soft);
+   SDL_SetRenderDrawColor(soft, 0, 0, 255, SDL_ALPHA_OPAQUE);
+   ret = SDL_RenderDrawLine(soft, 10, 40, 50, 40);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLine, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(_surfacePixel(surface, 30, 39) == 0xFF && _surfacePixel(surface, 30, 40) == 0xFF && _surfacePixel(surface, 30, 41) == 0xFF,
+                       "Verify inside of anti-aliased wide line is covered");
+   SDLTest_AssertCheck(_surfacePixel(surface, 30, 38) > 0x60 && _surfacePixel(surface, 30, 38) < 0xA0 &&
+                       _surfacePixel(surface, 30, 42) > 0x60 && _surfacePixel(surface, 30, 42) < 0xA0 &&
+                       _surfacePixel(surface, 30, 37) == 0 && _surfacePixel(surface, 30, 43) == 0,
+                       "Verify edges of anti-aliased wide line are half covered, got: 0x%.6x", _surfacePixel(surface, 30, 38));
+
+   /* No pixel of a closed anti-aliased outline gets more than full coverage */
+   SDL_SetRenderDrawColor(soft, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(soft);
+   SDL_SetRenderDrawBlendMode(soft, SDL_BLENDMODE_BLEND);
+   SDL_SetRenderDrawColor(soft, 0, 0, 255, 128);
+   points[0].x = 10;
+   points[0].y = 10;
+   points[1].x = 50;
+   points[1].y = 10;
+   points[2].x = 30;
+   points[2].y = 50;
+   points[3] = points[0];
+   ret = SDL_RenderDrawLines(soft, points, 4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderDrawLines, expected: 0, got: %i", ret);
+   errors = 0;
+   for (y = 0; y < 64; y++) {
+      for (x = 0; x < 64; x++) {
+         if (_surfacePixel(surface, x, y) > _surfacePixel(surface, 30, 10)) {
+            ++errors;
+         }
+      }
+   }
+   SDLTest_AssertCheck(errors == 0, "Verify joins of anti-aliased wide lines are blended once, expected: 0 errors, got: %i", errors);
+   SDL_SetRenderDrawBlendMode(soft, SDL_BLENDMODE_NONE);
+   SDL_DestroyRenderer(soft);
+
+   SDL_SetHint(SDL_HINT_RENDER_LINE_WIDTH, "1");
+   SDL_SetHint(SDL_HINT_RENDER_LINE_ANTIALIAS, "0");
+   SDL_FreeSurface(surface);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Finds the bounding box of the pixels that differ from the background. Helper function.
+ */
+static void
+_findDrawnRect(SDL_Surface *surface, Uint32 background, SDL_Rect *rect)
+{
+   int x, y, x0 = surface->w, y0 = surface->h, x1 = -1, y1 = -1;
+
+   for (y = 0; y < surface->h; y++) {
+      for (x = 0; x < surface->w; x++) {
+         if (_surfacePixel(surface, x, y) != background) {
+            x0 = SDL_min(x0, x);
+            y0 = SDL_min(y0, y);
+            x1 = SDL_max(x1, x);
+            y1 = SDL_max(y1, y);
+         }
+      }
+   }
+   rect->x = x0;
+   rect->y = y0;
+   rect->w = x1 - x0 + 1;
+   rect->h = y1 - y0 + 1;
+}
+
+/**
+ * @brief Tests unscaled quarter turns and flips against the general rotation path.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyEx
+ */
+int
+render_testCopyExQuarterTurns(void *arg)
+{
+   const double angles[] = { 0.0, 90.0, 180.0, 270.0, -90.0, 450.0 };
+   const SDL_RendererFlip flips[] = { SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL };
+   /* A small texture, and one that takes several tiles */
+   const int sizes[][2] = { { 7, 5 }, { 70, 45 } };
+   Uint32 pixels[45][70];
+   SDL_Surface *fast, *slow;
+   SDL_Renderer *fastRenderer, *slowRenderer;
+   SDL_Texture *fastTexture, *slowTexture;
+   SDL_Rect fastRect, slowRect;
+   int ret, i, j, k, x, y, errors = 0;
+
+   for (y = 0; y < 45; y++) {
+      for (x = 0; x < 70; x++) {
+         pixels[y][x] = 0xFF000000 | (x * 3 + 10) << 16 | (y * 5 + 10) << 8 | 0x80;
+      }
+   }
+
+   fast = SDL_CreateRGBSurfaceWithFormat(0, 256, 256, 32, SDL_PIXELFORMAT_RGB888);
+   slow = SDL_CreateRGBSurfaceWithFormat(0, 256, 256, 32, SDL_PIXELFORMAT_RGB888);
+   SDLTest_AssertCheck(fast != NULL && slow != NULL, "Verify surfaces are not NULL");
+   if (fast == NULL || slow == NULL) {
+      return TEST_ABORTED;
+   }
+   fastRenderer = SDL_CreateSoftwareRenderer(fast);
+   slowRenderer = SDL_CreateSoftwareRenderer(slow);
+   SDLTest_AssertCheck(fastRenderer != NULL && slowRenderer != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   if (fastRenderer == NULL || slowRenderer == NULL) {
+      return TEST_ABORTED;
+   }
+
+   for (k = 0; k < SDL_arraysize(sizes); k++) {
+      const int tw = sizes[k][0], th = sizes[k][1];
+
+      fastTexture = SDL_CreateTexture(fastRenderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STATIC, tw, th);
+      slowTexture = SDL_CreateTexture(slowRenderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STATIC, tw, th);
+      SDLTest_AssertCheck(fastTexture != NULL && slowTexture != NULL, "Verify textures are not NULL");
+      if (fastTexture == NULL || slowTexture == NULL) {
+         return TEST_ABORTED;
+      }
+      SDL_UpdateTexture(fastTexture, NULL, pixels, sizeof(pixels[0]));
+      SDL_UpdateTexture(slowTexture, NULL, pixels, sizeof(pixels[0]));
+
+      for (i = 0; i < SDL_arraysize(angles); i++) {
+         for (j = 0; j < SDL_arraysize(flips); j++) {
+            /* The unscaled copy takes the fast path, the copy scaled by two
+               goes through the rotozoomer, so each pixel becomes a 2x2 block */
+            SDL_Rect dst, dst2;
+
+            dst.x = 100;
+            dst.y = 100;
+            dst.w = tw;
+            dst.h = th;
+            dst2.x = 60;
+            dst2.y = 80;
+            dst2.w = 2 * tw;
+            dst2.h = 2 * th;
+            SDL_SetRenderDrawColor(fastRenderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+            SDL_RenderClear(fastRenderer);
+            SDL_SetRenderDrawColor(slowRenderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+            SDL_RenderClear(slowRenderer);
+            ret = SDL_RenderCopyEx(fastRenderer, fastTexture, NULL, &dst, angles[i], NULL, flips[j]);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+            ret = SDL_RenderCopyEx(slowRenderer, slowTexture, NULL, &dst2, angles[i], NULL, flips[j]);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+
+            _findDrawnRect(fast, 0, &fastRect);
+            _findDrawnRect(slow, 0, &slowRect);
+            if (fastRect.w * 2 != slowRect.w || fastRect.h * 2 != slowRect.h) {
+               ++errors;
+               continue;
+            }
+            for (y = 0; y < fastRect.h; y++) {
+               for (x = 0; x < fastRect.w; x++) {
+                  if (_surfacePixel(fast, fastRect.x + x, fastRect.y + y) !=
+                      _surfacePixel(slow, slowRect.x + 2 * x, slowRect.y + 2 * y)) {
+                     ++errors;
+                  }
+               }
+            }
+         }
+      }
+      SDLTest_AssertCheck(errors == 0, "Verify quarter turns of %ix%i texture match the rotozoomer, expected: 0 errors, got: %i", tw, th, errors);
+
+      if (k == 0) {
+         /* A 90 degree turn around the (truncated) center of the destination */
+         SDL_Rect dst = { 20, 20, 7, 5 };
+         SDL_RenderClear(fastRenderer);
+         SDL_RenderCopyEx(fastRenderer, fastTexture, NULL, &dst, 90.0, NULL, SDL_FLIP_NONE);
+         _findDrawnRect(fast, 0, &fastRect);
+         SDLTest_AssertCheck(fastRect.w == 5 && fastRect.h == 7 && fastRect.x == 20 && fastRect.y == 19,
+                             "Verify rotated rect, expected: 20,19 5x7, got: %i,%i %ix%i", fastRect.x, fastRect.y, fastRect.w, fastRect.h);
+         SDLTest_AssertCheck(_surfacePixel(fast, 20, 19) == (pixels[4][0] & 0x00FFFFFF),
+                             "Verify the bottom left pixel is turned to the top left");
+      }
+      SDL_DestroyTexture(fastTexture);
+      SDL_DestroyTexture(slowTexture);
+   }
+
+   SDL_DestroyRenderer(fastRenderer);
+   SDL_DestroyRenderer(slowRenderer);
+   SDL_FreeSurface(fast);
+   SDL_FreeSurface(slow);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that rotated copies kept across frames follow texture changes.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyEx
+ */
+int
+render_testCopyExCache(void *arg)
+{
+   const SDL_BlendMode modes[] = { SDL_BLENDMODE_NONE, SDL_BLENDMODE_BLEND };
+   Uint32 pixels[16][16];
+   SDL_Surface *cached, *uncached;
+   SDL_Renderer *cachedRenderer, *uncachedRenderer;
+   SDL_Texture *cachedTexture, *uncachedTexture;
+   SDL_Rect dst = { 10, 10, 24, 20 };
+   void *locked;
+   int pitch, ret, i, j, x, y;
+
+   for (y = 0; y < 16; y++) {
+      for (x = 0; x < 16; x++) {
+         pixels[y][x] = (Uint32)((x * 16) << 24 | (y * 16) << 16 | (x * y) << 8 | 0xFF);
+      }
+   }
+
+   cached = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGB888);
+   uncached = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGB888);
+   SDLTest_AssertCheck(cached != NULL && uncached != NULL, "Verify surfaces are not NULL");
+   if (cached == NULL || uncached == NULL) {
+      return TEST_ABORTED;
+   }
+   cachedRenderer = SDL_CreateSoftwareRenderer(cached);
+   uncachedRenderer = SDL_CreateSoftwareRenderer(uncached);
+   SDLTest_AssertCheck(cachedRenderer != NULL && uncachedRenderer != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+   if (cachedRenderer == NULL || uncachedRenderer == NULL) {
+      return TEST_ABORTED;
+   }
+   cachedTexture = SDL_CreateTexture(cachedRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   SDLTest_AssertCheck(cachedTexture != NULL, "Verify texture is not NULL");
+   if (cachedTexture == NULL) {
+      return TEST_ABORTED;
+   }
+   SDL_UpdateTexture(cachedTexture, NULL, pixels, sizeof(pixels[0]));
+
+   for (i = 0; i < 4; i++) {
+      for (j = 0; j < SDL_arraysize(modes); j++) {
+         SDL_SetTextureBlendMode(cachedTexture, modes[j]);
+         SDL_SetTextureColorMod(cachedTexture, 255, 128 + j * 64, 255);
+
+         /* The same copy a few frames in a row, against a texture that was never copied before */
+         for (x = 0; x < 3; x++) {
+            uncachedTexture = SDL_CreateTexture(uncachedRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+            SDLTest_AssertCheck(uncachedTexture != NULL, "Verify texture is not NULL");
+            if (uncachedTexture == NULL) {
+               return TEST_ABORTED;
+            }
+            SDL_UpdateTexture(uncachedTexture, NULL, pixels, sizeof(pixels[0]));
+            SDL_SetTextureBlendMode(uncachedTexture, modes[j]);
+            SDL_SetTextureColorMod(uncachedTexture, 255, 128 + j * 64, 255);
+
+            SDL_SetRenderDrawColor(cachedRenderer, 40, 80, 120, SDL_ALPHA_OPAQUE);
+            SDL_RenderClear(cachedRenderer);
+            SDL_SetRenderDrawColor(uncachedRenderer, 40, 80, 120, SDL_ALPHA_OPAQUE);
+            SDL_RenderClear(uncachedRenderer);
+            ret = SDL_RenderCopyEx(cachedRenderer, cachedTexture, NULL, &dst, 30.0, NULL, SDL_FLIP_HORIZONTAL);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+            ret = SDL_RenderCopyEx(uncachedRenderer, uncachedTexture, NULL, &dst, 30.0, NULL, SDL_FLIP_HORIZONTAL);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+            ret = SDL_memcmp(cached->pixels, uncached->pixels, cached->pitch * cached->h);
+            SDLTest_AssertCheck(ret == 0, "Verify cached rotation %i of blend mode %i matches, expected: 0, got: %i", x, modes[j], ret);
+            SDL_DestroyTexture(uncachedTexture);
+         }
+      }
+
+      /* Change the texture through each way of changing it */
+      for (y = 0; y < 16; y++) {
+         pixels[y][i] ^= 0x00FFFFFF;
+      }
+      if (i & 1) {
+         SDL_LockTexture(cachedTexture, NULL, &locked, &pitch);
+         for (y = 0; y < 16; y++) {
+            SDL_memcpy((Uint8 *)locked + y * pitch, pixels[y], sizeof(pixels[y]));
+         }
+         SDL_UnlockTexture(cachedTexture);
+      } else {
+         SDL_UpdateTexture(cachedTexture, NULL, pixels, sizeof(pixels[0]));
+      }
+   }
+
+   SDL_DestroyTexture(cachedTexture);
+   SDL_DestroyRenderer(cachedRenderer);
+   SDL_DestroyRenderer(uncachedRenderer);
+   SDL_FreeSurface(cached);
+   SDL_FreeSurface(uncached);
+   return TEST_COMPLETED;
+}
+
+/* Blends one pixel the way the software renderer's primitives do */
+static Uint32
+_blendPixel(const SDL_PixelFormat *format, Uint32 pixel, SDL_BlendMode mode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+   Uint8 dr, dg, db, da;
+
+   SDL_GetRGBA(pixel, format, &dr, &dg, &db, &da);
+   switch (mode) {
+   case SDL_BLENDMODE_BLEND:
+      dr = (dr * (255 - a)) / 255 + (r * a) / 255;
+      dg = (dg * (255 - a)) / 255 + (g * a) / 255;
+      db = (db * (255 - a)) / 255 + (b * a) / 255;
+      da = (da * (255 - a)) / 255 + a;
+      break;
+   case SDL_BLENDMODE_ADD:
+      dr = SDL_min(dr + (r * a) / 255, 255);
+      dg = SDL_min(dg + (g * a) / 255, 255);
+      db = SDL_min(db + (b * a) / 255, 255);
+      break;
+   default:
+      dr = (dr * r) / 255;
+      dg = (dg * g) / 255;
+      db = (db * b) / 255;
+      break;
+   }
+   return SDL_MapRGBA(format, dr, dg, db, da);
+}
+
+/**
+ * @brief Tests blended fills, horizontal lines and points of the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderFillRect
+ */
+int
+render_testBlendSpans(void *arg)
+{
+   const Uint32 formats[] = {
+      SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB565
+   };
+   const SDL_BlendMode modes[] = { SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD };
+   const SDL_Point points[] = { { 0, 0 }, { 47, 0 }, { 20, 11 }, { 21, 11 }, { 22, 11 } };
+   const SDL_Rect rect = { 3, 2, 37, 5 };
+   SDL_Surface *surface, *original;
+   SDL_Renderer *soft;
+   SDL_Point point;
+   Uint32 pixel, expected;
+   int f, m, i, x, y, covered, errors;
+
+   for (f = 0; f < SDL_arraysize(formats); f++) {
+      for (m = 0; m < SDL_arraysize(modes); m++) {
+         surface = SDL_CreateRGBSurfaceWithFormat(0, 48, 12, SDL_BITSPERPIXEL(formats[f]), formats[f]);
+         SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+         if (surface == NULL) {
+            return TEST_ABORTED;
+         }
+         for (y = 0; y < surface->h; y++) {
+            for (x = 0; x < surface->w; x++) {
+               pixel = SDL_MapRGBA(surface->format, x * 5, y * 20, (x * y) & 0xFF, 255 - x * 3);
+               SDL_memcpy((Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel, &pixel, surface->format->BytesPerPixel);
+            }
+         }
+         original = SDL_ConvertSurface(surface, surface->format, 0);
+         SDLTest_AssertCheck(original != NULL, "Verify copy of surface is not NULL");
+         soft = SDL_CreateSoftwareRenderer(surface);
+         SDLTest_AssertCheck(soft != NULL, "Verify SDL_CreateSoftwareRenderer() result is not NULL");
+         if (original == NULL || soft == NULL) {
+            return TEST_ABORTED;
+         }
+
+         SDL_SetRenderDrawBlendMode(soft, modes[m]);
+         SDL_SetRenderDrawColor(soft, 200, 100, 50, 160);
+         SDL_RenderFillRect(soft, &rect);
+         SDL_RenderDrawLine(soft, 1, 8, 45, 8);
+         SDL_RenderDrawLine(soft, 44, 9, 2, 9);
+         SDL_RenderDrawPoints(soft, points, SDL_arraysize(points));
+
+         errors = 0;
+         for (y = 0; y < surface->h; y++) {
+            for (x = 0; x < surface->w; x++) {
+               point.x = x;
+               point.y = y;
+               covered = SDL_EnclosePoints(&point, 1, &rect, NULL) ||
+                         (y == 8 && x >= 1 && x <= 45) ||
+                         (y == 9 && x >= 2 && x <= 44);
+               for (i = 0; i < SDL_arraysize(points); i++) {
+                  if (points[i].x == x && points[i].y == y) {
+                     covered = SDL_TRUE;
+                  }
+               }
+               pixel = 0;
+               expected = 0;
+               SDL_memcpy(&pixel, (Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel, surface->format->BytesPerPixel);
+               SDL_memcpy(&expected, (Uint8 *)original->pixels + y * original->pitch + x * original->format->BytesPerPixel, original->format->BytesPerPixel);
+               if (covered) {
+                  expected = _blendPixel(surface->format, expected, modes[m], 200, 100, 50, 160);
+               }
+               if (pixel != expected) {
+                  errors++;
+               }
+            }
+         }
+         SDLTest_AssertCheck(errors == 0, "Verify blend mode %i on %s matches the per-pixel blend, expected: 0 errors, got: %i",
+                             modes[m], SDL_GetPixelFormatName(formats[f]), errors);
+
+         SDL_DestroyRenderer(soft);
+         SDL_FreeSurface(original);
+         SDL_FreeSurface(surface);
+      }
+   }
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Checks to see if functionality is supported. Helper function.
  */
@@ -1085,9 +2052,33 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testTextureAtlas, "render_testTextureAtlas", "Tests texture atlas packing, removal and eviction", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testYUVTexture, "render_testYUVTexture", "Tests NV12/NV21 textures with partial updates and clipped copies", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testLineRaster, "render_testLineRaster", "Tests anti-aliased and wide lines of the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testCopyExQuarterTurns, "render_testCopyExQuarterTurns", "Tests unscaled quarter turns and flips of the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testCopyExCache, "render_testCopyExCache", "Tests that cached rotated copies follow texture changes", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest13 =
+        { (SDLTest_TestCaseFp)render_testBlendSpans, "render_testBlendSpans", "Tests blended fills, lines and points against the per-pixel blend", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest14 =
+        { (SDLTest_TestCaseFp)render_testTextureAtlasRepackFailure, "render_testTextureAtlasRepackFailure", "Tests that a texture atlas is unchanged when repacking fails partway", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest15 =
+        { (SDLTest_TestCaseFp)render_testYUVTextureOddRect, "render_testYUVTextureOddRect", "Tests a partial update of a planar YUV texture at an odd position", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, &renderTest12, &renderTest13, &renderTest14, &renderTest15, NULL
 };
 
 /* Render test suite (global) */
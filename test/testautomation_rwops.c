@@ -700,6 +700,220 @@ rwops_testFileWriteReadEndian(void)
 }
 
 
+/**
+ * @brief Tests reading from a memory mapped file and direct access to its data.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromMappedFile
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWGetPointer
+ */
+int
+rwops_testMappedFile(void)
+{
+   SDL_RWops *rw;
+   const char *data;
+   size_t size;
+   Sint64 i;
+   int result;
+
+   /* Nonexistent and empty file names fail */
+   rw = SDL_RWFromMappedFile("rwops_does_not_exist");
+   SDLTest_AssertPass("Call to SDL_RWFromMappedFile(\"rwops_does_not_exist\") succeeded");
+   SDLTest_AssertCheck(rw == NULL, "Verify opening a nonexistent file returns NULL");
+   rw = SDL_RWFromMappedFile("");
+   SDLTest_AssertPass("Call to SDL_RWFromMappedFile(\"\") succeeded");
+   SDLTest_AssertCheck(rw == NULL, "Verify opening an empty file name returns NULL");
+
+   rw = SDL_RWFromMappedFile(RWopsReadTestFilename);
+   SDLTest_AssertPass("Call to SDL_RWFromMappedFile() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromMappedFile does not return NULL");
+
+   /* Bail out if NULL */
+   if (rw == NULL) return TEST_ABORTED;
+
+   /* Platforms without memory mapping fall back to a regular file */
+   SDLTest_AssertCheck(
+      rw->type == SDL_RWOPS_MAPPED || rw->type == SDL_RWOPS_STDFILE ||
+      rw->type == SDL_RWOPS_WINFILE || rw->type == SDL_RWOPS_JNIFILE,
+      "Verify RWops type is SDL_RWOPS_MAPPED or a file type; got: %d", rw->type);
+
+   /* Run generic tests */
+   _testGenericRWopsValidations( rw, 0 );
+
+   /* The unread data can be accessed directly */
+   i = SDL_RWseek(rw, 6, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 6, "Verify seek to 6 with SDL_RWseek (RW_SEEK_SET), expected 6, got %"SDL_PRIs64, i);
+   data = (const char *)SDL_RWGetPointer(rw, &size);
+   SDLTest_AssertPass("Call to SDL_RWGetPointer() succeeded");
+   if (rw->type == SDL_RWOPS_MAPPED) {
+      SDLTest_AssertCheck(data != NULL, "Verify SDL_RWGetPointer returns data for a mapped file");
+      SDLTest_AssertCheck(size == sizeof(RWopsHelloWorldTestString)-7, "Verify remaining size, expected %i, got %i", (int) sizeof(RWopsHelloWorldTestString)-7, (int) size);
+      if (data != NULL) {
+         SDLTest_AssertCheck(SDL_memcmp(data, &RWopsHelloWorldTestString[6], size) == 0, "Verify data matches the file contents");
+      }
+   } else {
+      SDLTest_AssertCheck(data == NULL && size == 0, "Verify SDL_RWGetPointer returns NULL for a file stream");
+   }
+
+   /* Close handle */
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   /* Memory streams give access to their data too */
+   rw = SDL_RWFromConstMem(RWopsAlphabetString, sizeof(RWopsAlphabetString)-1);
+   SDLTest_AssertCheck(rw != NULL, "Verify opening memory with SDL_RWFromConstMem does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDL_RWseek(rw, -3, RW_SEEK_END);
+   data = (const char *)SDL_RWGetPointer(rw, &size);
+   SDLTest_AssertPass("Call to SDL_RWGetPointer() succeeded");
+   SDLTest_AssertCheck(data == &RWopsAlphabetString[sizeof(RWopsAlphabetString)-4], "Verify SDL_RWGetPointer returns the read position");
+   SDLTest_AssertCheck(size == 3, "Verify remaining size, expected 3, got %i", (int) size);
+   SDL_RWclose(rw);
+
+   return TEST_COMPLETED;
+}
+
+/* Counts the calls made to a memory stream it wraps, like a custom stream */
+static int _countedReads;
+static int _countedWrites;
+
+static Sint64 SDLCALL
+_countedSize(SDL_RWops *context)
+{
+   SDL_RWops *mem = (SDL_RWops *)context->hidden.unknown.data1;
+   return SDL_RWsize(mem);
+}
+
+static Sint64 SDLCALL
+_countedSeek(SDL_RWops *context, Sint64 offset, int whence)
+{
+   SDL_RWops *mem = (SDL_RWops *)context->hidden.unknown.data1;
+   return SDL_RWseek(mem, offset, whence);
+}
+
+static size_t SDLCALL
+_countedRead(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+   SDL_RWops *mem = (SDL_RWops *)context->hidden.unknown.data1;
+   _countedReads++;
+   return SDL_RWread(mem, ptr, size, maxnum);
+}
+
+static size_t SDLCALL
+_countedWrite(SDL_RWops *context, const void *ptr, size_t size, size_t num)
+{
+   SDL_RWops *mem = (SDL_RWops *)context->hidden.unknown.data1;
+   _countedWrites++;
+   return SDL_RWwrite(mem, ptr, size, num);
+}
+
+static int SDLCALL
+_countedClose(SDL_RWops *context)
+{
+   SDL_RWops *mem = (SDL_RWops *)context->hidden.unknown.data1;
+   SDL_FreeRW(context);
+   return SDL_RWclose(mem);
+}
+
+static SDL_RWops *
+_createCountedRW(void *mem, int size)
+{
+   SDL_RWops *rw = SDL_AllocRW();
+   if (rw == NULL) return NULL;
+   rw->size = _countedSize;
+   rw->seek = _countedSeek;
+   rw->read = _countedRead;
+   rw->write = _countedWrite;
+   rw->close = _countedClose;
+   rw->hidden.unknown.data1 = SDL_RWFromMem(mem, size);
+   _countedReads = 0;
+   _countedWrites = 0;
+   return rw;
+}
+
+/**
+ * @brief Tests buffering another stream.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromBufferedRW
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWClose
+ */
+int
+rwops_testBufferedRW(void)
+{
+   char mem[sizeof(RWopsHelloWorldTestString)];
+   Uint8 data[64];
+   SDL_RWops *src;
+   SDL_RWops *rw;
+   Sint64 i;
+   Uint32 value;
+   int result;
+
+   /* Invalid parameters */
+   rw = SDL_RWFromBufferedRW(NULL, 0, SDL_FALSE);
+   SDLTest_AssertPass("Call to SDL_RWFromBufferedRW(NULL, 0, SDL_FALSE) succeeded");
+   SDLTest_AssertCheck(rw == NULL, "Verify SDL_RWFromBufferedRW(NULL, 0, SDL_FALSE) returns NULL");
+
+   /* The generic tests pass through a small buffer */
+   SDL_zero(mem);
+   src = SDL_RWFromMem(mem, sizeof(RWopsHelloWorldTestString)-1);
+   SDLTest_AssertCheck(src != NULL, "Verify opening memory with SDL_RWFromMem does not return NULL");
+   if (src == NULL) return TEST_ABORTED;
+   rw = SDL_RWFromBufferedRW(src, 4, SDL_TRUE);
+   SDLTest_AssertPass("Call to SDL_RWFromBufferedRW(src, 4, SDL_TRUE) succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_RWFromBufferedRW does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_BUFFERED, "Verify RWops type is SDL_RWOPS_BUFFERED; expected: %d, got: %d", SDL_RWOPS_BUFFERED, rw->type);
+   _testGenericRWopsValidations(rw, 1);
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   /* Reading a field at a time only reads the source once per buffer */
+   for (i = 0; i < (Sint64)sizeof(data); ++i) {
+      data[i] = (Uint8)i;
+   }
+   src = _createCountedRW(data, sizeof(data));
+   if (src == NULL) return TEST_ABORTED;
+   rw = SDL_RWFromBufferedRW(src, 32, SDL_FALSE);
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_RWFromBufferedRW does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   for (i = 0; i < 10; ++i) {
+      value = SDL_ReadLE32(rw);
+      SDLTest_AssertCheck(value == SDL_SwapLE32(((Uint32 *)data)[i]), "Verify value %d read from the buffer", (int)i);
+   }
+   SDLTest_AssertCheck(_countedReads == 2, "Verify the source was read twice; got: %d", _countedReads);
+
+   /* Seeking within the buffer doesn't read again, and the source is left at the same position */
+   i = SDL_RWseek(rw, -8, RW_SEEK_CUR);
+   SDLTest_AssertCheck(i == 32, "Verify seek to -8 with SDL_RWseek (RW_SEEK_CUR), expected 32, got %"SDL_PRIs64, i);
+   value = SDL_ReadLE32(rw);
+   SDLTest_AssertCheck(value == SDL_SwapLE32(((Uint32 *)data)[8]), "Verify value read after seeking");
+   SDLTest_AssertCheck(_countedReads == 2, "Verify the source wasn't read again; got: %d", _countedReads);
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   i = SDL_RWtell(src);
+   SDLTest_AssertCheck(i == 36, "Verify the source is at the buffered position, expected 36, got %"SDL_PRIs64, i);
+
+   /* Writes are collected until the buffer is closed */
+   SDL_RWseek(src, 0, RW_SEEK_SET);
+   _countedWrites = 0;
+   rw = SDL_RWFromBufferedRW(src, 0, SDL_TRUE);
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_RWFromBufferedRW does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   for (i = 0; i < 16; ++i) {
+      SDL_WriteBE32(rw, (Uint32)i);
+   }
+   SDLTest_AssertCheck(_countedWrites == 0, "Verify the source wasn't written yet; got: %d", _countedWrites);
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   SDLTest_AssertCheck(_countedWrites == 1, "Verify the source was written once; got: %d", _countedWrites);
+   SDLTest_AssertCheck(data[7] == 1 && data[63] == 15, "Verify the written values, expected 1 and 15, got %d and %d", data[7], data[63]);
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* RWops test cases */
@@ -733,10 +947,16 @@ static const SDLTest_TestCaseReference rwopsTest9 =
 static const SDLTest_TestCaseReference rwopsTest10 =
         { (SDLTest_TestCaseFp)rwops_testCompareRWFromMemWithRWFromFile, "rwops_testCompareRWFromMemWithRWFromFile", "Compare RWFromMem and RWFromFile RWops for read and seek", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference rwopsTest11 =
+        { (SDLTest_TestCaseFp)rwops_testMappedFile, "rwops_testMappedFile", "Tests reading from a memory mapped file", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest12 =
+        { (SDLTest_TestCaseFp)rwops_testBufferedRW, "rwops_testBufferedRW", "Tests buffering another stream", TEST_ENABLED };
+
 /* Sequence of RWops test cases */
 static const SDLTest_TestCaseReference *rwopsTests[] =  {
     &rwopsTest1, &rwopsTest2, &rwopsTest3, &rwopsTest4, &rwopsTest5, &rwopsTest6,
-    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, NULL
+    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, &rwopsTest11, &rwopsTest12, NULL
 };
 
 /* RWops test suite (global) */
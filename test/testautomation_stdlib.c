@@ -290,6 +290,271 @@ stdlib_sscanf(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Memory functions that count their calls and forward to SDL's originals */
+static SDL_malloc_func _realMalloc;
+static SDL_calloc_func _realCalloc;
+static SDL_realloc_func _realRealloc;
+static SDL_free_func _realFree;
+static int _countedAllocs;
+
+static void * SDLCALL
+_countingMalloc(size_t size)
+{
+  ++_countedAllocs;
+  return _realMalloc(size);
+}
+
+static void * SDLCALL
+_countingCalloc(size_t nmemb, size_t size)
+{
+  ++_countedAllocs;
+  return _realCalloc(nmemb, size);
+}
+
+static void * SDLCALL
+_countingRealloc(void *mem, size_t size)
+{
+  if (!mem) {
+    ++_countedAllocs;
+  }
+  return _realRealloc(mem, size);
+}
+
+static void SDLCALL
+_countingFree(void *mem)
+{
+  --_countedAllocs;
+  _realFree(mem);
+}
+
+/**
+ * @brief Call to SDL_SetMemoryFunctions and SDL_SetMemoryFunctionsForTag
+ */
+int
+stdlib_memoryFunctions(void *arg)
+{
+  SDL_malloc_func malloc_func;
+  SDL_calloc_func calloc_func;
+  SDL_realloc_func realloc_func;
+  SDL_free_func free_func;
+  SDL_Surface *surface;
+  void *mem;
+  int count, result;
+
+  SDL_GetMemoryFunctions(&_realMalloc, &_realCalloc, &_realRealloc, &_realFree);
+  SDLTest_AssertPass("Call to SDL_GetMemoryFunctions()");
+  SDLTest_AssertCheck(_realMalloc && _realCalloc && _realRealloc && _realFree, "Check that all memory functions are set");
+
+  /* Invalid parameters */
+  result = SDL_SetMemoryFunctions(NULL, _realCalloc, _realRealloc, _realFree);
+  SDLTest_AssertCheck(result == -1, "Check SDL_SetMemoryFunctions() with NULL malloc_func, expected: -1, got: %i", result);
+  result = SDL_SetMemoryFunctionsForTag(SDL_NUM_MEMORY_TAGS, _realMalloc, _realCalloc, _realRealloc, _realFree);
+  SDLTest_AssertCheck(result == -1, "Check SDL_SetMemoryFunctionsForTag() with an invalid tag, expected: -1, got: %i", result);
+  result = SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_GENERAL, NULL, NULL, NULL, NULL);
+  SDLTest_AssertCheck(result == -1, "Check resetting SDL_MEMORY_TAG_GENERAL, expected: -1, got: %i", result);
+
+  /* Allocations are counted while they're live */
+  count = SDL_GetNumAllocations();
+  mem = SDL_malloc(16);
+  SDLTest_AssertCheck(SDL_GetNumAllocations() == count + 1, "Check SDL_GetNumAllocations() after SDL_malloc(), expected: %i, got: %i", count + 1, SDL_GetNumAllocations());
+  mem = SDL_realloc(mem, 32);
+  SDLTest_AssertCheck(SDL_GetNumAllocations() == count + 1, "Check SDL_GetNumAllocations() after SDL_realloc(), expected: %i, got: %i", count + 1, SDL_GetNumAllocations());
+  SDL_free(mem);
+  SDLTest_AssertCheck(SDL_GetNumAllocations() == count, "Check SDL_GetNumAllocations() after SDL_free(), expected: %i, got: %i", count, SDL_GetNumAllocations());
+  mem = SDL_malloc(16);
+  mem = SDL_realloc(mem, 0);
+  SDLTest_AssertCheck(mem == NULL, "Check SDL_realloc() to 0 bytes returns NULL");
+  SDLTest_AssertCheck(SDL_GetNumAllocations() == count, "Check SDL_GetNumAllocations() after SDL_realloc() to 0 bytes, expected: %i, got: %i", count, SDL_GetNumAllocations());
+
+  /* A subsystem's allocations go to the functions for its tag */
+  _countedAllocs = 0;
+  result = SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, _countingMalloc, _countingCalloc, _countingRealloc, _countingFree);
+  SDLTest_AssertCheck(result == 0, "Check SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO), expected: 0, got: %i", result);
+  SDL_GetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, &malloc_func, &calloc_func, &realloc_func, &free_func);
+  SDLTest_AssertCheck(malloc_func == _countingMalloc && free_func == _countingFree, "Check SDL_GetMemoryFunctionsForTag() returns the functions for the tag");
+  mem = SDL_malloc(16);
+  SDLTest_AssertCheck(_countedAllocs == 0, "Check SDL_malloc() doesn't use the video functions, got: %i allocations", _countedAllocs);
+  SDL_free(mem);
+
+  count = SDL_GetNumAllocationsForTag(SDL_MEMORY_TAG_VIDEO);
+  surface = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+  SDLTest_AssertPass("Call to SDL_CreateRGBSurfaceWithFormat()");
+  SDLTest_AssertCheck(surface != NULL, "Check that the surface was created");
+  SDLTest_AssertCheck(_countedAllocs == 1, "Check that the surface pixels used the video functions, expected: 1, got: %i allocations", _countedAllocs);
+  SDLTest_AssertCheck(SDL_GetNumAllocationsForTag(SDL_MEMORY_TAG_VIDEO) == count + 1, "Check SDL_GetNumAllocationsForTag(SDL_MEMORY_TAG_VIDEO), expected: %i, got: %i", count + 1, SDL_GetNumAllocationsForTag(SDL_MEMORY_TAG_VIDEO));
+  SDL_FreeSurface(surface);
+  SDLTest_AssertCheck(_countedAllocs == 0, "Check that the surface pixels were freed, got: %i allocations", _countedAllocs);
+
+  /* Reset the tag to the general functions */
+  result = SDL_SetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, NULL, NULL, NULL, NULL);
+  SDLTest_AssertCheck(result == 0, "Check resetting SDL_MEMORY_TAG_VIDEO, expected: 0, got: %i", result);
+  SDL_GetMemoryFunctionsForTag(SDL_MEMORY_TAG_VIDEO, &malloc_func, &calloc_func, &realloc_func, &free_func);
+  SDLTest_AssertCheck(malloc_func == _realMalloc && free_func == _realFree, "Check SDL_GetMemoryFunctionsForTag() returns the general functions after a reset");
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Call to SDL_memset, SDL_memcpy, SDL_memcmp, SDL_strlen and SDL_strchr
+ *        with all offsets and lengths around the vector and word sizes
+ *
+ * These only reach SDL's own implementations in builds without a C runtime
+ * (or without the matching HAVE_* function); otherwise they check the C
+ * runtime's versions.
+ */
+int
+stdlib_memfuncs(void *arg)
+{
+  Uint8 src[160], dst[160];
+  char text[160];
+  size_t offset, len, i;
+  int failures = 0;
+  int result;
+
+  for (offset = 0; offset < 32; ++offset) {
+    for (len = 0; len < 96; ++len) {
+      SDL_memset(dst, 0xAA, sizeof(dst));
+      SDL_memset(dst + offset, 0x55, len);
+      for (i = 0; i < sizeof(dst); ++i) {
+        if (dst[i] != ((i >= offset && i < offset + len) ? 0x55 : 0xAA)) {
+          ++failures;
+          SDLTest_LogError("SDL_memset(dst + %d, 0x55, %d) set byte %d to 0x%.2x", (int) offset, (int) len, (int) i, dst[i]);
+          break;
+        }
+      }
+
+      for (i = 0; i < sizeof(src); ++i) {
+        src[i] = (Uint8) (i * 7 + 1);
+      }
+      SDL_memset(dst, 0, sizeof(dst));
+      SDL_memcpy(dst + offset, src + (31 - offset), len);
+      result = SDL_memcmp(dst + offset, src + (31 - offset), len);
+      if (result != 0) {
+        ++failures;
+        SDLTest_LogError("SDL_memcmp() after SDL_memcpy(dst + %d, src + %d, %d), expected: 0, got: %d", (int) offset, (int) (31 - offset), (int) len, result);
+      }
+      if (dst[offset + len] != 0 || (offset > 0 && dst[offset - 1] != 0)) {
+        ++failures;
+        SDLTest_LogError("SDL_memcpy(dst + %d, src, %d) wrote outside the destination", (int) offset, (int) len);
+      }
+      if (len > 0) {
+        /* Compares as unsigned char */
+        dst[offset + len - 1] = 0xFF;
+        src[(31 - offset) + len - 1] = 0x01;
+        result = SDL_memcmp(dst + offset, src + (31 - offset), len);
+        if (result <= 0) {
+          ++failures;
+          SDLTest_LogError("SDL_memcmp() with the last of %d bytes greater, expected: > 0, got: %d", (int) len, result);
+        }
+      }
+
+      SDL_memset(text, 'a', sizeof(text));
+      text[offset + len] = '\0';
+      if (len > 0) {
+        text[offset + len - 1] = 'z';
+      }
+      if (SDL_strlen(text + offset) != len) {
+        ++failures;
+        SDLTest_LogError("SDL_strlen() at offset %d, expected: %d, got: %d", (int) offset, (int) len, (int) SDL_strlen(text + offset));
+      }
+      if (SDL_strchr(text + offset, 'z') != (len > 0 ? text + offset + len - 1 : NULL)) {
+        ++failures;
+        SDLTest_LogError("SDL_strchr(text + %d, 'z') with length %d returned the wrong position", (int) offset, (int) len);
+      }
+      if (SDL_strchr(text + offset, 'q') != NULL) {
+        ++failures;
+        SDLTest_LogError("SDL_strchr(text + %d, 'q') with length %d found a character that isn't there", (int) offset, (int) len);
+      }
+      if (SDL_strchr(text + offset, '\0') != text + offset + len) {
+        ++failures;
+        SDLTest_LogError("SDL_strchr(text + %d, '\\0') with length %d didn't return the terminator", (int) offset, (int) len);
+      }
+    }
+  }
+  SDLTest_AssertCheck(failures == 0, "Check memory and string functions at all offsets and lengths, got: %d failures", failures);
+
+  return TEST_COMPLETED;
+}
+
+static int SDLCALL
+_compareInts(const void *a, const void *b)
+{
+  const int x = *(const int *) a;
+  const int y = *(const int *) b;
+  return (x < y) ? -1 : (x > y);
+}
+
+static int SDLCALL
+_compareSint64s(const void *a, const void *b)
+{
+  const Sint64 x = *(const Sint64 *) a;
+  const Sint64 y = *(const Sint64 *) b;
+  return (x < y) ? -1 : (x > y);
+}
+
+static int SDLCALL
+_compareBytes(const void *a, const void *b)
+{
+  return (int) *(const Uint8 *) a - (int) *(const Uint8 *) b;
+}
+
+/**
+ * @brief Call to SDL_qsort with ascending, descending, repetitive and random
+ *        data, for word sized, 8 byte and single byte elements
+ */
+int
+stdlib_qsort(void *arg)
+{
+  const char *orders[] = { "ascending", "descending", "repetitive", "organ pipe", "random" };
+  const int count = 10000;
+  int *ints = (int *) SDL_malloc(count * sizeof(int));
+  Sint64 *longs = (Sint64 *) SDL_malloc(count * sizeof(Sint64));
+  Uint8 *bytes = (Uint8 *) SDL_malloc(count);
+  int order, i, sorted;
+
+  SDLTest_AssertCheck(ints && longs && bytes, "Check that the arrays were allocated");
+  if (!ints || !longs || !bytes) {
+    SDL_free(ints);
+    SDL_free(longs);
+    SDL_free(bytes);
+    return TEST_ABORTED;
+  }
+
+  for (order = 0; order < (int) SDL_arraysize(orders); ++order) {
+    for (i = 0; i < count; ++i) {
+      switch (order) {
+      case 0: ints[i] = i; break;
+      case 1: ints[i] = count - i; break;
+      case 2: ints[i] = i % 3; break;
+      case 3: ints[i] = (i < count / 2) ? i : (count - i); break;
+      default: ints[i] = SDLTest_RandomIntegerInRange(-count, count); break;
+      }
+      longs[i] = (Sint64) ints[i] * 0x100000001LL;
+      bytes[i] = (Uint8) ints[i];
+    }
+
+    SDL_qsort(ints, count, sizeof(int), _compareInts);
+    SDL_qsort(longs, count, sizeof(Sint64), _compareSint64s);
+    SDL_qsort(bytes, count, 1, _compareBytes);
+    SDLTest_AssertPass("Call to SDL_qsort() with %s data", orders[order]);
+
+    sorted = 1;
+    for (i = 1; i < count; ++i) {
+      if (ints[i - 1] > ints[i] || longs[i - 1] > longs[i] || bytes[i - 1] > bytes[i]) {
+        sorted = 0;
+        break;
+      }
+    }
+    SDLTest_AssertCheck(sorted, "Check that %s data was sorted", orders[order]);
+  }
+
+  SDL_free(ints);
+  SDL_free(longs);
+  SDL_free(bytes);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Standard C routine test cases */
@@ -305,9 +570,18 @@ static const SDLTest_TestCaseReference stdlibTest3 =
 static const SDLTest_TestCaseReference stdlibTest4 =
         { (SDLTest_TestCaseFp)stdlib_sscanf, "stdlib_sscanf", "Call to SDL_sscanf", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference stdlibTest5 =
+        { (SDLTest_TestCaseFp)stdlib_memoryFunctions, "stdlib_memoryFunctions", "Call to SDL_SetMemoryFunctions and SDL_SetMemoryFunctionsForTag", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest6 =
+        { (SDLTest_TestCaseFp)stdlib_memfuncs, "stdlib_memfuncs", "Call to SDL_memset, SDL_memcpy, SDL_memcmp, SDL_strlen and SDL_strchr", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibTest7 =
+        { (SDLTest_TestCaseFp)stdlib_qsort, "stdlib_qsort", "Call to SDL_qsort", TEST_ENABLED };
+
 /* Sequence of Standard C routine test cases */
 static const SDLTest_TestCaseReference *stdlibTests[] =  {
-    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, NULL
+    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, &stdlibTest5, &stdlibTest6, &stdlibTest7, NULL
 };
 
 /* Standard C routine test suite (global) */
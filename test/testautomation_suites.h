@@ -9,10 +9,12 @@
 #include "SDL_test.h"
 
 /* Test collections */
+extern SDLTest_TestSuiteReference atomicTestSuite;
 extern SDLTest_TestSuiteReference audioTestSuite;
 extern SDLTest_TestSuiteReference clipboardTestSuite;
 extern SDLTest_TestSuiteReference eventsTestSuite;
 extern SDLTest_TestSuiteReference keyboardTestSuite;
+extern SDLTest_TestSuiteReference logTestSuite;
 extern SDLTest_TestSuiteReference mainTestSuite;
 extern SDLTest_TestSuiteReference mouseTestSuite;
 extern SDLTest_TestSuiteReference pixelsTestSuite;
@@ -30,10 +32,12 @@ extern SDLTest_TestSuiteReference hintsTestSuite;
 
 /* All test suites */
 SDLTest_TestSuiteReference *testSuites[] =  {
+    &atomicTestSuite,
     &audioTestSuite,
     &clipboardTestSuite,
     &eventsTestSuite,
     &keyboardTestSuite,
+    &logTestSuite,
     &mainTestSuite,
     &mouseTestSuite,
     &pixelsTestSuite,
@@ -390,6 +390,113 @@ surface_testCompleteSurfaceConversion(void *arg)
 }
 
 
+/* !
+ *  Tests conversion between RGB and all YUV formats with SDL_ConvertPixels.
+ */
+int
+surface_testConvertPixelsYUV(void *arg)
+{
+    const Uint32 yuv_formats[] = {
+        SDL_PIXELFORMAT_YV12,
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_YUY2,
+        SDL_PIXELFORMAT_UYVY,
+        SDL_PIXELFORMAT_YVYU,
+    };
+    const SDL_YUV_CONVERSION_MODE modes[] = {
+        SDL_YUV_CONVERSION_JPEG,
+        SDL_YUV_CONVERSION_BT601,
+        SDL_YUV_CONVERSION_BT709,
+        SDL_YUV_CONVERSION_BT709_FULL,
+    };
+    /* Odd width so both the vectorized and the remaining pixels are used */
+    const int w = 37, h = 6;
+    const int rgb_pitch = w * 4;
+    Uint32 *rgb, *result;
+    Uint8 *yuv;
+    Uint8 yuy2[4] = { 235, 128, 16, 128 };
+    Uint32 pixels[2];
+    int i, j, x, y, ret, yuv_pitch, errors;
+
+    rgb = (Uint32 *)SDL_malloc(rgb_pitch * h);
+    result = (Uint32 *)SDL_malloc(rgb_pitch * h);
+    yuv = (Uint8 *)SDL_malloc(rgb_pitch * h * 2);
+    SDLTest_AssertCheck(rgb && result && yuv, "Verify buffers are allocated");
+    if (!rgb || !result || !yuv) {
+        SDL_free(rgb);
+        SDL_free(result);
+        SDL_free(yuv);
+        return TEST_ABORTED;
+    }
+
+    /* Solid 2x2 blocks, so chroma subsampling doesn't lose anything */
+    for (y = 0; y < h; ++y) {
+        for (x = 0; x < w; ++x) {
+            const Uint32 block = (y / 2) * 19 + (x / 2);
+            rgb[y * w + x] = 0xFF000000 | ((block * 97) % 256) << 16 | ((block * 61 + 40) % 256) << 8 | ((block * 13 + 200) % 256);
+        }
+    }
+
+    for (i = 0; i < SDL_arraysize(modes); ++i) {
+        SDL_SetYUVConversionMode(modes[i]);
+        for (j = 0; j < SDL_arraysize(yuv_formats); ++j) {
+            if (yuv_formats[j] == SDL_PIXELFORMAT_YUY2 ||
+                yuv_formats[j] == SDL_PIXELFORMAT_UYVY ||
+                yuv_formats[j] == SDL_PIXELFORMAT_YVYU) {
+                yuv_pitch = ((w + 1) / 2) * 4;
+            } else {
+                yuv_pitch = w;
+            }
+            ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, rgb, rgb_pitch, yuv_formats[j], yuv, yuv_pitch);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertPixels to %s, expected: 0, got: %i", SDL_GetPixelFormatName(yuv_formats[j]), ret);
+            ret = SDL_ConvertPixels(w, h, yuv_formats[j], yuv, yuv_pitch, SDL_PIXELFORMAT_ARGB8888, result, rgb_pitch);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertPixels from %s, expected: 0, got: %i", SDL_GetPixelFormatName(yuv_formats[j]), ret);
+
+            errors = 0;
+            for (x = 0; x < w * h; ++x) {
+                int k;
+                for (k = 0; k < 32; k += 8) {
+                    const int diff = (int)((rgb[x] >> k) & 0xFF) - (int)((result[x] >> k) & 0xFF);
+                    if (diff < -6 || diff > 6) {
+                        ++errors;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Validate round trip through %s in mode %i, expected: 0 errors, got: %i", SDL_GetPixelFormatName(yuv_formats[j]), modes[i], errors);
+        }
+    }
+
+    /* Limited range white and black */
+    SDL_SetYUVConversionMode(SDL_YUV_CONVERSION_BT601);
+    ret = SDL_ConvertPixels(2, 1, SDL_PIXELFORMAT_YUY2, yuy2, 4, SDL_PIXELFORMAT_ARGB8888, pixels, 8);
+    SDLTest_AssertCheck(ret == 0 && pixels[0] == 0xFFFFFFFF, "Verify BT.601 white, expected: 0xFFFFFFFF, got: 0x%.8x", pixels[0]);
+    SDLTest_AssertCheck(ret == 0 && pixels[1] == 0xFF000000, "Verify BT.601 black, expected: 0xFF000000, got: 0x%.8x", pixels[1]);
+
+    /* Full range BT.709 red, Y = 0.2126 * 255 */
+    SDL_SetYUVConversionMode(SDL_YUV_CONVERSION_BT709_FULL);
+    pixels[0] = pixels[1] = 0xFFFF0000;
+    ret = SDL_ConvertPixels(2, 1, SDL_PIXELFORMAT_ARGB8888, pixels, 8, SDL_PIXELFORMAT_YUY2, yuy2, 4);
+    SDLTest_AssertCheck(ret == 0 && yuy2[0] == 54 && yuy2[3] == 255, "Verify full range BT.709 red, expected: Y 54 V 255, got: Y %d V %d", yuy2[0], yuy2[3]);
+    ret = SDL_ConvertPixels(2, 1, SDL_PIXELFORMAT_YUY2, yuy2, 4, SDL_PIXELFORMAT_ARGB8888, pixels, 8);
+    SDLTest_AssertCheck(ret == 0 && ((pixels[0] >> 16) & 0xFF) >= 0xFC && ((pixels[0] >> 8) & 0xFF) <= 3 && (pixels[0] & 0xFF) <= 3, "Verify full range BT.709 red round trip, expected: about 0xFFFF0000, got: 0x%.8x", pixels[0]);
+
+    /* Formats without 8-bit channels go through the blitters */
+    ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_YV12, yuv, w, SDL_PIXELFORMAT_RGB565, result, rgb_pitch);
+    SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertPixels to RGB565, expected: 0, got: %i", ret);
+
+    ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_YV12, yuv, w, SDL_PIXELFORMAT_NV12, result, w);
+    SDLTest_AssertCheck(ret == -1, "Validate conversion between YUV formats fails, got: %i", ret);
+
+    SDL_SetYUVConversionMode(SDL_YUV_CONVERSION_BT601);
+    SDL_free(rgb);
+    SDL_free(result);
+    SDL_free(yuv);
+
+    return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests sprite loading. A failure case.
  */
@@ -588,6 +695,707 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/**
+ * @brief Tests blitting one surface to several targets in turn, which reuses the blit mapping.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_BlitSurface
+ */
+int
+surface_testBlitAlternateTargets(void *arg)
+{
+    SDL_Surface *src, *targets[3];
+    Uint32 expected[3];
+    int i, pass, ret;
+
+    src = SDL_CreateRGBSurfaceWithFormat(0, 8, 8, 32, SDL_PIXELFORMAT_ARGB8888);
+    targets[0] = SDL_CreateRGBSurfaceWithFormat(0, 8, 8, 32, SDL_PIXELFORMAT_RGB888);
+    targets[1] = SDL_CreateRGBSurfaceWithFormat(0, 16, 4, 32, SDL_PIXELFORMAT_RGB888);
+    targets[2] = SDL_CreateRGBSurfaceWithFormat(0, 8, 8, 16, SDL_PIXELFORMAT_RGB565);
+    SDLTest_AssertCheck(src && targets[0] && targets[1] && targets[2], "Verify surfaces are not NULL");
+    if (!src || !targets[0] || !targets[1] || !targets[2]) {
+        return TEST_ABORTED;
+    }
+    SDL_FillRect(src, NULL, 0xFF00FF00);
+    SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+
+    for (pass = 0; pass < 3; pass++) {
+        /* The second pass changes the blit flags, the third drops a target */
+        if (pass == 1) {
+            SDL_SetSurfaceColorMod(src, 0, 128, 0);
+        }
+        for (i = 0; i < SDL_arraysize(targets); i++) {
+            SDL_FillRect(targets[i], NULL, 0);
+            ret = SDL_BlitSurface(src, NULL, targets[i], NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface to target %d, expected: 0, got: %i", i, ret);
+            if (pass == 2 && i == 0) {
+                /* The blit mapping still references the surface */
+                SDL_FreeSurface(targets[0]);
+            }
+        }
+        expected[0] = expected[1] = (pass == 0) ? 0x00FF00 : 0x008000;
+        expected[2] = SDL_MapRGB(targets[2]->format, 0, (pass == 0) ? 255 : 128, 0);
+        for (i = (pass == 2) ? 1 : 0; i < SDL_arraysize(targets); i++) {
+            Uint32 pixel;
+            if (targets[i]->format->BytesPerPixel == 2) {
+                pixel = *(Uint16 *)targets[i]->pixels;
+            } else {
+                pixel = *(Uint32 *)targets[i]->pixels & 0x00FFFFFF;
+            }
+            SDLTest_AssertCheck(pixel == expected[i], "Verify pass %d target %d, expected: 0x%.6x, got: 0x%.6x", pass, i, expected[i], pixel);
+        }
+    }
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(targets[1]);
+    SDL_FreeSurface(targets[2]);
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests premultiplying alpha and blitting with premultiplied alpha blending.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_PremultiplyAlpha
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetSurfaceBlendMode
+ */
+int
+surface_testPremultipliedAlpha(void *arg)
+{
+    const Uint32 colors[] = {
+        0x80FF4020, 0xFF123456, 0x00FFFFFF, 0x40808080,
+        0xC0102030, 0x01FFFFFF, 0xFE0000FF
+    };
+    const int n = SDL_arraysize(colors);
+    Uint32 pixels[SDL_arraysize(colors)], abgr[SDL_arraysize(colors)];
+    SDL_Surface *src, *dst, *dst565;
+    SDL_BlendMode mode;
+    int i, c, ret;
+
+    /* Premultiply in place, and into a format with a different byte order */
+    SDL_memcpy(pixels, colors, sizeof(pixels));
+    ret = SDL_PremultiplyAlpha(n, 1, SDL_PIXELFORMAT_ARGB8888, pixels, sizeof(pixels),
+                               SDL_PIXELFORMAT_ABGR8888, abgr, sizeof(abgr));
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha() to ABGR8888, expected: 0, got: %i", ret);
+    ret = SDL_PremultiplyAlpha(n, 1, SDL_PIXELFORMAT_ARGB8888, pixels, sizeof(pixels),
+                               SDL_PIXELFORMAT_ARGB8888, pixels, sizeof(pixels));
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha() in place, expected: 0, got: %i", ret);
+    SDLTest_AssertCheck(pixels[0] == 0x80802010, "Verify premultiplied pixel, expected: 0x80802010, got: 0x%.8x", pixels[0]);
+    for (i = 0; i < n; i++) {
+        const Uint32 a = colors[i] >> 24;
+        Uint32 expected = colors[i] & 0xFF000000;
+        for (c = 0; c < 24; c += 8) {
+            expected |= ((((colors[i] >> c) & 0xFF) * a + 127) / 255) << c;
+        }
+        SDLTest_AssertCheck(pixels[i] == expected, "Verify pixel %d, expected: 0x%.8x, got: 0x%.8x", i, expected, pixels[i]);
+        expected = (expected & 0xFF00FF00) | ((expected >> 16) & 0xFF) | ((expected & 0xFF) << 16);
+        SDLTest_AssertCheck(abgr[i] == expected, "Verify ABGR8888 pixel %d, expected: 0x%.8x, got: 0x%.8x", i, expected, abgr[i]);
+    }
+
+    /* Blit the premultiplied pixels over opaque blue */
+    src = SDL_CreateRGBSurfaceWithFormatFrom(pixels, n, 1, 32, sizeof(pixels), SDL_PIXELFORMAT_ARGB8888);
+    dst = SDL_CreateRGBSurfaceWithFormat(0, n, 1, 32, SDL_PIXELFORMAT_ARGB8888);
+    dst565 = SDL_CreateRGBSurfaceWithFormat(0, n, 1, 16, SDL_PIXELFORMAT_RGB565);
+    SDLTest_AssertCheck(src && dst && dst565, "Verify surfaces are not NULL");
+    if (!src || !dst || !dst565) {
+        return TEST_ABORTED;
+    }
+    ret = SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceBlendMode(), expected: 0, got: %i", ret);
+    ret = SDL_GetSurfaceBlendMode(src, &mode);
+    SDLTest_AssertCheck(ret == 0 && mode == SDL_BLENDMODE_BLEND_PREMULTIPLIED, "Verify SDL_GetSurfaceBlendMode(), got: %d", mode);
+
+    SDL_FillRect(dst, NULL, 0xFF0000FF);
+    SDL_FillRect(dst565, NULL, 0x001F);
+    ret = SDL_BlitSurface(src, NULL, dst, NULL);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(), expected: 0, got: %i", ret);
+    ret = SDL_BlitSurface(src, NULL, dst565, NULL);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface() to RGB565, expected: 0, got: %i", ret);
+    for (i = 0; i < n; i++) {
+        const Uint32 inva = 255 - (pixels[i] >> 24);
+        const Uint32 result = ((Uint32 *)dst->pixels)[i];
+        const Uint32 d = 0xFF0000FF;
+        Uint8 r, g, b;
+        for (c = 0; c < 32; c += 8) {
+            const int expected = ((pixels[i] >> c) & 0xFF) + (((d >> c) & 0xFF) * inva + 127) / 255;
+            const int actual = (result >> c) & 0xFF;
+            SDLTest_AssertCheck(SDL_abs(expected - actual) <= 1, "Verify blended pixel %d channel %d, expected: %d, got: %d", i, c / 8, expected, actual);
+        }
+        SDL_GetRGB(((Uint16 *)dst565->pixels)[i], dst565->format, &r, &g, &b);
+        SDLTest_AssertCheck(SDL_abs((int)r - (int)((pixels[i] >> 16) & 0xFF)) <= 8 &&
+                            SDL_abs((int)b - (int)((pixels[i] & 0xFF) + (255 * inva) / 255)) <= 8,
+                            "Verify RGB565 pixel %d, got: %d,%d,%d", i, r, g, b);
+    }
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(dst565);
+    return TEST_COMPLETED;
+}
+
+static Uint32
+_readPixel(SDL_Surface *surface, int x, int y)
+{
+    const Uint8 *p = (const Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel;
+    if (surface->format->BytesPerPixel == 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        return p[0] | (p[1] << 8) | (p[2] << 16);
+#else
+        return (p[0] << 16) | (p[1] << 8) | p[2];
+#endif
+    }
+    if (surface->format->BytesPerPixel == 2) {
+        return *(const Uint16 *)p;
+    }
+    return *(const Uint32 *)p;
+}
+
+static void
+_writePixel(SDL_Surface *surface, int x, int y, Uint32 pixel)
+{
+    Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel;
+    if (surface->format->BytesPerPixel == 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        p[0] = (Uint8)pixel; p[1] = (Uint8)(pixel >> 8); p[2] = (Uint8)(pixel >> 16);
+#else
+        p[0] = (Uint8)(pixel >> 16); p[1] = (Uint8)(pixel >> 8); p[2] = (Uint8)pixel;
+#endif
+    } else if (surface->format->BytesPerPixel == 2) {
+        *(Uint16 *)p = (Uint16)pixel;
+    } else {
+        *(Uint32 *)p = pixel;
+    }
+}
+
+/**
+ * @brief Tests conversions and colorkey blits between the byte aligned 24 and 32-bit formats
+ */
+int
+surface_testSwizzleBlits(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888,
+        SDL_PIXELFORMAT_RGBX8888, SDL_PIXELFORMAT_BGRX8888, SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_BGR24
+    };
+    const int w = 13, h = 3;
+    int i, j, x, y, ret;
+
+    for (i = 0; i < SDL_arraysize(formats); i++) {
+        for (j = 0; j < SDL_arraysize(formats); j++) {
+            SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[i]);
+            SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w + 3, h, 0, formats[j]);
+            const char *srcname = SDL_GetPixelFormatName(formats[i]);
+            const char *dstname = SDL_GetPixelFormatName(formats[j]);
+            const SDL_bool keyed = (src->format->BytesPerPixel == 4 && dst->format->BytesPerPixel == 4);
+            Uint32 key, sentinel;
+            int errors = 0;
+
+            SDLTest_AssertCheck(src && dst, "Verify surfaces are not NULL");
+            if (!src || !dst) {
+                return TEST_ABORTED;
+            }
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w; x++) {
+                    _writePixel(src, x, y, SDL_MapRGBA(src->format, (Uint8)(x * 19 + y), (Uint8)(x * 7 + 100), (Uint8)(255 - x * 11 - y), (Uint8)(x * 23 + y * 5)));
+                }
+            }
+            /* Two pixels in different lanes match the colorkey */
+            key = _readPixel(src, 1, 0);
+            _writePixel(src, 6, 1, key);
+
+            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+            sentinel = SDL_MapRGBA(dst->format, 1, 2, 3, 4);
+            SDL_FillRect(dst, NULL, sentinel);
+            ret = SDL_BlitSurface(src, NULL, dst, NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(%s -> %s), expected: 0, got: %i", srcname, dstname, ret);
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w + 3; x++) {
+                    Uint8 sr, sg, sb, sa, dr, dg, db, da;
+                    if (x < w) {
+                        SDL_GetRGBA(_readPixel(src, x, y), src->format, &sr, &sg, &sb, &sa);
+                        if (!dst->format->Amask) {
+                            sa = 255;
+                        }
+                    } else {
+                        SDL_GetRGBA(sentinel, dst->format, &sr, &sg, &sb, &sa);
+                    }
+                    SDL_GetRGBA(_readPixel(dst, x, y), dst->format, &dr, &dg, &db, &da);
+                    if (sr != dr || sg != dg || sb != db || sa != da) {
+                        ++errors;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Verify %s -> %s conversion, expected: 0 errors, got: %d", srcname, dstname, errors);
+
+            if (keyed) {
+                errors = 0;
+                SDL_SetColorKey(src, SDL_TRUE, key);
+                SDL_FillRect(dst, NULL, sentinel);
+                ret = SDL_BlitSurface(src, NULL, dst, NULL);
+                SDLTest_AssertCheck(ret == 0, "Verify result from colorkey SDL_BlitSurface(%s -> %s), expected: 0, got: %i", srcname, dstname, ret);
+                for (y = 0; y < h; y++) {
+                    for (x = 0; x < w; x++) {
+                        const Uint32 pixel = _readPixel(src, x, y);
+                        Uint8 sr, sg, sb, sa, dr, dg, db, da;
+                        if ((pixel & ~src->format->Amask) == (key & ~src->format->Amask)) {
+                            SDL_GetRGBA(sentinel, dst->format, &sr, &sg, &sb, &sa);
+                        } else {
+                            SDL_GetRGBA(pixel, src->format, &sr, &sg, &sb, &sa);
+                            if (!dst->format->Amask) {
+                                sa = 255;
+                            }
+                        }
+                        SDL_GetRGBA(_readPixel(dst, x, y), dst->format, &dr, &dg, &db, &da);
+                        if (sr != dr || sg != dg || sb != db || sa != da) {
+                            ++errors;
+                        }
+                    }
+                }
+                SDLTest_AssertCheck(errors == 0, "Verify %s -> %s colorkey blit, expected: 0 errors, got: %d", srcname, dstname, errors);
+
+                /* Converting to a format with alpha turns the colorkey into alpha */
+                if (dst->format->Amask) {
+                    SDL_Surface *converted = SDL_ConvertSurface(src, dst->format, 0);
+                    SDLTest_AssertCheck(converted != NULL, "Verify result from SDL_ConvertSurface(%s -> %s) is not NULL", srcname, dstname);
+                    if (converted) {
+                        errors = 0;
+                        for (y = 0; y < h; y++) {
+                            for (x = 0; x < w; x++) {
+                                const Uint32 pixel = _readPixel(src, x, y);
+                                Uint8 sr, sg, sb, sa, dr, dg, db, da;
+                                SDL_GetRGBA(pixel, src->format, &sr, &sg, &sb, &sa);
+                                if ((pixel & ~src->format->Amask) == (key & ~src->format->Amask)) {
+                                    sa = 0;
+                                }
+                                SDL_GetRGBA(_readPixel(converted, x, y), converted->format, &dr, &dg, &db, &da);
+                                if (sr != dr || sg != dg || sb != db || sa != da) {
+                                    ++errors;
+                                }
+                            }
+                        }
+                        SDLTest_AssertCheck(errors == 0, "Verify %s -> %s colorkey conversion, expected: 0 errors, got: %d", srcname, dstname, errors);
+                        SDL_FreeSurface(converted);
+                    }
+                }
+            }
+
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+        }
+    }
+
+    /* The same for 16-bit pixels */
+    {
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_ARGB4444);
+        SDL_Surface *converted;
+        int errors = 0;
+
+        SDLTest_AssertCheck(src != NULL, "Verify surface is not NULL");
+        if (!src) {
+            return TEST_ABORTED;
+        }
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++) {
+                _writePixel(src, x, y, (x % 5 == 2) ? 0xF123 : (Uint32)(0xF000 | (x * 0x111 + y)));
+            }
+        }
+        SDL_SetColorKey(src, SDL_TRUE, 0xF123);
+        converted = SDL_ConvertSurface(src, src->format, 0);
+        SDLTest_AssertCheck(converted != NULL, "Verify result from SDL_ConvertSurface() is not NULL");
+        if (converted) {
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w; x++) {
+                    const Uint32 expected = (x % 5 == 2) ? 0x0123 : (Uint32)(0xF000 | (x * 0x111 + y));
+                    if (_readPixel(converted, x, y) != expected) {
+                        ++errors;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Verify 16-bit colorkey conversion, expected: 0 errors, got: %d", errors);
+            SDL_FreeSurface(converted);
+        }
+        SDL_FreeSurface(src);
+    }
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that RLE encoded surfaces keep their pixels and follow changes to them
+ */
+int
+surface_testRLEAccel(void *arg)
+{
+    const int w = 37, h = 5;
+    int pass, x, y, ret, errors;
+    Uint32 *pixels;
+
+    for (pass = 0; pass < 2; pass++) {
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Surface *keyed = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGB888);
+        SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGB888);
+        SDL_Surface *ref = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGB888);
+        SDLTest_AssertCheck(src && keyed && dst && ref, "Verify surfaces are not NULL");
+        if (!src || !keyed || !dst || !ref) {
+            return TEST_ABORTED;
+        }
+
+        /* The second pass encodes on a background thread */
+        SDL_SetHint(SDL_HINT_VIDEO_RLE_BACKGROUND, pass ? "1" : "0");
+
+        pixels = (Uint32 *)src->pixels;
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++) {
+                /* opaque, translucent and transparent pixels, the transparent ones with a color */
+                const Uint32 alpha = (x % 3 == 0) ? 0xFF : (x % 3 == 1) ? (Uint32)(x * 7) : 0;
+                pixels[y * src->pitch / 4 + x] = (alpha << 24) | (x * 0x010203) | (y << 20);
+                ((Uint32 *)keyed->pixels)[y * keyed->pitch / 4 + x] = (x % 4) ? 0x00FF00FF : (Uint32)(x * 0x030201);
+            }
+        }
+        SDL_SetSurfaceRLE(src, 1);
+        SDL_SetColorKey(keyed, SDL_RLEACCEL, 0x00FF00FF);
+
+        SDL_FillRect(dst, NULL, 0x00204060);
+        ret = SDL_BlitSurface(src, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(), expected: 0, got: %i", ret);
+        ret = SDL_BlitSurface(keyed, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from colorkey SDL_BlitSurface(), expected: 0, got: %i", ret);
+        SDLTest_AssertCheck(SDL_MUSTLOCK(src) && SDL_MUSTLOCK(keyed), "Verify surfaces are RLE accelerated");
+
+        /* A lock that changes nothing keeps the encoding */
+        SDL_LockSurface(keyed);
+        SDL_UnlockSurface(keyed);
+        SDLTest_AssertCheck(SDL_MUSTLOCK(keyed), "Verify surface is still RLE accelerated after an unchanged lock");
+
+        /* Locking must give back the exact pixels, including transparent colors */
+        ret = SDL_LockSurface(src);
+        SDLTest_AssertCheck(ret == 0 && src->pixels, "Verify SDL_LockSurface() gives access to the pixels");
+        errors = 0;
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++) {
+                const Uint32 alpha = (x % 3 == 0) ? 0xFF : (x % 3 == 1) ? (Uint32)(x * 7) : 0;
+                if (((Uint32 *)src->pixels)[y * src->pitch / 4 + x] != ((alpha << 24) | (x * 0x010203) | (y << 20))) {
+                    ++errors;
+                }
+            }
+        }
+        SDLTest_AssertCheck(errors == 0, "Verify locked pixels are unchanged, expected: 0 errors, got: %d", errors);
+
+        /* Make every pixel opaque, then blits must follow the change */
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++) {
+                ((Uint32 *)src->pixels)[y * src->pitch / 4 + x] |= 0xFF000000;
+            }
+        }
+        SDL_UnlockSurface(src);
+        SDL_FillRect(keyed, NULL, 0x00FF00FF);
+
+        for (x = 0; x < 20; x++) {
+            SDL_Rect rect;
+            rect.x = 0;
+            rect.y = 0;
+            rect.w = w;
+            rect.h = h;
+            SDL_FillRect(dst, NULL, 0x00204060);
+            SDL_BlitSurface(src, NULL, dst, &rect);
+            SDL_BlitSurface(keyed, NULL, dst, &rect);
+            SDL_FillRect(ref, NULL, 0x00204060);
+            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(src, NULL, ref, NULL);
+            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+            ret = SDLTest_CompareSurfaces(dst, ref, 0);
+            if (ret != 0) {
+                break;
+            }
+            SDL_Delay(pass ? 5 : 0);
+        }
+        SDLTest_AssertCheck(ret == 0, "Verify blits after the pixels changed, expected: 0, got: %i", ret);
+
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(keyed);
+        SDL_FreeSurface(dst);
+        SDL_FreeSurface(ref);
+    }
+    SDL_SetHint(SDL_HINT_VIDEO_RLE_BACKGROUND, NULL);
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests filling rectangles of all pixel sizes against a reference fill
+ */
+static void
+_referenceFill(SDL_Surface *surface, const SDL_Rect *rect, Uint32 color)
+{
+    SDL_Rect clipped;
+    const int bpp = surface->format->BytesPerPixel;
+    int x, y;
+
+    if (!SDL_IntersectRect(rect, &surface->clip_rect, &clipped)) {
+        return;
+    }
+    for (y = clipped.y; y < clipped.y + clipped.h; y++) {
+        for (x = clipped.x; x < clipped.x + clipped.w; x++) {
+            Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * bpp;
+            switch (bpp) {
+            case 1:
+                *p = (Uint8)color;
+                break;
+            case 2:
+                *(Uint16 *)p = (Uint16)color;
+                break;
+            case 3:
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                p[0] = (Uint8)color; p[1] = (Uint8)(color >> 8); p[2] = (Uint8)(color >> 16);
+#else
+                p[0] = (Uint8)(color >> 16); p[1] = (Uint8)(color >> 8); p[2] = (Uint8)color;
+#endif
+                break;
+            default:
+                *(Uint32 *)p = color;
+                break;
+            }
+        }
+    }
+}
+
+int
+surface_testFillRects(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_ARGB8888
+    };
+    /* Large enough for non-temporal fills, with an odd pitch to misalign rows */
+    const int w = 311, h = 240, pitch = 311 * 4 + 3;
+    Uint8 *buffer = (Uint8 *)SDL_malloc(2 * pitch * h + 1);
+    SDL_Rect rects[200];
+    int f, i, j, ret;
+
+    SDLTest_AssertCheck(buffer != NULL, "Verify buffer is not NULL");
+    if (!buffer) {
+        return TEST_ABORTED;
+    }
+    /* The row padding is compared too, so it must start out identical */
+    SDL_memset(buffer, 0, 2 * pitch * h + 1);
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        int bpp, depth;
+        Uint32 Rmask, Gmask, Bmask, Amask;
+        SDL_Surface *dst, *ref;
+
+        SDL_PixelFormatEnumToMasks(formats[f], &depth, &Rmask, &Gmask, &Bmask, &Amask);
+        dst = SDL_CreateRGBSurfaceFrom(buffer + 1, w, h, depth, pitch, Rmask, Gmask, Bmask, Amask);
+        ref = SDL_CreateRGBSurfaceFrom(buffer + 1 + pitch * h, w, h, depth, pitch, Rmask, Gmask, Bmask, Amask);
+        SDLTest_AssertCheck(dst && ref, "Verify surfaces are not NULL");
+        if (!dst || !ref) {
+            SDL_free(buffer);
+            return TEST_ABORTED;
+        }
+        bpp = dst->format->BytesPerPixel;
+
+        /* Whole surface fill */
+        ret = SDL_FillRect(dst, NULL, 0x12345678);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect(), expected: 0, got: %i", ret);
+        _referenceFill(ref, &ref->clip_rect, 0x12345678);
+        ret = SDL_memcmp(dst->pixels, ref->pixels, pitch * h);
+        SDLTest_AssertCheck(ret == 0, "Verify full fill of %d byte pixels, expected: 0, got: %i", bpp, ret);
+
+        /* Batches of unordered rectangles, partly outside the clip rect */
+        for (i = 0; i < SDL_arraysize(rects); i++) {
+            rects[i].x = SDLTest_RandomIntegerInRange(-20, w);
+            rects[i].y = SDLTest_RandomIntegerInRange(-20, h);
+            rects[i].w = SDLTest_RandomIntegerInRange(0, (i & 1) ? 8 : w);
+            rects[i].h = SDLTest_RandomIntegerInRange(0, (i & 1) ? 8 : 30);
+        }
+        for (i = 0; i < 2; i++) {
+            SDL_Rect clip;
+            const int count = i ? SDL_arraysize(rects) : 10;
+            const Uint32 color = i ? 0xA5C3E1F0 : 0x0F1E2D3C;
+
+            clip.x = 3 * i;
+            clip.y = 5 * i;
+            clip.w = w - 7 * i;
+            clip.h = h - 9 * i;
+            SDL_SetClipRect(dst, &clip);
+            SDL_SetClipRect(ref, &clip);
+            ret = SDL_FillRects(dst, rects, count, color);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects(), expected: 0, got: %i", ret);
+            for (j = 0; j < count; j++) {
+                _referenceFill(ref, &rects[j], color);
+            }
+            ret = SDL_memcmp(dst->pixels, ref->pixels, pitch * h);
+            SDLTest_AssertCheck(ret == 0, "Verify fill of %d rects of %d byte pixels, expected: 0, got: %i", count, bpp, ret);
+        }
+
+        SDL_FreeSurface(dst);
+        SDL_FreeSurface(ref);
+    }
+    SDL_free(buffer);
+
+    return TEST_COMPLETED;
+}
+
+/* Writes the headers of a BMP file with a 40 byte info header */
+static int
+_writeBMPHeader(Uint8 *buffer, int w, int h, int bpp, Uint32 compression, int extra, int size)
+{
+    const int offset = 14 + 40 + extra;
+
+    SDL_memset(buffer, 0, offset);
+    buffer[0] = 'B';
+    buffer[1] = 'M';
+    buffer[2] = (Uint8)(offset + size);
+    buffer[3] = (Uint8)((offset + size) >> 8);
+    buffer[10] = (Uint8)offset;
+    buffer[14] = 40;
+    buffer[18] = (Uint8)w;
+    buffer[22] = (Uint8)h;
+    buffer[23] = buffer[24] = buffer[25] = (h < 0) ? 0xFF : 0;
+    buffer[26] = 1;
+    buffer[28] = (Uint8)bpp;
+    buffer[30] = (Uint8)compression;
+    buffer[34] = (Uint8)size;
+    return offset;
+}
+
+/* A data source that can't tell its size */
+static Sint64 SDLCALL
+_unknownRWsize(SDL_RWops *context)
+{
+    return -1;
+}
+
+/* Compares a row of an 8-bit surface */
+static int
+_compareBMPRow(SDL_Surface *surface, int y, const Uint8 *expected)
+{
+    return SDL_memcmp((Uint8 *)surface->pixels + y * surface->pitch, expected, surface->w);
+}
+
+/**
+ * @brief Tests loading compressed, in place and bottom-up BMP files
+ */
+int
+surface_testLoadBMPEncodings(void *arg)
+{
+    const Uint8 rle8[] = {
+        3, 1, 0, 3, 2, 3, 4, 0, 0, 0,   /* bottom row: a run and 3 absolute pixels */
+        0, 2, 2, 1, 2, 5, 0, 0,         /* move 2 right and 1 up, then a run */
+        6, 7, 0, 1                      /* top row, then the end of the bitmap */
+    };
+    const Uint8 rle4[] = {
+        5, 0x12, 0, 0,                  /* alternating colors */
+        0, 3, 0x34, 0x50, 0, 1          /* 3 absolute pixels */
+    };
+    const Uint8 rle8_rows[4][6] = {
+        { 7, 7, 7, 7, 7, 7 }, { 0, 0, 5, 5, 0, 0 }, { 0, 0, 0, 0, 0, 0 }, { 1, 1, 1, 2, 3, 4 }
+    };
+    const Uint8 rle4_rows[2][5] = { { 3, 4, 5, 0, 0 }, { 1, 2, 1, 2, 1 } };
+    const char *filename = "testLoadBMPEncodings.bmp";
+    Uint32 buffer[64];
+    Uint8 *bytes = (Uint8 *)buffer;
+    SDL_Surface *surface, *face, *fromFile, *fromMemory;
+    SDL_RWops *rw;
+    int offset, y, ret;
+
+    /* Run length encoded 8-bit image */
+    offset = _writeBMPHeader(bytes, 6, 4, 8, 1, 0, sizeof(rle8));
+    SDL_memcpy(bytes + offset, rle8, sizeof(rle8));
+    surface = SDL_LoadBMP_RW(SDL_RWFromConstMem(bytes, offset + sizeof(rle8)), 1);
+    SDLTest_AssertCheck(surface != NULL, "Verify RLE8 image loaded, got: %s", surface ? "surface" : SDL_GetError());
+    if (surface) {
+        for (y = 0; y < 4; y++) {
+            SDLTest_AssertCheck(_compareBMPRow(surface, y, rle8_rows[y]) == 0, "Verify row %i of RLE8 image", y);
+        }
+        SDL_FreeSurface(surface);
+    }
+
+    /* Without the size of the data source, a huge biSizeImage is bounded by the image size */
+    bytes[34] = 0xF0;
+    bytes[35] = bytes[36] = bytes[37] = 0xFF;
+    rw = SDL_RWFromConstMem(bytes, offset + sizeof(rle8));
+    if (rw) {
+        rw->size = _unknownRWsize;
+    }
+    surface = SDL_LoadBMP_RW(rw, 1);
+    SDLTest_AssertCheck(surface != NULL, "Verify RLE8 image with unknown size loaded, got: %s", surface ? "surface" : SDL_GetError());
+    if (surface) {
+        for (y = 0; y < 4; y++) {
+            SDLTest_AssertCheck(_compareBMPRow(surface, y, rle8_rows[y]) == 0, "Verify row %i of RLE8 image with unknown size", y);
+        }
+        SDL_FreeSurface(surface);
+    }
+
+    /* Run length encoded 4-bit image */
+    offset = _writeBMPHeader(bytes, 5, 2, 4, 2, 0, sizeof(rle4));
+    SDL_memcpy(bytes + offset, rle4, sizeof(rle4));
+    surface = SDL_LoadBMP_RW(SDL_RWFromConstMem(bytes, offset + sizeof(rle4)), 1);
+    SDLTest_AssertCheck(surface != NULL, "Verify RLE4 image loaded, got: %s", surface ? "surface" : SDL_GetError());
+    if (surface) {
+        for (y = 0; y < 2; y++) {
+            SDLTest_AssertCheck(_compareBMPRow(surface, y, rle4_rows[y]) == 0, "Verify row %i of RLE4 image", y);
+        }
+        SDL_FreeSurface(surface);
+    }
+
+    /* Top-down 32-bit image with bit fields, used in place when allowed */
+    offset = _writeBMPHeader(bytes, 4, -3, 32, 3, 12 + 2, 4 * 3 * 4);
+    bytes[56] = 0xFF;   /* Rmask = 0x00FF0000 */
+    bytes[59] = 0xFF;   /* Gmask = 0x0000FF00 */
+    bytes[62] = 0xFF;   /* Bmask = 0x000000FF */
+    for (y = 0; y < 12; y++) {
+        buffer[offset / 4 + y] = 0x00102030 * y;
+    }
+    SDL_SetHint(SDL_HINT_BMP_LOAD_IN_PLACE, "1");
+    surface = SDL_LoadBMP_RW(SDL_RWFromMem(bytes, offset + 4 * 3 * 4), 1);
+    SDLTest_AssertCheck(surface != NULL && surface->pixels == &buffer[offset / 4], "Verify 32-bit image is used in place");
+    SDL_FreeSurface(surface);
+    SDL_SetHint(SDL_HINT_BMP_LOAD_IN_PLACE, "0");
+    surface = SDL_LoadBMP_RW(SDL_RWFromMem(bytes, offset + 4 * 3 * 4), 1);
+    SDLTest_AssertCheck(surface != NULL && surface->pixels != &buffer[offset / 4], "Verify 32-bit image is copied");
+    if (surface) {
+        ret = SDL_memcmp(surface->pixels, &buffer[offset / 4], 4 * 3 * 4);
+        SDLTest_AssertCheck(ret == 0, "Verify 32-bit image pixels, expected: 0, got: %i", ret);
+        SDL_FreeSurface(surface);
+    }
+
+    /* Bottom-up image flipped after reading it from a file, or copied row by row from memory */
+    face = SDLTest_ImageFace();
+    SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+    if (face == NULL) {
+        return TEST_ABORTED;
+    }
+    unlink(filename);
+    ret = SDL_SaveBMP(face, filename);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP, expected: 0, got: %i", ret);
+    fromFile = SDL_LoadBMP(filename);
+    rw = SDL_RWFromFile(filename, "rb");
+    SDLTest_AssertCheck(rw != NULL, "Verify BMP file opened");
+    if (rw == NULL) {
+        return TEST_ABORTED;
+    }
+    offset = (int)SDL_RWsize(rw);
+    bytes = (Uint8 *)SDL_malloc(offset);
+    SDL_RWread(rw, bytes, 1, offset);
+    SDL_RWclose(rw);
+    fromMemory = SDL_LoadBMP_RW(SDL_RWFromConstMem(bytes, offset), 1);
+    SDLTest_AssertCheck(fromFile != NULL && fromMemory != NULL, "Verify BMP loaded from file and memory");
+    if (fromFile && fromMemory) {
+        ret = SDLTest_CompareSurfaces(fromFile, face, 0);
+        SDLTest_AssertCheck(ret == 0, "Verify BMP loaded from file matches, expected: 0, got: %i", ret);
+        ret = SDLTest_CompareSurfaces(fromMemory, face, 0);
+        SDLTest_AssertCheck(ret == 0, "Verify BMP loaded from memory matches, expected: 0, got: %i", ret);
+    }
+    unlink(filename);
+    SDL_free(bytes);
+    SDL_FreeSurface(fromFile);
+    SDL_FreeSurface(fromMemory);
+    SDL_FreeSurface(face);
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -630,11 +1438,33 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testConvertPixelsYUV, "surface_testConvertPixelsYUV", "Tests pixel conversion between RGB and YUV formats", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testBlitAlternateTargets, "surface_testBlitAlternateTargets", "Tests blitting one surface to several targets in turn", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testPremultipliedAlpha, "surface_testPremultipliedAlpha", "Tests premultiplying alpha and premultiplied alpha blending", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testSwizzleBlits, "surface_testSwizzleBlits", "Tests blitting between byte aligned 24 and 32-bit formats", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testRLEAccel, "surface_testRLEAccel", "Tests locking and changing RLE accelerated surfaces", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest18 =
+        { (SDLTest_TestCaseFp)surface_testFillRects, "surface_testFillRects", "Tests filling rectangles of all pixel sizes", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest19 =
+        { (SDLTest_TestCaseFp)surface_testLoadBMPEncodings, "surface_testLoadBMPEncodings", "Tests loading compressed, in place and bottom-up BMP files", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14, &surfaceTest15,
+    &surfaceTest16, &surfaceTest17, &surfaceTest18, &surfaceTest19, NULL
 };
 
 /* Surface test suite (global) */